@@ -0,0 +1,611 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+// Benchmark of the conversion functions
+// Each configuration (resolution, format, implementation, thread count and store policy) is run for a minimum
+// time, and the wall clock time of each frame is measured, to report the median and 99th percentile time per
+// frame, the throughput (input and output bytes) and the cycles per pixel. Results are printed as a table, and
+// optionally saved as json, so that they can be compared between versions and hosts.
+
+// posix_memalign, clock_gettime, getopt, gethostname
+#define _POSIX_C_SOURCE 200112L
+
+#include "yuv_rgb.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <unistd.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+typedef enum
+{
+	KIND_YUV2RGB,
+	KIND_YUVSP2RGB,
+	KIND_YUV2RGB32,
+	KIND_RGB2YUV,
+	KIND_RGB2YUVSP
+} ConversionKind;
+
+typedef union
+{
+	YUV2RGBFunction yuv2rgb;
+	YUVSP2RGBFunction yuvsp2rgb;
+	YUV2RGB32Function yuv2rgb32;
+	RGB2YUVFunction rgb2yuv;
+	RGB2YUVSPFunction rgb2yuvsp;
+} ConversionFunction;
+
+typedef struct
+{
+	const char *name;
+	SIMDType simd;       // instruction set required by the implementation
+	int aligned;         // the implementation requires aligned pointers and strides
+	ConversionFunction fun;
+	int precise;         // the dispatching function is run with PRECISION_HIGH
+} Implementation;
+
+#define MAX_IMPLEMENTATIONS 15
+
+typedef struct
+{
+	const char *name;
+	ConversionKind kind;
+	Implementation implementations[MAX_IMPLEMENTATIONS];  // terminated by a NULL name
+} Format;
+
+#define YUV2RGB(NAME, SIMD, ALIGNED, FUN) {NAME, SIMD, ALIGNED, {.yuv2rgb = FUN}, 0}
+#define YUVSP2RGB(NAME, SIMD, ALIGNED, FUN) {NAME, SIMD, ALIGNED, {.yuvsp2rgb = FUN}, 0}
+#define YUV2RGB32(NAME, SIMD, ALIGNED, FUN) {NAME, SIMD, ALIGNED, {.yuv2rgb32 = FUN}, 0}
+#define RGB2YUV(NAME, SIMD, ALIGNED, FUN) {NAME, SIMD, ALIGNED, {.rgb2yuv = FUN}, 0}
+#define RGB2YUVSP(NAME, SIMD, ALIGNED, FUN) {NAME, SIMD, ALIGNED, {.rgb2yuvsp = FUN}, 0}
+// the high precision implementations: the std one, and the dispatching function (aligned)
+#define PRECISE(MEMBER, STD_FUN, FUN) {"precise_std", SIMD_NONE, 0, {.MEMBER = STD_FUN}, 0}, \
+	{"precise", SIMD_NONE, 1, {.MEMBER = FUN}, 1}
+
+// the sse implementations exist on x86 builds and arm builds with neon (forwarding to neon), the ssse3, avx2 
+// and avx512 ones only on x86 builds, the neon ones on arm builds with neon
+static const Format formats[] = {
+	{"yuv420_rgb24", KIND_YUV2RGB, {
+		YUV2RGB("std", SIMD_NONE, 0, yuv420_rgb24_std),
+		YUV2RGB("lut", SIMD_NONE, 0, yuv420_rgb24_lut),
+#if defined(__SSE2__) || defined(__ARM_NEON)
+		YUV2RGB("sse", SIMD_SSE2, 1, yuv420_rgb24_sse),
+		YUV2RGB("sseu", SIMD_SSE2, 0, yuv420_rgb24_sseu),
+#endif
+#ifdef __SSE2__
+		YUV2RGB("ssse3", SIMD_SSSE3, 1, yuv420_rgb24_ssse3),
+		YUV2RGB("ssse3u", SIMD_SSSE3, 0, yuv420_rgb24_ssse3u),
+		YUV2RGB("avx2", SIMD_AVX2, 1, yuv420_rgb24_avx2),
+		YUV2RGB("avx2u", SIMD_AVX2, 0, yuv420_rgb24_avx2u),
+		YUV2RGB("avx512", SIMD_AVX512, 1, yuv420_rgb24_avx512),
+		YUV2RGB("avx512u", SIMD_AVX512, 0, yuv420_rgb24_avx512u),
+#endif
+#ifdef __ARM_NEON
+		YUV2RGB("neon", SIMD_NEON, 0, yuv420_rgb24_neon),
+#endif
+		YUV2RGB("auto", SIMD_NONE, 0, yuv420_rgb24),
+		PRECISE(yuv2rgb, yuv420_rgb24_precise_std, yuv420_rgb24),
+		{NULL, SIMD_NONE, 0, {0}, 0}}},
+	{"nv12_rgb24", KIND_YUVSP2RGB, {
+		YUVSP2RGB("std", SIMD_NONE, 0, nv12_rgb24_std),
+		YUVSP2RGB("lut", SIMD_NONE, 0, nv12_rgb24_lut),
+#if defined(__SSE2__) || defined(__ARM_NEON)
+		YUVSP2RGB("sse", SIMD_SSE2, 1, nv12_rgb24_sse),
+		YUVSP2RGB("sseu", SIMD_SSE2, 0, nv12_rgb24_sseu),
+#endif
+#ifdef __SSE2__
+		YUVSP2RGB("ssse3", SIMD_SSSE3, 1, nv12_rgb24_ssse3),
+		YUVSP2RGB("ssse3u", SIMD_SSSE3, 0, nv12_rgb24_ssse3u),
+		YUVSP2RGB("avx2", SIMD_AVX2, 1, nv12_rgb24_avx2),
+		YUVSP2RGB("avx2u", SIMD_AVX2, 0, nv12_rgb24_avx2u),
+		YUVSP2RGB("avx512", SIMD_AVX512, 1, nv12_rgb24_avx512),
+		YUVSP2RGB("avx512u", SIMD_AVX512, 0, nv12_rgb24_avx512u),
+#endif
+#ifdef __ARM_NEON
+		YUVSP2RGB("neon", SIMD_NEON, 0, nv12_rgb24_neon),
+#endif
+		YUVSP2RGB("auto", SIMD_NONE, 0, nv12_rgb24),
+		PRECISE(yuvsp2rgb, nv12_rgb24_precise_std, nv12_rgb24),
+		{NULL, SIMD_NONE, 0, {0}, 0}}},
+	{"yuv420_rgba32", KIND_YUV2RGB32, {
+		YUV2RGB32("std", SIMD_NONE, 0, yuv420_rgba32_std),
+		YUV2RGB32("auto", SIMD_NONE, 0, yuv420_rgba32),
+		{NULL, SIMD_NONE, 0, {0}, 0}}},
+	{"rgb24_yuv420", KIND_RGB2YUV, {
+		RGB2YUV("std", SIMD_NONE, 0, rgb24_yuv420_std),
+#if defined(__SSE2__) || defined(__ARM_NEON)
+		RGB2YUV("sse", SIMD_SSE2, 1, rgb24_yuv420_sse),
+		RGB2YUV("sseu", SIMD_SSE2, 0, rgb24_yuv420_sseu),
+#endif
+#ifdef __SSE2__
+		RGB2YUV("avx512", SIMD_AVX512, 1, rgb24_yuv420_avx512),
+		RGB2YUV("avx512u", SIMD_AVX512, 0, rgb24_yuv420_avx512u),
+#endif
+#ifdef __ARM_NEON
+		RGB2YUV("neon", SIMD_NEON, 0, rgb24_yuv420_neon),
+#endif
+		RGB2YUV("auto", SIMD_NONE, 0, rgb24_yuv420),
+		PRECISE(rgb2yuv, rgb24_yuv420_precise_std, rgb24_yuv420),
+		{NULL, SIMD_NONE, 0, {0}, 0}}},
+	{"rgb24_nv12", KIND_RGB2YUVSP, {
+		RGB2YUVSP("std", SIMD_NONE, 0, rgb24_nv12_std),
+#if defined(__SSE2__) || defined(__ARM_NEON)
+		RGB2YUVSP("sse", SIMD_SSE2, 1, rgb24_nv12_sse),
+		RGB2YUVSP("sseu", SIMD_SSE2, 0, rgb24_nv12_sseu),
+#endif
+#ifdef __SSE2__
+		RGB2YUVSP("avx512", SIMD_AVX512, 1, rgb24_nv12_avx512),
+		RGB2YUVSP("avx512u", SIMD_AVX512, 0, rgb24_nv12_avx512u),
+#endif
+#ifdef __ARM_NEON
+		RGB2YUVSP("neon", SIMD_NEON, 0, rgb24_nv12_neon),
+#endif
+		RGB2YUVSP("auto", SIMD_NONE, 0, rgb24_nv12),
+		PRECISE(rgb2yuvsp, rgb24_nv12_precise_std, rgb24_nv12),
+		{NULL, SIMD_NONE, 0, {0}, 0}}}
+};
+#define FORMAT_COUNT (sizeof(formats)/sizeof(formats[0]))
+
+typedef struct
+{
+	const char *name;
+	uint32_t width, height;
+} Resolution;
+
+static const Resolution resolutions[] = {
+	{"qvga", 320, 240},
+	{"vga", 640, 480},
+	{"720p", 1280, 720},
+	{"1080p", 1920, 1080},
+	{"4k", 3840, 2160},
+	{"8k", 7680, 4320}
+};
+#define RESOLUTION_COUNT (sizeof(resolutions)/sizeof(resolutions[0]))
+
+static const char *policy_names[] = {"auto", "stream", "temporal"};
+static const char *simd_names[] = {"none", "neon", "sse2", "ssse3", "avx2", "avx512"};
+
+#define MIN_ITERATIONS 5
+#define MAX_ITERATIONS 100000
+
+// image planes, with 64 bytes aligned strides for the aligned implementations, and strides and pointers
+// shifted by one byte for the unaligned ones, so that they do not run on aligned memory by chance
+typedef struct
+{
+	uint8_t *memory[3];
+	uint8_t *data[3];
+	uint32_t stride[3];
+	size_t size[3];      // bytes of image data (without padding) of each plane
+	uint32_t plane_count;
+} Image;
+
+static int image_create(Image *image, uint32_t plane_count, const uint32_t row_bytes[3], const uint32_t rows[3], int aligned)
+{
+	memset(image, 0, sizeof(Image));
+	image->plane_count = plane_count;
+	uint32_t i;
+	for(i=0; i<plane_count; ++i)
+	{
+		const uint32_t stride = (row_bytes[i]+63)/64*64 + (aligned ? 0 : 1);
+		void *ptr = NULL;
+		if(posix_memalign(&ptr, 64, (size_t)stride*rows[i]+64)!=0)
+			return 1;
+		image->memory[i] = ptr;
+		image->data[i] = image->memory[i] + (aligned ? 0 : 1);
+		image->stride[i] = stride;
+		image->size[i] = (size_t)row_bytes[i]*rows[i];
+		// valid yuv values, so that the simd implementations are not measured on saturated values only
+		size_t j;
+		uint32_t seed = 12345+i;
+		for(j=0; j<(size_t)stride*rows[i]+64-(aligned ? 0 : 1); ++j)
+		{
+			seed = seed*1103515245u+12345u;
+			image->data[i][j] = 16+(seed>>16)%220;
+		}
+	}
+	return 0;
+}
+
+static void image_destroy(Image *image)
+{
+	uint32_t i;
+	for(i=0; i<image->plane_count; ++i)
+		free(image->memory[i]);
+}
+
+static size_t image_size(const Image *image)
+{
+	return image->size[0]+image->size[1]+image->size[2];
+}
+
+// yuv420p, nv12, rgb24 or rgba image
+static int image_create_format(Image *image, int kind_yuv, int semi_planar, uint32_t pixel_size, uint32_t width, uint32_t height, int aligned)
+{
+	const uint32_t uv_width = (width+1)/2, uv_height = (height+1)/2;
+	if(kind_yuv)
+	{
+		const uint32_t row_bytes[3] = {width, semi_planar ? 2*uv_width : uv_width, uv_width};
+		const uint32_t rows[3] = {height, uv_height, uv_height};
+		return image_create(image, semi_planar ? 2 : 3, row_bytes, rows, aligned);
+	}
+	else
+	{
+		const uint32_t row_bytes[3] = {pixel_size*width, 0, 0};
+		const uint32_t rows[3] = {height, 0, 0};
+		return image_create(image, 1, row_bytes, rows, aligned);
+	}
+}
+
+static void convert(const Format *format, const Implementation *implementation, YUVRGBThreadPool *pool,
+	uint32_t width, uint32_t height, const Image *in, Image *out)
+{
+	const ConversionFunction fun = implementation->fun;
+	switch(format->kind)
+	{
+		case KIND_YUV2RGB:
+			if(pool)
+				yuv2rgb_mt(pool, fun.yuv2rgb, width, height, in->data[0], in->data[1], in->data[2], in->stride[0], in->stride[1],
+					out->data[0], out->stride[0], YCBCR_601);
+			else
+				fun.yuv2rgb(width, height, in->data[0], in->data[1], in->data[2], in->stride[0], in->stride[1],
+					out->data[0], out->stride[0], YCBCR_601);
+			break;
+		case KIND_YUVSP2RGB:
+			if(pool)
+				yuvsp2rgb_mt(pool, fun.yuvsp2rgb, width, height, in->data[0], in->data[1], in->stride[0], in->stride[1],
+					out->data[0], out->stride[0], YCBCR_601);
+			else
+				fun.yuvsp2rgb(width, height, in->data[0], in->data[1], in->stride[0], in->stride[1],
+					out->data[0], out->stride[0], YCBCR_601);
+			break;
+		case KIND_YUV2RGB32:
+			if(pool)
+				yuv2rgb32_mt(pool, fun.yuv2rgb32, width, height, in->data[0], in->data[1], in->data[2], in->stride[0], in->stride[1],
+					out->data[0], out->stride[0], YCBCR_601, 255);
+			else
+				fun.yuv2rgb32(width, height, in->data[0], in->data[1], in->data[2], in->stride[0], in->stride[1],
+					out->data[0], out->stride[0], YCBCR_601, 255);
+			break;
+		case KIND_RGB2YUV:
+			if(pool)
+				rgb2yuv_mt(pool, fun.rgb2yuv, width, height, in->data[0], in->stride[0],
+					out->data[0], out->data[1], out->data[2], out->stride[0], out->stride[1], YCBCR_601);
+			else
+				fun.rgb2yuv(width, height, in->data[0], in->stride[0],
+					out->data[0], out->data[1], out->data[2], out->stride[0], out->stride[1], YCBCR_601);
+			break;
+		case KIND_RGB2YUVSP:
+			if(pool)
+				rgb2yuvsp_mt(pool, fun.rgb2yuvsp, width, height, in->data[0], in->stride[0],
+					out->data[0], out->data[1], out->stride[0], out->stride[1], YCBCR_601);
+			else
+				fun.rgb2yuvsp(width, height, in->data[0], in->stride[0],
+					out->data[0], out->data[1], out->stride[0], out->stride[1], YCBCR_601);
+			break;
+	}
+}
+
+static uint64_t time_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec*1000000000u + ts.tv_nsec;
+}
+
+static uint64_t cycles(void)
+{
+#ifdef HAVE_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+	const uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+	return x<y ? -1 : (x>y ? 1 : 0);
+}
+
+// nearest rank percentile of sorted values
+static uint64_t percentile(const uint64_t *sorted, uint32_t count, uint32_t percent)
+{
+	uint32_t rank = (uint32_t)(((uint64_t)count*percent+99)/100);
+	if(rank<1)
+		rank = 1;
+	return sorted[rank-1];
+}
+
+typedef struct
+{
+	uint32_t iterations;
+	uint64_t median_ns, p99_ns;
+	uint64_t median_cycles;
+} Measure;
+
+// run the conversion until min_time_ns is elapsed (and at least MIN_ITERATIONS times), after a first
+// conversion that is not measured (page faults, cold caches, thread wake up)
+static void measure(const Format *format, const Implementation *implementation, YUVRGBThreadPool *pool,
+	uint32_t width, uint32_t height, const Image *in, Image *out, uint64_t min_time_ns,
+	uint64_t *times, uint64_t *cycle_counts, Measure *result)
+{
+	convert(format, implementation, pool, width, height, in, out);
+
+	uint32_t n = 0;
+	uint64_t total = 0;
+	while(n<MAX_ITERATIONS && (n<MIN_ITERATIONS || total<min_time_ns))
+	{
+		const uint64_t c0 = cycles(), t0 = time_ns();
+		convert(format, implementation, pool, width, height, in, out);
+		const uint64_t t1 = time_ns(), c1 = cycles();
+		times[n] = t1-t0;
+		cycle_counts[n] = c1-c0;
+		total += t1-t0;
+		++n;
+	}
+
+	qsort(times, n, sizeof(uint64_t), compare_u64);
+	qsort(cycle_counts, n, sizeof(uint64_t), compare_u64);
+	result->iterations = n;
+	result->median_ns = percentile(times, n, 50);
+	result->p99_ns = percentile(times, n, 99);
+	result->median_cycles = percentile(cycle_counts, n, 50);
+}
+
+// check if name is in the comma separated list (an empty list selects everything)
+static int selected(const char *list, const char *name)
+{
+	if(!list)
+		return 1;
+	const size_t length = strlen(name);
+	const char *p = list;
+	while(*p)
+	{
+		const char *end = strchr(p, ',');
+		const size_t item_length = end ? (size_t)(end-p) : strlen(p);
+		if(item_length==length && strncmp(p, name, length)==0)
+			return 1;
+		p += item_length;
+		if(*p==',')
+			++p;
+	}
+	return 0;
+}
+
+static void print_usage(const char *program)
+{
+	printf("Usage : %s [-r resolutions] [-f formats] [-i implementations] [-t threads] [-p policies] [-m min_time_ms] [-o results.json]\n", program);
+	printf("All lists are comma separated, and everything is run by default:\n");
+	printf("  resolutions: qvga,vga,720p,1080p,4k,8k\n");
+	printf("  formats: yuv420_rgb24,nv12_rgb24,yuv420_rgba32,rgb24_yuv420,rgb24_nv12\n");
+	printf("  implementations: std,lut,sse,sseu,ssse3,ssse3u,avx2,avx2u,avx512,avx512u,neon,auto,precise_std,precise (those not supported by the cpu are skipped)\n");
+	printf("  threads: thread counts (default 1 and the number of cpus)\n");
+	printf("  policies: auto,stream,temporal, only used for the aligned simd implementations (default all)\n");
+	printf("  min_time_ms: minimum measure time of each configuration (default 200)\n");
+	printf("The json output can be written to the standard output with -o -\n");
+}
+
+int main(int argc, char **argv)
+{
+	const char *resolution_list = NULL, *format_list = NULL, *implementation_list = NULL, *policy_list = NULL;
+	const char *output_filename = NULL;
+	uint32_t thread_counts[16];
+	uint32_t thread_count_count = 0;
+	uint64_t min_time_ns = 200000000u;
+
+	int option;
+	while((option = getopt(argc, argv, "r:f:i:t:p:m:o:h")) != -1)
+	{
+		switch(option)
+		{
+			case 'r': resolution_list = optarg; break;
+			case 'f': format_list = optarg; break;
+			case 'i': implementation_list = optarg; break;
+			case 'p': policy_list = optarg; break;
+			case 'm': min_time_ns = (uint64_t)(atof(optarg)*1000000.0); break;
+			case 'o': output_filename = optarg; break;
+			case 't':
+			{
+				const char *p = optarg;
+				while(*p && thread_count_count<16)
+				{
+					const long value = strtol(p, NULL, 10);
+					if(value<=0)
+					{
+						fprintf(stderr, "Invalid thread count list : %s\n", optarg);
+						return 1;
+					}
+					thread_counts[thread_count_count++] = (uint32_t)value;
+					const char *end = strchr(p, ',');
+					p = end ? end+1 : p+strlen(p);
+				}
+				break;
+			}
+			default:
+				print_usage(argv[0]);
+				return option=='h' ? 0 : 1;
+		}
+	}
+
+	const long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+	if(thread_count_count==0)
+	{
+		thread_counts[thread_count_count++] = 1;
+		if(cpu_count>1)
+			thread_counts[thread_count_count++] = (uint32_t)cpu_count;
+	}
+
+	const SIMDType simd = yuv_rgb_cpu_simd();
+#ifdef __OPTIMIZE__
+	const int optimized = 1;
+#else
+	const int optimized = 0;
+	fprintf(stderr, "Warning: built without optimization, use -DCMAKE_BUILD_TYPE=Release\n");
+#endif
+
+	FILE *json = NULL;
+	if(output_filename)
+	{
+		json = strcmp(output_filename, "-")==0 ? stdout : fopen(output_filename, "w");
+		if(!json)
+		{
+			perror("Error opening json output file");
+			return 1;
+		}
+	}
+	// when the json is written to the standard output, the table goes to the error output
+	FILE *table = json==stdout ? stderr : stdout;
+
+	char hostname[256] = "unknown";
+	gethostname(hostname, sizeof(hostname));
+	hostname[sizeof(hostname)-1] = 0;
+
+	if(json)
+	{
+		fprintf(json, "{\n  \"host\": {\"hostname\": \"%s\", \"cpus\": %ld, \"simd\": \"%s\", \"optimized\": %s, \"compiler\": \"%s\", \"cycles\": \"%s\"},\n",
+			hostname, cpu_count, simd_names[simd], optimized ? "true" : "false",
+#ifdef __VERSION__
+			__VERSION__,
+#else
+			"unknown",
+#endif
+#ifdef HAVE_TSC
+			"tsc"
+#else
+			"none"
+#endif
+			);
+		fprintf(json, "  \"min_time_ms\": %.1f,\n  \"results\": [", min_time_ns/1e6);
+	}
+
+	fprintf(table, "host %s, %ld cpus, simd %s\n", hostname, cpu_count, simd_names[simd]);
+	fprintf(table, "%-14s %-11s %-6s %-11s %-8s %-8s %6s %12s %12s %8s %8s\n", "format", "impl", "res", "size", "threads", "policy",
+		"iters", "median_ns", "p99_ns", "GB/s", "cyc/px");
+
+	uint64_t *times = malloc(MAX_ITERATIONS*sizeof(uint64_t));
+	uint64_t *cycle_counts = malloc(MAX_ITERATIONS*sizeof(uint64_t));
+	YUVRGBThreadPool *pools[16] = {NULL};
+	int first_result = 1, status = 0;
+
+	uint32_t r, f, t, p;
+	for(r=0; r<RESOLUTION_COUNT && status==0; ++r)
+	{
+		const Resolution *resolution = &resolutions[r];
+		if(!selected(resolution_list, resolution->name))
+			continue;
+		const uint32_t width = resolution->width, height = resolution->height;
+
+		for(f=0; f<FORMAT_COUNT && status==0; ++f)
+		{
+			const Format *format = &formats[f];
+			if(!selected(format_list, format->name))
+				continue;
+			const int yuv_input = format->kind==KIND_YUV2RGB || format->kind==KIND_YUVSP2RGB || format->kind==KIND_YUV2RGB32;
+			const int semi_planar = format->kind==KIND_YUVSP2RGB || format->kind==KIND_RGB2YUVSP;
+			const uint32_t rgb_size = format->kind==KIND_YUV2RGB32 ? 4 : 3;
+
+			const Implementation *implementation;
+			for(implementation=format->implementations; implementation->name && status==0; ++implementation)
+			{
+				if(!selected(implementation_list, implementation->name) || implementation->simd>simd)
+					continue;
+
+				Image in, out;
+				if(image_create_format(&in, yuv_input, semi_planar, rgb_size, width, height, implementation->aligned) ||
+					image_create_format(&out, !yuv_input, semi_planar, rgb_size, width, height, implementation->aligned))
+				{
+					fprintf(stderr, "Error allocating images\n");
+					status = 1;
+					break;
+				}
+				const double bytes = (double)(image_size(&in)+image_size(&out));
+
+				for(t=0; t<thread_count_count; ++t)
+				{
+					YUVRGBThreadPool *pool = NULL;
+					if(thread_counts[t]>1)
+					{
+						if(!pools[t])
+							pools[t] = yuv_rgb_pool_create(thread_counts[t]);
+						pool = pools[t];
+						if(!pool)
+						{
+							fprintf(stderr, "Error creating thread pool\n");
+							status = 1;
+							break;
+						}
+					}
+
+					// the store policy only changes the aligned simd implementations
+					const uint32_t policy_count = (implementation->aligned && implementation->simd!=SIMD_NONE) ? 3 : 1;
+					for(p=0; p<policy_count; ++p)
+					{
+						if(policy_count>1 && !selected(policy_list, policy_names[p]))
+							continue;
+						yuv_rgb_set_store_policy((StorePolicy)p);
+						yuv_rgb_set_precision(implementation->precise ? PRECISION_HIGH : PRECISION_FAST);
+
+						Measure m;
+						measure(format, implementation, pool, width, height, &in, &out, min_time_ns, times, cycle_counts, &m);
+
+						const double gbps = bytes/m.median_ns;
+						const double cycles_per_pixel = (double)m.median_cycles/((double)width*height);
+						const char *policy = policy_count>1 ? policy_names[p] : "-";
+
+						fprintf(table, "%-14s %-11s %-6s %5ux%-5u %-8u %-8s %6u %12llu %12llu %8.2f ",
+							format->name, implementation->name, resolution->name, width, height, thread_counts[t], policy,
+							m.iterations, (unsigned long long)m.median_ns, (unsigned long long)m.p99_ns, gbps);
+#ifdef HAVE_TSC
+						fprintf(table, "%8.3f\n", cycles_per_pixel);
+#else
+						fprintf(table, "%8s\n", "-");
+#endif
+						fflush(table);
+
+						if(json)
+						{
+							fprintf(json, "%s\n    {\"format\": \"%s\", \"implementation\": \"%s\", \"aligned\": %s, \"resolution\": \"%s\", "
+								"\"width\": %u, \"height\": %u, \"threads\": %u, \"store_policy\": \"%s\", \"iterations\": %u, "
+								"\"median_ns\": %llu, \"p99_ns\": %llu, \"gbps\": %.3f, ",
+								first_result ? "" : ",", format->name, implementation->name, implementation->aligned ? "true" : "false",
+								resolution->name, width, height, thread_counts[t], policy_count>1 ? policy_names[p] : "none", m.iterations,
+								(unsigned long long)m.median_ns, (unsigned long long)m.p99_ns, gbps);
+#ifdef HAVE_TSC
+							fprintf(json, "\"cycles_per_pixel\": %.4f}", cycles_per_pixel);
+#else
+							fprintf(json, "\"cycles_per_pixel\": null}");
+#endif
+							first_result = 0;
+						}
+					}
+				}
+
+				image_destroy(&in);
+				image_destroy(&out);
+			}
+		}
+	}
+
+	yuv_rgb_set_store_policy(STORE_AUTO);
+	yuv_rgb_set_precision(PRECISION_FAST);
+	for(t=0; t<thread_count_count; ++t)
+		yuv_rgb_pool_destroy(pools[t]);
+	free(times);
+	free(cycle_counts);
+
+	if(json)
+	{
+		fprintf(json, "\n  ]\n}\n");
+		if(json!=stdout)
+			fclose(json);
+	}
+	return status;
+}
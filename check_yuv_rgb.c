@@ -0,0 +1,1481 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+// Correctness and accuracy test of the conversion functions
+// Each conversion is run on random images (random sizes, strides, alignments, color spaces and store
+// policies), with every implementation supported by the cpu, and:
+// - the output of each implementation must be identical to the output of the std implementation,
+// - the bytes around the output image (padding of the rows, before and after the planes) must not be written,
+// - the output of the std implementation is compared with a double precision computation, the maximum
+//   error and the PSNR are reported, and the maximum error must not exceed the bound of the conversion.
+// It returns 0 if all checks pass.
+
+// posix_memalign
+#define _POSIX_C_SOURCE 200112L
+
+#include "yuv_rgb.h"
+
+#include <math.h>
+#include <poll.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// any function pointer, converted back to the signature of its conversion before the call
+typedef void (*GenericFunction)(void);
+
+// memory layouts of the images
+typedef enum
+{
+	LAYOUT_YUV420P,
+	LAYOUT_NV12,        // also nv21, the chroma order is given separately
+	LAYOUT_YUV444P,
+	LAYOUT_PACKED422,   // yuyv or uyvy
+	LAYOUT_YUV420P10,   // 10 bits values in 16 bits words
+	LAYOUT_P016,        // semi planar, 16 bits values
+	LAYOUT_RGB24,
+	LAYOUT_RGB32,
+	LAYOUT_RGB48,
+	LAYOUT_RGBP,
+	LAYOUT_RGBP_FLOAT,
+	LAYOUT_RGBP_HALF
+} Layout;
+
+// double precision reference computation
+typedef enum
+{
+	REFERENCE_NONE,
+	REFERENCE_YUV2RGB,
+	REFERENCE_RGB2YUV
+} Reference;
+
+typedef struct
+{
+	const char *name;
+	GenericFunction fun;
+	SIMDType simd;   // instruction set required by the implementation
+	int aligned;     // requires 64 bytes aligned pointers and strides
+} Implementation;
+
+#define MAX_IMPLEMENTATIONS 16
+
+typedef struct Conversion Conversion;
+
+typedef struct
+{
+	uint8_t *memory;
+	size_t memory_size;
+	uint8_t *data;
+	uint32_t stride;
+	uint32_t row_bytes;
+	uint32_t rows;
+} Plane;
+
+typedef struct
+{
+	Plane planes[3];
+	uint32_t plane_count;
+} Image;
+
+// parameters of one conversion call
+typedef struct
+{
+	uint32_t width, height;          // input size
+	uint32_t out_width, out_height;  // output size, only different for the resize conversion
+	YCbCrType yuv_type;
+	const YCbCrContext *context;
+	uint8_t alpha;
+	float scale[3], bias[3];
+} Run;
+
+typedef void (*Runner)(const Conversion *conversion, GenericFunction fun, const Run *run, const Image *in, Image *out);
+
+struct Conversion
+{
+	const char *name;
+	Layout in_layout, out_layout;
+	const char *in_order, *out_order;  // channel order of packed and semi planar layouts
+	Runner runner;
+	int option;                        // upsampling, downsampling or resize mode, or orientation
+	Reference reference;
+	double max_error;                  // maximum error with the reference, in 8 bits units
+	Implementation implementations[MAX_IMPLEMENTATIONS];  // terminated by a NULL name, the first one is std
+};
+
+// random numbers, xorshift64*
+static uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+static uint32_t random_u32(void)
+{
+	random_state ^= random_state >> 12;
+	random_state ^= random_state << 25;
+	random_state ^= random_state >> 27;
+	return (uint32_t)((random_state*0x2545F4914F6CDD1DULL) >> 32);
+}
+
+static uint32_t random_range(uint32_t min, uint32_t max)
+{
+	return min + random_u32()%(max-min+1);
+}
+
+// Runners, calling the function with the planes of the images
+
+static void run_yuv2rgb(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((YUV2RGBFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[1].data, in->planes[2].data,
+		in->planes[0].stride, in->planes[1].stride, out->planes[0].data, out->planes[0].stride, r->yuv_type);
+}
+
+static void run_yuvsp2rgb(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((YUVSP2RGBFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[1].data,
+		in->planes[0].stride, in->planes[1].stride, out->planes[0].data, out->planes[0].stride, r->yuv_type);
+}
+
+static void run_yuv2rgb32(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((YUV2RGB32Function)fun)(r->width, r->height, in->planes[0].data, in->planes[1].data, in->planes[2].data,
+		in->planes[0].stride, in->planes[1].stride, out->planes[0].data, out->planes[0].stride, r->yuv_type, r->alpha);
+}
+
+static void run_yuvsp2rgb32(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((YUVSP2RGB32Function)fun)(r->width, r->height, in->planes[0].data, in->planes[1].data,
+		in->planes[0].stride, in->planes[1].stride, out->planes[0].data, out->planes[0].stride, r->yuv_type, r->alpha);
+}
+
+static void run_rgb2yuv(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((RGB2YUVFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[0].stride,
+		out->planes[0].data, out->planes[1].data, out->planes[2].data, out->planes[0].stride, out->planes[1].stride, r->yuv_type);
+}
+
+static void run_rgb2yuvsp(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((RGB2YUVSPFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[0].stride,
+		out->planes[0].data, out->planes[1].data, out->planes[0].stride, out->planes[1].stride, r->yuv_type);
+}
+
+// The rotated conversions, the rgb output being rotated back in the input orientation, so that it can be 
+// compared with the reference
+static void rotate_back(const Run *r, Orientation orientation, const uint8_t *rotated, uint8_t *rgb, uint32_t rgb_stride)
+{
+	const uint32_t w = r->width, h = r->height;
+	const uint32_t rotated_width = (orientation==ORIENTATION_ROTATE_90 || orientation==ORIENTATION_ROTATE_270) ? h : w;
+	uint32_t x, y;
+	for(y=0; y<h; ++y)
+		for(x=0; x<w; ++x)
+		{
+			uint32_t rx = x, ry = y;
+			switch(orientation)
+			{
+				case ORIENTATION_ROTATE_90: rx = h-1-y; ry = x; break;
+				case ORIENTATION_ROTATE_180: rx = w-1-x; ry = h-1-y; break;
+				case ORIENTATION_ROTATE_270: rx = y; ry = w-1-x; break;
+				case ORIENTATION_MIRROR: rx = w-1-x; break;
+				case ORIENTATION_FLIP: ry = h-1-y; break;
+				default: break;
+			}
+			memcpy(rgb+y*rgb_stride+3*x, rotated+3*((size_t)ry*rotated_width+rx), 3);
+		}
+}
+
+static void run_yuv2rgb_rotate(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	uint8_t *rotated = malloc(3*(size_t)r->width*r->height+1);
+	if(!rotated)
+		return;
+	const uint32_t rotated_stride = 3*((c->option==ORIENTATION_ROTATE_90 || c->option==ORIENTATION_ROTATE_270) ? 
+		r->height : r->width);
+	yuv2rgb_rotate((YUV2RGBFunction)fun, r->width, r->height, in->planes[0].data, in->planes[1].data, in->planes[2].data,
+		in->planes[0].stride, in->planes[1].stride, rotated, rotated_stride, r->yuv_type, (Orientation)c->option);
+	rotate_back(r, (Orientation)c->option, rotated, out->planes[0].data, out->planes[0].stride);
+	free(rotated);
+}
+
+static void run_yuvsp2rgb_rotate(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	uint8_t *rotated = malloc(3*(size_t)r->width*r->height+1);
+	if(!rotated)
+		return;
+	const uint32_t rotated_stride = 3*((c->option==ORIENTATION_ROTATE_90 || c->option==ORIENTATION_ROTATE_270) ? 
+		r->height : r->width);
+	yuvsp2rgb_rotate((YUVSP2RGBFunction)fun, r->width, r->height, in->planes[0].data, in->planes[1].data,
+		in->planes[0].stride, in->planes[1].stride, rotated, rotated_stride, r->yuv_type, (Orientation)c->option);
+	rotate_back(r, (Orientation)c->option, rotated, out->planes[0].data, out->planes[0].stride);
+	free(rotated);
+}
+
+typedef void (*UpsamplingFunction)(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type, ChromaUpsampling upsampling);
+
+static void run_upsampling(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	((UpsamplingFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[1].data, in->planes[2].data,
+		in->planes[0].stride, in->planes[1].stride, out->planes[0].data, out->planes[0].stride, r->yuv_type,
+		(ChromaUpsampling)c->option);
+}
+
+typedef void (*DownsamplingFunction)(uint32_t width, uint32_t height, const uint8_t *rgb, uint32_t rgb_stride,
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	YCbCrType yuv_type, ChromaDownsampling downsampling);
+
+static void run_downsampling(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	((DownsamplingFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[0].stride,
+		out->planes[0].data, out->planes[1].data, out->planes[2].data, out->planes[0].stride, out->planes[1].stride,
+		r->yuv_type, (ChromaDownsampling)c->option);
+}
+
+typedef void (*ResizeFunction)(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_width, uint32_t rgb_height, uint32_t rgb_stride, YCbCrType yuv_type);
+
+static void run_resize(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((ResizeFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[1].data, in->planes[2].data,
+		in->planes[0].stride, in->planes[1].stride, out->planes[0].data, r->out_width, r->out_height,
+		out->planes[0].stride, r->yuv_type);
+}
+
+typedef void (*PackedFunction)(uint32_t width, uint32_t height, const uint8_t *yuv, uint32_t yuv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type);
+
+static void run_packed(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((PackedFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[0].stride,
+		out->planes[0].data, out->planes[0].stride, r->yuv_type);
+}
+
+typedef void (*RGBPFunction)(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *r, uint8_t *g, uint8_t *b, uint32_t rgb_stride, YCbCrType yuv_type);
+
+static void run_rgbp(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((RGBPFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[1].data, in->planes[2].data,
+		in->planes[0].stride, in->planes[1].stride, out->planes[0].data, out->planes[1].data, out->planes[2].data,
+		out->planes[0].stride, r->yuv_type);
+}
+
+typedef void (*RGBPFloatFunction)(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	float *r, float *g, float *b, uint32_t rgb_stride, YCbCrType yuv_type, const float scale[3], const float bias[3]);
+
+static void run_rgbp_float(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((RGBPFloatFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[1].data, in->planes[2].data,
+		in->planes[0].stride, in->planes[1].stride, (float*)out->planes[0].data, (float*)out->planes[1].data,
+		(float*)out->planes[2].data, out->planes[0].stride, r->yuv_type, r->scale, r->bias);
+}
+
+typedef void (*RGBPHalfFunction)(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint16_t *r, uint16_t *g, uint16_t *b, uint32_t rgb_stride, YCbCrType yuv_type, const float scale[3], const float bias[3]);
+
+static void run_rgbp_half(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((RGBPHalfFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[1].data, in->planes[2].data,
+		in->planes[0].stride, in->planes[1].stride, (uint16_t*)out->planes[0].data, (uint16_t*)out->planes[1].data,
+		(uint16_t*)out->planes[2].data, out->planes[0].stride, r->yuv_type, r->scale, r->bias);
+}
+
+typedef void (*P10RGB24Function)(uint32_t width, uint32_t height,
+	const uint16_t *y, const uint16_t *u, const uint16_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type);
+typedef void (*P10RGB48Function)(uint32_t width, uint32_t height,
+	const uint16_t *y, const uint16_t *u, const uint16_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint16_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type);
+typedef void (*P010RGB24Function)(uint32_t width, uint32_t height,
+	const uint16_t *y, const uint16_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type);
+typedef void (*P010RGB48Function)(uint32_t width, uint32_t height,
+	const uint16_t *y, const uint16_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint16_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type);
+
+static void run_p10(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	const uint16_t *y = (const uint16_t*)in->planes[0].data, *u = (const uint16_t*)in->planes[1].data,
+		*v = (const uint16_t*)in->planes[2].data;
+	if(c->out_layout==LAYOUT_RGB48)
+		((P10RGB48Function)fun)(r->width, r->height, y, u, v, in->planes[0].stride, in->planes[1].stride,
+			(uint16_t*)out->planes[0].data, out->planes[0].stride, r->yuv_type);
+	else
+		((P10RGB24Function)fun)(r->width, r->height, y, u, v, in->planes[0].stride, in->planes[1].stride,
+			out->planes[0].data, out->planes[0].stride, r->yuv_type);
+}
+
+static void run_p010(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	const uint16_t *y = (const uint16_t*)in->planes[0].data, *uv = (const uint16_t*)in->planes[1].data;
+	if(c->out_layout==LAYOUT_RGB48)
+		((P010RGB48Function)fun)(r->width, r->height, y, uv, in->planes[0].stride, in->planes[1].stride,
+			(uint16_t*)out->planes[0].data, out->planes[0].stride, r->yuv_type);
+	else
+		((P010RGB24Function)fun)(r->width, r->height, y, uv, in->planes[0].stride, in->planes[1].stride,
+			out->planes[0].data, out->planes[0].stride, r->yuv_type);
+}
+
+typedef void (*YUV2RGBContextFunction)(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, const YCbCrContext *context);
+typedef void (*RGB2YUVContextFunction)(uint32_t width, uint32_t height, const uint8_t *rgb, uint32_t rgb_stride,
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, const YCbCrContext *context);
+
+static void run_yuv2rgb_context(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((YUV2RGBContextFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[1].data, in->planes[2].data,
+		in->planes[0].stride, in->planes[1].stride, out->planes[0].data, out->planes[0].stride, r->context);
+}
+
+static void run_rgb2yuv_context(const Conversion *c, GenericFunction fun, const Run *r, const Image *in, Image *out)
+{
+	(void)c;
+	((RGB2YUVContextFunction)fun)(r->width, r->height, in->planes[0].data, in->planes[0].stride,
+		out->planes[0].data, out->planes[1].data, out->planes[2].data, out->planes[0].stride, out->planes[1].stride,
+		r->context);
+}
+
+// The multithreaded and strip conversions, with the signature of the conversion functions, so that they are
+// checked as other implementations of the main conversions
+
+static YUVRGBThreadPool *thread_pool = NULL;
+#define STRIP_ROWS 4
+
+static void yuv420_rgb24_mt(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	yuv2rgb_mt(thread_pool, yuv420_rgb24, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+}
+
+static void yuv420_rgb24_strips(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	yuv2rgb_strips(yuv420_rgb24, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type, STRIP_ROWS, NULL, NULL);
+}
+
+static void nv12_rgb24_mt(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	yuvsp2rgb_mt(thread_pool, nv12_rgb24, width, height, y, uv, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+}
+
+static void nv12_rgb24_strips(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	yuvsp2rgb_strips(nv12_rgb24, width, height, y, uv, y_stride, uv_stride, rgb, rgb_stride, yuv_type, STRIP_ROWS, NULL, NULL);
+}
+
+// the region of interest conversions, with the image split in four regions at an odd column and row
+#define ROI_REGIONS(RGB, RGB_STRIDE) \
+	const uint32_t split_x = (width/3)|1, split_y = (height/3)|1; \
+	const uint32_t x1 = split_x<width ? split_x : width, y1 = split_y<height ? split_y : height; \
+	const YUVRGBRegion regions[4] = { \
+		{0, 0, x1, y1, RGB, RGB_STRIDE}, \
+		{x1, 0, width-x1, y1, RGB+3*x1, RGB_STRIDE}, \
+		{0, y1, x1, height-y1, RGB+y1*RGB_STRIDE, RGB_STRIDE}, \
+		{x1, y1, width-x1, height-y1, RGB+y1*RGB_STRIDE+3*x1, RGB_STRIDE}};
+
+static void yuv420_rgb24_roi(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	ROI_REGIONS(rgb, rgb_stride)
+	yuv2rgb_roi(yuv420_rgb24, y, u, v, y_stride, uv_stride, regions, 4, yuv_type);
+}
+
+static void nv12_rgb24_roi(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	ROI_REGIONS(rgb, rgb_stride)
+	yuvsp2rgb_roi(nv12_rgb24, y, uv, y_stride, uv_stride, regions, 4, yuv_type);
+}
+
+static void yuv420_rgba32_mt(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride, YCbCrType yuv_type, uint8_t alpha)
+{
+	yuv2rgb32_mt(thread_pool, yuv420_rgba32, width, height, y, u, v, y_stride, uv_stride, rgba, rgba_stride, yuv_type, alpha);
+}
+
+static void nv12_rgba32_strips(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride, YCbCrType yuv_type, uint8_t alpha)
+{
+	yuvsp2rgb32_strips(nv12_rgba32, width, height, y, uv, y_stride, uv_stride, rgba, rgba_stride, yuv_type, alpha,
+		STRIP_ROWS, NULL, NULL);
+}
+
+static void rgb24_yuv420_mt(uint32_t width, uint32_t height, const uint8_t *rgb, uint32_t rgb_stride,
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, YCbCrType yuv_type)
+{
+	rgb2yuv_mt(thread_pool, rgb24_yuv420, width, height, rgb, rgb_stride, y, u, v, y_stride, uv_stride, yuv_type);
+}
+
+static void rgb24_yuv420_strips(uint32_t width, uint32_t height, const uint8_t *rgb, uint32_t rgb_stride,
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, YCbCrType yuv_type)
+{
+	rgb2yuv_strips(rgb24_yuv420, width, height, rgb, rgb_stride, y, u, v, y_stride, uv_stride, yuv_type, STRIP_ROWS, NULL, NULL);
+}
+
+static void rgb24_nv12_mt(uint32_t width, uint32_t height, const uint8_t *rgb, uint32_t rgb_stride,
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, YCbCrType yuv_type)
+{
+	rgb2yuvsp_mt(thread_pool, rgb24_nv12, width, height, rgb, rgb_stride, y, uv, y_stride, uv_stride, yuv_type);
+}
+
+// The job queue, with a completion read from its fd for the yuv to rgb conversion, and with a callback for 
+// the rgb to yuv one
+
+static YUVRGBJobQueue *job_queue = NULL;
+
+static void yuv420_rgb24_queue(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	YUVRGBJob job = {JOB_YUV2RGB, {.yuv2rgb = yuv420_rgb24}, width, height, {y, u, v}, {y_stride, uv_stride},
+		{rgb, NULL, NULL}, {rgb_stride, 0}, yuv_type, 0, NULL, rgb};
+	yuv_rgb_queue_submit(job_queue, &job);
+
+	struct pollfd fd = {yuv_rgb_queue_fd(job_queue), POLLIN, 0};
+	void *completed = NULL;
+	if(poll(&fd, 1, 10000)!=1 || yuv_rgb_queue_completed(job_queue, &completed, 1)!=1 || completed!=rgb)
+	{
+		fprintf(stderr, "Error waiting for the job queue\n");
+		exit(1);
+	}
+}
+
+static void count_completion(void *user_data)
+{
+	++*(uint32_t*)user_data;
+}
+
+static void rgb24_yuv420_queue(uint32_t width, uint32_t height, const uint8_t *rgb, uint32_t rgb_stride,
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, YCbCrType yuv_type)
+{
+	uint32_t completions = 0;
+	YUVRGBJob job = {JOB_RGB2YUV, {.rgb2yuv = rgb24_yuv420}, width, height, {rgb, NULL, NULL}, {rgb_stride, 0},
+		{y, u, v}, {y_stride, uv_stride}, yuv_type, 0, count_completion, &completions};
+	yuv_rgb_queue_submit(job_queue, &job);
+	yuv_rgb_queue_wait(job_queue);
+	if(completions!=1)
+	{
+		fprintf(stderr, "Error waiting for the job queue\n");
+		exit(1);
+	}
+}
+
+// The dispatching functions with PRECISION_HIGH, checked as implementations of the high precision conversions
+
+static void yuv420_rgb24_high(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	yuv_rgb_set_precision(PRECISION_HIGH);
+	yuv420_rgb24(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+	yuv_rgb_set_precision(PRECISION_FAST);
+}
+
+static void nv12_rgb24_high(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	yuv_rgb_set_precision(PRECISION_HIGH);
+	nv12_rgb24(width, height, y, uv, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+	yuv_rgb_set_precision(PRECISION_FAST);
+}
+
+static void nv21_rgb24_high(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	yuv_rgb_set_precision(PRECISION_HIGH);
+	nv21_rgb24(width, height, y, uv, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+	yuv_rgb_set_precision(PRECISION_FAST);
+}
+
+static void yuv420_rgb24_high_mt(uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride, YCbCrType yuv_type)
+{
+	yuv_rgb_set_precision(PRECISION_HIGH);
+	yuv2rgb_mt(thread_pool, yuv420_rgb24, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+	yuv_rgb_set_precision(PRECISION_FAST);
+}
+
+static void rgb24_yuv420_high(uint32_t width, uint32_t height, const uint8_t *rgb, uint32_t rgb_stride,
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, YCbCrType yuv_type)
+{
+	yuv_rgb_set_precision(PRECISION_HIGH);
+	rgb24_yuv420(width, height, rgb, rgb_stride, y, u, v, y_stride, uv_stride, yuv_type);
+	yuv_rgb_set_precision(PRECISION_FAST);
+}
+
+static void rgb24_nv12_high(uint32_t width, uint32_t height, const uint8_t *rgb, uint32_t rgb_stride,
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, YCbCrType yuv_type)
+{
+	yuv_rgb_set_precision(PRECISION_HIGH);
+	rgb24_nv12(width, height, rgb, rgb_stride, y, uv, y_stride, uv_stride, yuv_type);
+	yuv_rgb_set_precision(PRECISION_FAST);
+}
+
+static void rgb24_nv21_high(uint32_t width, uint32_t height, const uint8_t *rgb, uint32_t rgb_stride,
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, YCbCrType yuv_type)
+{
+	yuv_rgb_set_precision(PRECISION_HIGH);
+	rgb24_nv21(width, height, rgb, rgb_stride, y, uv, y_stride, uv_stride, yuv_type);
+	yuv_rgb_set_precision(PRECISION_FAST);
+}
+
+// Conversion table
+
+#define F(FUN) ((GenericFunction)(FUN))
+#define STD(FUN) {"std", F(FUN), SIMD_NONE, 0}
+#define AUTO(FUN) {"auto", F(FUN), SIMD_NONE, 0}
+#define LUT(FUN) {"lut", F(FUN), SIMD_NONE, 0}
+#define END {NULL, NULL, SIMD_NONE, 0}
+// the sse functions also exist on arm builds with neon, where they forward to the neon ones
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define SSE(FUN) {"sse", F(FUN), SIMD_SSE2, 1},
+#define SSEU(FUN) {"sseu", F(FUN), SIMD_SSE2, 0},
+#else
+#define SSE(FUN)
+#define SSEU(FUN)
+#endif
+#ifdef __SSE2__
+#define SSSE3(FUN) {"ssse3", F(FUN), SIMD_SSSE3, 1}, {"ssse3u", F(FUN##u), SIMD_SSSE3, 0},
+#define AVX2(FUN) {"avx2", F(FUN), SIMD_AVX2, 1}, {"avx2u", F(FUN##u), SIMD_AVX2, 0},
+#define AVX512(FUN) {"avx512", F(FUN), SIMD_AVX512, 1}, {"avx512u", F(FUN##u), SIMD_AVX512, 0},
+#else
+#define SSSE3(FUN)
+#define AVX2(FUN)
+#define AVX512(FUN)
+#endif
+#ifdef __ARM_NEON
+#define NEON(FUN) {"neon", F(FUN), SIMD_NEON, 0},
+#else
+#define NEON(FUN)
+#endif
+#define MT(FUN) {"mt", F(FUN), SIMD_NONE, 0}
+#define STRIPS(FUN) {"strips", F(FUN), SIMD_NONE, 0}
+#define ROI(FUN) {"roi", F(FUN), SIMD_NONE, 0}
+#define QUEUE(FUN) {"queue", F(FUN), SIMD_NONE, 0}
+#define HIGH(FUN) {"high", F(FUN), SIMD_NONE, 0}
+#define HIGH_MT(FUN) {"high_mt", F(FUN), SIMD_NONE, 0}
+
+// maximum errors of the 8 bits fixed point conversions, measured on all the color spaces
+#define YUV2RGB_MAX_ERROR 4.0
+#define RGB2YUV_MAX_ERROR 2.0
+// and of the high precision conversions
+#define PRECISE_MAX_ERROR 1.0
+
+static const Conversion conversions[] = {
+	{"yuv420_rgb24", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_yuv2rgb, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuv420_rgb24_std), LUT(yuv420_rgb24_lut), SSE(yuv420_rgb24_sse) SSEU(yuv420_rgb24_sseu) SSSE3(yuv420_rgb24_ssse3) AVX2(yuv420_rgb24_avx2) AVX512(yuv420_rgb24_avx512)
+		NEON(yuv420_rgb24_neon) AUTO(yuv420_rgb24), MT(yuv420_rgb24_mt), STRIPS(yuv420_rgb24_strips), ROI(yuv420_rgb24_roi), QUEUE(yuv420_rgb24_queue), END}},
+	{"nv12_rgb24", LAYOUT_NV12, LAYOUT_RGB24, "uv", "rgb", run_yuvsp2rgb, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(nv12_rgb24_std), LUT(nv12_rgb24_lut), SSE(nv12_rgb24_sse) SSEU(nv12_rgb24_sseu) SSSE3(nv12_rgb24_ssse3) AVX2(nv12_rgb24_avx2) AVX512(nv12_rgb24_avx512)
+		NEON(nv12_rgb24_neon) AUTO(nv12_rgb24), MT(nv12_rgb24_mt), STRIPS(nv12_rgb24_strips), ROI(nv12_rgb24_roi), END}},
+	{"nv21_rgb24", LAYOUT_NV12, LAYOUT_RGB24, "vu", "rgb", run_yuvsp2rgb, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(nv21_rgb24_std), LUT(nv21_rgb24_lut), SSE(nv21_rgb24_sse) SSEU(nv21_rgb24_sseu) SSSE3(nv21_rgb24_ssse3) AVX2(nv21_rgb24_avx2) AVX512(nv21_rgb24_avx512)
+		NEON(nv21_rgb24_neon) AUTO(nv21_rgb24), END}},
+	{"yuv420_rgb24_rotate_90", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_yuv2rgb_rotate, ORIENTATION_ROTATE_90, REFERENCE_YUV2RGB,
+		YUV2RGB_MAX_ERROR, {STD(yuv420_rgb24_std), SSEU(yuv420_rgb24_sseu) AUTO(yuv420_rgb24), END}},
+	{"yuv420_rgb24_rotate_180", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_yuv2rgb_rotate, ORIENTATION_ROTATE_180, REFERENCE_YUV2RGB,
+		YUV2RGB_MAX_ERROR, {STD(yuv420_rgb24_std), SSEU(yuv420_rgb24_sseu) AUTO(yuv420_rgb24), END}},
+	{"yuv420_rgb24_rotate_270", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_yuv2rgb_rotate, ORIENTATION_ROTATE_270, REFERENCE_YUV2RGB,
+		YUV2RGB_MAX_ERROR, {STD(yuv420_rgb24_std), SSEU(yuv420_rgb24_sseu) AUTO(yuv420_rgb24), END}},
+	{"yuv420_rgb24_mirror", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_yuv2rgb_rotate, ORIENTATION_MIRROR, REFERENCE_YUV2RGB,
+		YUV2RGB_MAX_ERROR, {STD(yuv420_rgb24_std), SSEU(yuv420_rgb24_sseu) AUTO(yuv420_rgb24), END}},
+	{"yuv420_rgb24_flip", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_yuv2rgb_rotate, ORIENTATION_FLIP, REFERENCE_YUV2RGB,
+		YUV2RGB_MAX_ERROR, {STD(yuv420_rgb24_std), SSEU(yuv420_rgb24_sseu) AUTO(yuv420_rgb24), END}},
+	{"nv12_rgb24_rotate_90", LAYOUT_NV12, LAYOUT_RGB24, "uv", "rgb", run_yuvsp2rgb_rotate, ORIENTATION_ROTATE_90, REFERENCE_YUV2RGB,
+		YUV2RGB_MAX_ERROR, {STD(nv12_rgb24_std), SSEU(nv12_rgb24_sseu) AUTO(nv12_rgb24), END}},
+	{"nv12_rgb24_rotate_180", LAYOUT_NV12, LAYOUT_RGB24, "uv", "rgb", run_yuvsp2rgb_rotate, ORIENTATION_ROTATE_180, REFERENCE_YUV2RGB,
+		YUV2RGB_MAX_ERROR, {STD(nv12_rgb24_std), SSEU(nv12_rgb24_sseu) AUTO(nv12_rgb24), END}},
+	{"nv12_rgb24_rotate_270", LAYOUT_NV12, LAYOUT_RGB24, "uv", "rgb", run_yuvsp2rgb_rotate, ORIENTATION_ROTATE_270, REFERENCE_YUV2RGB,
+		YUV2RGB_MAX_ERROR, {STD(nv12_rgb24_std), SSEU(nv12_rgb24_sseu) AUTO(nv12_rgb24), END}},
+	{"nv12_rgb24_mirror", LAYOUT_NV12, LAYOUT_RGB24, "uv", "rgb", run_yuvsp2rgb_rotate, ORIENTATION_MIRROR, REFERENCE_YUV2RGB,
+		YUV2RGB_MAX_ERROR, {STD(nv12_rgb24_std), SSEU(nv12_rgb24_sseu) AUTO(nv12_rgb24), END}},
+	{"nv12_rgb24_flip", LAYOUT_NV12, LAYOUT_RGB24, "uv", "rgb", run_yuvsp2rgb_rotate, ORIENTATION_FLIP, REFERENCE_YUV2RGB,
+		YUV2RGB_MAX_ERROR, {STD(nv12_rgb24_std), SSEU(nv12_rgb24_sseu) AUTO(nv12_rgb24), END}},
+	{"yuv420_rgb24_precise", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_yuv2rgb, 0, REFERENCE_YUV2RGB, PRECISE_MAX_ERROR,
+		{STD(yuv420_rgb24_precise_std), HIGH(yuv420_rgb24_high), HIGH_MT(yuv420_rgb24_high_mt), END}},
+	{"nv12_rgb24_precise", LAYOUT_NV12, LAYOUT_RGB24, "uv", "rgb", run_yuvsp2rgb, 0, REFERENCE_YUV2RGB, PRECISE_MAX_ERROR,
+		{STD(nv12_rgb24_precise_std), HIGH(nv12_rgb24_high), END}},
+	{"nv21_rgb24_precise", LAYOUT_NV12, LAYOUT_RGB24, "vu", "rgb", run_yuvsp2rgb, 0, REFERENCE_YUV2RGB, PRECISE_MAX_ERROR,
+		{STD(nv21_rgb24_precise_std), HIGH(nv21_rgb24_high), END}},
+	{"yuv420_rgba32", LAYOUT_YUV420P, LAYOUT_RGB32, "yuv", "rgba", run_yuv2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuv420_rgba32_std), AUTO(yuv420_rgba32), MT(yuv420_rgba32_mt), END}},
+	{"yuv420_bgra32", LAYOUT_YUV420P, LAYOUT_RGB32, "yuv", "bgra", run_yuv2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuv420_bgra32_std), AUTO(yuv420_bgra32), END}},
+	{"yuv420_argb32", LAYOUT_YUV420P, LAYOUT_RGB32, "yuv", "argb", run_yuv2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuv420_argb32_std), AUTO(yuv420_argb32), END}},
+	{"yuv420_abgr32", LAYOUT_YUV420P, LAYOUT_RGB32, "yuv", "abgr", run_yuv2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuv420_abgr32_std), AUTO(yuv420_abgr32), END}},
+	{"nv12_rgba32", LAYOUT_NV12, LAYOUT_RGB32, "uv", "rgba", run_yuvsp2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(nv12_rgba32_std), AUTO(nv12_rgba32), STRIPS(nv12_rgba32_strips), END}},
+	{"nv12_bgra32", LAYOUT_NV12, LAYOUT_RGB32, "uv", "bgra", run_yuvsp2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(nv12_bgra32_std), AUTO(nv12_bgra32), END}},
+	{"nv12_argb32", LAYOUT_NV12, LAYOUT_RGB32, "uv", "argb", run_yuvsp2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(nv12_argb32_std), AUTO(nv12_argb32), END}},
+	{"nv12_abgr32", LAYOUT_NV12, LAYOUT_RGB32, "uv", "abgr", run_yuvsp2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(nv12_abgr32_std), AUTO(nv12_abgr32), END}},
+	{"nv21_rgba32", LAYOUT_NV12, LAYOUT_RGB32, "vu", "rgba", run_yuvsp2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(nv21_rgba32_std), AUTO(nv21_rgba32), END}},
+	{"nv21_bgra32", LAYOUT_NV12, LAYOUT_RGB32, "vu", "bgra", run_yuvsp2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(nv21_bgra32_std), AUTO(nv21_bgra32), END}},
+	{"nv21_argb32", LAYOUT_NV12, LAYOUT_RGB32, "vu", "argb", run_yuvsp2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(nv21_argb32_std), AUTO(nv21_argb32), END}},
+	{"nv21_abgr32", LAYOUT_NV12, LAYOUT_RGB32, "vu", "abgr", run_yuvsp2rgb32, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(nv21_abgr32_std), AUTO(nv21_abgr32), END}},
+	{"yuv444p_rgb24", LAYOUT_YUV444P, LAYOUT_RGB24, "yuv", "rgb", run_yuv2rgb, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuv444p_rgb24_std), AUTO(yuv444p_rgb24), END}},
+	{"yuyv_rgb24", LAYOUT_PACKED422, LAYOUT_RGB24, "yuyv", "rgb", run_packed, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuyv_rgb24_std), AUTO(yuyv_rgb24), END}},
+	{"uyvy_rgb24", LAYOUT_PACKED422, LAYOUT_RGB24, "uyvy", "rgb", run_packed, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(uyvy_rgb24_std), AUTO(uyvy_rgb24), END}},
+	{"yuv420_rgb24_upsampling_nearest", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_upsampling, CHROMA_NEAREST,
+		REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR, {STD(yuv420_rgb24_upsampling_std), AUTO(yuv420_rgb24_upsampling), END}},
+	{"yuv420_rgb24_upsampling_center", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_upsampling, CHROMA_BILINEAR_CENTER,
+		REFERENCE_NONE, 0, {STD(yuv420_rgb24_upsampling_std), AUTO(yuv420_rgb24_upsampling), END}},
+	{"yuv420_rgb24_upsampling_cosited", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_upsampling, CHROMA_BILINEAR_COSITED,
+		REFERENCE_NONE, 0, {STD(yuv420_rgb24_upsampling_std), AUTO(yuv420_rgb24_upsampling), END}},
+	{"yuv420_rgb24_resize_2x", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_resize, 2, REFERENCE_NONE, 0,
+		{STD(yuv420_rgb24_resize_std), AUTO(yuv420_rgb24_resize), END}},
+	{"yuv420_rgb24_resize_4x", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_resize, 4, REFERENCE_NONE, 0,
+		{STD(yuv420_rgb24_resize_std), AUTO(yuv420_rgb24_resize), END}},
+	{"yuv420_rgb24_resize_bilinear", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_resize, 3, REFERENCE_NONE, 0,
+		{STD(yuv420_rgb24_resize_std), AUTO(yuv420_rgb24_resize), END}},
+	{"yuv420_rgbp", LAYOUT_YUV420P, LAYOUT_RGBP, "yuv", "rgb", run_rgbp, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuv420_rgbp_std), AUTO(yuv420_rgbp), END}},
+	{"yuv420_rgbp_float", LAYOUT_YUV420P, LAYOUT_RGBP_FLOAT, "yuv", "rgb", run_rgbp_float, 0, REFERENCE_NONE, 0,
+		{STD(yuv420_rgbp_float_std), AUTO(yuv420_rgbp_float), END}},
+	{"yuv420_rgbp_half", LAYOUT_YUV420P, LAYOUT_RGBP_HALF, "yuv", "rgb", run_rgbp_half, 0, REFERENCE_NONE, 0,
+		{STD(yuv420_rgbp_half_std), AUTO(yuv420_rgbp_half), END}},
+	{"yuv420p10_rgb24", LAYOUT_YUV420P10, LAYOUT_RGB24, "yuv", "rgb", run_p10, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuv420p10_rgb24_std), AUTO(yuv420p10_rgb24), END}},
+	{"yuv420p10_rgb48", LAYOUT_YUV420P10, LAYOUT_RGB48, "yuv", "rgb", run_p10, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuv420p10_rgb48_std), AUTO(yuv420p10_rgb48), END}},
+	{"p010_rgb24", LAYOUT_P016, LAYOUT_RGB24, "uv", "rgb", run_p010, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(p010_rgb24_std), AUTO(p010_rgb24), END}},
+	{"p010_rgb48", LAYOUT_P016, LAYOUT_RGB48, "uv", "rgb", run_p010, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(p010_rgb48_std), AUTO(p010_rgb48), END}},
+	{"yuv420_rgb24_ctx", LAYOUT_YUV420P, LAYOUT_RGB24, "yuv", "rgb", run_yuv2rgb_context, 0, REFERENCE_YUV2RGB, YUV2RGB_MAX_ERROR,
+		{STD(yuv420_rgb24_ctx_std), AUTO(yuv420_rgb24_ctx), END}},
+	{"rgb24_yuv420", LAYOUT_RGB24, LAYOUT_YUV420P, "rgb", "yuv", run_rgb2yuv, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(rgb24_yuv420_std), SSE(rgb24_yuv420_sse) SSEU(rgb24_yuv420_sseu) AVX512(rgb24_yuv420_avx512)
+		NEON(rgb24_yuv420_neon) AUTO(rgb24_yuv420), MT(rgb24_yuv420_mt), STRIPS(rgb24_yuv420_strips), QUEUE(rgb24_yuv420_queue), END}},
+	{"rgb24_yuv420_precise", LAYOUT_RGB24, LAYOUT_YUV420P, "rgb", "yuv", run_rgb2yuv, 0, REFERENCE_RGB2YUV, PRECISE_MAX_ERROR,
+		{STD(rgb24_yuv420_precise_std), HIGH(rgb24_yuv420_high), END}},
+	{"rgb32_yuv420", LAYOUT_RGB32, LAYOUT_YUV420P, "rgba", "yuv", run_rgb2yuv, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(rgb32_yuv420_std), SSE(rgb32_yuv420_sse) SSEU(rgb32_yuv420_sseu) NEON(rgb32_yuv420_neon) AUTO(rgb32_yuv420), END}},
+	{"bgr24_yuv420", LAYOUT_RGB24, LAYOUT_YUV420P, "bgr", "yuv", run_rgb2yuv, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(bgr24_yuv420_std), AUTO(bgr24_yuv420), END}},
+	{"bgra32_yuv420", LAYOUT_RGB32, LAYOUT_YUV420P, "bgra", "yuv", run_rgb2yuv, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(bgra32_yuv420_std), AUTO(bgra32_yuv420), END}},
+	{"argb32_yuv420", LAYOUT_RGB32, LAYOUT_YUV420P, "argb", "yuv", run_rgb2yuv, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(argb32_yuv420_std), AUTO(argb32_yuv420), END}},
+	{"abgr32_yuv420", LAYOUT_RGB32, LAYOUT_YUV420P, "abgr", "yuv", run_rgb2yuv, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(abgr32_yuv420_std), AUTO(abgr32_yuv420), END}},
+	{"rgb24_nv12", LAYOUT_RGB24, LAYOUT_NV12, "rgb", "uv", run_rgb2yuvsp, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(rgb24_nv12_std), SSE(rgb24_nv12_sse) SSEU(rgb24_nv12_sseu) AVX512(rgb24_nv12_avx512)
+		NEON(rgb24_nv12_neon) AUTO(rgb24_nv12), MT(rgb24_nv12_mt), END}},
+	{"rgb24_nv21", LAYOUT_RGB24, LAYOUT_NV12, "rgb", "vu", run_rgb2yuvsp, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(rgb24_nv21_std), SSE(rgb24_nv21_sse) SSEU(rgb24_nv21_sseu) AVX512(rgb24_nv21_avx512)
+		NEON(rgb24_nv21_neon) AUTO(rgb24_nv21), END}},
+	{"rgb24_nv12_precise", LAYOUT_RGB24, LAYOUT_NV12, "rgb", "uv", run_rgb2yuvsp, 0, REFERENCE_RGB2YUV, PRECISE_MAX_ERROR,
+		{STD(rgb24_nv12_precise_std), HIGH(rgb24_nv12_high), END}},
+	{"rgb24_nv21_precise", LAYOUT_RGB24, LAYOUT_NV12, "rgb", "vu", run_rgb2yuvsp, 0, REFERENCE_RGB2YUV, PRECISE_MAX_ERROR,
+		{STD(rgb24_nv21_precise_std), HIGH(rgb24_nv21_high), END}},
+	{"rgb32_nv12", LAYOUT_RGB32, LAYOUT_NV12, "rgba", "uv", run_rgb2yuvsp, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(rgb32_nv12_std), SSE(rgb32_nv12_sse) SSEU(rgb32_nv12_sseu) NEON(rgb32_nv12_neon) AUTO(rgb32_nv12), END}},
+	{"rgb32_nv21", LAYOUT_RGB32, LAYOUT_NV12, "rgba", "vu", run_rgb2yuvsp, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(rgb32_nv21_std), SSE(rgb32_nv21_sse) SSEU(rgb32_nv21_sseu) NEON(rgb32_nv21_neon) AUTO(rgb32_nv21), END}},
+	{"rgb24_yuv420_downsampling_box", LAYOUT_RGB24, LAYOUT_YUV420P, "rgb", "yuv", run_downsampling, CHROMA_BOX,
+		REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR, {STD(rgb24_yuv420_downsampling_std), AUTO(rgb24_yuv420_downsampling), END}},
+	{"rgb24_yuv420_downsampling_121", LAYOUT_RGB24, LAYOUT_YUV420P, "rgb", "yuv", run_downsampling, CHROMA_121_COSITED,
+		REFERENCE_NONE, 0, {STD(rgb24_yuv420_downsampling_std), AUTO(rgb24_yuv420_downsampling), END}},
+	{"rgb32_yuv420_downsampling_121", LAYOUT_RGB32, LAYOUT_YUV420P, "rgba", "yuv", run_downsampling, CHROMA_121_COSITED,
+		REFERENCE_NONE, 0, {STD(rgb32_yuv420_downsampling_std), AUTO(rgb32_yuv420_downsampling), END}},
+	{"rgb24_yuv420_ctx", LAYOUT_RGB24, LAYOUT_YUV420P, "rgb", "yuv", run_rgb2yuv_context, 0, REFERENCE_RGB2YUV, RGB2YUV_MAX_ERROR,
+		{STD(rgb24_yuv420_ctx_std), AUTO(rgb24_yuv420_ctx), END}}
+};
+#define CONVERSION_COUNT (sizeof(conversions)/sizeof(conversions[0]))
+
+// color spaces, as given to ycbcr_context_create, the last one is the one of the context conversions
+typedef struct
+{
+	double r_factor, b_factor;
+	double y_min, y_max, cbcr_range;
+} ColorSpace;
+
+static const ColorSpace color_spaces[6] = {
+	{0.299, 0.114, 0.0, 255.0, 255.0},      // YCBCR_JPEG
+	{0.299, 0.114, 16.0, 235.0, 224.0},     // YCBCR_601
+	{0.2126, 0.0722, 16.0, 235.0, 224.0},   // YCBCR_709
+	{0.2126, 0.0722, 0.0, 255.0, 255.0},    // YCBCR_709_FULL
+	{0.2627, 0.0593, 16.0, 235.0, 224.0},   // YCBCR_2020
+	{0.212, 0.087, 16.0, 235.0, 224.0}      // SMPTE 240M, with a context
+};
+#define CONTEXT_COLOR_SPACE 5
+
+// Images
+
+#define GUARD_SIZE 64
+#define GUARD_VALUE 0xA5
+
+static uint32_t element_size(Layout layout)
+{
+	switch(layout)
+	{
+		case LAYOUT_YUV420P10: case LAYOUT_P016: case LAYOUT_RGB48: case LAYOUT_RGBP_HALF: return 2;
+		case LAYOUT_RGBP_FLOAT: return 4;
+		default: return 1;
+	}
+}
+
+// number of planes, bytes per row and rows of each plane
+static uint32_t plane_geometry(Layout layout, uint32_t width, uint32_t height, uint32_t row_bytes[3], uint32_t rows[3])
+{
+	const uint32_t uv_width = (width+1)/2, uv_height = (height+1)/2;
+	rows[0] = rows[1] = rows[2] = height;
+	switch(layout)
+	{
+		case LAYOUT_YUV420P:
+		case LAYOUT_YUV420P10:
+			row_bytes[0] = width*element_size(layout);
+			row_bytes[1] = row_bytes[2] = uv_width*element_size(layout);
+			rows[1] = rows[2] = uv_height;
+			return 3;
+		case LAYOUT_NV12:
+		case LAYOUT_P016:
+			row_bytes[0] = width*element_size(layout);
+			row_bytes[1] = 2*uv_width*element_size(layout);
+			rows[1] = uv_height;
+			return 2;
+		case LAYOUT_YUV444P:
+		case LAYOUT_RGBP:
+		case LAYOUT_RGBP_FLOAT:
+		case LAYOUT_RGBP_HALF:
+			row_bytes[0] = row_bytes[1] = row_bytes[2] = width*element_size(layout);
+			return 3;
+		case LAYOUT_PACKED422: row_bytes[0] = 4*uv_width; return 1;
+		case LAYOUT_RGB24: row_bytes[0] = 3*width; return 1;
+		case LAYOUT_RGB32: row_bytes[0] = 4*width; return 1;
+		case LAYOUT_RGB48: row_bytes[0] = 6*width; return 1;
+	}
+	return 0;
+}
+
+// allocate the planes of an image, surrounded by guard bytes
+// With aligned, planes and strides are multiples of 64 bytes, otherwise they are random (multiples of the
+// element size). Planes 1 and 2 share the same stride, and the three planes of rgbp images too.
+static int image_create(Image *image, Layout layout, uint32_t width, uint32_t height, int aligned)
+{
+	uint32_t row_bytes[3], rows[3];
+	const uint32_t es = element_size(layout);
+	memset(image, 0, sizeof(Image));
+	image->plane_count = plane_geometry(layout, width, height, row_bytes, rows);
+	const int shared_stride = layout==LAYOUT_RGBP || layout==LAYOUT_RGBP_FLOAT || layout==LAYOUT_RGBP_HALF;
+
+	uint32_t i;
+	for(i=0; i<image->plane_count; ++i)
+	{
+		Plane *plane = &image->planes[i];
+		uint32_t stride, offset;
+		if(i==2 || (i==1 && shared_stride))
+			stride = image->planes[i-1].stride;
+		else if(aligned)
+			stride = (row_bytes[i]+63)/64*64 + 64*random_range(0, 1);
+		else
+			stride = row_bytes[i] + es*random_range(0, 9);
+		offset = aligned ? 0 : es*random_range(0, 64/es-1);
+
+		plane->row_bytes = row_bytes[i];
+		plane->rows = rows[i];
+		plane->stride = stride;
+		plane->memory_size = GUARD_SIZE + offset + (size_t)stride*rows[i] + GUARD_SIZE;
+		void *memory = NULL;
+		if(posix_memalign(&memory, 64, plane->memory_size)!=0)
+			return 1;
+		plane->memory = memory;
+		plane->data = plane->memory + GUARD_SIZE + offset;
+		memset(plane->memory, GUARD_VALUE, plane->memory_size);
+	}
+	return 0;
+}
+
+static void image_destroy(Image *image)
+{
+	uint32_t i;
+	for(i=0; i<image->plane_count; ++i)
+		free(image->planes[i].memory);
+}
+
+// random input values, in the range of the layout, with some images of uniform or extreme values
+static void image_fill(Image *image, Layout layout)
+{
+	const uint32_t mode = random_range(0, 9);
+	const uint8_t uniform = (uint8_t)random_u32();
+	uint32_t i, r, x;
+	for(i=0; i<image->plane_count; ++i)
+	{
+		Plane *plane = &image->planes[i];
+		for(r=0; r<plane->rows; ++r)
+		{
+			uint8_t *row = plane->data + (size_t)r*plane->stride;
+			for(x=0; x<plane->row_bytes; ++x)
+			{
+				switch(mode)
+				{
+					case 0: row[x] = uniform; break;
+					case 1: row[x] = (random_u32()&1) ? 255 : 0; break;
+					default: row[x] = (uint8_t)random_u32(); break;
+				}
+			}
+			// 10 bits values in the low bits of the (native endian) 16 bits words
+			if(layout==LAYOUT_YUV420P10)
+				for(x=0; x<plane->row_bytes/2; ++x)
+					((uint16_t*)row)[x] &= 0x3FF;
+		}
+	}
+}
+
+static void image_copy(Image *dst, const Image *src)
+{
+	uint32_t i, r;
+	for(i=0; i<src->plane_count; ++i)
+		for(r=0; r<src->planes[i].rows; ++r)
+			memcpy(dst->planes[i].data + (size_t)r*dst->planes[i].stride, src->planes[i].data + (size_t)r*src->planes[i].stride,
+				src->planes[i].row_bytes);
+}
+
+// return the position of the first different byte, or -1
+static long image_compare(const Image *a, const Image *b, uint32_t *plane_index, uint32_t *row_index)
+{
+	uint32_t i, r;
+	for(i=0; i<a->plane_count; ++i)
+		for(r=0; r<a->planes[i].rows; ++r)
+		{
+			const uint8_t *row_a = a->planes[i].data + (size_t)r*a->planes[i].stride,
+				*row_b = b->planes[i].data + (size_t)r*b->planes[i].stride;
+			uint32_t x;
+			for(x=0; x<a->planes[i].row_bytes; ++x)
+				if(row_a[x]!=row_b[x])
+				{
+					*plane_index = i;
+					*row_index = r;
+					return x;
+				}
+		}
+	return -1;
+}
+
+// check that the bytes outside of the image rows were not written
+static int image_guards_intact(const Image *image)
+{
+	uint32_t i;
+	for(i=0; i<image->plane_count; ++i)
+	{
+		const Plane *plane = &image->planes[i];
+		const uint8_t *p = plane->memory, *end = plane->memory + plane->memory_size;
+		uint32_t r;
+		for(r=0; r<=plane->rows; ++r)
+		{
+			// bytes between the end of the previous row (or the start of the memory) and the start of this row
+			const uint8_t *next = r<plane->rows ? plane->data + (size_t)r*plane->stride : end;
+			for(; p<next; ++p)
+				if(*p!=GUARD_VALUE)
+					return 0;
+			p += plane->row_bytes;
+		}
+	}
+	return 1;
+}
+
+// Reference computation
+
+static double clamp_double(double value, double max)
+{
+	return value<0.0 ? 0.0 : (value>max ? max : value);
+}
+
+// position of the channel in the order string
+static uint32_t channel(const char *order, char c)
+{
+	return (uint32_t)(strchr(order, c)-order);
+}
+
+// y, u and v values of a pixel, scaled to 8 bits
+static void sample_yuv(const Conversion *c, const Image *in, uint32_t x, uint32_t y, double yuv[3])
+{
+	const Plane *p = in->planes;
+	const uint32_t uv_x = x/2, uv_y = y/2;
+	switch(c->in_layout)
+	{
+		case LAYOUT_YUV420P:
+			yuv[0] = p[0].data[y*p[0].stride + x];
+			yuv[1] = p[1].data[uv_y*p[1].stride + uv_x];
+			yuv[2] = p[2].data[uv_y*p[2].stride + uv_x];
+			break;
+		case LAYOUT_NV12:
+			yuv[0] = p[0].data[y*p[0].stride + x];
+			yuv[1] = p[1].data[uv_y*p[1].stride + 2*uv_x + channel(c->in_order, 'u')];
+			yuv[2] = p[1].data[uv_y*p[1].stride + 2*uv_x + channel(c->in_order, 'v')];
+			break;
+		case LAYOUT_YUV444P:
+			yuv[0] = p[0].data[y*p[0].stride + x];
+			yuv[1] = p[1].data[y*p[1].stride + x];
+			yuv[2] = p[2].data[y*p[2].stride + x];
+			break;
+		case LAYOUT_PACKED422:
+		{
+			const uint8_t *macropixel = p[0].data + y*p[0].stride + 4*uv_x;
+			const uint32_t y_position = (x%2) ? (uint32_t)(strrchr(c->in_order, 'y')-c->in_order) : channel(c->in_order, 'y');
+			yuv[0] = macropixel[y_position];
+			yuv[1] = macropixel[channel(c->in_order, 'u')];
+			yuv[2] = macropixel[channel(c->in_order, 'v')];
+			break;
+		}
+		case LAYOUT_YUV420P10:
+			yuv[0] = ((const uint16_t*)(p[0].data + y*p[0].stride))[x]/4.0;
+			yuv[1] = ((const uint16_t*)(p[1].data + uv_y*p[1].stride))[uv_x]/4.0;
+			yuv[2] = ((const uint16_t*)(p[2].data + uv_y*p[2].stride))[uv_x]/4.0;
+			break;
+		case LAYOUT_P016:
+			yuv[0] = ((const uint16_t*)(p[0].data + y*p[0].stride))[x]/256.0;
+			yuv[1] = ((const uint16_t*)(p[1].data + uv_y*p[1].stride))[2*uv_x + channel(c->in_order, 'u')]/256.0;
+			yuv[2] = ((const uint16_t*)(p[1].data + uv_y*p[1].stride))[2*uv_x + channel(c->in_order, 'v')]/256.0;
+			break;
+		default:
+			yuv[0] = yuv[1] = yuv[2] = 0.0;
+			break;
+	}
+}
+
+// r, g and b values of a pixel (and alpha, or -1 if there is no alpha channel), in the range of the layout
+static void sample_rgb(Layout layout, const char *order, const Image *image, uint32_t x, uint32_t y, double rgb[3], int *alpha)
+{
+	const Plane *p = image->planes;
+	*alpha = -1;
+	switch(layout)
+	{
+		case LAYOUT_RGB24:
+		case LAYOUT_RGB32:
+		{
+			const uint32_t size = layout==LAYOUT_RGB24 ? 3 : 4;
+			const uint8_t *pixel = p[0].data + y*p[0].stride + size*x;
+			rgb[0] = pixel[channel(order, 'r')];
+			rgb[1] = pixel[channel(order, 'g')];
+			rgb[2] = pixel[channel(order, 'b')];
+			if(strchr(order, 'a'))
+				*alpha = pixel[channel(order, 'a')];
+			break;
+		}
+		case LAYOUT_RGB48:
+		{
+			const uint16_t *pixel = (const uint16_t*)(p[0].data + y*p[0].stride) + 3*x;
+			rgb[0] = pixel[0];
+			rgb[1] = pixel[1];
+			rgb[2] = pixel[2];
+			break;
+		}
+		case LAYOUT_RGBP:
+			rgb[0] = p[0].data[y*p[0].stride + x];
+			rgb[1] = p[1].data[y*p[1].stride + x];
+			rgb[2] = p[2].data[y*p[2].stride + x];
+			break;
+		default:
+			rgb[0] = rgb[1] = rgb[2] = 0.0;
+			break;
+	}
+}
+
+typedef struct
+{
+	double max_error;
+	double squared_error;
+	double max_value;   // for the psnr, in 8 bits units
+	uint64_t count;
+} ErrorStats;
+
+static void add_error(ErrorStats *stats, double error)
+{
+	error = fabs(error);
+	if(error>stats->max_error)
+		stats->max_error = error;
+	stats->squared_error += error*error;
+	stats->count++;
+}
+
+// compare the std output with the double precision conversion, errors are in 8 bits units
+static int reference_yuv2rgb(const Conversion *c, const ColorSpace *cs, const Run *run, const Image *in, const Image *out, ErrorStats *stats)
+{
+	const double g_factor = 1.0-cs->r_factor-cs->b_factor;
+	const double out_max = c->out_layout==LAYOUT_RGB48 ? 65535.0 : 255.0;
+	uint32_t x, y;
+	for(y=0; y<run->height; ++y)
+		for(x=0; x<run->width; ++x)
+		{
+			double yuv[3], rgb[3];
+			int alpha;
+			sample_yuv(c, in, x, y, yuv);
+			sample_rgb(c->out_layout, c->out_order, out, x, y, rgb, &alpha);
+			if(alpha>=0 && alpha!=run->alpha)
+				return 0;
+
+			const double luma = (yuv[0]-cs->y_min)/(cs->y_max-cs->y_min),
+				cb = (yuv[1]-128.0)/cs->cbcr_range,
+				cr = (yuv[2]-128.0)/cs->cbcr_range;
+			const double r = luma + 2.0*(1.0-cs->r_factor)*cr,
+				b = luma + 2.0*(1.0-cs->b_factor)*cb,
+				g = (luma - cs->r_factor*r - cs->b_factor*b)/g_factor;
+			const double expected[3] = {r, g, b};
+			uint32_t i;
+			for(i=0; i<3; ++i)
+				add_error(stats, (clamp_double(floor(expected[i]*out_max+0.5), out_max)-rgb[i])*255.0/out_max);
+		}
+	stats->max_value = 255.0;
+	return 1;
+}
+
+static int reference_rgb2yuv(const Conversion *c, const ColorSpace *cs, const Run *run, const Image *in, const Image *out, ErrorStats *stats)
+{
+	const double g_factor = 1.0-cs->r_factor-cs->b_factor;
+	const Plane *p = out->planes;
+	uint32_t x, y;
+	for(y=0; y<run->height; y+=2)
+		for(x=0; x<run->width; x+=2)
+		{
+			// chroma from the average of the pixels of the block
+			double cb_sum = 0.0, cr_sum = 0.0;
+			uint32_t n = 0, dx, dy;
+			for(dy=0; dy<2 && y+dy<run->height; ++dy)
+				for(dx=0; dx<2 && x+dx<run->width; ++dx)
+				{
+					double rgb[3];
+					int alpha;
+					sample_rgb(c->in_layout, c->in_order, in, x+dx, y+dy, rgb, &alpha);
+					const double luma = cs->r_factor*rgb[0] + g_factor*rgb[1] + cs->b_factor*rgb[2];
+					const double expected_y = cs->y_min + (cs->y_max-cs->y_min)*luma/255.0;
+					add_error(stats, clamp_double(floor(expected_y+0.5), 255.0) - p[0].data[(y+dy)*p[0].stride + x+dx]);
+					cb_sum += (rgb[2]-luma)/(2.0*(1.0-cs->b_factor));
+					cr_sum += (rgb[0]-luma)/(2.0*(1.0-cs->r_factor));
+					++n;
+				}
+			const double expected_u = clamp_double(floor(128.0 + cs->cbcr_range/255.0*cb_sum/n + 0.5), 255.0),
+				expected_v = clamp_double(floor(128.0 + cs->cbcr_range/255.0*cr_sum/n + 0.5), 255.0);
+			double u, v;
+			if(c->out_layout==LAYOUT_NV12)
+			{
+				u = p[1].data[(y/2)*p[1].stride + x + channel(c->out_order, 'u')];
+				v = p[1].data[(y/2)*p[1].stride + x + channel(c->out_order, 'v')];
+			}
+			else
+			{
+				u = p[1].data[(y/2)*p[1].stride + x/2];
+				v = p[2].data[(y/2)*p[2].stride + x/2];
+			}
+			add_error(stats, expected_u-u);
+			add_error(stats, expected_v-v);
+		}
+	stats->max_value = 255.0;
+	return 1;
+}
+
+// Statistics and trace callback
+// With a library built with statistics, the counters of the yuv420_rgb24 dispatching function and the spans 
+// given to the trace callback must match the conversions, and be cleared by the reset.
+
+typedef struct
+{
+	uint32_t spans;
+	uint64_t pixels;
+} TraceCount;
+
+static void count_span(const YUVRGBSpan *span, void *user_data)
+{
+	TraceCount *count = user_data;
+	if(strcmp(span->function, "yuv420_rgb24")==0)
+	{
+		count->spans++;
+		count->pixels += (uint64_t)span->width*span->height;
+	}
+}
+
+// sum of the calls and pixels of all the entries of a function (one per selected implementation)
+static void stats_sum(const char *function, uint64_t *calls, uint64_t *pixels)
+{
+	const uint32_t max_count = yuv_rgb_stats(NULL, 0);
+	YUVRGBStats *stats = malloc((max_count+1)*sizeof(YUVRGBStats));
+	if(!stats)
+	{
+		fprintf(stderr, "Error allocating statistics\n");
+		exit(1);
+	}
+	const uint32_t count = yuv_rgb_stats(stats, max_count);
+	uint32_t i;
+	*calls = *pixels = 0;
+	for(i=0; i<count && i<max_count; ++i)
+		if(strcmp(stats[i].function, function)==0)
+		{
+			*calls += stats[i].calls;
+			*pixels += stats[i].pixels;
+		}
+	free(stats);
+}
+
+static int check_stats(uint32_t iterations)
+{
+	if(!yuv_rgb_stats_enabled())
+	{
+		printf("%-32s %-6s %-64s %10s %8s\n", "stats", "skip", "(built without USE_STATS)", "-", "-");
+		return 0;
+	}
+
+	TraceCount trace = {0, 0};
+	uint64_t expected_pixels = 0;
+	yuv_rgb_stats_reset();
+	yuv_rgb_set_trace_callback(count_span, &trace);
+	uint32_t it;
+	for(it=0; it<iterations; ++it)
+	{
+		const uint32_t width = random_range(1, 160), height = random_range(1, 12);
+		Image in, out;
+		if(image_create(&in, LAYOUT_YUV420P, width, height, random_range(0, 1)) ||
+			image_create(&out, LAYOUT_RGB24, width, height, random_range(0, 1)))
+		{
+			fprintf(stderr, "Error allocating images\n");
+			exit(1);
+		}
+		image_fill(&in, LAYOUT_YUV420P);
+		yuv420_rgb24(width, height, in.planes[0].data, in.planes[1].data, in.planes[2].data, in.planes[0].stride,
+			in.planes[1].stride, out.planes[0].data, out.planes[0].stride, YCBCR_601);
+		expected_pixels += (uint64_t)width*height;
+		image_destroy(&in);
+		image_destroy(&out);
+	}
+	yuv_rgb_set_trace_callback(NULL, NULL);
+
+	uint64_t calls, pixels;
+	stats_sum("yuv420_rgb24", &calls, &pixels);
+	int failed = calls!=iterations || pixels!=expected_pixels || trace.spans!=iterations || trace.pixels!=expected_pixels;
+	if(failed)
+		printf("  stats: %llu calls and %llu pixels counted, %u spans and %llu pixels traced, expected %u and %llu\n",
+			(unsigned long long)calls, (unsigned long long)pixels, trace.spans, (unsigned long long)trace.pixels,
+			iterations, (unsigned long long)expected_pixels);
+
+	yuv_rgb_stats_reset();
+	stats_sum("yuv420_rgb24", &calls, &pixels);
+	if(calls!=0 || pixels!=0)
+	{
+		printf("  stats: %llu calls and %llu pixels after the reset\n", (unsigned long long)calls, (unsigned long long)pixels);
+		failed = 1;
+	}
+	printf("%-32s %-6s %-64s %10s %8s\n", "stats", failed ? "FAIL" : "ok", "calls, pixels, trace, reset", "-", "-");
+	return failed;
+}
+
+// Job chaining
+// Each callback submits the next job to a queue of capacity 1, which is full until the slot of the 
+// completed job is freed, before its callback.
+
+typedef struct
+{
+	YUVRGBJobQueue *queue;
+	YUVRGBJob job;
+	uint32_t remaining, completions;
+} JobChain;
+
+static void chain_next_job(void *user_data)
+{
+	JobChain *chain = user_data;
+	chain->completions++;
+	if(chain->remaining>0)
+	{
+		chain->remaining--;
+		yuv_rgb_queue_submit(chain->queue, &chain->job);
+	}
+}
+
+static int check_queue_chain(uint32_t iterations)
+{
+	const uint32_t width = 64, height = 16;
+	Image in, out;
+	if(image_create(&in, LAYOUT_YUV420P, width, height, 1) || image_create(&out, LAYOUT_RGB24, width, height, 1))
+	{
+		fprintf(stderr, "Error allocating images\n");
+		exit(1);
+	}
+	image_fill(&in, LAYOUT_YUV420P);
+
+	JobChain chain;
+	chain.queue = yuv_rgb_queue_create(2, 1);
+	if(!chain.queue)
+	{
+		fprintf(stderr, "Error creating the job queue\n");
+		exit(1);
+	}
+	const YUVRGBJob job = {JOB_YUV2RGB, {.yuv2rgb = yuv420_rgb24}, width, height,
+		{in.planes[0].data, in.planes[1].data, in.planes[2].data}, {in.planes[0].stride, in.planes[1].stride},
+		{out.planes[0].data, NULL, NULL}, {out.planes[0].stride, 0}, YCBCR_601, 0, chain_next_job, &chain};
+	chain.job = job;
+	chain.remaining = iterations;
+	chain.completions = 0;
+	yuv_rgb_queue_submit(chain.queue, &chain.job);
+	yuv_rgb_queue_wait(chain.queue);
+	const int failed = chain.completions!=iterations+1 || !image_guards_intact(&out);
+	yuv_rgb_queue_destroy(chain.queue);
+	image_destroy(&in);
+	image_destroy(&out);
+
+	if(failed)
+		printf("  queue_chain: %u completions, expected %u\n", chain.completions, iterations+1);
+	printf("%-32s %-6s %-64s %10s %8s\n", "queue_chain", failed ? "FAIL" : "ok", "submit from the callbacks", "-", "-");
+	return failed;
+}
+
+// Test loop
+
+typedef struct
+{
+	uint32_t runs, mismatches, guard_errors;
+} ImplementationStats;
+
+static void print_usage(const char *program)
+{
+	printf("Usage : %s [-n iterations] [-s seed] [-f conversion] [-v]\n", program);
+	printf("  -n : number of random images per conversion (default 100)\n");
+	printf("  -s : random seed (default 1)\n");
+	printf("  -f : only check the conversions whose name contains this string\n");
+	printf("  -v : print every failure, instead of the first one of each implementation\n");
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t iterations = 100;
+	uint64_t seed = 1;
+	const char *filter = NULL;
+	int verbose = 0;
+	int i;
+	for(i=1; i<argc; ++i)
+	{
+		if(strcmp(argv[i], "-n")==0 && i+1<argc)
+			iterations = (uint32_t)strtoul(argv[++i], NULL, 10);
+		else if(strcmp(argv[i], "-s")==0 && i+1<argc)
+			seed = strtoull(argv[++i], NULL, 10);
+		else if(strcmp(argv[i], "-f")==0 && i+1<argc)
+			filter = argv[++i];
+		else if(strcmp(argv[i], "-v")==0)
+			verbose = 1;
+		else
+		{
+			print_usage(argv[0]);
+			return 1;
+		}
+	}
+	random_state ^= seed*0xBF58476D1CE4E5B9ULL;
+
+	const SIMDType simd = yuv_rgb_cpu_simd();
+	thread_pool = yuv_rgb_pool_create(3);
+	job_queue = yuv_rgb_queue_create(3, 2);
+	const ColorSpace *context_cs = &color_spaces[CONTEXT_COLOR_SPACE];
+	YCbCrContext *context = ycbcr_context_create(context_cs->r_factor, context_cs->b_factor,
+		(uint8_t)context_cs->y_min, (uint8_t)context_cs->y_max, (uint8_t)context_cs->cbcr_range);
+	if(!thread_pool || !job_queue || !context)
+	{
+		fprintf(stderr, "Error creating the thread pool, the job queue or the conversion context\n");
+		return 1;
+	}
+
+	printf("simd %d, %u images per conversion, seed %llu\n", (int)simd, iterations, (unsigned long long)seed);
+	printf("%-32s %-6s %-64s %10s %8s\n", "conversion", "result", "implementations (failures)", "max error", "psnr");
+
+	int failed_conversions = 0;
+	uint32_t ci;
+	for(ci=0; ci<CONVERSION_COUNT; ++ci)
+	{
+		const Conversion *c = &conversions[ci];
+		if(filter && !strstr(c->name, filter))
+			continue;
+
+		ImplementationStats stats[MAX_IMPLEMENTATIONS];
+		memset(stats, 0, sizeof(stats));
+		ErrorStats errors;
+		memset(&errors, 0, sizeof(errors));
+		int reference_failed = 0;
+
+		uint32_t it;
+		for(it=0; it<iterations; ++it)
+		{
+			Run run;
+			memset(&run, 0, sizeof(run));
+			// mostly small images, that cover all the block and tail combinations, and some larger ones
+			run.width = random_range(1, (it%8)==7 ? 700 : 160);
+			run.height = random_range(1, (it%8)==7 ? 40 : 12);
+			if(c->runner==run_resize)
+			{
+				// integer factors, or 2/3 for the bilinear interpolation
+				const uint32_t factor = (uint32_t)c->option;
+				if(factor==3)
+				{
+					run.out_width = (run.width*2+2)/3;
+					run.out_height = (run.height*2+2)/3;
+				}
+				else
+				{
+					run.width = factor*random_range(1, 700/factor);
+					run.height = factor*random_range(1, 40/factor);
+					run.out_width = run.width/factor;
+					run.out_height = run.height/factor;
+				}
+			}
+			else
+			{
+				run.out_width = run.width;
+				run.out_height = run.height;
+			}
+			run.yuv_type = (YCbCrType)random_range(0, 4);
+			run.context = context;
+			run.alpha = (uint8_t)random_u32();
+			uint32_t k;
+			for(k=0; k<3; ++k)
+			{
+				run.scale[k] = (float)(random_range(1, 1000)/100000.0);
+				run.bias[k] = (float)((random_range(0, 2000)-1000.0)/1000.0);
+			}
+			yuv_rgb_set_store_policy((StorePolicy)random_range(0, 2));
+
+			Image in, expected;
+			if(image_create(&in, c->in_layout, run.width, run.height, random_range(0, 1)) ||
+				image_create(&expected, c->out_layout, run.out_width, run.out_height, random_range(0, 1)))
+			{
+				fprintf(stderr, "Error allocating images\n");
+				return 1;
+			}
+			image_fill(&in, c->in_layout);
+			c->runner(c, c->implementations[0].fun, &run, &in, &expected);
+
+			if(c->reference!=REFERENCE_NONE)
+			{
+				const ColorSpace *cs = (c->runner==run_yuv2rgb_context || c->runner==run_rgb2yuv_context) ?
+					context_cs : &color_spaces[run.yuv_type];
+				const int valid = c->reference==REFERENCE_YUV2RGB ?
+					reference_yuv2rgb(c, cs, &run, &in, &expected, &errors) :
+					reference_rgb2yuv(c, cs, &run, &in, &expected, &errors);
+				if(!valid)
+					reference_failed = 1;
+			}
+			if(!image_guards_intact(&expected))
+				stats[0].guard_errors++;
+			stats[0].runs++;
+
+			const Implementation *implementation;
+			uint32_t ii;
+			for(ii=1, implementation=&c->implementations[1]; implementation->name; ++ii, ++implementation)
+			{
+				if(implementation->simd>simd)
+					continue;
+
+				Image impl_in, out;
+				const int aligned = implementation->aligned || random_range(0, 1);
+				if(image_create(&impl_in, c->in_layout, run.width, run.height, aligned) ||
+					image_create(&out, c->out_layout, run.out_width, run.out_height, aligned))
+				{
+					fprintf(stderr, "Error allocating images\n");
+					return 1;
+				}
+				image_copy(&impl_in, &in);
+				c->runner(c, implementation->fun, &run, &impl_in, &out);
+
+				stats[ii].runs++;
+				uint32_t plane_index = 0, row_index = 0;
+				const long position = image_compare(&out, &expected, &plane_index, &row_index);
+				const int guards = image_guards_intact(&out);
+				if(position>=0)
+					stats[ii].mismatches++;
+				if(!guards)
+					stats[ii].guard_errors++;
+				if((position>=0 || !guards) && (verbose || stats[ii].mismatches+stats[ii].guard_errors==1))
+				{
+					printf("  %s %s: %ux%u, yuv_type %d, %s, strides %u %u -> %u %u", c->name, implementation->name,
+						run.width, run.height, (int)run.yuv_type, aligned ? "aligned" : "unaligned",
+						impl_in.planes[0].stride, impl_in.planes[1].stride, out.planes[0].stride, out.planes[1].stride);
+					if(position>=0)
+						printf(", first difference in plane %u, row %u, byte %ld\n", plane_index, row_index, position);
+					else
+						printf(", bytes written outside of the image\n");
+				}
+				image_destroy(&impl_in);
+				image_destroy(&out);
+			}
+			image_destroy(&in);
+			image_destroy(&expected);
+		}
+
+		// summary of the conversion
+		char summary[256] = "";
+		int failed = reference_failed || (c->reference!=REFERENCE_NONE && errors.max_error>c->max_error);
+		size_t length = 0;
+		const Implementation *implementation;
+		uint32_t ii;
+		for(ii=0, implementation=c->implementations; implementation->name; ++ii, ++implementation)
+		{
+			if(stats[ii].runs==0)
+				continue;
+			const uint32_t failures = stats[ii].mismatches + stats[ii].guard_errors;
+			if(failures)
+				failed = 1;
+			if(length<sizeof(summary))
+				length += snprintf(summary+length, sizeof(summary)-length, failures ? "%s(%u) " : "%s ", implementation->name, failures);
+		}
+		failed_conversions += failed;
+
+		if(c->reference!=REFERENCE_NONE && errors.count>0)
+		{
+			const double mse = errors.squared_error/errors.count;
+			printf("%-32s %-6s %-64s %10.0f %8.2f\n", c->name, failed ? "FAIL" : "ok", summary, errors.max_error,
+				mse>0.0 ? 10.0*log10(errors.max_value*errors.max_value/mse) : INFINITY);
+		}
+		else
+			printf("%-32s %-6s %-64s %10s %8s\n", c->name, failed ? "FAIL" : "ok", summary, "-", "-");
+		if(reference_failed)
+			printf("  %s: wrong alpha values\n", c->name);
+	}
+
+	yuv_rgb_set_store_policy(STORE_AUTO);
+	if(!filter || strstr("stats", filter))
+		failed_conversions += check_stats(iterations);
+	if(!filter || strstr("queue_chain", filter))
+		failed_conversions += check_queue_chain(iterations);
+	ycbcr_context_destroy(context);
+	yuv_rgb_pool_destroy(thread_pool);
+	yuv_rgb_queue_destroy(job_queue);
+
+	if(failed_conversions)
+		printf("%d conversions failed\n", failed_conversions);
+	else
+		printf("All conversions passed\n");
+	return failed_conversions ? 1 : 0;
+}
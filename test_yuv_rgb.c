@@ -3,15 +3,23 @@
 
 // This program demonstrate how to convert a YUV420p image (raw format) to RGB (ppm format), and the reverse operation
 
+// posix_memalign
+#define _POSIX_C_SOURCE 200112L
+
 #include "yuv_rgb.h"
 
+#include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
-#include <x86intrin.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #if USE_FFMPEG
 #include <libswscale/swscale.h>
@@ -20,6 +28,16 @@
 #include <ippcc.h>
 #endif
 
+// allocate memory aligned on a given boundary (must be a power of two multiple of sizeof(void*))
+// memory must be freed with free
+void *aligned_malloc(size_t size, size_t alignment)
+{
+	void *ptr = NULL;
+	if(posix_memalign(&ptr, alignment, size)!=0)
+		return NULL;
+	return ptr;
+}
+
 // read a raw yuv image file
 // raw yuv files can be generated by ffmpeg, for example, using :
 //  ffmpeg -i test.png -c:v rawvideo -pix_fmt yuv420p test.yuv
@@ -289,6 +307,177 @@ void test_rgb2yuv(uint32_t width, uint32_t height,
 	free(out_filename);
 }
 
+// streaming conversion of a raw yuv420p sequence (several frames in the same file)
+// The input file is mapped in memory, and the next frame is prefetched while the current one is converted. 
+// The rgb frames are converted alternately in two buffers, and written by a separate thread, so that writing 
+// frame N overlaps the conversion of frame N+1, without allocation per frame.
+typedef struct
+{
+	FILE *fp;
+	size_t frame_size;
+	uint8_t *buffers[2];
+	uint32_t converted, written;  // number of frames converted and written
+	int done;
+	int error;  // errno of the first failed write, 0 if none
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+} FrameWriter;
+
+static void *frame_writer_thread(void *arg)
+{
+	FrameWriter *writer = arg;
+	pthread_mutex_lock(&writer->mutex);
+	for(;;)
+	{
+		while(writer->written==writer->converted && !writer->done)
+			pthread_cond_wait(&writer->cond, &writer->mutex);
+		if(writer->written==writer->converted)
+			break;
+		
+		const uint8_t *buffer = writer->buffers[writer->written%2];
+		pthread_mutex_unlock(&writer->mutex);
+		const int error = fwrite(buffer, 1, writer->frame_size, writer->fp)!=writer->frame_size ? (errno ? errno : EIO) : 0;
+		pthread_mutex_lock(&writer->mutex);
+		if(!writer->error)
+			writer->error = error;
+		writer->written++;
+		pthread_cond_broadcast(&writer->cond);
+	}
+	pthread_mutex_unlock(&writer->mutex);
+	return NULL;
+}
+
+static double elapsed_seconds(const struct timespec *start)
+{
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec-start->tv_sec) + (now.tv_nsec-start->tv_nsec)*1e-9;
+}
+
+// convert all frames of filename to a raw rgb24 file (that can be read by ffmpeg with -f rawvideo -pix_fmt rgb24)
+int convertRawYUVSequence(const char *filename, uint32_t width, uint32_t height, const char *out, YCbCrType yuv_type)
+{
+	const size_t y_size = (size_t)width*height, 
+		uv_size = (size_t)((width+1)/2)*((height+1)/2), 
+		yuv_frame_size = y_size + 2*uv_size, 
+		rgb_frame_size = 3*y_size;
+	
+	int fd = open(filename, O_RDONLY);
+	if(fd<0)
+	{
+		perror("Error opening yuv sequence for read");
+		return 1;
+	}
+	
+	struct stat file_stat;
+	if(fstat(fd, &file_stat)!=0 || (size_t)file_stat.st_size<yuv_frame_size)
+	{
+		fprintf(stderr, "Wrong size of yuv sequence, expected at least one frame of %zu bytes\n", yuv_frame_size);
+		close(fd);
+		return 2;
+	}
+	const size_t file_size = file_stat.st_size;
+	const uint32_t frame_number = file_size/yuv_frame_size;
+	if(file_size%yuv_frame_size)
+		fprintf(stderr, "Ignoring the last %zu bytes of the yuv sequence (incomplete frame)\n", file_size%yuv_frame_size);
+	
+	const uint8_t *YUV = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(YUV==MAP_FAILED)
+	{
+		perror("Error mapping yuv sequence");
+		return 3;
+	}
+	posix_madvise((void*)YUV, file_size, POSIX_MADV_SEQUENTIAL);
+	
+	FrameWriter writer;
+	writer.fp = fopen(out, "wb");
+	if(!writer.fp)
+	{
+		perror("Error opening rgb sequence for write");
+		munmap((void*)YUV, file_size);
+		return 4;
+	}
+	writer.frame_size = rgb_frame_size;
+	writer.buffers[0] = aligned_malloc(rgb_frame_size, 64);
+	writer.buffers[1] = aligned_malloc(rgb_frame_size, 64);
+	if(!writer.buffers[0] || !writer.buffers[1])
+	{
+		fprintf(stderr, "Error allocating rgb frame buffers\n");
+		free(writer.buffers[0]);
+		free(writer.buffers[1]);
+		fclose(writer.fp);
+		munmap((void*)YUV, file_size);
+		return 6;
+	}
+	writer.converted = writer.written = 0;
+	writer.done = writer.error = 0;
+	pthread_mutex_init(&writer.mutex, NULL);
+	pthread_cond_init(&writer.cond, NULL);
+	
+	pthread_t writer_thread;
+	const int thread_error = pthread_create(&writer_thread, NULL, frame_writer_thread, &writer);
+	if(thread_error)
+	{
+		fprintf(stderr, "Error starting rgb sequence writer thread: %s\n", strerror(thread_error));
+		pthread_cond_destroy(&writer.cond);
+		pthread_mutex_destroy(&writer.mutex);
+		free(writer.buffers[0]);
+		free(writer.buffers[1]);
+		fclose(writer.fp);
+		munmap((void*)YUV, file_size);
+		return 7;
+	}
+	
+	struct timespec start;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	double conversion_time = 0;
+	for(uint32_t i=0; i<frame_number; ++i)
+	{
+		const uint8_t *frame = YUV + i*yuv_frame_size;
+		if((i+1)<frame_number)
+			posix_madvise((void*)(frame+yuv_frame_size), yuv_frame_size, POSIX_MADV_WILLNEED);
+		
+		// wait until the buffer of frame i-2 is written
+		pthread_mutex_lock(&writer.mutex);
+		while((writer.converted-writer.written)>=2)
+			pthread_cond_wait(&writer.cond, &writer.mutex);
+		pthread_mutex_unlock(&writer.mutex);
+		
+		struct timespec conversion_start;
+		clock_gettime(CLOCK_MONOTONIC, &conversion_start);
+		yuv420_rgb24(width, height, frame, frame+y_size, frame+y_size+uv_size, width, (width+1)/2, 
+			writer.buffers[i%2], width*3, yuv_type);
+		conversion_time += elapsed_seconds(&conversion_start);
+		
+		pthread_mutex_lock(&writer.mutex);
+		writer.converted++;
+		pthread_cond_broadcast(&writer.cond);
+		pthread_mutex_unlock(&writer.mutex);
+	}
+	
+	pthread_mutex_lock(&writer.mutex);
+	writer.done = 1;
+	pthread_cond_broadcast(&writer.cond);
+	pthread_mutex_unlock(&writer.mutex);
+	pthread_join(writer_thread, NULL);
+	const double total_time = elapsed_seconds(&start);
+	
+	printf("Converted %u frames in %f sec (%f fps), conversion time : %f sec\n", 
+		frame_number, total_time, frame_number/total_time, conversion_time);
+	
+	const int error = writer.error;
+	if(error)
+		fprintf(stderr, "Error writing rgb sequence: %s\n", strerror(error));
+	pthread_cond_destroy(&writer.cond);
+	pthread_mutex_destroy(&writer.mutex);
+	free(writer.buffers[0]);
+	free(writer.buffers[1]);
+	fclose(writer.fp);
+	munmap((void*)YUV, file_size);
+	return error ? 5 : 0;
+}
+
 // equivalent conversion functions for external libraries
 
 #if USE_FFMPEG
@@ -356,9 +545,20 @@ int main(int argc, char **argv)
 		printf("Or    : test yuv2rgb_nv21 <yuv image file> <image width> <image height> <output template filename>\n");
 		printf("Or    : test rgb2yuv <rgb24 binary ppm image file> <output template filename>\n");
 		printf("Or    : test rgba2yuv <rgb24 binary ppm image file> <output template filename>\n");
+		printf("Or    : test yuv2rgb_video <yuv sequence file> <image width> <image height> <output rgb24 raw file>\n");
 		return 1;
 	}
 	
+	if(strcmp(argv[1], "yuv2rgb_video")==0)
+	{
+		if(argc<6)
+		{
+			printf("Invalid argument number for yuv2rgb_video mode, call without argument to see usage.\n");
+			return 1;
+		}
+		return convertRawYUVSequence(argv[2], atoi(argv[3]), atoi(argv[4]), argv[5], YCBCR_601);
+	}
+	
 	const int iteration_number = 100;
 	printf("Time will be measured in each configuration for %d iterations...\n", iteration_number);
 	const YCbCrType yuv_format = YCBCR_601;
@@ -426,13 +626,13 @@ int main(int argc, char **argv)
 		U = YUV+width*height;
 		V = YUV+width*height+((width+1)/2)*((height+1)/2);
 		
-		// allocate aligned data
-		const size_t y_stride = width + (16-width%16)%16;
-		const size_t uv_stride = (mode==YUV2RGB) ? (width+1)/2 + (16-((width+1)/2)%16)%16 : y_stride;
-		const size_t rgb_stride = width*3 +(16-(3*width)%16)%16;
+		// allocate aligned data (64 bytes alignment, required by the avx512 aligned versions)
+		const size_t y_stride = width + (64-width%64)%64;
+		const size_t uv_stride = (mode==YUV2RGB) ? (width+1)/2 + (64-((width+1)/2)%64)%64 : y_stride;
+		const size_t rgb_stride = width*3 +(64-(3*width)%64)%64;
 	
 		const size_t y_size = y_stride*height, uv_size = uv_stride*((height+1)/2);
-		YUVa = _mm_malloc(y_size+2*uv_size, 16);
+		YUVa = aligned_malloc(y_size+2*uv_size, 64);
 		Ya = YUVa;
 		Ua = YUVa+y_size;
 		Va = YUVa+y_size+uv_size;
@@ -453,15 +653,33 @@ int main(int argc, char **argv)
 			}
 		}
 		
-		RGBa = _mm_malloc(rgb_stride*height, 16);
+		RGBa = aligned_malloc(rgb_stride*height, 64);
+		
+#ifdef __SSE2__
+		const int has_avx2 = yuv_rgb_cpu_simd()>=SIMD_AVX2;
+		const int has_avx512 = yuv_rgb_cpu_simd()>=SIMD_AVX512;
+#endif
 		
 		// test all versions
 		if(mode==YUV2RGB)
 		{
 			test_yuv2rgb(width, height, Y, U, V, width, (width+1)/2, RGB, width*3, yuv_format, 
 				out, "std", iteration_number, yuv420_rgb24_std);
+#ifdef __SSE2__
 			test_yuv2rgb(width, height, Y, U, V, width, (width+1)/2, RGB, width*3, yuv_format, 
 				out, "sse2_unaligned", iteration_number, yuv420_rgb24_sseu);
+			if(has_avx2)
+				test_yuv2rgb(width, height, Y, U, V, width, (width+1)/2, RGB, width*3, yuv_format, 
+					out, "avx2_unaligned", iteration_number, yuv420_rgb24_avx2u);
+			if(has_avx512)
+				test_yuv2rgb(width, height, Y, U, V, width, (width+1)/2, RGB, width*3, yuv_format, 
+					out, "avx512_unaligned", iteration_number, yuv420_rgb24_avx512u);
+#elif defined(__ARM_NEON)
+			test_yuv2rgb(width, height, Y, U, V, width, (width+1)/2, RGB, width*3, yuv_format, 
+				out, "neon", iteration_number, yuv420_rgb24_neon);
+#endif
+			test_yuv2rgb(width, height, Y, U, V, width, (width+1)/2, RGB, width*3, yuv_format, 
+				out, "auto_unaligned", iteration_number, yuv420_rgb24);
 #if USE_FFMPEG
 			test_yuv2rgb(width, height, Y, U, V, width, (width+1)/2, RGB, width*3, yuv_format, 
 				out, "ffmpeg_unaligned", iteration_number, yuv420_rgb24_ffmpeg);
@@ -470,8 +688,18 @@ int main(int argc, char **argv)
 			test_yuv2rgb(width, height, Y, U, V, width, (width+1)/2, RGB, width*3, yuv_format, 
 				out, "ipp_unaligned", iteration_number, yuv420_rgb24_ipp);
 #endif
+#ifdef __SSE2__
 			test_yuv2rgb(width, height, Ya, Ua, Va, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
 				out, "sse2_aligned", iteration_number, yuv420_rgb24_sse);
+			if(has_avx2)
+				test_yuv2rgb(width, height, Ya, Ua, Va, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
+					out, "avx2_aligned", iteration_number, yuv420_rgb24_avx2);
+			if(has_avx512)
+				test_yuv2rgb(width, height, Ya, Ua, Va, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
+					out, "avx512_aligned", iteration_number, yuv420_rgb24_avx512);
+#endif
+			test_yuv2rgb(width, height, Ya, Ua, Va, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
+				out, "auto_aligned", iteration_number, yuv420_rgb24);
 #if USE_FFMPEG
 			test_yuv2rgb(width, height, Ya, Ua, Va, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
 				out, "ffmpeg_aligned", iteration_number, yuv420_rgb24_ffmpeg);
@@ -485,19 +713,65 @@ int main(int argc, char **argv)
 		{
 			test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
 				out, "std", iteration_number, nv12_rgb24_std);
+#ifdef __SSE2__
 			test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
 				out, "sse2_unaligned", iteration_number, nv12_rgb24_sseu);
+			if(has_avx2)
+				test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
+					out, "avx2_unaligned", iteration_number, nv12_rgb24_avx2u);
+			if(has_avx512)
+				test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
+					out, "avx512_unaligned", iteration_number, nv12_rgb24_avx512u);
+#elif defined(__ARM_NEON)
+			test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
+				out, "neon", iteration_number, nv12_rgb24_neon);
+#endif
+			test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
+				out, "auto_unaligned", iteration_number, nv12_rgb24);
+#ifdef __SSE2__
 			test_yuvsp2rgb(width, height, Ya, Ua, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
 				out, "sse2_aligned", iteration_number, nv12_rgb24_sse);
+			if(has_avx2)
+				test_yuvsp2rgb(width, height, Ya, Ua, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
+					out, "avx2_aligned", iteration_number, nv12_rgb24_avx2);
+			if(has_avx512)
+				test_yuvsp2rgb(width, height, Ya, Ua, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
+					out, "avx512_aligned", iteration_number, nv12_rgb24_avx512);
+#endif
+			test_yuvsp2rgb(width, height, Ya, Ua, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
+				out, "auto_aligned", iteration_number, nv12_rgb24);
 		}
 		else if(mode==YUV2RGB_NV21)
 		{
 			test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
 				out, "std", iteration_number, nv21_rgb24_std);
+#ifdef __SSE2__
 			test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
 				out, "sse2_unaligned", iteration_number, nv21_rgb24_sseu);
+			if(has_avx2)
+				test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
+					out, "avx2_unaligned", iteration_number, nv21_rgb24_avx2u);
+			if(has_avx512)
+				test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
+					out, "avx512_unaligned", iteration_number, nv21_rgb24_avx512u);
+#elif defined(__ARM_NEON)
+			test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
+				out, "neon", iteration_number, nv21_rgb24_neon);
+#endif
+			test_yuvsp2rgb(width, height, Y, U, width, width, RGB, width*3, yuv_format, 
+				out, "auto_unaligned", iteration_number, nv21_rgb24);
+#ifdef __SSE2__
 			test_yuvsp2rgb(width, height, Ya, Ua, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
 				out, "sse2_aligned", iteration_number, nv21_rgb24_sse);
+			if(has_avx2)
+				test_yuvsp2rgb(width, height, Ya, Ua, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
+					out, "avx2_aligned", iteration_number, nv21_rgb24_avx2);
+			if(has_avx512)
+				test_yuvsp2rgb(width, height, Ya, Ua, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
+					out, "avx512_aligned", iteration_number, nv21_rgb24_avx512);
+#endif
+			test_yuvsp2rgb(width, height, Ya, Ua, y_stride, uv_stride, RGBa, rgb_stride, yuv_format, 
+				out, "auto_aligned", iteration_number, nv21_rgb24);
 		}
 	}
 	else if(mode==RGB2YUV)
@@ -522,29 +796,42 @@ int main(int argc, char **argv)
 		U = YUV+width*height;
 		V = YUV+width*height+((width+1)/2)*((height+1)/2);
 		
-		// allocate aligned data
-		const size_t y_stride = width + (16-width%16)%16,
-		uv_stride = (width+1)/2 + (16-((width+1)/2)%16)%16,
-		rgb_stride = width*3 +(16-(3*width)%16)%16;
+		// allocate aligned data (64 bytes alignment, required by the avx512 aligned versions)
+		const size_t y_stride = width + (64-width%64)%64,
+		uv_stride = (width+1)/2 + (64-((width+1)/2)%64)%64,
+		rgb_stride = width*3 +(64-(3*width)%64)%64;
 		
-		RGBa = _mm_malloc(rgb_stride*height, 16);
+		RGBa = aligned_malloc(rgb_stride*height, 64);
 		for(unsigned int i=0; i<height; ++i)
 		{
 			memcpy(RGBa+i*rgb_stride, RGB+i*width*3, width*3);
 		}
 		
 		const size_t y_size = y_stride*height, uv_size = uv_stride*((height+1)/2);
-		YUVa = _mm_malloc(y_size+2*uv_size, 16);
+		YUVa = aligned_malloc(y_size+2*uv_size, 64);
 		Ya = YUVa;
 		Ua = YUVa+y_size;
 		Va = YUVa+y_size+uv_size;
 
+#ifdef __SSE2__
+		const int has_avx512 = yuv_rgb_cpu_simd()>=SIMD_AVX512;
+#endif
 		
 		// test all versions
 		test_rgb2yuv(width, height, RGB, width*3, Y, U, V, width, (width+1)/2, yuv_format, 
 			out, "std", iteration_number, rgb24_yuv420_std);
+#ifdef __SSE2__
 		test_rgb2yuv(width, height, RGB, width*3, Y, U, V, width, (width+1)/2, yuv_format, 
 			out, "sse2_unaligned", iteration_number, rgb24_yuv420_sseu);
+		if(has_avx512)
+			test_rgb2yuv(width, height, RGB, width*3, Y, U, V, width, (width+1)/2, yuv_format, 
+				out, "avx512_unaligned", iteration_number, rgb24_yuv420_avx512u);
+#elif defined(__ARM_NEON)
+		test_rgb2yuv(width, height, RGB, width*3, Y, U, V, width, (width+1)/2, yuv_format, 
+			out, "neon", iteration_number, rgb24_yuv420_neon);
+#endif
+		test_rgb2yuv(width, height, RGB, width*3, Y, U, V, width, (width+1)/2, yuv_format, 
+			out, "auto_unaligned", iteration_number, rgb24_yuv420);
 #if USE_FFMPEG
 		test_rgb2yuv(width, height, RGB, width*3, Y, U, V, width, (width+1)/2, yuv_format, 
 			out, "ffmpeg_unaligned", iteration_number, rgb24_yuv420_ffmpeg);
@@ -553,8 +840,15 @@ int main(int argc, char **argv)
 		test_rgb2yuv(width, height, RGB, width*3, Y, U, V, width, (width+1)/2, yuv_format, 
 			out, "ipp_unaligned", iteration_number, rgb24_yuv420_ipp);
 #endif
+#ifdef __SSE2__
 		test_rgb2yuv(width, height, RGBa, rgb_stride, Ya, Ua, Va, y_stride, uv_stride, yuv_format, 
 			out, "sse2_aligned", iteration_number, rgb24_yuv420_sse);
+		if(has_avx512)
+			test_rgb2yuv(width, height, RGBa, rgb_stride, Ya, Ua, Va, y_stride, uv_stride, yuv_format, 
+				out, "avx512_aligned", iteration_number, rgb24_yuv420_avx512);
+#endif
+		test_rgb2yuv(width, height, RGBa, rgb_stride, Ya, Ua, Va, y_stride, uv_stride, yuv_format, 
+			out, "auto_aligned", iteration_number, rgb24_yuv420);
 #if USE_FFMPEG
 		test_rgb2yuv(width, height, RGBa, rgb_stride, Ya, Ua, Va, y_stride, uv_stride, yuv_format, 
 			out, "ffmpeg_aligned", iteration_number, rgb24_yuv420_ffmpeg);
@@ -590,14 +884,14 @@ int main(int argc, char **argv)
 		uv_stride = (width+1)/2 + (16-((width+1)/2)%16)%16,
 		rgba_stride = width*4 +(16-(4*width)%16)%16;
 		
-		RGBa = _mm_malloc(rgba_stride*height, 16);
+		RGBa = aligned_malloc(rgba_stride*height, 16);
 		for(unsigned int i=0; i<height; ++i)
 		{
 			memcpy(RGBa+i*rgba_stride, RGBA+i*width*4, width*4);
 		}
 		
 		const size_t y_size = y_stride*height, uv_size = uv_stride*((height+1)/2);
-		YUVa = _mm_malloc(y_size+2*uv_size, 16);
+		YUVa = aligned_malloc(y_size+2*uv_size, 16);
 		Ya = YUVa;
 		Ua = YUVa+y_size;
 		Va = YUVa+y_size+uv_size;
@@ -605,16 +899,25 @@ int main(int argc, char **argv)
 		// test all versions
 		test_rgb2yuv(width, height, RGBA, width*4, Y, U, V, width, (width+1)/2, yuv_format, 
 			out, "std", iteration_number, rgb32_yuv420_std);
+#ifdef __SSE2__
 		test_rgb2yuv(width, height, RGBA, width*4, Y, U, V, width, (width+1)/2, yuv_format, 
 			out, "sse2_unaligned", iteration_number, rgb32_yuv420_sseu);
 		test_rgb2yuv(width, height, RGBa, rgba_stride, Ya, Ua, Va, y_stride, uv_stride, yuv_format, 
 			out, "sse2_aligned", iteration_number, rgb32_yuv420_sse);
+#elif defined(__ARM_NEON)
+		test_rgb2yuv(width, height, RGBA, width*4, Y, U, V, width, (width+1)/2, yuv_format, 
+			out, "neon", iteration_number, rgb32_yuv420_neon);
+#endif
+		test_rgb2yuv(width, height, RGBA, width*4, Y, U, V, width, (width+1)/2, yuv_format, 
+			out, "auto_unaligned", iteration_number, rgb32_yuv420);
+		test_rgb2yuv(width, height, RGBa, rgba_stride, Ya, Ua, Va, y_stride, uv_stride, yuv_format, 
+			out, "auto_aligned", iteration_number, rgb32_yuv420);
 		
 		free(RGBA);
 	}
 	
-	_mm_free(RGBa);
-	_mm_free(YUVa);
+	free(RGBa);
+	free(YUVa);
 	free(RGB);
 	free(YUV);
 	
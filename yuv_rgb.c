@@ -1,11 +1,28 @@
 // Copyright 2016 Adrien Descamps
 // Distributed under BSD 3-Clause License
 
+#ifdef YUV_RGB_STATS
+// clock_gettime
+#define _POSIX_C_SOURCE 199309L
+#endif
+
 #include "yuv_rgb.h"
 
+#ifdef __SSE2__
 #include <x86intrin.h>
+#include <cpuid.h>
+#endif
+
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
 
 #include <stdio.h>
+#include <stdlib.h>
+
+#ifdef YUV_RGB_STATS
+#include <time.h>
+#endif
 
 
 uint8_t clamp(int16_t value)
@@ -96,12 +113,22 @@ typedef struct
 	uint8_t y_offset;    // YMin
 } YUV2RGBParam;
 
+// The (B-Y') and (R-Y') values are at most the difference between a saturated channel and the Y' of the 
+// pixel (see RGB2YUV_PIXEL_STD): the chroma factors are limited so that their products with them fit in 
+// signed 16 bits integers (as the simd implementations compute them), and the chroma values in 8 bits, 
+// without changing them when the rounded value is already small enough
+#define RGB2YUV_MAX_DIFFERENCE(F) \
+	((255-((FIXED_POINT_VALUE(F, 8)*255)>>8)) > (((256-FIXED_POINT_VALUE(F, 8))*255)>>8) ? \
+	(255-((FIXED_POINT_VALUE(F, 8)*255)>>8)) : (((256-FIXED_POINT_VALUE(F, 8))*255)>>8))
+#define RGB2YUV_CHROMA_FACTOR(value, F) \
+	(FIXED_POINT_VALUE(value, 8)*RGB2YUV_MAX_DIFFERENCE(F)<32768 ? FIXED_POINT_VALUE(value, 8) : 32767/RGB2YUV_MAX_DIFFERENCE(F))
+
 #define RGB2YUV_PARAM(Rf, Bf, YMin, YMax, CbCrRange) \
 {.r_factor=FIXED_POINT_VALUE(Rf, 8), \
 .g_factor=256-FIXED_POINT_VALUE(Rf, 8)-FIXED_POINT_VALUE(Bf, 8), \
 .b_factor=FIXED_POINT_VALUE(Bf, 8), \
-.cb_factor=FIXED_POINT_VALUE((CbCrRange/255.0)/(2.0*(1-Bf)), 8), \
-.cr_factor=FIXED_POINT_VALUE((CbCrRange/255.0)/(2.0*(1-Rf)), 8), \
+.cb_factor=RGB2YUV_CHROMA_FACTOR((CbCrRange/255.0)/(2.0*(1-Bf)), Bf), \
+.cr_factor=RGB2YUV_CHROMA_FACTOR((CbCrRange/255.0)/(2.0*(1-Rf)), Rf), \
 .y_factor=FIXED_POINT_VALUE((YMax-YMin)/255.0, 7), \
 .y_offset=YMin}
 
@@ -113,72 +140,253 @@ typedef struct
 .y_factor=FIXED_POINT_VALUE(255.0/(YMax-YMin), 7), \
 .y_offset=YMin}
 
-static const RGB2YUVParam RGB2YUV[3] = {
+static const RGB2YUVParam RGB2YUV[5] = {
 	// ITU-T T.871 (JPEG)
 	RGB2YUV_PARAM(0.299, 0.114, 0.0, 255.0, 255.0),
 	// ITU-R BT.601-7
 	RGB2YUV_PARAM(0.299, 0.114, 16.0, 235.0, 224.0),
 	// ITU-R BT.709-6
-	RGB2YUV_PARAM(0.2126, 0.0722, 16.0, 235.0, 224.0)
+	RGB2YUV_PARAM(0.2126, 0.0722, 16.0, 235.0, 224.0),
+	// ITU-R BT.709-6 full range
+	RGB2YUV_PARAM(0.2126, 0.0722, 0.0, 255.0, 255.0),
+	// ITU-R BT.2020-2
+	RGB2YUV_PARAM(0.2627, 0.0593, 16.0, 235.0, 224.0)
 };
 
-static const YUV2RGBParam YUV2RGB[3] = {
+static const YUV2RGBParam YUV2RGB[5] = {
 	// ITU-T T.871 (JPEG)
 	YUV2RGB_PARAM(0.299, 0.114, 0.0, 255.0, 255.0),
 	// ITU-R BT.601-7
 	YUV2RGB_PARAM(0.299, 0.114, 16.0, 235.0, 224.0),
 	// ITU-R BT.709-6
-	YUV2RGB_PARAM(0.2126, 0.0722, 16.0, 235.0, 224.0)
+	YUV2RGB_PARAM(0.2126, 0.0722, 16.0, 235.0, 224.0),
+	// ITU-R BT.709-6 full range
+	YUV2RGB_PARAM(0.2126, 0.0722, 0.0, 255.0, 255.0),
+	// ITU-R BT.2020-2
+	YUV2RGB_PARAM(0.2627, 0.0593, 16.0, 235.0, 224.0)
 };
 
+// Conversion context, for the matrices and ranges given at runtime
+struct YCbCrContext
+{
+	YUV2RGBParam yuv2rgb;
+	RGB2YUVParam rgb2yuv;
+};
 
-void rgb24_yuv420_std(
+// the fixed point factors must fit in their uint8_t fields
+static int fixed_point_fits(double value, int precision)
+{
+	return value>=0.0 && FIXED_POINT_VALUE(value, precision)<=255;
+}
+
+YCbCrContext *ycbcr_context_create(double r_factor, double b_factor, uint8_t y_min, uint8_t y_max, uint8_t cbcr_range)
+{
+	const double Rf = r_factor, Bf = b_factor, YMin = y_min, YMax = y_max, CbCrRange = cbcr_range;
+	if(!(Rf>0.0 && Bf>0.0 && (Rf+Bf)<1.0) || y_max<=y_min || cbcr_range==0)
+		return NULL;
+	
+	if(!fixed_point_fits(Rf, 8) || !fixed_point_fits(Bf, 8) || 
+		!fixed_point_fits((CbCrRange/255.0)/(2.0*(1-Bf)), 8) || !fixed_point_fits((CbCrRange/255.0)/(2.0*(1-Rf)), 8) || 
+		!fixed_point_fits((YMax-YMin)/255.0, 7) || 
+		!fixed_point_fits(255.0*(2.0*(1-Bf))/CbCrRange, 6) || !fixed_point_fits(255.0*(2.0*(1-Rf))/CbCrRange, 6) || 
+		!fixed_point_fits(Bf/(1.0-Bf-Rf)*255.0*(2.0*(1-Bf))/CbCrRange, 7) || 
+		!fixed_point_fits(Rf/(1.0-Bf-Rf)*255.0*(2.0*(1-Rf))/CbCrRange, 7) || 
+		!fixed_point_fits(255.0/(YMax-YMin), 7))
+		return NULL;
+	
+	YCbCrContext *context = malloc(sizeof(YCbCrContext));
+	if(!context)
+		return NULL;
+	
+	const RGB2YUVParam rgb2yuv = RGB2YUV_PARAM(Rf, Bf, YMin, YMax, CbCrRange);
+	const YUV2RGBParam yuv2rgb = YUV2RGB_PARAM(Rf, Bf, YMin, YMax, CbCrRange);
+	context->rgb2yuv = rgb2yuv;
+	context->yuv2rgb = yuv2rgb;
+	return context;
+}
+
+void ycbcr_context_destroy(YCbCrContext *context)
+{
+	free(context);
+}
+
+// For high bit depth input (see yuv420p10_rgb24), the yuv values are first converted to 14 bits (Y14, Cb14 
+// and Cr14, 64 times the 8 bits value), so that the offset values fit in signed 16 bits integers.
+// For 8 bits rgb, each term is computed with a 16 bits multiplication, keeping the high 16 bits of the product, 
+// which gives values with 5 bits of extra precision:
+// * Y' = ((2*(Y14-64*YMin))*[255/(64*(YMax-YMin))])>>16, with N=20
+// * R = (Y' + ((4*(Cr14-8192))*[255*(CrNorm)/(64*CrRange)])>>16 + 16)>>5, with N=19 for the chroma factors
+// * B and G are computed the same way, with the factors defined below
+// For 16 bits rgb, the values in [0:65535] are computed with 32 bits sums, with N=11:
+// * Y' = (Y14-64*YMin)*[65535/(64*(YMax-YMin))]
+// * R = (Y' + (Cr14-8192)*[65535*(CrNorm)/(64*CrRange)] + 1024)>>11
+// * B = (Y' + (Cb14-8192)*[65535*(CbNorm)/(64*CbRange)] + 1024)>>11
+// * G = (Y' - (Cr14-8192)*[Rf/Gf*65535*(CrNorm)/(64*CrRange)] - (Cb14-8192)*[Bf/Gf*65535*(CbNorm)/(64*CbRange)] + 1024)>>11
+// In both cases, N is the highest precision for which all factors fit in signed 16 bits integers.
+#define RGB24_14_Y_PRECISION 20
+#define RGB24_14_UV_PRECISION 19
+#define RGB24_14_SHIFT 5
+#define RGB48_14_PRECISION 11
+#define RGB48_14_SHIFT RGB48_14_PRECISION
+
+typedef struct
+{
+	int16_t y_factor;    // [Max/(64*(YMax-YMin))]
+	int16_t r_cr_factor; // [Max*(CrNorm)/(64*CrRange)]
+	int16_t g_cb_factor; // -[Bf/Gf*Max*(CbNorm)/(64*CbRange)]
+	int16_t g_cr_factor; // -[Rf/Gf*Max*(CrNorm)/(64*CrRange)]
+	int16_t b_cb_factor; // [Max*(CbNorm)/(64*CbRange)]
+	int16_t y_offset;    // 64*YMin
+} YUV2RGB14Param;
+
+#define YUV2RGB14_PARAM(Rf, Bf, YMin, YMax, CbCrRange, Max, NY, NUV) \
+{.y_factor=FIXED_POINT_VALUE(Max/(64.0*(YMax-YMin)), NY), \
+.r_cr_factor=FIXED_POINT_VALUE(Max*(2.0*(1-Rf))/(64.0*CbCrRange), NUV), \
+.g_cb_factor=-FIXED_POINT_VALUE(Bf/(1.0-Bf-Rf)*Max*(2.0*(1-Bf))/(64.0*CbCrRange), NUV), \
+.g_cr_factor=-FIXED_POINT_VALUE(Rf/(1.0-Bf-Rf)*Max*(2.0*(1-Rf))/(64.0*CbCrRange), NUV), \
+.b_cb_factor=FIXED_POINT_VALUE(Max*(2.0*(1-Bf))/(64.0*CbCrRange), NUV), \
+.y_offset=64*YMin}
+
+#define YUV2RGB14_RGB24_PARAM(Rf, Bf, YMin, YMax, CbCrRange) \
+	YUV2RGB14_PARAM(Rf, Bf, YMin, YMax, CbCrRange, 255.0, RGB24_14_Y_PRECISION, RGB24_14_UV_PRECISION)
+#define YUV2RGB14_RGB48_PARAM(Rf, Bf, YMin, YMax, CbCrRange) \
+	YUV2RGB14_PARAM(Rf, Bf, YMin, YMax, CbCrRange, 65535.0, RGB48_14_PRECISION, RGB48_14_PRECISION)
+
+static const YUV2RGB14Param YUV2RGB14_RGB24[5] = {
+	// ITU-T T.871 (JPEG)
+	YUV2RGB14_RGB24_PARAM(0.299, 0.114, 0.0, 255.0, 255.0),
+	// ITU-R BT.601-7
+	YUV2RGB14_RGB24_PARAM(0.299, 0.114, 16.0, 235.0, 224.0),
+	// ITU-R BT.709-6
+	YUV2RGB14_RGB24_PARAM(0.2126, 0.0722, 16.0, 235.0, 224.0),
+	// ITU-R BT.709-6 full range
+	YUV2RGB14_RGB24_PARAM(0.2126, 0.0722, 0.0, 255.0, 255.0),
+	// ITU-R BT.2020-2
+	YUV2RGB14_RGB24_PARAM(0.2627, 0.0593, 16.0, 235.0, 224.0)
+};
+
+static const YUV2RGB14Param YUV2RGB14_RGB48[5] = {
+	// ITU-T T.871 (JPEG)
+	YUV2RGB14_RGB48_PARAM(0.299, 0.114, 0.0, 255.0, 255.0),
+	// ITU-R BT.601-7
+	YUV2RGB14_RGB48_PARAM(0.299, 0.114, 16.0, 235.0, 224.0),
+	// ITU-R BT.709-6
+	YUV2RGB14_RGB48_PARAM(0.2126, 0.0722, 16.0, 235.0, 224.0),
+	// ITU-R BT.709-6 full range
+	YUV2RGB14_RGB48_PARAM(0.2126, 0.0722, 0.0, 255.0, 255.0),
+	// ITU-R BT.2020-2
+	YUV2RGB14_RGB48_PARAM(0.2627, 0.0593, 16.0, 235.0, 224.0)
+};
+
+// For the high precision rgb to yuv conversion (see yuv_rgb_set_precision), Y, Cb and Cr are computed directly 
+// from the r, g and b values, with N=15 bits factors and 32 bits sums:
+// * Y = (y_r*R + y_g*G + y_b*B + YMin*2^N + 2^(N-1))>>N
+// * Cb = (cb_r*sR + cb_g*sG + cb_b*sB + 128*2^(N+2) + 2^(N+1))>>(N+2), sR, sG and sB being the sums of the 
+//   four pixels of the chroma sample, and Cr the same way
+// The green factors are computed from the others, so that the factors of Y sum to [(YMax-YMin)/255] and the 
+// chroma factors to 0 (gray pixels have Cb=Cr=128 exactly).
+#define RGB2YUV15_PRECISION 15
+
+typedef struct
+{
+	int16_t y_r_factor;  // [Rf*(YMax-YMin)/255]
+	int16_t y_g_factor;  // [(YMax-YMin)/255]-y_r_factor-y_b_factor
+	int16_t y_b_factor;  // [Bf*(YMax-YMin)/255]
+	int16_t cb_r_factor; // -[Rf*CbRange/(255*CbNorm)]
+	int16_t cb_g_factor; // -cb_r_factor-cb_b_factor
+	int16_t cb_b_factor; // [CbRange/(255*2)]
+	int16_t cr_r_factor; // [CrRange/(255*2)]
+	int16_t cr_g_factor; // -cr_r_factor-cr_b_factor
+	int16_t cr_b_factor; // -[Bf*CrRange/(255*CrNorm)]
+	int16_t y_offset;    // YMin
+} RGB2YUV15Param;
+
+#define RGB2YUV15_PARAM(Rf, Bf, YMin, YMax, CbCrRange) \
+{.y_r_factor=FIXED_POINT_VALUE(Rf*(YMax-YMin)/255.0, RGB2YUV15_PRECISION), \
+.y_g_factor=FIXED_POINT_VALUE((YMax-YMin)/255.0, RGB2YUV15_PRECISION)- \
+	FIXED_POINT_VALUE(Rf*(YMax-YMin)/255.0, RGB2YUV15_PRECISION)-FIXED_POINT_VALUE(Bf*(YMax-YMin)/255.0, RGB2YUV15_PRECISION), \
+.y_b_factor=FIXED_POINT_VALUE(Bf*(YMax-YMin)/255.0, RGB2YUV15_PRECISION), \
+.cb_r_factor=-FIXED_POINT_VALUE(Rf*CbCrRange/(255.0*2.0*(1-Bf)), RGB2YUV15_PRECISION), \
+.cb_g_factor=FIXED_POINT_VALUE(Rf*CbCrRange/(255.0*2.0*(1-Bf)), RGB2YUV15_PRECISION)- \
+	FIXED_POINT_VALUE(CbCrRange/(255.0*2.0), RGB2YUV15_PRECISION), \
+.cb_b_factor=FIXED_POINT_VALUE(CbCrRange/(255.0*2.0), RGB2YUV15_PRECISION), \
+.cr_r_factor=FIXED_POINT_VALUE(CbCrRange/(255.0*2.0), RGB2YUV15_PRECISION), \
+.cr_g_factor=FIXED_POINT_VALUE(Bf*CbCrRange/(255.0*2.0*(1-Rf)), RGB2YUV15_PRECISION)- \
+	FIXED_POINT_VALUE(CbCrRange/(255.0*2.0), RGB2YUV15_PRECISION), \
+.cr_b_factor=-FIXED_POINT_VALUE(Bf*CbCrRange/(255.0*2.0*(1-Rf)), RGB2YUV15_PRECISION), \
+.y_offset=YMin}
+
+static const RGB2YUV15Param RGB2YUV15[5] = {
+	// ITU-T T.871 (JPEG)
+	RGB2YUV15_PARAM(0.299, 0.114, 0.0, 255.0, 255.0),
+	// ITU-R BT.601-7
+	RGB2YUV15_PARAM(0.299, 0.114, 16.0, 235.0, 224.0),
+	// ITU-R BT.709-6
+	RGB2YUV15_PARAM(0.2126, 0.0722, 16.0, 235.0, 224.0),
+	// ITU-R BT.709-6 full range
+	RGB2YUV15_PARAM(0.2126, 0.0722, 0.0, 255.0, 255.0),
+	// ITU-R BT.2020-2
+	RGB2YUV15_PARAM(0.2627, 0.0593, 16.0, 235.0, 224.0)
+};
+
+
+// The std functions process the image by blocks of 2x2 pixels, that share the same chroma values.
+// If width is odd, the last column is processed as the left half of a block, and if height is odd, 
+// the last row is processed as both rows of a block.
+
+// The other channel orders are generated from the same code, the positions of the channels in memory 
+// are given as R, G, B and A indices (A is unused for 24 bits formats).
+#define RGB24_POSITIONS 0, 1, 2, -1
+#define BGR24_POSITIONS 2, 1, 0, -1
+#define RGBA_POSITIONS 0, 1, 2, 3
+#define BGRA_POSITIONS 2, 1, 0, 3
+#define ARGB_POSITIONS 1, 2, 3, 0
+#define ABGR_POSITIONS 3, 2, 1, 0
+
+// compute Y of a pixel, and add its (B-Y') and (R-Y') values to the chroma sums
+#define RGB2YUV_PIXEL_STD(RGB_PTR, Y_PTR) \
+	y_tmp = (param->r_factor*(RGB_PTR)[0] + param->g_factor*(RGB_PTR)[1] + param->b_factor*(RGB_PTR)[2])>>8; \
+	u_tmp += (RGB_PTR)[2]-y_tmp; \
+	v_tmp += (RGB_PTR)[0]-y_tmp; \
+	*(Y_PTR)=((y_tmp*param->y_factor)>>7) + param->y_offset;
+
+// compute u and v from the sums of four pixels
+#define RGB2UV_STD \
+	u_ptr[0] = ((((u_tmp+2)>>2)*param->cb_factor)>>8) + 128; \
+	v_ptr[0] = ((((v_tmp+2)>>2)*param->cr_factor)>>8) + 128;
+
+// same as yuv420_rgb24_param_std
+static void rgb24_yuv420_param_std(
 	uint32_t width, uint32_t height, 
 	const uint8_t *RGB, uint32_t RGB_stride, 
 	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
-	YCbCrType yuv_type)
+	const RGB2YUVParam *rgb2yuv_param)
 {
-	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
+	const RGB2YUVParam param_copy = *rgb2yuv_param, *const param = &param_copy;
 	
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; y<height; y+=2)
 	{
+		const uint32_t y2 = (y+1)<height ? (y+1) : y;
 		const uint8_t *rgb_ptr1=RGB+y*RGB_stride,
-			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+			*rgb_ptr2=RGB+y2*RGB_stride;
 		
 		uint8_t *y_ptr1=Y+y*Y_stride,
-			*y_ptr2=Y+(y+1)*Y_stride,
+			*y_ptr2=Y+y2*Y_stride,
 			*u_ptr=U+(y/2)*UV_stride,
 			*v_ptr=V+(y/2)*UV_stride;
 		
-		for(x=0; x<(width-1); x+=2)
+		for(x=0; (x+1)<width; x+=2)
 		{
 			// compute yuv for the four pixels, u and v values are summed
 			uint8_t y_tmp;
-			int16_t u_tmp, v_tmp;
+			int16_t u_tmp=0, v_tmp=0;
 			
-			y_tmp = (param->r_factor*rgb_ptr1[0] + param->g_factor*rgb_ptr1[1] + param->b_factor*rgb_ptr1[2])>>8;
-			u_tmp = rgb_ptr1[2]-y_tmp;
-			v_tmp = rgb_ptr1[0]-y_tmp;
-			y_ptr1[0]=((y_tmp*param->y_factor)>>7) + param->y_offset;
-			
-			y_tmp = (param->r_factor*rgb_ptr1[3] + param->g_factor*rgb_ptr1[4] + param->b_factor*rgb_ptr1[5])>>8;
-			u_tmp += rgb_ptr1[5]-y_tmp;
-			v_tmp += rgb_ptr1[3]-y_tmp;
-			y_ptr1[1]=((y_tmp*param->y_factor)>>7) + param->y_offset;
-
-			y_tmp = (param->r_factor*rgb_ptr2[0] + param->g_factor*rgb_ptr2[1] + param->b_factor*rgb_ptr2[2])>>8;
-			u_tmp += rgb_ptr2[2]-y_tmp;
-			v_tmp += rgb_ptr2[0]-y_tmp;
-			y_ptr2[0]=((y_tmp*param->y_factor)>>7) + param->y_offset;
-			
-			y_tmp = (param->r_factor*rgb_ptr2[3] + param->g_factor*rgb_ptr2[4] + param->b_factor*rgb_ptr2[5])>>8;
-			u_tmp += rgb_ptr2[5]-y_tmp;
-			v_tmp += rgb_ptr2[3]-y_tmp;
-			y_ptr2[1]=((y_tmp*param->y_factor)>>7) + param->y_offset;
-
-			u_ptr[0] = (((u_tmp>>2)*param->cb_factor)>>8) + 128;
-			v_ptr[0] = (((v_tmp>>2)*param->cb_factor)>>8) + 128;
+			RGB2YUV_PIXEL_STD(rgb_ptr1, y_ptr1)
+			RGB2YUV_PIXEL_STD(rgb_ptr1+3, y_ptr1+1)
+			RGB2YUV_PIXEL_STD(rgb_ptr2, y_ptr2)
+			RGB2YUV_PIXEL_STD(rgb_ptr2+3, y_ptr2+1)
+			RGB2UV_STD
 			
 			rgb_ptr1 += 6;
 			rgb_ptr2 += 6;
@@ -187,9 +395,39 @@ void rgb24_yuv420_std(
 			u_ptr += 1;
 			v_ptr += 1;
 		}
+		if(x<width)
+		{
+			// last column, each pixel counts twice in the u and v sums
+			uint8_t y_tmp;
+			int16_t u_tmp=0, v_tmp=0;
+			
+			RGB2YUV_PIXEL_STD(rgb_ptr1, y_ptr1)
+			RGB2YUV_PIXEL_STD(rgb_ptr2, y_ptr2)
+			u_tmp *= 2;
+			v_tmp *= 2;
+			RGB2UV_STD
+		}
 	}
 }
 
+void rgb24_yuv420_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	rgb24_yuv420_param_std(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, &(RGB2YUV[yuv_type]));
+}
+
+void rgb24_yuv420_ctx_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	const YCbCrContext *context)
+{
+	rgb24_yuv420_param_std(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, &(context->rgb2yuv));
+}
+
 void rgb32_yuv420_std(
 	uint32_t width, uint32_t height, 
 	const uint8_t *RGBA, uint32_t RGBA_stride, 
@@ -199,44 +437,28 @@ void rgb32_yuv420_std(
 	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
 	
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; y<height; y+=2)
 	{
+		const uint32_t y2 = (y+1)<height ? (y+1) : y;
 		const uint8_t *rgb_ptr1=RGBA+y*RGBA_stride,
-			*rgb_ptr2=RGBA+(y+1)*RGBA_stride;
+			*rgb_ptr2=RGBA+y2*RGBA_stride;
 		
 		uint8_t *y_ptr1=Y+y*Y_stride,
-			*y_ptr2=Y+(y+1)*Y_stride,
+			*y_ptr2=Y+y2*Y_stride,
 			*u_ptr=U+(y/2)*UV_stride,
 			*v_ptr=V+(y/2)*UV_stride;
 		
-		for(x=0; x<(width-1); x+=2)
+		for(x=0; (x+1)<width; x+=2)
 		{
 			// compute yuv for the four pixels, u and v values are summed
 			uint8_t y_tmp;
-			int16_t u_tmp, v_tmp;
-			
-			y_tmp = (param->r_factor*rgb_ptr1[0] + param->g_factor*rgb_ptr1[1] + param->b_factor*rgb_ptr1[2])>>8;
-			u_tmp = rgb_ptr1[2]-y_tmp;
-			v_tmp = rgb_ptr1[0]-y_tmp;
-			y_ptr1[0]=((y_tmp*param->y_factor)>>7) + param->y_offset;
+			int16_t u_tmp=0, v_tmp=0;
 			
-			y_tmp = (param->r_factor*rgb_ptr1[4] + param->g_factor*rgb_ptr1[5] + param->b_factor*rgb_ptr1[6])>>8;
-			u_tmp += rgb_ptr1[6]-y_tmp;
-			v_tmp += rgb_ptr1[4]-y_tmp;
-			y_ptr1[1]=((y_tmp*param->y_factor)>>7) + param->y_offset;
-
-			y_tmp = (param->r_factor*rgb_ptr2[0] + param->g_factor*rgb_ptr2[1] + param->b_factor*rgb_ptr2[2])>>8;
-			u_tmp += rgb_ptr2[2]-y_tmp;
-			v_tmp += rgb_ptr2[0]-y_tmp;
-			y_ptr2[0]=((y_tmp*param->y_factor)>>7) + param->y_offset;
-			
-			y_tmp = (param->r_factor*rgb_ptr2[4] + param->g_factor*rgb_ptr2[5] + param->b_factor*rgb_ptr2[6])>>8;
-			u_tmp += rgb_ptr2[6]-y_tmp;
-			v_tmp += rgb_ptr2[4]-y_tmp;
-			y_ptr2[1]=((y_tmp*param->y_factor)>>7) + param->y_offset;
-
-			u_ptr[0] = (((u_tmp>>2)*param->cb_factor)>>8) + 128;
-			v_ptr[0] = (((v_tmp>>2)*param->cb_factor)>>8) + 128;
+			RGB2YUV_PIXEL_STD(rgb_ptr1, y_ptr1)
+			RGB2YUV_PIXEL_STD(rgb_ptr1+4, y_ptr1+1)
+			RGB2YUV_PIXEL_STD(rgb_ptr2, y_ptr2)
+			RGB2YUV_PIXEL_STD(rgb_ptr2+4, y_ptr2+1)
+			RGB2UV_STD
 			
 			rgb_ptr1 += 8;
 			rgb_ptr2 += 8;
@@ -245,60 +467,298 @@ void rgb32_yuv420_std(
 			u_ptr += 1;
 			v_ptr += 1;
 		}
+		if(x<width)
+		{
+			// last column, each pixel counts twice in the u and v sums
+			uint8_t y_tmp;
+			int16_t u_tmp=0, v_tmp=0;
+			
+			RGB2YUV_PIXEL_STD(rgb_ptr1, y_ptr1)
+			RGB2YUV_PIXEL_STD(rgb_ptr2, y_ptr2)
+			u_tmp *= 2;
+			v_tmp *= 2;
+			RGB2UV_STD
+		}
 	}
 }
 
+// same as RGB2YUV_PIXEL_STD, for any channel order
+#define RGB2YUV_PIXEL_ORDER_STD(RGB_PTR, Y_PTR, R_POS, G_POS, B_POS, A_POS) \
+	y_tmp = (param->r_factor*(RGB_PTR)[R_POS] + param->g_factor*(RGB_PTR)[G_POS] + param->b_factor*(RGB_PTR)[B_POS])>>8; \
+	u_tmp += (RGB_PTR)[B_POS]-y_tmp; \
+	v_tmp += (RGB_PTR)[R_POS]-y_tmp; \
+	*(Y_PTR)=((y_tmp*param->y_factor)>>7) + param->y_offset;
 
-void yuv420_rgb24_std(
+#define RGB_YUV420_STD_FUNCTION(NAME, PIXEL_SIZE, POSITIONS) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type) \
+{ \
+	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]); \
+	\
+	uint32_t x, y; \
+	for(y=0; y<height; y+=2) \
+	{ \
+		const uint32_t y2 = (y+1)<height ? (y+1) : y; \
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride, \
+			*rgb_ptr2=RGB+y2*RGB_stride; \
+		\
+		uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+y2*Y_stride, \
+			*u_ptr=U+(y/2)*UV_stride, \
+			*v_ptr=V+(y/2)*UV_stride; \
+		\
+		for(x=0; (x+1)<width; x+=2) \
+		{ \
+			uint8_t y_tmp; \
+			int16_t u_tmp=0, v_tmp=0; \
+			\
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr1, y_ptr1, POSITIONS) \
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr1+(PIXEL_SIZE), y_ptr1+1, POSITIONS) \
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr2, y_ptr2, POSITIONS) \
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr2+(PIXEL_SIZE), y_ptr2+1, POSITIONS) \
+			RGB2UV_STD \
+			\
+			rgb_ptr1 += 2*(PIXEL_SIZE); \
+			rgb_ptr2 += 2*(PIXEL_SIZE); \
+			y_ptr1 += 2; \
+			y_ptr2 += 2; \
+			u_ptr += 1; \
+			v_ptr += 1; \
+		} \
+		if(x<width) \
+		{ \
+			uint8_t y_tmp; \
+			int16_t u_tmp=0, v_tmp=0; \
+			\
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr1, y_ptr1, POSITIONS) \
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr2, y_ptr2, POSITIONS) \
+			u_tmp *= 2; \
+			v_tmp *= 2; \
+			RGB2UV_STD \
+		} \
+	} \
+}
+
+RGB_YUV420_STD_FUNCTION(bgr24_yuv420_std, 3, BGR24_POSITIONS)
+RGB_YUV420_STD_FUNCTION(bgra32_yuv420_std, 4, BGRA_POSITIONS)
+RGB_YUV420_STD_FUNCTION(argb32_yuv420_std, 4, ARGB_POSITIONS)
+RGB_YUV420_STD_FUNCTION(abgr32_yuv420_std, 4, ABGR_POSITIONS)
+
+// rgb to nv12 and nv21, U_INDEX and V_INDEX are the positions of u and v in the interleaved chroma plane
+// RGB2UV_STD writes through u_ptr and v_ptr, that point inside the interleaved plane
+#define RGB_NV_STD_FUNCTION(NAME, PIXEL_SIZE, POSITIONS, U_INDEX, V_INDEX) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type) \
+{ \
+	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]); \
+	\
+	uint32_t x, y; \
+	for(y=0; y<height; y+=2) \
+	{ \
+		const uint32_t y2 = (y+1)<height ? (y+1) : y; \
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride, \
+			*rgb_ptr2=RGB+y2*RGB_stride; \
+		\
+		uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+y2*Y_stride, \
+			*u_ptr=UV+(y/2)*UV_stride+(U_INDEX), \
+			*v_ptr=UV+(y/2)*UV_stride+(V_INDEX); \
+		\
+		for(x=0; (x+1)<width; x+=2) \
+		{ \
+			uint8_t y_tmp; \
+			int16_t u_tmp=0, v_tmp=0; \
+			\
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr1, y_ptr1, POSITIONS) \
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr1+(PIXEL_SIZE), y_ptr1+1, POSITIONS) \
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr2, y_ptr2, POSITIONS) \
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr2+(PIXEL_SIZE), y_ptr2+1, POSITIONS) \
+			RGB2UV_STD \
+			\
+			rgb_ptr1 += 2*(PIXEL_SIZE); \
+			rgb_ptr2 += 2*(PIXEL_SIZE); \
+			y_ptr1 += 2; \
+			y_ptr2 += 2; \
+			u_ptr += 2; \
+			v_ptr += 2; \
+		} \
+		if(x<width) \
+		{ \
+			uint8_t y_tmp; \
+			int16_t u_tmp=0, v_tmp=0; \
+			\
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr1, y_ptr1, POSITIONS) \
+			RGB2YUV_PIXEL_ORDER_STD(rgb_ptr2, y_ptr2, POSITIONS) \
+			u_tmp *= 2; \
+			v_tmp *= 2; \
+			RGB2UV_STD \
+		} \
+	} \
+}
+
+RGB_NV_STD_FUNCTION(rgb24_nv12_std, 3, RGB24_POSITIONS, 0, 1)
+RGB_NV_STD_FUNCTION(rgb24_nv21_std, 3, RGB24_POSITIONS, 1, 0)
+RGB_NV_STD_FUNCTION(rgb32_nv12_std, 4, RGBA_POSITIONS, 0, 1)
+RGB_NV_STD_FUNCTION(rgb32_nv21_std, 4, RGBA_POSITIONS, 1, 0)
+
+// rgb to yuv420p with a [1 2 1] horizontal chroma filter, for co-sited chroma samples
+// The chroma sample of columns 2x and 2x+1 is computed from the (B-Y') and (R-Y') sums over both lines of 
+// columns 2x-1, 2x (counted twice) and 2x+1, the pixels being repeated on the image borders.
+// compute Y' of a pixel, and its (B-Y') and (R-Y') values
+#define RGB2YUV_DIFF_STD(RGB_PTR, U_DIFF, V_DIFF) \
+	y_tmp = (param->r_factor*(RGB_PTR)[0] + param->g_factor*(RGB_PTR)[1] + param->b_factor*(RGB_PTR)[2])>>8; \
+	U_DIFF = (RGB_PTR)[2]-y_tmp; \
+	V_DIFF = (RGB_PTR)[0]-y_tmp;
+
+// save Y of the pixel computed by RGB2YUV_DIFF_STD
+#define SAVE_Y_STD(Y_PTR) \
+	*(Y_PTR)=((y_tmp*param->y_factor)>>7) + param->y_offset;
+
+// (B-Y') and (R-Y') sums of a column, over both lines
+#define RGB2YUV_COLUMN_STD(RGB_PTR1, RGB_PTR2, U_SUM, V_SUM) \
+	RGB2YUV_DIFF_STD(RGB_PTR1, U_SUM, V_SUM) \
+	RGB2YUV_DIFF_STD(RGB_PTR2, u_diff, v_diff) \
+	U_SUM += u_diff; \
+	V_SUM += v_diff;
+
+// same, also saving the Y values of both pixels
+#define RGB2YUV_COLUMN_Y_STD(RGB_PTR1, RGB_PTR2, Y_PTR1, Y_PTR2, U_SUM, V_SUM) \
+	RGB2YUV_DIFF_STD(RGB_PTR1, U_SUM, V_SUM) \
+	SAVE_Y_STD(Y_PTR1) \
+	RGB2YUV_DIFF_STD(RGB_PTR2, u_diff, v_diff) \
+	SAVE_Y_STD(Y_PTR2) \
+	U_SUM += u_diff; \
+	V_SUM += v_diff;
+
+// convert the columns from first (that must be even) to width-1, the column on the left of first is only 
+// read, for the chroma of the first column, so that the simd functions can use it for their last columns
+#define RGB_YUV420_121_STD_FUNCTION(NAME, PIXEL_SIZE) \
+static void NAME(uint32_t first, uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type) \
+{ \
+	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]); \
+	const uint32_t left = first>0 ? (PIXEL_SIZE) : 0; \
+	\
+	uint32_t x, y; \
+	for(y=0; y<height; y+=2) \
+	{ \
+		const uint32_t y2 = (y+1)<height ? (y+1) : y; \
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride+(PIXEL_SIZE)*first, \
+			*rgb_ptr2=RGB+y2*RGB_stride+(PIXEL_SIZE)*first; \
+		\
+		uint8_t *y_ptr1=Y+y*Y_stride+first, \
+			*y_ptr2=Y+y2*Y_stride+first, \
+			*u_ptr=U+(y/2)*UV_stride+first/2, \
+			*v_ptr=V+(y/2)*UV_stride+first/2; \
+		\
+		uint8_t y_tmp; \
+		int16_t u_left, v_left, u_tmp, v_tmp, u_right, v_right, u_diff, v_diff; \
+		RGB2YUV_COLUMN_STD(rgb_ptr1-left, rgb_ptr2-left, u_left, v_left) \
+		\
+		for(x=first; x<width; x+=2) \
+		{ \
+			RGB2YUV_COLUMN_Y_STD(rgb_ptr1, rgb_ptr2, y_ptr1, y_ptr2, u_tmp, v_tmp) \
+			if((x+1)<width) \
+			{ \
+				RGB2YUV_COLUMN_Y_STD(rgb_ptr1+(PIXEL_SIZE), rgb_ptr2+(PIXEL_SIZE), y_ptr1+1, y_ptr2+1, u_right, v_right) \
+			} \
+			else \
+			{ \
+				u_right = u_tmp; \
+				v_right = v_tmp; \
+			} \
+			\
+			u_ptr[0] = ((((u_left+2*u_tmp+u_right+4)>>3)*param->cb_factor)>>8) + 128; \
+			v_ptr[0] = ((((v_left+2*v_tmp+v_right+4)>>3)*param->cr_factor)>>8) + 128; \
+			u_left = u_right; \
+			v_left = v_right; \
+			\
+			rgb_ptr1 += 2*(PIXEL_SIZE); \
+			rgb_ptr2 += 2*(PIXEL_SIZE); \
+			y_ptr1 += 2; \
+			y_ptr2 += 2; \
+			u_ptr += 1; \
+			v_ptr += 1; \
+		} \
+	} \
+}
+
+RGB_YUV420_121_STD_FUNCTION(rgb24_yuv420_121_std, 3)
+RGB_YUV420_121_STD_FUNCTION(rgb32_yuv420_121_std, 4)
+
+#define RGB_YUV420_DOWNSAMPLING_STD_FUNCTION(NAME, BOX_FUNCTION, FILTER_121_FUNCTION) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type, ChromaDownsampling downsampling) \
+{ \
+	if(downsampling==CHROMA_121_COSITED) \
+		FILTER_121_FUNCTION(0, width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type); \
+	else \
+		BOX_FUNCTION(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type); \
+}
+
+RGB_YUV420_DOWNSAMPLING_STD_FUNCTION(rgb24_yuv420_downsampling_std, rgb24_yuv420_std, rgb24_yuv420_121_std)
+RGB_YUV420_DOWNSAMPLING_STD_FUNCTION(rgb32_yuv420_downsampling_std, rgb32_yuv420_std, rgb32_yuv420_121_std)
+
+// compute Cb Cr color offsets, common to four pixels
+#define UV2RGB_STD(U_VALUE, V_VALUE) \
+	int8_t u_tmp, v_tmp; \
+	u_tmp = (U_VALUE)-128; \
+	v_tmp = (V_VALUE)-128; \
+	\
+	int16_t b_cb_offset, r_cr_offset, g_cbcr_offset; \
+	b_cb_offset = (param->cb_factor*u_tmp)>>6; \
+	r_cr_offset = (param->cr_factor*v_tmp)>>6; \
+	g_cbcr_offset = (param->g_cb_factor*u_tmp + param->g_cr_factor*v_tmp)>>7; \
+	int16_t y_tmp;
+
+// compute rgb of a pixel, from its Y value and the color offsets
+#define Y2RGB_PIXEL_STD(Y_VALUE, RGB_PTR) \
+	y_tmp = (param->y_factor*((Y_VALUE)-param->y_offset))>>7; \
+	(RGB_PTR)[0] = clamp(y_tmp + r_cr_offset); \
+	(RGB_PTR)[1] = clamp(y_tmp - g_cbcr_offset); \
+	(RGB_PTR)[2] = clamp(y_tmp + b_cb_offset);
+
+// The conversions with a predefined color space and with a context share the same code, the parameters 
+// being given by a pointer. They are copied to a local variable, that the stores can not modify, so that 
+// the compiler can keep them (or the vectors broadcast from them) in registers for the whole image.
+static void yuv420_rgb24_param_std(
 	uint32_t width, uint32_t height, 
 	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
 	uint8_t *RGB, uint32_t RGB_stride, 
-	YCbCrType yuv_type)
+	const YUV2RGBParam *yuv2rgb_param)
 {
-	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	const YUV2RGBParam param_copy = *yuv2rgb_param, *const param = &param_copy;
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; y<height; y+=2)
 	{
+		const uint32_t y2 = (y+1)<height ? (y+1) : y;
 		const uint8_t *y_ptr1=Y+y*Y_stride,
-			*y_ptr2=Y+(y+1)*Y_stride,
+			*y_ptr2=Y+y2*Y_stride,
 			*u_ptr=U+(y/2)*UV_stride,
 			*v_ptr=V+(y/2)*UV_stride;
 		
 		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
-			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+			*rgb_ptr2=RGB+y2*RGB_stride;
 		
-		for(x=0; x<(width-1); x+=2)
+		for(x=0; (x+1)<width; x+=2)
 		{
-			int8_t u_tmp, v_tmp;
-			u_tmp = u_ptr[0]-128;
-			v_tmp = v_ptr[0]-128;
-			
-			//compute Cb Cr color offsets, common to four pixels
-			int16_t b_cb_offset, r_cr_offset, g_cbcr_offset;
-			b_cb_offset = (param->cb_factor*u_tmp)>>6;
-			r_cr_offset = (param->cr_factor*v_tmp)>>6;
-			g_cbcr_offset = (param->g_cb_factor*u_tmp + param->g_cr_factor*v_tmp)>>7;
-			
-			int16_t y_tmp;
-			y_tmp = (param->y_factor*(y_ptr1[0]-param->y_offset))>>7;
-			rgb_ptr1[0] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr1[1] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr1[2] = clamp(y_tmp + b_cb_offset);
-			
-			y_tmp = (param->y_factor*(y_ptr1[1]-param->y_offset))>>7;
-			rgb_ptr1[3] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr1[4] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr1[5] = clamp(y_tmp + b_cb_offset);
+			UV2RGB_STD(u_ptr[0], v_ptr[0])
 			
-			y_tmp = (param->y_factor*(y_ptr2[0]-param->y_offset))>>7;
-			rgb_ptr2[0] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr2[1] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr2[2] = clamp(y_tmp + b_cb_offset);
-			
-			y_tmp = (param->y_factor*(y_ptr2[1]-param->y_offset))>>7;
-			rgb_ptr2[3] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr2[4] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr2[5] = clamp(y_tmp + b_cb_offset);
+			Y2RGB_PIXEL_STD(y_ptr1[0], rgb_ptr1)
+			Y2RGB_PIXEL_STD(y_ptr1[1], rgb_ptr1+3)
+			Y2RGB_PIXEL_STD(y_ptr2[0], rgb_ptr2)
+			Y2RGB_PIXEL_STD(y_ptr2[1], rgb_ptr2+3)
 			
 			rgb_ptr1 += 6;
 			rgb_ptr2 += 6;
@@ -307,9 +767,35 @@ void yuv420_rgb24_std(
 			u_ptr += 1;
 			v_ptr += 1;
 		}
+		if(x<width)
+		{
+			// last column
+			UV2RGB_STD(u_ptr[0], v_ptr[0])
+			
+			Y2RGB_PIXEL_STD(y_ptr1[0], rgb_ptr1)
+			Y2RGB_PIXEL_STD(y_ptr2[0], rgb_ptr2)
+		}
 	}
 }
 
+void yuv420_rgb24_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	yuv420_rgb24_param_std(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, &(YUV2RGB[yuv_type]));
+}
+
+void yuv420_rgb24_ctx_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	const YCbCrContext *context)
+{
+	yuv420_rgb24_param_std(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, &(context->yuv2rgb));
+}
+
 void nv12_rgb24_std(
 	uint32_t width, uint32_t height, 
 	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
@@ -318,47 +804,24 @@ void nv12_rgb24_std(
 {
 	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; y<height; y+=2)
 	{
+		const uint32_t y2 = (y+1)<height ? (y+1) : y;
 		const uint8_t *y_ptr1=Y+y*Y_stride,
-			*y_ptr2=Y+(y+1)*Y_stride,
+			*y_ptr2=Y+y2*Y_stride,
 			*uv_ptr=UV+(y/2)*UV_stride;
 		
 		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
-			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+			*rgb_ptr2=RGB+y2*RGB_stride;
 		
-		for(x=0; x<(width-1); x+=2)
+		for(x=0; (x+1)<width; x+=2)
 		{
-			int8_t u_tmp, v_tmp;
-			u_tmp = uv_ptr[0]-128;
-			v_tmp = uv_ptr[1]-128;
-			
-			//compute Cb Cr color offsets, common to four pixels
-			int16_t b_cb_offset, r_cr_offset, g_cbcr_offset;
-			b_cb_offset = (param->cb_factor*u_tmp)>>6;
-			r_cr_offset = (param->cr_factor*v_tmp)>>6;
-			g_cbcr_offset = (param->g_cb_factor*u_tmp + param->g_cr_factor*v_tmp)>>7;
-			
-			int16_t y_tmp;
-			y_tmp = (param->y_factor*(y_ptr1[0]-param->y_offset))>>7;
-			rgb_ptr1[0] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr1[1] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr1[2] = clamp(y_tmp + b_cb_offset);
-			
-			y_tmp = (param->y_factor*(y_ptr1[1]-param->y_offset))>>7;
-			rgb_ptr1[3] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr1[4] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr1[5] = clamp(y_tmp + b_cb_offset);
-			
-			y_tmp = (param->y_factor*(y_ptr2[0]-param->y_offset))>>7;
-			rgb_ptr2[0] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr2[1] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr2[2] = clamp(y_tmp + b_cb_offset);
+			UV2RGB_STD(uv_ptr[0], uv_ptr[1])
 			
-			y_tmp = (param->y_factor*(y_ptr2[1]-param->y_offset))>>7;
-			rgb_ptr2[3] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr2[4] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr2[5] = clamp(y_tmp + b_cb_offset);
+			Y2RGB_PIXEL_STD(y_ptr1[0], rgb_ptr1)
+			Y2RGB_PIXEL_STD(y_ptr1[1], rgb_ptr1+3)
+			Y2RGB_PIXEL_STD(y_ptr2[0], rgb_ptr2)
+			Y2RGB_PIXEL_STD(y_ptr2[1], rgb_ptr2+3)
 			
 			rgb_ptr1 += 6;
 			rgb_ptr2 += 6;
@@ -366,6 +829,14 @@ void nv12_rgb24_std(
 			y_ptr2 += 2;
 			uv_ptr += 2;
 		}
+		if(x<width)
+		{
+			// last column
+			UV2RGB_STD(uv_ptr[0], uv_ptr[1])
+			
+			Y2RGB_PIXEL_STD(y_ptr1[0], rgb_ptr1)
+			Y2RGB_PIXEL_STD(y_ptr2[0], rgb_ptr2)
+		}
 	}
 }
 
@@ -377,47 +848,24 @@ void nv21_rgb24_std(
 {
 	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; y<height; y+=2)
 	{
+		const uint32_t y2 = (y+1)<height ? (y+1) : y;
 		const uint8_t *y_ptr1=Y+y*Y_stride,
-			*y_ptr2=Y+(y+1)*Y_stride,
+			*y_ptr2=Y+y2*Y_stride,
 			*uv_ptr=UV+(y/2)*UV_stride;
 		
 		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
-			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+			*rgb_ptr2=RGB+y2*RGB_stride;
 		
-		for(x=0; x<(width-1); x+=2)
+		for(x=0; (x+1)<width; x+=2)
 		{
-			int8_t u_tmp, v_tmp;
-			u_tmp = uv_ptr[1]-128;
-			v_tmp = uv_ptr[0]-128;
-			
-			//compute Cb Cr color offsets, common to four pixels
-			int16_t b_cb_offset, r_cr_offset, g_cbcr_offset;
-			b_cb_offset = (param->cb_factor*u_tmp)>>6;
-			r_cr_offset = (param->cr_factor*v_tmp)>>6;
-			g_cbcr_offset = (param->g_cb_factor*u_tmp + param->g_cr_factor*v_tmp)>>7;
-			
-			int16_t y_tmp;
-			y_tmp = (param->y_factor*(y_ptr1[0]-param->y_offset))>>7;
-			rgb_ptr1[0] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr1[1] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr1[2] = clamp(y_tmp + b_cb_offset);
-			
-			y_tmp = (param->y_factor*(y_ptr1[1]-param->y_offset))>>7;
-			rgb_ptr1[3] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr1[4] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr1[5] = clamp(y_tmp + b_cb_offset);
+			UV2RGB_STD(uv_ptr[1], uv_ptr[0])
 			
-			y_tmp = (param->y_factor*(y_ptr2[0]-param->y_offset))>>7;
-			rgb_ptr2[0] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr2[1] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr2[2] = clamp(y_tmp + b_cb_offset);
-			
-			y_tmp = (param->y_factor*(y_ptr2[1]-param->y_offset))>>7;
-			rgb_ptr2[3] = clamp(y_tmp + r_cr_offset);
-			rgb_ptr2[4] = clamp(y_tmp - g_cbcr_offset);
-			rgb_ptr2[5] = clamp(y_tmp + b_cb_offset);
+			Y2RGB_PIXEL_STD(y_ptr1[0], rgb_ptr1)
+			Y2RGB_PIXEL_STD(y_ptr1[1], rgb_ptr1+3)
+			Y2RGB_PIXEL_STD(y_ptr2[0], rgb_ptr2)
+			Y2RGB_PIXEL_STD(y_ptr2[1], rgb_ptr2+3)
 			
 			rgb_ptr1 += 6;
 			rgb_ptr2 += 6;
@@ -425,73 +873,1426 @@ void nv21_rgb24_std(
 			y_ptr2 += 2;
 			uv_ptr += 2;
 		}
+		if(x<width)
+		{
+			// last column
+			UV2RGB_STD(uv_ptr[1], uv_ptr[0])
+			
+			Y2RGB_PIXEL_STD(y_ptr1[0], rgb_ptr1)
+			Y2RGB_PIXEL_STD(y_ptr2[0], rgb_ptr2)
+		}
+	}
+}
+
+// Lookup table engine
+// For the cpus without simd (or with slow multiplications, as small microcontrollers), the _lut functions 
+// replace the multiplications of UV2RGB_STD and Y2RGB_PIXEL_STD by tables indexed by the Y, U and V values, 
+// and the clamp calls by a table indexed by the unclamped channel value, with exactly the same output as 
+// the std functions. They also convert the remaining columns and row of the simd functions.
+// The green offset terms are stored before their shift, (g_cb*u + g_cr*v)>>7 being computed from their sum.
+typedef struct
+{
+	int16_t y[256];    // (y_factor*(Y-y_offset))>>7
+	int16_t r_cr[256]; // (cr_factor*(V-128))>>6
+	int16_t b_cb[256]; // (cb_factor*(U-128))>>6
+	int16_t g_cb[256]; // g_cb_factor*(U-128)
+	int16_t g_cr[256]; // g_cr_factor*(V-128)
+	int ready;
+} YUV2RGBTable;
+
+// with the uint8_t factors of YUV2RGBParam, the unclamped channel values are in [-1020:1020]
+#define LUT_CLAMP_OFFSET 1024
+
+static uint8_t lut_clamp[2*LUT_CLAMP_OFFSET];
+static int lut_clamp_ready = 0;
+static YUV2RGBTable yuv2rgb_tables[5];
+
+// The tables are built at the first conversion with each YCbCrType. Several threads may build the same 
+// table at the same time, writing the same values, and the release store of the ready flag ensures that 
+// a thread that sees it set also sees the complete table.
+static const uint8_t *yuv2rgb_clamp_table(void)
+{
+	if(!__atomic_load_n(&lut_clamp_ready, __ATOMIC_ACQUIRE))
+	{
+		int i;
+		for(i=0; i<2*LUT_CLAMP_OFFSET; ++i)
+			lut_clamp[i] = clamp(i-LUT_CLAMP_OFFSET);
+		__atomic_store_n(&lut_clamp_ready, 1, __ATOMIC_RELEASE);
+	}
+	return lut_clamp+LUT_CLAMP_OFFSET;
+}
+
+static const YUV2RGBTable *yuv2rgb_table(YCbCrType yuv_type)
+{
+	YUV2RGBTable *const table = &(yuv2rgb_tables[yuv_type]);
+	if(!__atomic_load_n(&(table->ready), __ATOMIC_ACQUIRE))
+	{
+		const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+		int i;
+		for(i=0; i<256; ++i)
+		{
+			table->y[i] = (param->y_factor*(i-param->y_offset))>>7;
+			table->r_cr[i] = (param->cr_factor*(i-128))>>6;
+			table->b_cb[i] = (param->cb_factor*(i-128))>>6;
+			table->g_cb[i] = param->g_cb_factor*(i-128);
+			table->g_cr[i] = param->g_cr_factor*(i-128);
+		}
+		__atomic_store_n(&(table->ready), 1, __ATOMIC_RELEASE);
+	}
+	return table;
+}
+
+#define UV2RGB_LUT(U_VALUE, V_VALUE) \
+	const int b_cb_offset = table->b_cb[U_VALUE], \
+		r_cr_offset = table->r_cr[V_VALUE], \
+		g_cbcr_offset = (table->g_cb[U_VALUE] + table->g_cr[V_VALUE])>>7; \
+	int y_tmp;
+
+#define Y2RGB_PIXEL_LUT(Y_VALUE, RGB_PTR) \
+	y_tmp = table->y[Y_VALUE]; \
+	(RGB_PTR)[0] = clamp_table[y_tmp + r_cr_offset]; \
+	(RGB_PTR)[1] = clamp_table[y_tmp - g_cbcr_offset]; \
+	(RGB_PTR)[2] = clamp_table[y_tmp + b_cb_offset];
+
+#define YUV_RGB24_LUT_BODY(U, V, UV_STEP) \
+	const YUV2RGBTable *const table = yuv2rgb_table(yuv_type); \
+	const uint8_t *const clamp_table = yuv2rgb_clamp_table(); \
+	uint32_t x, y; \
+	for(y=0; y<height; y+=2) \
+	{ \
+		const uint32_t y2 = (y+1)<height ? (y+1) : y; \
+		const uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+y2*Y_stride, \
+			*u_ptr=(U)+(y/2)*UV_stride, \
+			*v_ptr=(V)+(y/2)*UV_stride; \
+		\
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride, \
+			*rgb_ptr2=RGB+y2*RGB_stride; \
+		\
+		for(x=0; (x+1)<width; x+=2) \
+		{ \
+			UV2RGB_LUT(u_ptr[0], v_ptr[0]) \
+			\
+			Y2RGB_PIXEL_LUT(y_ptr1[0], rgb_ptr1) \
+			Y2RGB_PIXEL_LUT(y_ptr1[1], rgb_ptr1+3) \
+			Y2RGB_PIXEL_LUT(y_ptr2[0], rgb_ptr2) \
+			Y2RGB_PIXEL_LUT(y_ptr2[1], rgb_ptr2+3) \
+			\
+			rgb_ptr1 += 6; \
+			rgb_ptr2 += 6; \
+			y_ptr1 += 2; \
+			y_ptr2 += 2; \
+			u_ptr += UV_STEP; \
+			v_ptr += UV_STEP; \
+		} \
+		if(x<width) \
+		{ \
+			/* last column */ \
+			UV2RGB_LUT(u_ptr[0], v_ptr[0]) \
+			\
+			Y2RGB_PIXEL_LUT(y_ptr1[0], rgb_ptr1) \
+			Y2RGB_PIXEL_LUT(y_ptr2[0], rgb_ptr2) \
+		} \
 	}
+
+void yuv420_rgb24_lut(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	YUV_RGB24_LUT_BODY(U, V, 1)
+}
+
+// U_INDEX and V_INDEX are the positions of u and v in the interleaved chroma plane
+#define NV_RGB24_LUT_FUNCTION(NAME, U_INDEX, V_INDEX) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	YUV_RGB24_LUT_BODY(UV+(U_INDEX), UV+(V_INDEX), 2) \
+}
+
+NV_RGB24_LUT_FUNCTION(nv12_rgb24_lut, 0, 1)
+NV_RGB24_LUT_FUNCTION(nv21_rgb24_lut, 1, 0)
+
+
+// 32 bits rgb outputs
+// compute rgb of a pixel, from its Y value and the color offsets, and set its alpha value
+#define Y2RGB32_PIXEL_STD(Y_VALUE, RGB_PTR, R_POS, G_POS, B_POS, A_POS) \
+	y_tmp = (param->y_factor*((Y_VALUE)-param->y_offset))>>7; \
+	(RGB_PTR)[R_POS] = clamp(y_tmp + r_cr_offset); \
+	(RGB_PTR)[G_POS] = clamp(y_tmp - g_cbcr_offset); \
+	(RGB_PTR)[B_POS] = clamp(y_tmp + b_cb_offset); \
+	(RGB_PTR)[A_POS] = alpha;
+
+#define YUV420_RGB32_STD_FUNCTION(NAME, POSITIONS) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGBA, uint32_t RGBA_stride, \
+	YCbCrType yuv_type, uint8_t alpha) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	uint32_t x, y; \
+	for(y=0; y<height; y+=2) \
+	{ \
+		const uint32_t y2 = (y+1)<height ? (y+1) : y; \
+		const uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+y2*Y_stride, \
+			*u_ptr=U+(y/2)*UV_stride, \
+			*v_ptr=V+(y/2)*UV_stride; \
+		\
+		uint8_t *rgb_ptr1=RGBA+y*RGBA_stride, \
+			*rgb_ptr2=RGBA+y2*RGBA_stride; \
+		\
+		for(x=0; (x+1)<width; x+=2) \
+		{ \
+			UV2RGB_STD(u_ptr[0], v_ptr[0]) \
+			\
+			Y2RGB32_PIXEL_STD(y_ptr1[0], rgb_ptr1, POSITIONS) \
+			Y2RGB32_PIXEL_STD(y_ptr1[1], rgb_ptr1+4, POSITIONS) \
+			Y2RGB32_PIXEL_STD(y_ptr2[0], rgb_ptr2, POSITIONS) \
+			Y2RGB32_PIXEL_STD(y_ptr2[1], rgb_ptr2+4, POSITIONS) \
+			\
+			rgb_ptr1 += 8; \
+			rgb_ptr2 += 8; \
+			y_ptr1 += 2; \
+			y_ptr2 += 2; \
+			u_ptr += 1; \
+			v_ptr += 1; \
+		} \
+		if(x<width) \
+		{ \
+			UV2RGB_STD(u_ptr[0], v_ptr[0]) \
+			\
+			Y2RGB32_PIXEL_STD(y_ptr1[0], rgb_ptr1, POSITIONS) \
+			Y2RGB32_PIXEL_STD(y_ptr2[0], rgb_ptr2, POSITIONS) \
+		} \
+	} \
+}
+
+// U_INDEX and V_INDEX are the positions of u and v in the interleaved chroma plane (0 and 1 for nv12)
+#define NV_RGB32_STD_FUNCTION(NAME, U_INDEX, V_INDEX, POSITIONS) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGBA, uint32_t RGBA_stride, \
+	YCbCrType yuv_type, uint8_t alpha) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	uint32_t x, y; \
+	for(y=0; y<height; y+=2) \
+	{ \
+		const uint32_t y2 = (y+1)<height ? (y+1) : y; \
+		const uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+y2*Y_stride, \
+			*uv_ptr=UV+(y/2)*UV_stride; \
+		\
+		uint8_t *rgb_ptr1=RGBA+y*RGBA_stride, \
+			*rgb_ptr2=RGBA+y2*RGBA_stride; \
+		\
+		for(x=0; (x+1)<width; x+=2) \
+		{ \
+			UV2RGB_STD(uv_ptr[U_INDEX], uv_ptr[V_INDEX]) \
+			\
+			Y2RGB32_PIXEL_STD(y_ptr1[0], rgb_ptr1, POSITIONS) \
+			Y2RGB32_PIXEL_STD(y_ptr1[1], rgb_ptr1+4, POSITIONS) \
+			Y2RGB32_PIXEL_STD(y_ptr2[0], rgb_ptr2, POSITIONS) \
+			Y2RGB32_PIXEL_STD(y_ptr2[1], rgb_ptr2+4, POSITIONS) \
+			\
+			rgb_ptr1 += 8; \
+			rgb_ptr2 += 8; \
+			y_ptr1 += 2; \
+			y_ptr2 += 2; \
+			uv_ptr += 2; \
+		} \
+		if(x<width) \
+		{ \
+			UV2RGB_STD(uv_ptr[U_INDEX], uv_ptr[V_INDEX]) \
+			\
+			Y2RGB32_PIXEL_STD(y_ptr1[0], rgb_ptr1, POSITIONS) \
+			Y2RGB32_PIXEL_STD(y_ptr2[0], rgb_ptr2, POSITIONS) \
+		} \
+	} \
 }
 
+YUV420_RGB32_STD_FUNCTION(yuv420_rgba32_std, RGBA_POSITIONS)
+YUV420_RGB32_STD_FUNCTION(yuv420_bgra32_std, BGRA_POSITIONS)
+YUV420_RGB32_STD_FUNCTION(yuv420_argb32_std, ARGB_POSITIONS)
+YUV420_RGB32_STD_FUNCTION(yuv420_abgr32_std, ABGR_POSITIONS)
+NV_RGB32_STD_FUNCTION(nv12_rgba32_std, 0, 1, RGBA_POSITIONS)
+NV_RGB32_STD_FUNCTION(nv12_bgra32_std, 0, 1, BGRA_POSITIONS)
+NV_RGB32_STD_FUNCTION(nv12_argb32_std, 0, 1, ARGB_POSITIONS)
+NV_RGB32_STD_FUNCTION(nv12_abgr32_std, 0, 1, ABGR_POSITIONS)
+NV_RGB32_STD_FUNCTION(nv21_rgba32_std, 1, 0, RGBA_POSITIONS)
+NV_RGB32_STD_FUNCTION(nv21_bgra32_std, 1, 0, BGRA_POSITIONS)
+NV_RGB32_STD_FUNCTION(nv21_argb32_std, 1, 0, ARGB_POSITIONS)
+NV_RGB32_STD_FUNCTION(nv21_abgr32_std, 1, 0, ABGR_POSITIONS)
+
+// Store policy
+// In the aligned simd functions, SAVE_SI128 (and SAVE_SI256, SAVE_SI512) is STREAM_SI128, that uses non 
+// temporal stores if stream_stores is set, and aligned regular stores otherwise. STORE_POLICY_BEGIN sets 
+// stream_stores from the store policy and the SIZE bytes of output, and STORE_POLICY_END ends the function 
+// with a store fence after non temporal stores.
+static StorePolicy store_policy = STORE_AUTO;
+
+// with statistics, the store policy of the last simd function of the thread, see STATS_CALL
+#ifdef YUV_RGB_STATS
+static __thread int stats_stream_stores = 0;
+#define STATS_STORE_POLICY(STREAM) stats_stream_stores = (STREAM);
+#else
+#define STATS_STORE_POLICY(STREAM)
+#endif
 
 #ifdef __SSE2__
 
-//see rgb.txt
-#define UNPACK_RGB24_32_STEP(RS1, RS2, RS3, RS4, RS5, RS6, RD1, RD2, RD3, RD4, RD5, RD6) \
-RD1 = _mm_unpacklo_epi8(RS1, RS4); \
-RD2 = _mm_unpackhi_epi8(RS1, RS4); \
-RD3 = _mm_unpacklo_epi8(RS2, RS5); \
-RD4 = _mm_unpackhi_epi8(RS2, RS5); \
-RD5 = _mm_unpacklo_epi8(RS3, RS6); \
-RD6 = _mm_unpackhi_epi8(RS3, RS6);
+// half of the last level cache, from the cpuid cache descriptors (leaf 4 on intel, 0x8000001D on amd), 
+// or 4MB if they are not available. Several threads may compute it at the same time, finding the same value.
+static size_t stream_threshold(void)
+{
+	static size_t threshold = 0;
+	size_t value = __atomic_load_n(&threshold, __ATOMIC_RELAXED);
+	if(value==0)
+	{
+		static const unsigned int leaves[2] = {4, 0x8000001D};
+		size_t cache_size = 0;
+		unsigned int l, i, eax, ebx, ecx, edx;
+		for(l=0; l<2 && cache_size==0; ++l)
+			for(i=0; i<16 && __get_cpuid_count(leaves[l], i, &eax, &ebx, &ecx, &edx) && (eax&0x1f)!=0; ++i)
+			{
+				/* ways * partitions * line size * sets, for data and unified caches */
+				const size_t size = (size_t)((ebx>>22)+1)*(((ebx>>12)&0x3ff)+1)*((ebx&0xfff)+1)*(ecx+1);
+				if((eax&0x1f)!=2 && size>cache_size)
+					cache_size = size;
+			}
+		value = cache_size>0 ? cache_size/2 : 4*1024*1024;
+		__atomic_store_n(&threshold, value, __ATOMIC_RELAXED);
+	}
+	return value;
+}
 
-#define RGB2YUV_16(R, G, B, Y, U, V) \
-Y = _mm_add_epi16(_mm_mullo_epi16(R, _mm_set1_epi16(param->r_factor)), \
-                  _mm_mullo_epi16(G, _mm_set1_epi16(param->g_factor))); \
-Y = _mm_add_epi16(Y, _mm_mullo_epi16(B, _mm_set1_epi16(param->b_factor))); \
-Y = _mm_srli_epi16(Y, 8); \
-U = _mm_mullo_epi16(_mm_sub_epi16(B, Y), _mm_set1_epi16(param->cb_factor)); \
-U = _mm_add_epi16(_mm_srai_epi16(U, 8), _mm_set1_epi16(128)); \
-V = _mm_mullo_epi16(_mm_sub_epi16(R, Y), _mm_set1_epi16(param->cr_factor)); \
-V = _mm_add_epi16(_mm_srai_epi16(V, 8), _mm_set1_epi16(128)); \
-Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset));
+static int use_stream_stores(size_t size)
+{
+	return store_policy==STORE_STREAM || (store_policy==STORE_AUTO && size>stream_threshold());
+}
 
-#define RGB2YUV_32 \
-	__m128i r_16, g_16, b_16; \
-	__m128i y1_16, y2_16, cb1_16, cb2_16, cr1_16, cr2_16, Y, cb, cr; \
-	__m128i tmp1, tmp2, tmp3, tmp4, tmp5, tmp6; \
-	__m128i rgb1 = LOAD_SI128((const __m128i*)(rgb_ptr1)), \
-		rgb2 = LOAD_SI128((const __m128i*)(rgb_ptr1+16)), \
-		rgb3 = LOAD_SI128((const __m128i*)(rgb_ptr1+32)), \
-		rgb4 = LOAD_SI128((const __m128i*)(rgb_ptr2)), \
-		rgb5 = LOAD_SI128((const __m128i*)(rgb_ptr2+16)), \
-		rgb6 = LOAD_SI128((const __m128i*)(rgb_ptr2+32)); \
-	/* unpack rgb24 data to r, g and b data in separate channels*/ \
-	/* see rgb.txt to get an idea of the algorithm, note that we only go to the next to last step*/ \
-	/* here, because averaging in horizontal direction is easier like this*/ \
-	/* The last step is applied further on the Y channel only*/ \
-	UNPACK_RGB24_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6) \
-	UNPACK_RGB24_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6) \
-	UNPACK_RGB24_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6) \
-	UNPACK_RGB24_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6) \
-	/* first compute Y', (B-Y') and (R-Y'), in 16bits values, for the first line */ \
-	/* Y is saved for each pixel, while only sums of (B-Y') and (R-Y') for pairs of adjacents pixels are saved*/ \
-	r_16 = _mm_unpacklo_epi8(rgb1, _mm_setzero_si128()); \
-	g_16 = _mm_unpacklo_epi8(rgb2, _mm_setzero_si128()); \
-	b_16 = _mm_unpacklo_epi8(rgb3, _mm_setzero_si128()); \
-	y1_16 = _mm_add_epi16(_mm_mullo_epi16(r_16, _mm_set1_epi16(param->r_factor)), \
-		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
-	y1_16 = _mm_add_epi16(y1_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
-	y1_16 = _mm_srli_epi16(y1_16, 8); \
-	cb1_16 = _mm_sub_epi16(b_16, y1_16); \
-	cr1_16 = _mm_sub_epi16(r_16, y1_16); \
-	r_16 = _mm_unpacklo_epi8(rgb4, _mm_setzero_si128()); \
-	g_16 = _mm_unpacklo_epi8(rgb5, _mm_setzero_si128()); \
-	b_16 = _mm_unpacklo_epi8(rgb6, _mm_setzero_si128()); \
-	y2_16 = _mm_add_epi16(_mm_mullo_epi16(r_16, _mm_set1_epi16(param->r_factor)), \
-		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
-	y2_16 = _mm_add_epi16(y2_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
-	y2_16 = _mm_srli_epi16(y2_16, 8); \
-	cb1_16 = _mm_add_epi16(cb1_16, _mm_sub_epi16(b_16, y2_16)); \
-	cr1_16 = _mm_add_epi16(cr1_16, _mm_sub_epi16(r_16, y2_16)); \
-	/* Rescale Y' to Y, pack it to 8bit values and save it */ \
-	y1_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y1_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
-	y2_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y2_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
+#define STORE_POLICY_BEGIN(SIZE) \
+	const int stream_stores = use_stream_stores(SIZE); \
+	STATS_STORE_POLICY(stream_stores)
+
+#define STORE_POLICY_END \
+	if(stream_stores) \
+		_mm_sfence();
+
+#define STREAM_SI128(ADDR, VALUE) (stream_stores ? _mm_stream_si128(ADDR, VALUE) : _mm_store_si128(ADDR, VALUE))
+#define STREAM_SI256(ADDR, VALUE) (stream_stores ? _mm256_stream_si256(ADDR, VALUE) : _mm256_store_si256(ADDR, VALUE))
+#define STREAM_SI512(ADDR, VALUE) (stream_stores ? _mm512_stream_si512(ADDR, VALUE) : _mm512_store_si512(ADDR, VALUE))
+
+#else
+
+#define STORE_POLICY_BEGIN(SIZE)
+#define STORE_POLICY_END
+
+#endif
+
+// yuv420p to rgb24 with chroma interpolation
+// Each row is converted by chunks of UPSAMPLE_CHUNK_SIZE pixels. The chroma samples of the chunk are first 
+// interpolated vertically, between the nearest chroma row (weight 3/4) and the next nearest one (weight 1/4), 
+// and kept as 16 bits sums (3*near+far), with one more sample on each side (repeated at the image borders).
+// They are then interpolated horizontally to one value per pixel: with centered chroma, pixels use 3/4 of 
+// their chroma sample and 1/4 of the closest neighbour, and with co-sited chroma, even pixels use their 
+// chroma sample and odd pixels the average of the two surrounding samples.
+// Finally, the row is converted with one chroma value per pixel.
+#define UPSAMPLE_CHUNK_SIZE 256
+
+static void chroma_sum_vertical_std(const uint8_t *near_ptr, const uint8_t *far_ptr, uint32_t count, int16_t *sum)
+{
+	uint32_t i;
+	for(i=0; i<count; ++i)
+		sum[i] = 3*near_ptr[i] + far_ptr[i];
+}
+
+// sum[-1] and sum[count] must be valid, 2*count values are saved in out
+static void chroma_upsample_horizontal_std(const int16_t *sum, uint32_t count, uint8_t *out, ChromaUpsampling upsampling)
+{
+	uint32_t i;
+	if(upsampling==CHROMA_BILINEAR_COSITED)
+	{
+		for(i=0; i<count; ++i)
+		{
+			out[2*i] = (sum[i]+2)>>2;
+			out[2*i+1] = (sum[i]+sum[i+1]+4)>>3;
+		}
+	}
+	else
+	{
+		const int16_t *left = sum-1;
+		for(i=0; i<count; ++i)
+		{
+			out[2*i] = (3*sum[i]+left[i]+8)>>4;
+			out[2*i+1] = (3*sum[i]+sum[i+1]+8)>>4;
+		}
+	}
+}
+
+// convert count pixels of a row, with one chroma value per pixel
+static void yuv444_rgb24_row_std(const YUV2RGBParam *param, 
+	const uint8_t *y_ptr, const uint8_t *u_ptr, const uint8_t *v_ptr, uint32_t count, uint8_t *rgb_ptr)
+{
+	uint32_t x;
+	for(x=0; x<count; ++x)
+	{
+		UV2RGB_STD(u_ptr[x], v_ptr[x])
+		Y2RGB_PIXEL_STD(y_ptr[x], rgb_ptr+3*x)
+	}
+}
+
+// NEAREST_FUNCTION converts without interpolation, SUM_VERTICAL, UPSAMPLE_HORIZONTAL and CONVERT_ROW have the 
+// same parameters as the std functions above
+#define YUV420_RGB24_UPSAMPLING_FUNCTION(DECL, NAME, NEAREST_FUNCTION, SUM_VERTICAL, UPSAMPLE_HORIZONTAL, CONVERT_ROW) \
+DECL void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type, ChromaUpsampling upsampling) \
+{ \
+	if(upsampling==CHROMA_NEAREST) \
+	{ \
+		NEAREST_FUNCTION(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type); \
+		return; \
+	} \
+	\
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride) \
+	const uint32_t uv_width = (width+1)/2, uv_height = (height+1)/2; \
+	int16_t u_sum[UPSAMPLE_CHUNK_SIZE/2+2], v_sum[UPSAMPLE_CHUNK_SIZE/2+2]; \
+	uint8_t u_row[UPSAMPLE_CHUNK_SIZE], v_row[UPSAMPLE_CHUNK_SIZE]; \
+	\
+	uint32_t x, y; \
+	for(y=0; y<height; ++y) \
+	{ \
+		const uint32_t near_row = y/2, \
+			far_row = (y%2) ? ((near_row+1)<uv_height ? near_row+1 : near_row) : (near_row>0 ? near_row-1 : 0); \
+		const uint8_t *y_ptr=Y+y*Y_stride, \
+			*u_near=U+near_row*UV_stride, \
+			*u_far=U+far_row*UV_stride, \
+			*v_near=V+near_row*UV_stride, \
+			*v_far=V+far_row*UV_stride; \
+		\
+		uint8_t *rgb_ptr=RGB+y*RGB_stride; \
+		\
+		for(x=0; x<width; x+=UPSAMPLE_CHUNK_SIZE) \
+		{ \
+			const uint32_t count = (width-x)<UPSAMPLE_CHUNK_SIZE ? (width-x) : UPSAMPLE_CHUNK_SIZE, \
+				uv_first = x/2, \
+				uv_count = (count+1)/2, \
+				uv_before = uv_first>0 ? uv_first-1 : 0, \
+				uv_after = (uv_first+uv_count)<uv_width ? uv_first+uv_count : uv_width-1; \
+			\
+			SUM_VERTICAL(u_near+uv_first, u_far+uv_first, uv_count, u_sum+1); \
+			SUM_VERTICAL(v_near+uv_first, v_far+uv_first, uv_count, v_sum+1); \
+			u_sum[0] = 3*u_near[uv_before] + u_far[uv_before]; \
+			v_sum[0] = 3*v_near[uv_before] + v_far[uv_before]; \
+			u_sum[uv_count+1] = 3*u_near[uv_after] + u_far[uv_after]; \
+			v_sum[uv_count+1] = 3*v_near[uv_after] + v_far[uv_after]; \
+			\
+			UPSAMPLE_HORIZONTAL(u_sum+1, uv_count, u_row, upsampling); \
+			UPSAMPLE_HORIZONTAL(v_sum+1, uv_count, v_row, upsampling); \
+			CONVERT_ROW(param, y_ptr+x, u_row, v_row, count, rgb_ptr+3*x); \
+		} \
+	} \
+	STORE_POLICY_END \
+}
+
+YUV420_RGB24_UPSAMPLING_FUNCTION(, yuv420_rgb24_upsampling_std, yuv420_rgb24_std, 
+	chroma_sum_vertical_std, chroma_upsample_horizontal_std, yuv444_rgb24_row_std)
+
+// 4:4:4 and packed 4:2:2 yuv to rgb
+void yuv444p_rgb24_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	uint32_t y;
+	for(y=0; y<height; ++y)
+		yuv444_rgb24_row_std(param, Y+y*Y_stride, U+y*UV_stride, V+y*UV_stride, width, RGB+y*RGB_stride);
+}
+
+// Y0_POS, U_POS, Y1_POS and V_POS are the positions of the values in each 4 bytes macropixel
+#define YUV422_RGB24_STD_FUNCTION(NAME, Y0_POS, U_POS, Y1_POS, V_POS) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *YUV, uint32_t YUV_stride, \
+	uint8_t *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	uint32_t x, y; \
+	for(y=0; y<height; ++y) \
+	{ \
+		const uint8_t *yuv_ptr=YUV+y*YUV_stride; \
+		uint8_t *rgb_ptr=RGB+y*RGB_stride; \
+		\
+		for(x=0; (x+1)<width; x+=2) \
+		{ \
+			UV2RGB_STD(yuv_ptr[U_POS], yuv_ptr[V_POS]) \
+			\
+			Y2RGB_PIXEL_STD(yuv_ptr[Y0_POS], rgb_ptr) \
+			Y2RGB_PIXEL_STD(yuv_ptr[Y1_POS], rgb_ptr+3) \
+			\
+			rgb_ptr += 6; \
+			yuv_ptr += 4; \
+		} \
+		if(x<width) \
+		{ \
+			/* last column */ \
+			UV2RGB_STD(yuv_ptr[U_POS], yuv_ptr[V_POS]) \
+			\
+			Y2RGB_PIXEL_STD(yuv_ptr[Y0_POS], rgb_ptr) \
+		} \
+	} \
+}
+
+YUV422_RGB24_STD_FUNCTION(yuyv_rgb24_std, 0, 1, 2, 3)
+YUV422_RGB24_STD_FUNCTION(uyvy_rgb24_std, 1, 0, 3, 2)
+
+// yuv420 to rgb with scaling
+// With integer factors, each rgb pixel gets the average of the yuv values of the factor_x*factor_y pixels it 
+// covers, each of them having the chroma values of its 2x2 block.
+static void yuv420_rgb24_box_std(const YUV2RGBParam *param, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t rgb_width, uint32_t rgb_height, uint32_t RGB_stride, 
+	uint32_t factor_x, uint32_t factor_y)
+{
+	const uint32_t count = factor_x*factor_y;
+	uint32_t x, y, i, j;
+	for(y=0; y<rgb_height; ++y)
+	{
+		uint8_t *rgb_ptr=RGB+y*RGB_stride;
+		for(x=0; x<rgb_width; ++x)
+		{
+			uint32_t y_sum=0, u_sum=0, v_sum=0;
+			for(j=y*factor_y; j<(y+1)*factor_y; ++j)
+			{
+				for(i=x*factor_x; i<(x+1)*factor_x; ++i)
+				{
+					y_sum += Y[j*Y_stride+i];
+					u_sum += U[(j/2)*UV_stride+i/2];
+					v_sum += V[(j/2)*UV_stride+i/2];
+				}
+			}
+			
+			const uint8_t y_value = (y_sum+count/2)/count, 
+				u_value = (u_sum+count/2)/count, 
+				v_value = (v_sum+count/2)/count;
+			UV2RGB_STD(u_value, v_value)
+			Y2RGB_PIXEL_STD(y_value, rgb_ptr+3*x)
+		}
+	}
+}
+
+// Otherwise, the yuv values are interpolated at the center of each rgb pixel (bilinear), the chroma samples 
+// being at the center of their 2x2 block, and the samples on the image borders being repeated.
+// Positions are in 16.16 fixed point, sample_position gives the two samples around POSITION and the 8 bits 
+// weight of the second one.
+static void sample_position(int64_t position, uint32_t size, uint32_t *first, uint32_t *second, uint32_t *weight)
+{
+	const int64_t max_position = (int64_t)(size-1)<<16;
+	if(position<0)
+		position = 0;
+	if(position>max_position)
+		position = max_position;
+	
+	*first = (uint32_t)(position>>16);
+	*second = (*first+1)<size ? *first+1 : *first;
+	*weight = (uint32_t)(position>>8)&255;
+}
+
+static uint8_t bilinear_sample(const uint8_t *plane, uint32_t stride, 
+	uint32_t x1, uint32_t x2, uint32_t weight_x, uint32_t y1, uint32_t y2, uint32_t weight_y)
+{
+	const uint32_t top = plane[y1*stride+x1]*(256-weight_x) + plane[y1*stride+x2]*weight_x,
+		bottom = plane[y2*stride+x1]*(256-weight_x) + plane[y2*stride+x2]*weight_x;
+	return (top*(256-weight_y) + bottom*weight_y + 32768)>>16;
+}
+
+static void yuv420_rgb24_bilinear_std(const YUV2RGBParam *param, uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t rgb_width, uint32_t rgb_height, uint32_t RGB_stride)
+{
+	const uint32_t uv_width = (width+1)/2, uv_height = (height+1)/2;
+	const int64_t step_x = ((int64_t)width<<16)/rgb_width, 
+		step_y = ((int64_t)height<<16)/rgb_height;
+	uint32_t x, y;
+	for(y=0; y<rgb_height; ++y)
+	{
+		const int64_t position_y = y*step_y + step_y/2 - 32768;
+		uint32_t y1, y2, weight_y, uv_y1, uv_y2, uv_weight_y;
+		sample_position(position_y, height, &y1, &y2, &weight_y);
+		sample_position(position_y/2 - 16384, uv_height, &uv_y1, &uv_y2, &uv_weight_y);
+		
+		uint8_t *rgb_ptr=RGB+y*RGB_stride;
+		for(x=0; x<rgb_width; ++x)
+		{
+			const int64_t position_x = x*step_x + step_x/2 - 32768;
+			uint32_t x1, x2, weight_x, uv_x1, uv_x2, uv_weight_x;
+			sample_position(position_x, width, &x1, &x2, &weight_x);
+			sample_position(position_x/2 - 16384, uv_width, &uv_x1, &uv_x2, &uv_weight_x);
+			
+			const uint8_t y_value = bilinear_sample(Y, Y_stride, x1, x2, weight_x, y1, y2, weight_y),
+				u_value = bilinear_sample(U, UV_stride, uv_x1, uv_x2, uv_weight_x, uv_y1, uv_y2, uv_weight_y),
+				v_value = bilinear_sample(V, UV_stride, uv_x1, uv_x2, uv_weight_x, uv_y1, uv_y2, uv_weight_y);
+			UV2RGB_STD(u_value, v_value)
+			Y2RGB_PIXEL_STD(y_value, rgb_ptr+3*x)
+		}
+	}
+}
+
+void yuv420_rgb24_resize_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t rgb_width, uint32_t rgb_height, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	if(rgb_width==0 || rgb_height==0)
+		return;
+	
+	if((width%rgb_width)==0 && (height%rgb_height)==0)
+		yuv420_rgb24_box_std(param, Y, U, V, Y_stride, UV_stride, RGB, rgb_width, rgb_height, RGB_stride, 
+			width/rgb_width, height/rgb_height);
+	else
+		yuv420_rgb24_bilinear_std(param, width, height, Y, U, V, Y_stride, UV_stride, 
+			RGB, rgb_width, rgb_height, RGB_stride);
+}
+
+// High bit depth yuv to rgb
+// yuv420p10 has 10 bits values in the low bits of 16 bits words (the other bits are ignored), while p010 and 
+// p016 have them in the high bits, so that both p010 and p016 are read as 16 bits values.
+// The strides are in bytes, ROW_PTR gives the row starting OFFSET bytes after PTR.
+#define P10_TO_14(VALUE) (((uint16_t)((VALUE)<<6))>>2)
+#define P016_TO_14(VALUE) ((VALUE)>>2)
+#define ROW_PTR(TYPE, PTR, OFFSET) ((TYPE*)((uintptr_t)(PTR)+(OFFSET)))
+#define RGB24_TYPE uint8_t
+#define RGB48_TYPE uint16_t
+
+static int32_t clamp_max(int32_t value, int32_t max_value)
+{
+	return value<0 ? 0 : (value>max_value ? max_value : value);
+}
+
+// compute the chroma terms (including the rounding constant), common to four pixels
+#define UV2RGB24_14_STD(U_VALUE, V_VALUE) \
+	const int32_t u_tmp = 4*((int32_t)(U_VALUE)-8192), \
+		v_tmp = 4*((int32_t)(V_VALUE)-8192); \
+	const int32_t r_tmp = ((param->r_cr_factor*v_tmp)>>16) + (1<<(RGB24_14_SHIFT-1)), \
+		g_tmp = ((param->g_cb_factor*u_tmp)>>16) + ((param->g_cr_factor*v_tmp)>>16) + (1<<(RGB24_14_SHIFT-1)), \
+		b_tmp = ((param->b_cb_factor*u_tmp)>>16) + (1<<(RGB24_14_SHIFT-1)); \
+	int32_t y_tmp;
+
+#define Y2RGB24_14_STD(Y_VALUE) ((param->y_factor*2*((int32_t)(Y_VALUE)-param->y_offset))>>16)
+
+#define UV2RGB48_14_STD(U_VALUE, V_VALUE) \
+	const int32_t u_tmp = (int32_t)(U_VALUE)-8192, \
+		v_tmp = (int32_t)(V_VALUE)-8192; \
+	const int32_t r_tmp = param->r_cr_factor*v_tmp + (1<<(RGB48_14_SHIFT-1)), \
+		g_tmp = param->g_cb_factor*u_tmp + param->g_cr_factor*v_tmp + (1<<(RGB48_14_SHIFT-1)), \
+		b_tmp = param->b_cb_factor*u_tmp + (1<<(RGB48_14_SHIFT-1)); \
+	int32_t y_tmp;
+
+#define Y2RGB48_14_STD(Y_VALUE) (param->y_factor*((int32_t)(Y_VALUE)-param->y_offset))
+
+// compute rgb of a pixel, from its Y' value and the chroma terms
+#define Y2RGB14_PIXEL_STD(Y_TERM, RGB_PTR) \
+	y_tmp = Y_TERM; \
+	(RGB_PTR)[0] = clamp_max((y_tmp + r_tmp)>>shift, max_value); \
+	(RGB_PTR)[1] = clamp_max((y_tmp + g_tmp)>>shift, max_value); \
+	(RGB_PTR)[2] = clamp_max((y_tmp + b_tmp)>>shift, max_value);
+
+// UV2RGB and Y2RGB compute the chroma and Y' terms, that are added and shifted by SHIFT bits
+// U and V are the first chroma row of each channel, and UV_STEP the distance between two chroma samples, 
+// of YUV_TYPE values (uint16_t, or uint8_t for the high precision 8 bits conversions)
+#define YUV16_RGB_STD_BODY(TO_14, YUV_TYPE, RGB_TYPE, PARAMS, UV2RGB, Y2RGB, SHIFT, U, V, UV_STEP) \
+	const YUV2RGB14Param *const param = &(PARAMS[yuv_type]); \
+	const int shift = SHIFT; \
+	const int32_t max_value = (1<<(8*sizeof(RGB_TYPE)))-1; \
+	uint32_t x, y; \
+	for(y=0; y<height; y+=2) \
+	{ \
+		const uint32_t y2 = (y+1)<height ? (y+1) : y; \
+		const YUV_TYPE *y_ptr1=ROW_PTR(const YUV_TYPE, Y, y*Y_stride), \
+			*y_ptr2=ROW_PTR(const YUV_TYPE, Y, y2*Y_stride), \
+			*u_ptr=ROW_PTR(const YUV_TYPE, U, (y/2)*UV_stride), \
+			*v_ptr=ROW_PTR(const YUV_TYPE, V, (y/2)*UV_stride); \
+		\
+		RGB_TYPE *rgb_ptr1=ROW_PTR(RGB_TYPE, RGB, y*RGB_stride), \
+			*rgb_ptr2=ROW_PTR(RGB_TYPE, RGB, y2*RGB_stride); \
+		\
+		for(x=0; (x+1)<width; x+=2) \
+		{ \
+			UV2RGB(TO_14(u_ptr[0]), TO_14(v_ptr[0])) \
+			\
+			Y2RGB14_PIXEL_STD(Y2RGB(TO_14(y_ptr1[0])), rgb_ptr1) \
+			Y2RGB14_PIXEL_STD(Y2RGB(TO_14(y_ptr1[1])), rgb_ptr1+3) \
+			Y2RGB14_PIXEL_STD(Y2RGB(TO_14(y_ptr2[0])), rgb_ptr2) \
+			Y2RGB14_PIXEL_STD(Y2RGB(TO_14(y_ptr2[1])), rgb_ptr2+3) \
+			\
+			rgb_ptr1 += 6; \
+			rgb_ptr2 += 6; \
+			y_ptr1 += 2; \
+			y_ptr2 += 2; \
+			u_ptr += UV_STEP; \
+			v_ptr += UV_STEP; \
+		} \
+		if(x<width) \
+		{ \
+			UV2RGB(TO_14(u_ptr[0]), TO_14(v_ptr[0])) \
+			\
+			Y2RGB14_PIXEL_STD(Y2RGB(TO_14(y_ptr1[0])), rgb_ptr1) \
+			Y2RGB14_PIXEL_STD(Y2RGB(TO_14(y_ptr2[0])), rgb_ptr2) \
+		} \
+	}
+
+#define YUV420P16_RGB_STD_FUNCTION(NAME, TO_14, YUV_TYPE, RGB_SIZE) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const YUV_TYPE *Y, const YUV_TYPE *U, const YUV_TYPE *V, uint32_t Y_stride, uint32_t UV_stride, \
+	RGB##RGB_SIZE##_TYPE *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	YUV16_RGB_STD_BODY(TO_14, YUV_TYPE, RGB##RGB_SIZE##_TYPE, YUV2RGB14_RGB##RGB_SIZE, UV2RGB##RGB_SIZE##_14_STD, \
+		Y2RGB##RGB_SIZE##_14_STD, RGB##RGB_SIZE##_14_SHIFT, U, V, 1) \
+}
+
+// U_INDEX and V_INDEX are the positions of u and v in the interleaved chroma plane
+#define P016_RGB_STD_FUNCTION(NAME, TO_14, YUV_TYPE, RGB_SIZE, U_INDEX, V_INDEX) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const YUV_TYPE *Y, const YUV_TYPE *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	RGB##RGB_SIZE##_TYPE *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	YUV16_RGB_STD_BODY(TO_14, YUV_TYPE, RGB##RGB_SIZE##_TYPE, YUV2RGB14_RGB##RGB_SIZE, UV2RGB##RGB_SIZE##_14_STD, \
+		Y2RGB##RGB_SIZE##_14_STD, RGB##RGB_SIZE##_14_SHIFT, UV+(U_INDEX), UV+(V_INDEX), 2) \
+}
+
+YUV420P16_RGB_STD_FUNCTION(yuv420p10_rgb24_std, P10_TO_14, uint16_t, 24)
+YUV420P16_RGB_STD_FUNCTION(yuv420p10_rgb48_std, P10_TO_14, uint16_t, 48)
+P016_RGB_STD_FUNCTION(p010_rgb24_std, P016_TO_14, uint16_t, 24, 0, 1)
+P016_RGB_STD_FUNCTION(p010_rgb48_std, P016_TO_14, uint16_t, 48, 0, 1)
+
+// High precision 8 bits conversions (see yuv_rgb_set_precision)
+// yuv to rgb24 uses the high bit depth code, with 8 bits values converted to 14 bits (64 times the value, 
+// which is exact), so that the factors have 19 and 20 bits of precision instead of 6 and 7 bits.
+#define U8_TO_14(VALUE) ((VALUE)<<6)
+
+YUV420P16_RGB_STD_FUNCTION(yuv420_rgb24_precise_std, U8_TO_14, uint8_t, 24)
+P016_RGB_STD_FUNCTION(nv12_rgb24_precise_std, U8_TO_14, uint8_t, 24, 0, 1)
+P016_RGB_STD_FUNCTION(nv21_rgb24_precise_std, U8_TO_14, uint8_t, 24, 1, 0)
+
+// rgb24 to yuv computes the values of each 2x2 block of pixels with the 15 bits factors (see RGB2YUV15Param), 
+// the pixels of the last column (and row) being used twice when width (height) is odd
+#define RGB2Y15_STD(RGB_PTR) \
+	((param->y_r_factor*(RGB_PTR)[0] + param->y_g_factor*(RGB_PTR)[1] + param->y_b_factor*(RGB_PTR)[2] + \
+	(param->y_offset<<RGB2YUV15_PRECISION) + (1<<(RGB2YUV15_PRECISION-1)))>>RGB2YUV15_PRECISION)
+
+#define RGB2UV15_STD(CHANNEL) \
+	clamp_max((param->CHANNEL##_r_factor*r_sum + param->CHANNEL##_g_factor*g_sum + param->CHANNEL##_b_factor*b_sum + \
+	(128<<(RGB2YUV15_PRECISION+2)) + (1<<(RGB2YUV15_PRECISION+1)))>>(RGB2YUV15_PRECISION+2), 255)
+
+#define RGB2YUV15_STD(RGB_PTR1, RGB_PTR2, RGB_PTR3, RGB_PTR4, Y_PTR1, Y_PTR2, Y_PTR3, Y_PTR4) \
+	{ \
+		const int32_t r_sum = (RGB_PTR1)[0] + (RGB_PTR2)[0] + (RGB_PTR3)[0] + (RGB_PTR4)[0], \
+			g_sum = (RGB_PTR1)[1] + (RGB_PTR2)[1] + (RGB_PTR3)[1] + (RGB_PTR4)[1], \
+			b_sum = (RGB_PTR1)[2] + (RGB_PTR2)[2] + (RGB_PTR3)[2] + (RGB_PTR4)[2]; \
+		*(Y_PTR1) = RGB2Y15_STD(RGB_PTR1); \
+		*(Y_PTR2) = RGB2Y15_STD(RGB_PTR2); \
+		*(Y_PTR3) = RGB2Y15_STD(RGB_PTR3); \
+		*(Y_PTR4) = RGB2Y15_STD(RGB_PTR4); \
+		u_ptr[0] = RGB2UV15_STD(cb); \
+		v_ptr[0] = RGB2UV15_STD(cr); \
+	}
+
+// U and V are the first chroma row of each channel, and UV_STEP the distance between two chroma samples
+#define RGB24_YUV15_STD_BODY(U, V, UV_STEP) \
+	const RGB2YUV15Param *const param = &(RGB2YUV15[yuv_type]); \
+	uint32_t x, y; \
+	for(y=0; y<height; y+=2) \
+	{ \
+		const uint32_t y2 = (y+1)<height ? (y+1) : y; \
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride, \
+			*rgb_ptr2=RGB+y2*RGB_stride; \
+		\
+		uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+y2*Y_stride, \
+			*u_ptr=(U)+(y/2)*UV_stride, \
+			*v_ptr=(V)+(y/2)*UV_stride; \
+		\
+		for(x=0; (x+1)<width; x+=2) \
+		{ \
+			RGB2YUV15_STD(rgb_ptr1, rgb_ptr1+3, rgb_ptr2, rgb_ptr2+3, y_ptr1, y_ptr1+1, y_ptr2, y_ptr2+1) \
+			\
+			rgb_ptr1 += 6; \
+			rgb_ptr2 += 6; \
+			y_ptr1 += 2; \
+			y_ptr2 += 2; \
+			u_ptr += UV_STEP; \
+			v_ptr += UV_STEP; \
+		} \
+		if(x<width) \
+			RGB2YUV15_STD(rgb_ptr1, rgb_ptr1, rgb_ptr2, rgb_ptr2, y_ptr1, y_ptr1, y_ptr2, y_ptr2) \
+	}
+
+void rgb24_yuv420_precise_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	RGB24_YUV15_STD_BODY(U, V, 1)
+}
+
+void rgb24_nv12_precise_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	RGB24_YUV15_STD_BODY(UV, UV+1, 2)
+}
+
+void rgb24_nv21_precise_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	RGB24_YUV15_STD_BODY(UV+1, UV, 2)
+}
+
+// Planar rgb outputs, as uint8, float or half float (IEEE binary16) values in separate planes
+// The float values are (value*scale[c] + bias[c]), value being the 8 bits value of channel c.
+// float_to_half rounds to the nearest even value, large values give infinity and NaN gives a quiet NaN.
+static uint16_t float_to_half(float value)
+{
+	union { float f; uint32_t u; } bits, magic;
+	bits.f = value;
+	const uint32_t sign = bits.u & 0x80000000u;
+	bits.u ^= sign;
+	
+	uint32_t half;
+	if(bits.u >= (143u<<23))
+	{
+		// overflow, infinity or NaN
+		half = bits.u > (255u<<23) ? 0x7e00 : 0x7c00;
+	}
+	else if(bits.u < (113u<<23))
+	{
+		// subnormal or zero, the float addition aligns and rounds the mantissa
+		magic.u = 126u<<23;
+		bits.f += magic.f;
+		half = bits.u - magic.u;
+	}
+	else
+	{
+		// normal, the exponent is rebiased and the mantissa rounded to 10 bits
+		half = (bits.u - (112u<<23) + 0xfff + ((bits.u>>13)&1)) >> 13;
+	}
+	return (uint16_t)(half | (sign>>16));
+}
+
+// STORE saves VALUE as the value of channel CHANNEL (0 for r, 1 for g and 2 for b) at PTR
+#define STORE_RGBP_STD(PTR, CHANNEL, VALUE) *(PTR) = (VALUE);
+#define STORE_RGBP_FLOAT_STD(PTR, CHANNEL, VALUE) *(PTR) = (VALUE)*scale[CHANNEL] + bias[CHANNEL];
+#define STORE_RGBP_HALF_STD(PTR, CHANNEL, VALUE) *(PTR) = float_to_half((VALUE)*scale[CHANNEL] + bias[CHANNEL]);
+
+// additional parameters and arguments of the conversion functions
+#define RGBP_PARAMS
+#define RGBP_ARGS
+#define RGBP_FLOAT_PARAMS , const float scale[3], const float bias[3]
+#define RGBP_FLOAT_ARGS , scale, bias
+
+#define Y2RGBP_PIXEL_STD(Y_VALUE, STORE, X) \
+	y_tmp = (param->y_factor*((Y_VALUE)-param->y_offset))>>7; \
+	STORE(r_ptr+(X), 0, clamp(y_tmp + r_cr_offset)) \
+	STORE(g_ptr+(X), 1, clamp(y_tmp - g_cbcr_offset)) \
+	STORE(b_ptr+(X), 2, clamp(y_tmp + b_cb_offset))
+
+// the strides are in bytes, the rows of the three planes use the same stride
+#define YUV420_RGBP_STD_FUNCTION(NAME, RGB_TYPE, STORE, EXTRA_PARAMS) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	RGB_TYPE *R, RGB_TYPE *G, RGB_TYPE *B, uint32_t RGB_stride, \
+	YCbCrType yuv_type EXTRA_PARAMS) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	uint32_t x, y; \
+	for(y=0; y<height; ++y) \
+	{ \
+		const uint8_t *y_ptr=Y+y*Y_stride, \
+			*u_ptr=U+(y/2)*UV_stride, \
+			*v_ptr=V+(y/2)*UV_stride; \
+		\
+		RGB_TYPE *r_ptr=ROW_PTR(RGB_TYPE, R, y*RGB_stride), \
+			*g_ptr=ROW_PTR(RGB_TYPE, G, y*RGB_stride), \
+			*b_ptr=ROW_PTR(RGB_TYPE, B, y*RGB_stride); \
+		\
+		for(x=0; (x+1)<width; x+=2) \
+		{ \
+			UV2RGB_STD(u_ptr[x/2], v_ptr[x/2]) \
+			\
+			Y2RGBP_PIXEL_STD(y_ptr[x], STORE, x) \
+			Y2RGBP_PIXEL_STD(y_ptr[x+1], STORE, x+1) \
+		} \
+		if(x<width) \
+		{ \
+			/* last column */ \
+			UV2RGB_STD(u_ptr[x/2], v_ptr[x/2]) \
+			\
+			Y2RGBP_PIXEL_STD(y_ptr[x], STORE, x) \
+		} \
+	} \
+}
+
+YUV420_RGBP_STD_FUNCTION(yuv420_rgbp_std, uint8_t, STORE_RGBP_STD, RGBP_PARAMS)
+YUV420_RGBP_STD_FUNCTION(yuv420_rgbp_float_std, float, STORE_RGBP_FLOAT_STD, RGBP_FLOAT_PARAMS)
+YUV420_RGBP_STD_FUNCTION(yuv420_rgbp_half_std, uint16_t, STORE_RGBP_HALF_STD, RGBP_FLOAT_PARAMS)
+
+
+
+// The simd functions convert blocks of BLOCK_SIZE columns of two rows, the remaining columns, and the last row 
+// if height is odd, are converted with the std function
+// PARAM is the last argument of STD_FUNCTION (yuv_type, or the parameters)
+#define YUV420_RGB24_PARAM_TAIL(STD_FUNCTION, BLOCK_SIZE, PARAM) \
+	{ \
+		const uint32_t done = width-width%(BLOCK_SIZE); \
+		if(done<width) \
+			STD_FUNCTION(width-done, height, Y+done, U+done/2, V+done/2, Y_stride, UV_stride, \
+				RGB+3*done, RGB_stride, PARAM); \
+		if((height%2) && done>0) \
+			STD_FUNCTION(done, 1, Y+(height-1)*Y_stride, U+(height/2)*UV_stride, V+(height/2)*UV_stride, \
+				Y_stride, UV_stride, RGB+(height-1)*RGB_stride, RGB_stride, PARAM); \
+	}
+
+#define YUV420_RGB24_TAIL(STD_FUNCTION, BLOCK_SIZE) YUV420_RGB24_PARAM_TAIL(STD_FUNCTION, BLOCK_SIZE, yuv_type)
+
+#define NV_RGB24_TAIL(STD_FUNCTION, BLOCK_SIZE) \
+	{ \
+		const uint32_t done = width-width%(BLOCK_SIZE); \
+		if(done<width) \
+			STD_FUNCTION(width-done, height, Y+done, UV+done, Y_stride, UV_stride, \
+				RGB+3*done, RGB_stride, yuv_type); \
+		if((height%2) && done>0) \
+			STD_FUNCTION(done, 1, Y+(height-1)*Y_stride, UV+(height/2)*UV_stride, \
+				Y_stride, UV_stride, RGB+(height-1)*RGB_stride, RGB_stride, yuv_type); \
+	}
+
+#define RGB_YUV420_PARAM_TAIL(STD_FUNCTION, BLOCK_SIZE, RGB_PTR, RGB_STRIDE, PIXEL_SIZE, PARAM) \
+	{ \
+		const uint32_t done = width-width%(BLOCK_SIZE); \
+		if(done<width) \
+			STD_FUNCTION(width-done, height, RGB_PTR+(PIXEL_SIZE)*done, RGB_STRIDE, \
+				Y+done, U+done/2, V+done/2, Y_stride, UV_stride, PARAM); \
+		if((height%2) && done>0) \
+			STD_FUNCTION(done, 1, RGB_PTR+(height-1)*RGB_STRIDE, RGB_STRIDE, \
+				Y+(height-1)*Y_stride, U+(height/2)*UV_stride, V+(height/2)*UV_stride, Y_stride, UV_stride, PARAM); \
+	}
+
+#define RGB_YUV420_TAIL(STD_FUNCTION, BLOCK_SIZE, RGB_PTR, RGB_STRIDE, PIXEL_SIZE) \
+	RGB_YUV420_PARAM_TAIL(STD_FUNCTION, BLOCK_SIZE, RGB_PTR, RGB_STRIDE, PIXEL_SIZE, yuv_type)
+
+#define RGB_NV_TAIL(STD_FUNCTION, BLOCK_SIZE, RGB_PTR, RGB_STRIDE, PIXEL_SIZE) \
+	{ \
+		const uint32_t done = width-width%(BLOCK_SIZE); \
+		if(done<width) \
+			STD_FUNCTION(width-done, height, RGB_PTR+(PIXEL_SIZE)*done, RGB_STRIDE, \
+				Y+done, UV+done, Y_stride, UV_stride, yuv_type); \
+		if((height%2) && done>0) \
+			STD_FUNCTION(done, 1, RGB_PTR+(height-1)*RGB_STRIDE, RGB_STRIDE, \
+				Y+(height-1)*Y_stride, UV+(height/2)*UV_stride, Y_stride, UV_stride, yuv_type); \
+	}
+
+#define YUV420_RGB32_TAIL(STD_FUNCTION, BLOCK_SIZE) \
+	{ \
+		const uint32_t done = width-width%(BLOCK_SIZE); \
+		if(done<width) \
+			STD_FUNCTION(width-done, height, Y+done, U+done/2, V+done/2, Y_stride, UV_stride, \
+				RGBA+4*done, RGBA_stride, yuv_type, alpha); \
+		if((height%2) && done>0) \
+			STD_FUNCTION(done, 1, Y+(height-1)*Y_stride, U+(height/2)*UV_stride, V+(height/2)*UV_stride, \
+				Y_stride, UV_stride, RGBA+(height-1)*RGBA_stride, RGBA_stride, yuv_type, alpha); \
+	}
+
+#define NV_RGB32_TAIL(STD_FUNCTION, BLOCK_SIZE) \
+	{ \
+		const uint32_t done = width-width%(BLOCK_SIZE); \
+		if(done<width) \
+			STD_FUNCTION(width-done, height, Y+done, UV+done, Y_stride, UV_stride, \
+				RGBA+4*done, RGBA_stride, yuv_type, alpha); \
+		if((height%2) && done>0) \
+			STD_FUNCTION(done, 1, Y+(height-1)*Y_stride, UV+(height/2)*UV_stride, \
+				Y_stride, UV_stride, RGBA+(height-1)*RGBA_stride, RGBA_stride, yuv_type, alpha); \
+	}
+
+// The simd functions with 32 bits rgb output are generated from the code converting a block of BLOCK_SIZE 
+// pixels of two lines (BLOCK), for each channel order and alignment.
+// DECL is the storage class and function attributes, and ALPHA_INIT declares the alpha vectors used by BLOCK.
+#define YUV420_RGB32_FUNCTION(DECL, NAME, STD_FUNCTION, BLOCK_SIZE, ALPHA_INIT, BLOCK) \
+DECL void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGBA, uint32_t RGBA_stride, \
+	YCbCrType yuv_type, uint8_t alpha) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	ALPHA_INIT \
+	STORE_POLICY_BEGIN((size_t)height*RGBA_stride) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height; y+=2) \
+	{ \
+		const uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+(y+1)*Y_stride, \
+			*u_ptr=U+(y/2)*UV_stride, \
+			*v_ptr=V+(y/2)*UV_stride; \
+		\
+		uint8_t *rgb_ptr1=RGBA+y*RGBA_stride, \
+			*rgb_ptr2=RGBA+(y+1)*RGBA_stride; \
+		\
+		for(x=0; (x+(BLOCK_SIZE)-1)<width; x+=(BLOCK_SIZE)) \
+		{ \
+			BLOCK \
+			\
+			y_ptr1+=(BLOCK_SIZE); \
+			y_ptr2+=(BLOCK_SIZE); \
+			u_ptr+=(BLOCK_SIZE)/2; \
+			v_ptr+=(BLOCK_SIZE)/2; \
+			rgb_ptr1+=4*(BLOCK_SIZE); \
+			rgb_ptr2+=4*(BLOCK_SIZE); \
+		} \
+	} \
+	YUV420_RGB32_TAIL(STD_FUNCTION, BLOCK_SIZE) \
+	STORE_POLICY_END \
+}
+
+#define NV_RGB32_FUNCTION(DECL, NAME, STD_FUNCTION, BLOCK_SIZE, ALPHA_INIT, BLOCK) \
+DECL void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGBA, uint32_t RGBA_stride, \
+	YCbCrType yuv_type, uint8_t alpha) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	ALPHA_INIT \
+	STORE_POLICY_BEGIN((size_t)height*RGBA_stride) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height; y+=2) \
+	{ \
+		const uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+(y+1)*Y_stride, \
+			*uv_ptr=UV+(y/2)*UV_stride; \
+		\
+		uint8_t *rgb_ptr1=RGBA+y*RGBA_stride, \
+			*rgb_ptr2=RGBA+(y+1)*RGBA_stride; \
+		\
+		for(x=0; (x+(BLOCK_SIZE)-1)<width; x+=(BLOCK_SIZE)) \
+		{ \
+			BLOCK \
+			\
+			y_ptr1+=(BLOCK_SIZE); \
+			y_ptr2+=(BLOCK_SIZE); \
+			uv_ptr+=(BLOCK_SIZE); \
+			rgb_ptr1+=4*(BLOCK_SIZE); \
+			rgb_ptr2+=4*(BLOCK_SIZE); \
+		} \
+	} \
+	NV_RGB32_TAIL(STD_FUNCTION, BLOCK_SIZE) \
+	STORE_POLICY_END \
+}
+
+// same for the high bit depth functions, with YUV_TYPE yuv values and RGB_TYPE rgb values (strides in bytes), 
+// and INIT declaring the conversion parameters used by BLOCK
+#define YUV420P16_RGB_TAIL(STD_FUNCTION, BLOCK_SIZE, YUV_TYPE, RGB_TYPE) \
+	{ \
+		const uint32_t done = width-width%(BLOCK_SIZE); \
+		if(done<width) \
+			STD_FUNCTION(width-done, height, Y+done, U+done/2, V+done/2, Y_stride, UV_stride, \
+				RGB+3*done, RGB_stride, yuv_type); \
+		if((height%2) && done>0) \
+			STD_FUNCTION(done, 1, ROW_PTR(const YUV_TYPE, Y, (height-1)*Y_stride), \
+				ROW_PTR(const YUV_TYPE, U, (height/2)*UV_stride), ROW_PTR(const YUV_TYPE, V, (height/2)*UV_stride), \
+				Y_stride, UV_stride, ROW_PTR(RGB_TYPE, RGB, (height-1)*RGB_stride), RGB_stride, yuv_type); \
+	}
+
+#define P016_RGB_TAIL(STD_FUNCTION, BLOCK_SIZE, YUV_TYPE, RGB_TYPE) \
+	{ \
+		const uint32_t done = width-width%(BLOCK_SIZE); \
+		if(done<width) \
+			STD_FUNCTION(width-done, height, Y+done, UV+done, Y_stride, UV_stride, \
+				RGB+3*done, RGB_stride, yuv_type); \
+		if((height%2) && done>0) \
+			STD_FUNCTION(done, 1, ROW_PTR(const YUV_TYPE, Y, (height-1)*Y_stride), \
+				ROW_PTR(const YUV_TYPE, UV, (height/2)*UV_stride), \
+				Y_stride, UV_stride, ROW_PTR(RGB_TYPE, RGB, (height-1)*RGB_stride), RGB_stride, yuv_type); \
+	}
+
+#define YUV420P16_RGB_FUNCTION(DECL, NAME, STD_FUNCTION, BLOCK_SIZE, YUV_TYPE, RGB_TYPE, INIT, BLOCK) \
+DECL void NAME( \
+	uint32_t width, uint32_t height, \
+	const YUV_TYPE *Y, const YUV_TYPE *U, const YUV_TYPE *V, uint32_t Y_stride, uint32_t UV_stride, \
+	RGB_TYPE *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	INIT \
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height; y+=2) \
+	{ \
+		const YUV_TYPE *y_ptr1=ROW_PTR(const YUV_TYPE, Y, y*Y_stride), \
+			*y_ptr2=ROW_PTR(const YUV_TYPE, Y, (y+1)*Y_stride), \
+			*u_ptr=ROW_PTR(const YUV_TYPE, U, (y/2)*UV_stride), \
+			*v_ptr=ROW_PTR(const YUV_TYPE, V, (y/2)*UV_stride); \
+		\
+		RGB_TYPE *rgb_ptr1=ROW_PTR(RGB_TYPE, RGB, y*RGB_stride), \
+			*rgb_ptr2=ROW_PTR(RGB_TYPE, RGB, (y+1)*RGB_stride); \
+		\
+		for(x=0; (x+(BLOCK_SIZE)-1)<width; x+=(BLOCK_SIZE)) \
+		{ \
+			BLOCK \
+			\
+			y_ptr1+=(BLOCK_SIZE); \
+			y_ptr2+=(BLOCK_SIZE); \
+			u_ptr+=(BLOCK_SIZE)/2; \
+			v_ptr+=(BLOCK_SIZE)/2; \
+			rgb_ptr1+=3*(BLOCK_SIZE); \
+			rgb_ptr2+=3*(BLOCK_SIZE); \
+		} \
+	} \
+	YUV420P16_RGB_TAIL(STD_FUNCTION, BLOCK_SIZE, YUV_TYPE, RGB_TYPE) \
+	STORE_POLICY_END \
+}
+
+#define P016_RGB_FUNCTION(DECL, NAME, STD_FUNCTION, BLOCK_SIZE, YUV_TYPE, RGB_TYPE, INIT, BLOCK) \
+DECL void NAME( \
+	uint32_t width, uint32_t height, \
+	const YUV_TYPE *Y, const YUV_TYPE *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	RGB_TYPE *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	INIT \
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height; y+=2) \
+	{ \
+		const YUV_TYPE *y_ptr1=ROW_PTR(const YUV_TYPE, Y, y*Y_stride), \
+			*y_ptr2=ROW_PTR(const YUV_TYPE, Y, (y+1)*Y_stride), \
+			*uv_ptr=ROW_PTR(const YUV_TYPE, UV, (y/2)*UV_stride); \
+		\
+		RGB_TYPE *rgb_ptr1=ROW_PTR(RGB_TYPE, RGB, y*RGB_stride), \
+			*rgb_ptr2=ROW_PTR(RGB_TYPE, RGB, (y+1)*RGB_stride); \
+		\
+		for(x=0; (x+(BLOCK_SIZE)-1)<width; x+=(BLOCK_SIZE)) \
+		{ \
+			BLOCK \
+			\
+			y_ptr1+=(BLOCK_SIZE); \
+			y_ptr2+=(BLOCK_SIZE); \
+			uv_ptr+=(BLOCK_SIZE); \
+			rgb_ptr1+=3*(BLOCK_SIZE); \
+			rgb_ptr2+=3*(BLOCK_SIZE); \
+		} \
+	} \
+	P016_RGB_TAIL(STD_FUNCTION, BLOCK_SIZE, YUV_TYPE, RGB_TYPE) \
+	STORE_POLICY_END \
+}
+
+// same for the planar rgb functions, with RGB_TYPE rgb values (strides in bytes), EXTRA_PARAMS and EXTRA_ARGS 
+// being the additional parameters and arguments (see RGBP_FLOAT_PARAMS and RGBP_FLOAT_ARGS)
+#define YUV420_RGBP_FUNCTION(DECL, NAME, STD_FUNCTION, BLOCK_SIZE, RGB_TYPE, EXTRA_PARAMS, EXTRA_ARGS, INIT, BLOCK) \
+DECL void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	RGB_TYPE *R, RGB_TYPE *G, RGB_TYPE *B, uint32_t RGB_stride, \
+	YCbCrType yuv_type EXTRA_PARAMS) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	INIT \
+	STORE_POLICY_BEGIN(3*(size_t)height*RGB_stride) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height; y+=2) \
+	{ \
+		const uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+(y+1)*Y_stride, \
+			*u_ptr=U+(y/2)*UV_stride, \
+			*v_ptr=V+(y/2)*UV_stride; \
+		\
+		RGB_TYPE *r_ptr1=ROW_PTR(RGB_TYPE, R, y*RGB_stride), \
+			*g_ptr1=ROW_PTR(RGB_TYPE, G, y*RGB_stride), \
+			*b_ptr1=ROW_PTR(RGB_TYPE, B, y*RGB_stride), \
+			*r_ptr2=ROW_PTR(RGB_TYPE, R, (y+1)*RGB_stride), \
+			*g_ptr2=ROW_PTR(RGB_TYPE, G, (y+1)*RGB_stride), \
+			*b_ptr2=ROW_PTR(RGB_TYPE, B, (y+1)*RGB_stride); \
+		\
+		for(x=0; (x+(BLOCK_SIZE)-1)<width; x+=(BLOCK_SIZE)) \
+		{ \
+			BLOCK \
+			\
+			y_ptr1+=(BLOCK_SIZE); \
+			y_ptr2+=(BLOCK_SIZE); \
+			u_ptr+=(BLOCK_SIZE)/2; \
+			v_ptr+=(BLOCK_SIZE)/2; \
+			r_ptr1+=(BLOCK_SIZE); \
+			g_ptr1+=(BLOCK_SIZE); \
+			b_ptr1+=(BLOCK_SIZE); \
+			r_ptr2+=(BLOCK_SIZE); \
+			g_ptr2+=(BLOCK_SIZE); \
+			b_ptr2+=(BLOCK_SIZE); \
+		} \
+	} \
+	\
+	const uint32_t done = width-width%(BLOCK_SIZE); \
+	if(done<width) \
+		STD_FUNCTION(width-done, height, Y+done, U+done/2, V+done/2, Y_stride, UV_stride, \
+			R+done, G+done, B+done, RGB_stride, yuv_type EXTRA_ARGS); \
+	if((height%2) && done>0) \
+		STD_FUNCTION(done, 1, Y+(height-1)*Y_stride, U+(height/2)*UV_stride, V+(height/2)*UV_stride, \
+			Y_stride, UV_stride, ROW_PTR(RGB_TYPE, R, (height-1)*RGB_stride), \
+			ROW_PTR(RGB_TYPE, G, (height-1)*RGB_stride), ROW_PTR(RGB_TYPE, B, (height-1)*RGB_stride), \
+			RGB_stride, yuv_type EXTRA_ARGS); \
+	STORE_POLICY_END \
+}
+
+// same for the rgb to yuv functions, BLOCK converts BLOCK_SIZE pixels of two lines, of PIXEL_SIZE bytes each, 
+// with the conversion parameters declared by INIT (RGB2YUV_INIT for the 8 bits factors)
+#define RGB2YUV_INIT const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
+
+#define RGB_YUV420_FUNCTION(DECL, NAME, STD_FUNCTION, BLOCK_SIZE, PIXEL_SIZE, INIT, BLOCK) \
+DECL void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type) \
+{ \
+	INIT \
+	STORE_POLICY_BEGIN((size_t)height*Y_stride*3/2) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height; y+=2) \
+	{ \
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride, \
+			*rgb_ptr2=RGB+(y+1)*RGB_stride; \
+		\
+		uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+(y+1)*Y_stride, \
+			*u_ptr=U+(y/2)*UV_stride, \
+			*v_ptr=V+(y/2)*UV_stride; \
+		\
+		for(x=0; (x+(BLOCK_SIZE)-1)<width; x+=(BLOCK_SIZE)) \
+		{ \
+			BLOCK \
+			\
+			rgb_ptr1+=(PIXEL_SIZE)*(BLOCK_SIZE); \
+			rgb_ptr2+=(PIXEL_SIZE)*(BLOCK_SIZE); \
+			y_ptr1+=(BLOCK_SIZE); \
+			y_ptr2+=(BLOCK_SIZE); \
+			u_ptr+=(BLOCK_SIZE)/2; \
+			v_ptr+=(BLOCK_SIZE)/2; \
+		} \
+	} \
+	RGB_YUV420_TAIL(STD_FUNCTION, BLOCK_SIZE, RGB, RGB_stride, PIXEL_SIZE) \
+	STORE_POLICY_END \
+}
+
+#define RGB_NV_FUNCTION(DECL, NAME, STD_FUNCTION, BLOCK_SIZE, PIXEL_SIZE, INIT, BLOCK) \
+DECL void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type) \
+{ \
+	INIT \
+	STORE_POLICY_BEGIN((size_t)height*Y_stride*3/2) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height; y+=2) \
+	{ \
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride, \
+			*rgb_ptr2=RGB+(y+1)*RGB_stride; \
+		\
+		uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+(y+1)*Y_stride, \
+			*uv_ptr=UV+(y/2)*UV_stride; \
+		\
+		for(x=0; (x+(BLOCK_SIZE)-1)<width; x+=(BLOCK_SIZE)) \
+		{ \
+			BLOCK \
+			\
+			rgb_ptr1+=(PIXEL_SIZE)*(BLOCK_SIZE); \
+			rgb_ptr2+=(PIXEL_SIZE)*(BLOCK_SIZE); \
+			y_ptr1+=(BLOCK_SIZE); \
+			y_ptr2+=(BLOCK_SIZE); \
+			uv_ptr+=(BLOCK_SIZE); \
+		} \
+	} \
+	RGB_NV_TAIL(STD_FUNCTION, BLOCK_SIZE, RGB, RGB_stride, PIXEL_SIZE) \
+	STORE_POLICY_END \
+}
+
+// same with the [1 2 1] chroma filter, FILTER_INIT declares and initializes the filter state at the beginning 
+// of each pair of lines, and the remaining pixels are converted with STD_FUNCTION (see RGB_YUV420_121_STD_FUNCTION)
+#define RGB_YUV420_121_FUNCTION(DECL, NAME, STD_FUNCTION, BLOCK_SIZE, PIXEL_SIZE, FILTER_INIT, BLOCK) \
+DECL void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type) \
+{ \
+	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]); \
+	const uint32_t done = width-width%(BLOCK_SIZE); \
+	STORE_POLICY_BEGIN((size_t)height*Y_stride*3/2) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height && done>0; y+=2) \
+	{ \
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride, \
+			*rgb_ptr2=RGB+(y+1)*RGB_stride; \
+		\
+		uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+(y+1)*Y_stride, \
+			*u_ptr=U+(y/2)*UV_stride, \
+			*v_ptr=V+(y/2)*UV_stride; \
+		\
+		FILTER_INIT \
+		for(x=0; (x+(BLOCK_SIZE)-1)<width; x+=(BLOCK_SIZE)) \
+		{ \
+			BLOCK \
+			\
+			rgb_ptr1+=(PIXEL_SIZE)*(BLOCK_SIZE); \
+			rgb_ptr2+=(PIXEL_SIZE)*(BLOCK_SIZE); \
+			y_ptr1+=(BLOCK_SIZE); \
+			y_ptr2+=(BLOCK_SIZE); \
+			u_ptr+=(BLOCK_SIZE)/2; \
+			v_ptr+=(BLOCK_SIZE)/2; \
+		} \
+	} \
+	if(done<width) \
+		STD_FUNCTION(done, width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type); \
+	if((height%2) && done>0) \
+		STD_FUNCTION(0, done, 1, RGB+(height-1)*RGB_stride, RGB_stride, \
+			Y+(height-1)*Y_stride, U+(height/2)*UV_stride, V+(height/2)*UV_stride, Y_stride, UV_stride, yuv_type); \
+	STORE_POLICY_END \
+}
+
+#ifdef __SSE2__
+
+//see rgb.txt
+#define UNPACK_RGB24_32_STEP(RS1, RS2, RS3, RS4, RS5, RS6, RD1, RD2, RD3, RD4, RD5, RD6) \
+RD1 = _mm_unpacklo_epi8(RS1, RS4); \
+RD2 = _mm_unpackhi_epi8(RS1, RS4); \
+RD3 = _mm_unpacklo_epi8(RS2, RS5); \
+RD4 = _mm_unpackhi_epi8(RS2, RS5); \
+RD5 = _mm_unpacklo_epi8(RS3, RS6); \
+RD6 = _mm_unpackhi_epi8(RS3, RS6);
+
+#define RGB2YUV_16(R, G, B, Y, U, V) \
+Y = _mm_add_epi16(_mm_mullo_epi16(R, _mm_set1_epi16(param->r_factor)), \
+                  _mm_mullo_epi16(G, _mm_set1_epi16(param->g_factor))); \
+Y = _mm_add_epi16(Y, _mm_mullo_epi16(B, _mm_set1_epi16(param->b_factor))); \
+Y = _mm_srli_epi16(Y, 8); \
+U = _mm_mullo_epi16(_mm_sub_epi16(B, Y), _mm_set1_epi16(param->cb_factor)); \
+U = _mm_add_epi16(_mm_srai_epi16(U, 8), _mm_set1_epi16(128)); \
+V = _mm_mullo_epi16(_mm_sub_epi16(R, Y), _mm_set1_epi16(param->cr_factor)); \
+V = _mm_add_epi16(_mm_srai_epi16(V, 8), _mm_set1_epi16(128)); \
+Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset));
+
+// The last unpack step produces one vector per channel (in memory order), for two groups of pixels. ORDER 
+// names the destination of each, so that rgb1/rgb4 always contain r, rgb2/rgb5 g and rgb3/rgb6 b: other 
+// channel orders are handled without any extra work.
+#define RGB24_UNPACK_ORDER rgb1, rgb2, rgb3, rgb4, rgb5, rgb6
+#define BGR24_UNPACK_ORDER rgb3, rgb2, rgb1, rgb6, rgb5, rgb4
+
+// save the 16 cb and cr values of CB and CR, to separate planes or interleaved (nv12 and nv21)
+#define SAVE_UV_PLANAR(CB, CR) \
+	SAVE_SI128((__m128i*)(u_ptr), CB); \
+	SAVE_SI128((__m128i*)(v_ptr), CR);
+
+#define SAVE_UV_NV12(CB, CR) \
+	SAVE_SI128((__m128i*)(uv_ptr), _mm_unpacklo_epi8(CB, CR)); \
+	SAVE_SI128((__m128i*)(uv_ptr+16), _mm_unpackhi_epi8(CB, CR));
+
+#define SAVE_UV_NV21(CB, CR) SAVE_UV_NV12(CR, CB)
+
+// The chroma filters compute the filtered (B-Y') and (R-Y') values of 8 chroma samples, from the sums over 
+// both lines of the even (CB_EVEN, CR_EVEN) and odd (CB_ODD, CR_ODD) pixels
+// average of the 2x2 pixels of each chroma sample, with rounding
+#define CHROMA_BOX_SSE(CB_EVEN, CB_ODD, CR_EVEN, CR_ODD, CB, CR) \
+	CB = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(CB_EVEN, CB_ODD), _mm_set1_epi16(2)), 2); \
+	CR = _mm_srai_epi16(_mm_add_epi16(_mm_add_epi16(CR_EVEN, CR_ODD), _mm_set1_epi16(2)), 2);
+
+// [1 2 1] filter centered on the even pixels, the odd pixel on the left of the first one is given in the 
+// first element of cb_left and cr_left, that are updated for the next pixels
+#define CHROMA_121_SSE(CB_EVEN, CB_ODD, CR_EVEN, CR_ODD, CB, CR) \
+	CB = _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(CB_EVEN, 1), CB_ODD), _mm_or_si128(_mm_slli_si128(CB_ODD, 2), cb_left)); \
+	CR = _mm_add_epi16(_mm_add_epi16(_mm_slli_epi16(CR_EVEN, 1), CR_ODD), _mm_or_si128(_mm_slli_si128(CR_ODD, 2), cr_left)); \
+	cb_left = _mm_srli_si128(CB_ODD, 14); \
+	cr_left = _mm_srli_si128(CR_ODD, 14); \
+	CB = _mm_srai_epi16(_mm_add_epi16(CB, _mm_set1_epi16(4)), 3); \
+	CR = _mm_srai_epi16(_mm_add_epi16(CR, _mm_set1_epi16(4)), 3);
+
+#define RGB2YUV_32 RGB2YUV_32_ORDER(RGB24_UNPACK_ORDER, CHROMA_BOX_SSE, SAVE_UV_PLANAR)
+
+#define RGB2YUV_32_ORDER(ORDER, FILTER, SAVE_UV) \
+	__m128i r_16, g_16, b_16; \
+	__m128i y1_16, y2_16, cb1_16, cb2_16, cr1_16, cr2_16, Y, cb, cr; \
+	__m128i cb_even, cb_odd, cr_even, cr_odd; \
+	__m128i tmp1, tmp2, tmp3, tmp4, tmp5, tmp6; \
+	__m128i rgb1 = LOAD_SI128((const __m128i*)(rgb_ptr1)), \
+		rgb2 = LOAD_SI128((const __m128i*)(rgb_ptr1+16)), \
+		rgb3 = LOAD_SI128((const __m128i*)(rgb_ptr1+32)), \
+		rgb4 = LOAD_SI128((const __m128i*)(rgb_ptr2)), \
+		rgb5 = LOAD_SI128((const __m128i*)(rgb_ptr2+16)), \
+		rgb6 = LOAD_SI128((const __m128i*)(rgb_ptr2+32)); \
+	/* unpack rgb24 data to r, g and b data in separate channels*/ \
+	/* see rgb.txt to get an idea of the algorithm, note that we only go to the next to last step*/ \
+	/* here, because averaging in horizontal direction is easier like this*/ \
+	/* The last step is applied further on the Y channel only*/ \
+	UNPACK_RGB24_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6) \
+	UNPACK_RGB24_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6) \
+	UNPACK_RGB24_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6) \
+	UNPACK_RGB24_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, ORDER) \
+	/* first compute Y', (B-Y') and (R-Y'), in 16bits values, for the first line */ \
+	/* Y is saved for each pixel, while only sums of (B-Y') and (R-Y') for pairs of adjacents pixels are saved*/ \
+	r_16 = _mm_unpacklo_epi8(rgb1, _mm_setzero_si128()); \
+	g_16 = _mm_unpacklo_epi8(rgb2, _mm_setzero_si128()); \
+	b_16 = _mm_unpacklo_epi8(rgb3, _mm_setzero_si128()); \
+	y1_16 = _mm_add_epi16(_mm_mullo_epi16(r_16, _mm_set1_epi16(param->r_factor)), \
+		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
+	y1_16 = _mm_add_epi16(y1_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
+	y1_16 = _mm_srli_epi16(y1_16, 8); \
+	cb_even = _mm_sub_epi16(b_16, y1_16); \
+	cr_even = _mm_sub_epi16(r_16, y1_16); \
+	r_16 = _mm_unpacklo_epi8(rgb4, _mm_setzero_si128()); \
+	g_16 = _mm_unpacklo_epi8(rgb5, _mm_setzero_si128()); \
+	b_16 = _mm_unpacklo_epi8(rgb6, _mm_setzero_si128()); \
+	y2_16 = _mm_add_epi16(_mm_mullo_epi16(r_16, _mm_set1_epi16(param->r_factor)), \
+		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
+	y2_16 = _mm_add_epi16(y2_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
+	y2_16 = _mm_srli_epi16(y2_16, 8); \
+	cb_odd = _mm_sub_epi16(b_16, y2_16); \
+	cr_odd = _mm_sub_epi16(r_16, y2_16); \
+	/* Rescale Y' to Y, pack it to 8bit values and save it */ \
+	y1_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y1_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
+	y2_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y2_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
 	Y = _mm_packus_epi16(y1_16, y2_16); \
 	Y = _mm_unpackhi_epi8(_mm_slli_si128(Y, 8), Y); \
 	SAVE_SI128((__m128i*)(y_ptr1), Y); \
@@ -504,8 +2305,8 @@ Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_fact
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y1_16 = _mm_add_epi16(y1_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y1_16 = _mm_srli_epi16(y1_16, 8); \
-	cb1_16 = _mm_add_epi16(cb1_16, _mm_sub_epi16(b_16, y1_16)); \
-	cr1_16 = _mm_add_epi16(cr1_16, _mm_sub_epi16(r_16, y1_16)); \
+	cb_even = _mm_add_epi16(cb_even, _mm_sub_epi16(b_16, y1_16)); \
+	cr_even = _mm_add_epi16(cr_even, _mm_sub_epi16(r_16, y1_16)); \
 	r_16 = _mm_unpackhi_epi8(rgb4, _mm_setzero_si128()); \
 	g_16 = _mm_unpackhi_epi8(rgb5, _mm_setzero_si128()); \
 	b_16 = _mm_unpackhi_epi8(rgb6, _mm_setzero_si128()); \
@@ -513,8 +2314,8 @@ Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_fact
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y2_16 = _mm_add_epi16(y2_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y2_16 = _mm_srli_epi16(y2_16, 8); \
-	cb1_16 = _mm_add_epi16(cb1_16, _mm_sub_epi16(b_16, y2_16)); \
-	cr1_16 = _mm_add_epi16(cr1_16, _mm_sub_epi16(r_16, y2_16)); \
+	cb_odd = _mm_add_epi16(cb_odd, _mm_sub_epi16(b_16, y2_16)); \
+	cr_odd = _mm_add_epi16(cr_odd, _mm_sub_epi16(r_16, y2_16)); \
 	/* Rescale Y' to Y, pack it to 8bit values and save it */ \
 	y1_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y1_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
 	y2_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y2_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
@@ -522,8 +2323,9 @@ Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_fact
 	Y = _mm_unpackhi_epi8(_mm_slli_si128(Y, 8), Y); \
 	SAVE_SI128((__m128i*)(y_ptr2), Y); \
 	/* Rescale Cb and Cr to their final range */ \
-	cb1_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(_mm_srai_epi16(cb1_16, 2), _mm_set1_epi16(param->cb_factor)), 8), _mm_set1_epi16(128)); \
-	cr1_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(_mm_srai_epi16(cr1_16, 2), _mm_set1_epi16(param->cr_factor)), 8), _mm_set1_epi16(128)); \
+	FILTER(cb_even, cb_odd, cr_even, cr_odd, cb1_16, cr1_16) \
+	cb1_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(cb1_16, _mm_set1_epi16(param->cb_factor)), 8), _mm_set1_epi16(128)); \
+	cr1_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(cr1_16, _mm_set1_epi16(param->cr_factor)), 8), _mm_set1_epi16(128)); \
 	\
 	/* do the same again with next data */ \
 	rgb1 = LOAD_SI128((const __m128i*)(rgb_ptr1+48)), \
@@ -539,7 +2341,7 @@ Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_fact
 	UNPACK_RGB24_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6) \
 	UNPACK_RGB24_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6) \
 	UNPACK_RGB24_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6) \
-	UNPACK_RGB24_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6) \
+	UNPACK_RGB24_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, ORDER) \
 	/* first compute Y', (B-Y') and (R-Y'), in 16bits values, for the first line */ \
 	/* Y is saved for each pixel, while only sums of (B-Y') and (R-Y') for pairs of adjacents pixels are saved*/ \
 	r_16 = _mm_unpacklo_epi8(rgb1, _mm_setzero_si128()); \
@@ -549,8 +2351,8 @@ Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_fact
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y1_16 = _mm_add_epi16(y1_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y1_16 = _mm_srli_epi16(y1_16, 8); \
-	cb2_16 = _mm_sub_epi16(b_16, y1_16); \
-	cr2_16 = _mm_sub_epi16(r_16, y1_16); \
+	cb_even = _mm_sub_epi16(b_16, y1_16); \
+	cr_even = _mm_sub_epi16(r_16, y1_16); \
 	r_16 = _mm_unpacklo_epi8(rgb4, _mm_setzero_si128()); \
 	g_16 = _mm_unpacklo_epi8(rgb5, _mm_setzero_si128()); \
 	b_16 = _mm_unpacklo_epi8(rgb6, _mm_setzero_si128()); \
@@ -558,8 +2360,8 @@ Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_fact
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y2_16 = _mm_add_epi16(y2_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y2_16 = _mm_srli_epi16(y2_16, 8); \
-	cb2_16 = _mm_add_epi16(cb2_16, _mm_sub_epi16(b_16, y2_16)); \
-	cr2_16 = _mm_add_epi16(cr2_16, _mm_sub_epi16(r_16, y2_16)); \
+	cb_odd = _mm_sub_epi16(b_16, y2_16); \
+	cr_odd = _mm_sub_epi16(r_16, y2_16); \
 	/* Rescale Y' to Y, pack it to 8bit values and save it */ \
 	y1_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y1_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
 	y2_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y2_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
@@ -575,8 +2377,8 @@ Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_fact
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y1_16 = _mm_add_epi16(y1_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y1_16 = _mm_srli_epi16(y1_16, 8); \
-	cb2_16 = _mm_add_epi16(cb2_16, _mm_sub_epi16(b_16, y1_16)); \
-	cr2_16 = _mm_add_epi16(cr2_16, _mm_sub_epi16(r_16, y1_16)); \
+	cb_even = _mm_add_epi16(cb_even, _mm_sub_epi16(b_16, y1_16)); \
+	cr_even = _mm_add_epi16(cr_even, _mm_sub_epi16(r_16, y1_16)); \
 	r_16 = _mm_unpackhi_epi8(rgb4, _mm_setzero_si128()); \
 	g_16 = _mm_unpackhi_epi8(rgb5, _mm_setzero_si128()); \
 	b_16 = _mm_unpackhi_epi8(rgb6, _mm_setzero_si128()); \
@@ -584,8 +2386,8 @@ Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_fact
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y2_16 = _mm_add_epi16(y2_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y2_16 = _mm_srli_epi16(y2_16, 8); \
-	cb2_16 = _mm_add_epi16(cb2_16, _mm_sub_epi16(b_16, y2_16)); \
-	cr2_16 = _mm_add_epi16(cr2_16, _mm_sub_epi16(r_16, y2_16)); \
+	cb_odd = _mm_add_epi16(cb_odd, _mm_sub_epi16(b_16, y2_16)); \
+	cr_odd = _mm_add_epi16(cr_odd, _mm_sub_epi16(r_16, y2_16)); \
 	/* Rescale Y' to Y, pack it to 8bit values and save it */ \
 	y1_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y1_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
 	y2_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y2_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
@@ -593,49 +2395,69 @@ Y = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(Y, _mm_set1_epi16(param->y_fact
 	Y = _mm_unpackhi_epi8(_mm_slli_si128(Y, 8), Y); \
 	SAVE_SI128((__m128i*)(y_ptr2+16), Y); \
 	/* Rescale Cb and Cr to their final range */ \
-	cb2_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(_mm_srai_epi16(cb2_16, 2), _mm_set1_epi16(param->cb_factor)), 8), _mm_set1_epi16(128)); \
-	cr2_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(_mm_srai_epi16(cr2_16, 2), _mm_set1_epi16(param->cr_factor)), 8), _mm_set1_epi16(128)); \
+	FILTER(cb_even, cb_odd, cr_even, cr_odd, cb2_16, cr2_16) \
+	cb2_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(cb2_16, _mm_set1_epi16(param->cb_factor)), 8), _mm_set1_epi16(128)); \
+	cr2_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(cr2_16, _mm_set1_epi16(param->cr_factor)), 8), _mm_set1_epi16(128)); \
 	/* Pack and save Cb Cr */ \
 	cb = _mm_packus_epi16(cb1_16, cb2_16); \
 	cr = _mm_packus_epi16(cr1_16, cr2_16); \
-	SAVE_SI128((__m128i*)(u_ptr), cb); \
-	SAVE_SI128((__m128i*)(v_ptr), cr);
+	SAVE_UV(cb, cr)
 
 
+#define RGB24_YUV420_PARAM_FUNCTION_SSE(NAME) \
+static void NAME(uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	const RGB2YUVParam *rgb2yuv_param) \
+{ \
+	const RGB2YUVParam param_copy = *rgb2yuv_param, *const param = &param_copy; \
+	STORE_POLICY_BEGIN((size_t)height*Y_stride*3/2) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height; y+=2) \
+	{ \
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride, \
+			*rgb_ptr2=RGB+(y+1)*RGB_stride; \
+		\
+		uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+(y+1)*Y_stride, \
+			*u_ptr=U+(y/2)*UV_stride, \
+			*v_ptr=V+(y/2)*UV_stride; \
+		\
+		for(x=0; (x+31)<width; x+=32) \
+		{ \
+			RGB2YUV_32 \
+			\
+			rgb_ptr1+=96; \
+			rgb_ptr2+=96; \
+			y_ptr1+=32; \
+			y_ptr2+=32; \
+			u_ptr+=16; \
+			v_ptr+=16; \
+		} \
+	} \
+	RGB_YUV420_PARAM_TAIL(rgb24_yuv420_param_std, 32, RGB, RGB_stride, 3, rgb2yuv_param) \
+	STORE_POLICY_END \
+}
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+RGB24_YUV420_PARAM_FUNCTION_SSE(rgb24_yuv420_param_sse)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+RGB24_YUV420_PARAM_FUNCTION_SSE(rgb24_yuv420_param_sseu)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
 void rgb24_yuv420_sse(uint32_t width, uint32_t height, 
 	const uint8_t *RGB, uint32_t RGB_stride, 
 	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
 	YCbCrType yuv_type)
 {
-	#define LOAD_SI128 _mm_load_si128
-	#define SAVE_SI128 _mm_stream_si128
-	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
-	
-	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
-	{
-		const uint8_t *rgb_ptr1=RGB+y*RGB_stride,
-			*rgb_ptr2=RGB+(y+1)*RGB_stride;
-		
-		uint8_t *y_ptr1=Y+y*Y_stride,
-			*y_ptr2=Y+(y+1)*Y_stride,
-			*u_ptr=U+(y/2)*UV_stride,
-			*v_ptr=V+(y/2)*UV_stride;
-		
-		for(x=0; x<(width-31); x+=32)
-		{
-			RGB2YUV_32
-			
-			rgb_ptr1+=96;
-			rgb_ptr2+=96;
-			y_ptr1+=32;
-			y_ptr2+=32;
-			u_ptr+=16; 
-			v_ptr+=16;
-		}
-	}
-	#undef LOAD_SI128
-	#undef SAVE_SI128
+	rgb24_yuv420_param_sse(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, &(RGB2YUV[yuv_type]));
 }
 
 void rgb24_yuv420_sseu(uint32_t width, uint32_t height, 
@@ -643,35 +2465,7 @@ void rgb24_yuv420_sseu(uint32_t width, uint32_t height,
 	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
 	YCbCrType yuv_type)
 {
-	#define LOAD_SI128 _mm_loadu_si128
-	#define SAVE_SI128 _mm_storeu_si128
-	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
-	
-	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
-	{
-		const uint8_t *rgb_ptr1=RGB+y*RGB_stride,
-			*rgb_ptr2=RGB+(y+1)*RGB_stride;
-		
-		uint8_t *y_ptr1=Y+y*Y_stride,
-			*y_ptr2=Y+(y+1)*Y_stride,
-			*u_ptr=U+(y/2)*UV_stride,
-			*v_ptr=V+(y/2)*UV_stride;
-		
-		for(x=0; x<(width-31); x+=32)
-		{
-			RGB2YUV_32
-			
-			rgb_ptr1+=96;
-			rgb_ptr2+=96;
-			y_ptr1+=32;
-			y_ptr2+=32;
-			u_ptr+=16; 
-			v_ptr+=16;
-		}
-	}
-	#undef LOAD_SI128
-	#undef SAVE_SI128
+	rgb24_yuv420_param_sseu(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, &(RGB2YUV[yuv_type]));
 }
 
 
@@ -687,9 +2481,19 @@ RD7 = _mm_unpacklo_epi8(RS4, RS8); \
 RD8 = _mm_unpackhi_epi8(RS4, RS8);
 
 
-#define RGBA2YUV_32 \
+// same as RGB24_UNPACK_ORDER, with four channels: rgb1/rgb5 contain r, rgb2/rgb6 g, rgb3/rgb7 b 
+// and rgb4/rgb8 alpha
+#define RGBA_UNPACK_ORDER rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, rgb7, rgb8
+#define BGRA_UNPACK_ORDER rgb3, rgb2, rgb1, rgb4, rgb7, rgb6, rgb5, rgb8
+#define ARGB_UNPACK_ORDER rgb4, rgb1, rgb2, rgb3, rgb8, rgb5, rgb6, rgb7
+#define ABGR_UNPACK_ORDER rgb4, rgb3, rgb2, rgb1, rgb8, rgb7, rgb6, rgb5
+
+#define RGBA2YUV_32 RGBA2YUV_32_ORDER(RGBA_UNPACK_ORDER, CHROMA_BOX_SSE, SAVE_UV_PLANAR)
+
+#define RGBA2YUV_32_ORDER(ORDER, FILTER, SAVE_UV) \
 	__m128i r_16, g_16, b_16; \
 	__m128i y1_16, y2_16, cb1_16, cb2_16, cr1_16, cr2_16, Y, cb, cr; \
+	__m128i cb_even, cb_odd, cr_even, cr_odd; \
 	__m128i tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8; \
 	__m128i rgb1 = LOAD_SI128((const __m128i*)(rgb_ptr1)), \
 		rgb2 = LOAD_SI128((const __m128i*)(rgb_ptr1+16)), \
@@ -706,7 +2510,7 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 	UNPACK_RGB32_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, rgb7, rgb8, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8) \
 	UNPACK_RGB32_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, rgb7, rgb8) \
 	UNPACK_RGB32_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, rgb7, rgb8, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8) \
-	UNPACK_RGB32_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, rgb7, rgb8) \
+	UNPACK_RGB32_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8, ORDER) \
 	/* first compute Y', (B-Y') and (R-Y'), in 16bits values, for the first line */ \
 	/* Y is saved for each pixel, while only sums of (B-Y') and (R-Y') for pairs of adjacents pixels are saved*/ \
 	r_16 = _mm_unpacklo_epi8(rgb1, _mm_setzero_si128()); \
@@ -716,8 +2520,8 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y1_16 = _mm_add_epi16(y1_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y1_16 = _mm_srli_epi16(y1_16, 8); \
-	cb1_16 = _mm_sub_epi16(b_16, y1_16); \
-	cr1_16 = _mm_sub_epi16(r_16, y1_16); \
+	cb_even = _mm_sub_epi16(b_16, y1_16); \
+	cr_even = _mm_sub_epi16(r_16, y1_16); \
 	r_16 = _mm_unpacklo_epi8(rgb5, _mm_setzero_si128()); \
 	g_16 = _mm_unpacklo_epi8(rgb6, _mm_setzero_si128()); \
 	b_16 = _mm_unpacklo_epi8(rgb7, _mm_setzero_si128()); \
@@ -725,8 +2529,8 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y2_16 = _mm_add_epi16(y2_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y2_16 = _mm_srli_epi16(y2_16, 8); \
-	cb1_16 = _mm_add_epi16(cb1_16, _mm_sub_epi16(b_16, y2_16)); \
-	cr1_16 = _mm_add_epi16(cr1_16, _mm_sub_epi16(r_16, y2_16)); \
+	cb_odd = _mm_sub_epi16(b_16, y2_16); \
+	cr_odd = _mm_sub_epi16(r_16, y2_16); \
 	/* Rescale Y' to Y, pack it to 8bit values and save it */ \
 	y1_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y1_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
 	y2_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y2_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
@@ -742,8 +2546,8 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y1_16 = _mm_add_epi16(y1_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y1_16 = _mm_srli_epi16(y1_16, 8); \
-	cb1_16 = _mm_add_epi16(cb1_16, _mm_sub_epi16(b_16, y1_16)); \
-	cr1_16 = _mm_add_epi16(cr1_16, _mm_sub_epi16(r_16, y1_16)); \
+	cb_even = _mm_add_epi16(cb_even, _mm_sub_epi16(b_16, y1_16)); \
+	cr_even = _mm_add_epi16(cr_even, _mm_sub_epi16(r_16, y1_16)); \
 	r_16 = _mm_unpackhi_epi8(rgb5, _mm_setzero_si128()); \
 	g_16 = _mm_unpackhi_epi8(rgb6, _mm_setzero_si128()); \
 	b_16 = _mm_unpackhi_epi8(rgb7, _mm_setzero_si128()); \
@@ -751,8 +2555,8 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y2_16 = _mm_add_epi16(y2_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y2_16 = _mm_srli_epi16(y2_16, 8); \
-	cb1_16 = _mm_add_epi16(cb1_16, _mm_sub_epi16(b_16, y2_16)); \
-	cr1_16 = _mm_add_epi16(cr1_16, _mm_sub_epi16(r_16, y2_16)); \
+	cb_odd = _mm_add_epi16(cb_odd, _mm_sub_epi16(b_16, y2_16)); \
+	cr_odd = _mm_add_epi16(cr_odd, _mm_sub_epi16(r_16, y2_16)); \
 	/* Rescale Y' to Y, pack it to 8bit values and save it */ \
 	y1_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y1_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
 	y2_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y2_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
@@ -760,8 +2564,9 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 	Y = _mm_unpackhi_epi8(_mm_slli_si128(Y, 8), Y); \
 	SAVE_SI128((__m128i*)(y_ptr2), Y); \
 	/* Rescale Cb and Cr to their final range */ \
-	cb1_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(_mm_srai_epi16(cb1_16, 2), _mm_set1_epi16(param->cb_factor)), 8), _mm_set1_epi16(128)); \
-	cr1_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(_mm_srai_epi16(cr1_16, 2), _mm_set1_epi16(param->cr_factor)), 8), _mm_set1_epi16(128)); \
+	FILTER(cb_even, cb_odd, cr_even, cr_odd, cb1_16, cr1_16) \
+	cb1_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(cb1_16, _mm_set1_epi16(param->cb_factor)), 8), _mm_set1_epi16(128)); \
+	cr1_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(cr1_16, _mm_set1_epi16(param->cr_factor)), 8), _mm_set1_epi16(128)); \
 	\
 	/* do the same again with next data */ \
 	rgb1 = LOAD_SI128((const __m128i*)(rgb_ptr1+64)), \
@@ -779,7 +2584,7 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 	UNPACK_RGB32_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, rgb7, rgb8, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8) \
 	UNPACK_RGB32_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, rgb7, rgb8) \
 	UNPACK_RGB32_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, rgb7, rgb8, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8) \
-	UNPACK_RGB32_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, rgb7, rgb8) \
+	UNPACK_RGB32_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, tmp7, tmp8, ORDER) \
 	/* first compute Y', (B-Y') and (R-Y'), in 16bits values, for the first line */ \
 	/* Y is saved for each pixel, while only sums of (B-Y') and (R-Y') for pairs of adjacents pixels are saved*/ \
 	r_16 = _mm_unpacklo_epi8(rgb1, _mm_setzero_si128()); \
@@ -789,8 +2594,8 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y1_16 = _mm_add_epi16(y1_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y1_16 = _mm_srli_epi16(y1_16, 8); \
-	cb2_16 = _mm_sub_epi16(b_16, y1_16); \
-	cr2_16 = _mm_sub_epi16(r_16, y1_16); \
+	cb_even = _mm_sub_epi16(b_16, y1_16); \
+	cr_even = _mm_sub_epi16(r_16, y1_16); \
 	r_16 = _mm_unpacklo_epi8(rgb5, _mm_setzero_si128()); \
 	g_16 = _mm_unpacklo_epi8(rgb6, _mm_setzero_si128()); \
 	b_16 = _mm_unpacklo_epi8(rgb7, _mm_setzero_si128()); \
@@ -798,8 +2603,8 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y2_16 = _mm_add_epi16(y2_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y2_16 = _mm_srli_epi16(y2_16, 8); \
-	cb2_16 = _mm_add_epi16(cb2_16, _mm_sub_epi16(b_16, y2_16)); \
-	cr2_16 = _mm_add_epi16(cr2_16, _mm_sub_epi16(r_16, y2_16)); \
+	cb_odd = _mm_sub_epi16(b_16, y2_16); \
+	cr_odd = _mm_sub_epi16(r_16, y2_16); \
 	/* Rescale Y' to Y, pack it to 8bit values and save it */ \
 	y1_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y1_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
 	y2_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y2_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
@@ -815,8 +2620,8 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y1_16 = _mm_add_epi16(y1_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y1_16 = _mm_srli_epi16(y1_16, 8); \
-	cb2_16 = _mm_add_epi16(cb2_16, _mm_sub_epi16(b_16, y1_16)); \
-	cr2_16 = _mm_add_epi16(cr2_16, _mm_sub_epi16(r_16, y1_16)); \
+	cb_even = _mm_add_epi16(cb_even, _mm_sub_epi16(b_16, y1_16)); \
+	cr_even = _mm_add_epi16(cr_even, _mm_sub_epi16(r_16, y1_16)); \
 	r_16 = _mm_unpackhi_epi8(rgb5, _mm_setzero_si128()); \
 	g_16 = _mm_unpackhi_epi8(rgb6, _mm_setzero_si128()); \
 	b_16 = _mm_unpackhi_epi8(rgb7, _mm_setzero_si128()); \
@@ -824,8 +2629,8 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 		_mm_mullo_epi16(g_16, _mm_set1_epi16(param->g_factor))); \
 	y2_16 = _mm_add_epi16(y2_16, _mm_mullo_epi16(b_16, _mm_set1_epi16(param->b_factor))); \
 	y2_16 = _mm_srli_epi16(y2_16, 8); \
-	cb2_16 = _mm_add_epi16(cb2_16, _mm_sub_epi16(b_16, y2_16)); \
-	cr2_16 = _mm_add_epi16(cr2_16, _mm_sub_epi16(r_16, y2_16)); \
+	cb_odd = _mm_add_epi16(cb_odd, _mm_sub_epi16(b_16, y2_16)); \
+	cr_odd = _mm_add_epi16(cr_odd, _mm_sub_epi16(r_16, y2_16)); \
 	/* Rescale Y' to Y, pack it to 8bit values and save it */ \
 	y1_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y1_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
 	y2_16 = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(y2_16, _mm_set1_epi16(param->y_factor)), 7), _mm_set1_epi16(param->y_offset)); \
@@ -833,13 +2638,13 @@ RD8 = _mm_unpackhi_epi8(RS4, RS8);
 	Y = _mm_unpackhi_epi8(_mm_slli_si128(Y, 8), Y); \
 	SAVE_SI128((__m128i*)(y_ptr2+16), Y); \
 	/* Rescale Cb and Cr to their final range */ \
-	cb2_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(_mm_srai_epi16(cb2_16, 2), _mm_set1_epi16(param->cb_factor)), 8), _mm_set1_epi16(128)); \
-	cr2_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(_mm_srai_epi16(cr2_16, 2), _mm_set1_epi16(param->cr_factor)), 8), _mm_set1_epi16(128)); \
+	FILTER(cb_even, cb_odd, cr_even, cr_odd, cb2_16, cr2_16) \
+	cb2_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(cb2_16, _mm_set1_epi16(param->cb_factor)), 8), _mm_set1_epi16(128)); \
+	cr2_16 = _mm_add_epi16(_mm_srai_epi16(_mm_mullo_epi16(cr2_16, _mm_set1_epi16(param->cr_factor)), 8), _mm_set1_epi16(128)); \
 	/* Pack and save Cb Cr */ \
 	cb = _mm_packus_epi16(cb1_16, cb2_16); \
 	cr = _mm_packus_epi16(cr1_16, cr2_16); \
-	SAVE_SI128((__m128i*)(u_ptr), cb); \
-	SAVE_SI128((__m128i*)(v_ptr), cr);
+	SAVE_UV(cb, cr)
 
 void rgb32_yuv420_sse(uint32_t width, uint32_t height, 
 	const uint8_t *RGBA, uint32_t RGBA_stride, 
@@ -847,11 +2652,12 @@ void rgb32_yuv420_sse(uint32_t width, uint32_t height,
 	YCbCrType yuv_type)
 {
 	#define LOAD_SI128 _mm_load_si128
-	#define SAVE_SI128 _mm_stream_si128
+	#define SAVE_SI128 STREAM_SI128
 	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
+	STORE_POLICY_BEGIN((size_t)height*Y_stride*3/2)
 	
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; (y+1)<height; y+=2)
 	{
 		const uint8_t *rgb_ptr1=RGBA+y*RGBA_stride,
 			*rgb_ptr2=RGBA+(y+1)*RGBA_stride;
@@ -861,7 +2667,7 @@ void rgb32_yuv420_sse(uint32_t width, uint32_t height,
 			*u_ptr=U+(y/2)*UV_stride,
 			*v_ptr=V+(y/2)*UV_stride;
 		
-		for(x=0; x<(width-31); x+=32)
+		for(x=0; (x+31)<width; x+=32)
 		{
 			RGBA2YUV_32
 			
@@ -873,6 +2679,8 @@ void rgb32_yuv420_sse(uint32_t width, uint32_t height,
 			v_ptr+=16;
 		}
 	}
+	RGB_YUV420_TAIL(rgb32_yuv420_std, 32, RGBA, RGBA_stride, 4)
+	STORE_POLICY_END
 	#undef LOAD_SI128
 	#undef SAVE_SI128
 }
@@ -887,7 +2695,7 @@ void rgb32_yuv420_sseu(uint32_t width, uint32_t height,
 	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
 	
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; (y+1)<height; y+=2)
 	{
 		const uint8_t *rgb_ptr1=RGBA+y*RGBA_stride,
 			*rgb_ptr2=RGBA+(y+1)*RGBA_stride;
@@ -897,7 +2705,7 @@ void rgb32_yuv420_sseu(uint32_t width, uint32_t height,
 			*u_ptr=U+(y/2)*UV_stride,
 			*v_ptr=V+(y/2)*UV_stride;
 		
-		for(x=0; x<(width-31); x+=32)
+		for(x=0; (x+31)<width; x+=32)
 		{
 			RGBA2YUV_32
 			
@@ -909,20 +2717,94 @@ void rgb32_yuv420_sseu(uint32_t width, uint32_t height,
 			v_ptr+=16;
 		}
 	}
+	RGB_YUV420_TAIL(rgb32_yuv420_std, 32, RGBA, RGBA_stride, 4)
 	#undef LOAD_SI128
 	#undef SAVE_SI128
 }
 
+// other channel orders
+#define RGB_YUV420_FUNCTIONS_SSE(SUFFIX) \
+	RGB_YUV420_FUNCTION(static, bgr24_yuv420_##SUFFIX, bgr24_yuv420_std, 32, 3, RGB2YUV_INIT, RGB2YUV_32_ORDER(BGR24_UNPACK_ORDER, CHROMA_BOX_SSE, SAVE_UV_PLANAR)) \
+	RGB_YUV420_FUNCTION(static, bgra32_yuv420_##SUFFIX, bgra32_yuv420_std, 32, 4, RGB2YUV_INIT, RGBA2YUV_32_ORDER(BGRA_UNPACK_ORDER, CHROMA_BOX_SSE, SAVE_UV_PLANAR)) \
+	RGB_YUV420_FUNCTION(static, argb32_yuv420_##SUFFIX, argb32_yuv420_std, 32, 4, RGB2YUV_INIT, RGBA2YUV_32_ORDER(ARGB_UNPACK_ORDER, CHROMA_BOX_SSE, SAVE_UV_PLANAR)) \
+	RGB_YUV420_FUNCTION(static, abgr32_yuv420_##SUFFIX, abgr32_yuv420_std, 32, 4, RGB2YUV_INIT, RGBA2YUV_32_ORDER(ABGR_UNPACK_ORDER, CHROMA_BOX_SSE, SAVE_UV_PLANAR))
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+RGB_YUV420_FUNCTIONS_SSE(sse)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+RGB_YUV420_FUNCTIONS_SSE(sseu)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+// rgb to nv12 and nv21, the chroma values are interleaved when saved
+#define RGB_NV_FUNCTIONS_SSE(SUFFIX) \
+	RGB_NV_FUNCTION(, rgb24_nv12_##SUFFIX, rgb24_nv12_std, 32, 3, RGB2YUV_INIT, RGB2YUV_32_ORDER(RGB24_UNPACK_ORDER, CHROMA_BOX_SSE, SAVE_UV_NV12)) \
+	RGB_NV_FUNCTION(, rgb24_nv21_##SUFFIX, rgb24_nv21_std, 32, 3, RGB2YUV_INIT, RGB2YUV_32_ORDER(RGB24_UNPACK_ORDER, CHROMA_BOX_SSE, SAVE_UV_NV21)) \
+	RGB_NV_FUNCTION(, rgb32_nv12_##SUFFIX, rgb32_nv12_std, 32, 4, RGB2YUV_INIT, RGBA2YUV_32_ORDER(RGBA_UNPACK_ORDER, CHROMA_BOX_SSE, SAVE_UV_NV12)) \
+	RGB_NV_FUNCTION(, rgb32_nv21_##SUFFIX, rgb32_nv21_std, 32, 4, RGB2YUV_INIT, RGBA2YUV_32_ORDER(RGBA_UNPACK_ORDER, CHROMA_BOX_SSE, SAVE_UV_NV21))
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+RGB_NV_FUNCTIONS_SSE(sse)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+RGB_NV_FUNCTIONS_SSE(sseu)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+// rgb to yuv420p with the [1 2 1] chroma filter, the state is initialized with the first column, that is 
+// repeated on the left border
+#define CHROMA_121_INIT_SSE \
+	__m128i cb_left, cr_left; \
+	{ \
+		uint8_t y_tmp; \
+		int16_t u_sum, v_sum, u_diff, v_diff; \
+		RGB2YUV_COLUMN_STD(rgb_ptr1, rgb_ptr2, u_sum, v_sum) \
+		cb_left = _mm_cvtsi32_si128((uint16_t)u_sum); \
+		cr_left = _mm_cvtsi32_si128((uint16_t)v_sum); \
+	}
+
+#define RGB_YUV420_121_FUNCTIONS_SSE(SUFFIX) \
+	RGB_YUV420_121_FUNCTION(static, rgb24_yuv420_121_##SUFFIX, rgb24_yuv420_121_std, 32, 3, CHROMA_121_INIT_SSE, \
+		RGB2YUV_32_ORDER(RGB24_UNPACK_ORDER, CHROMA_121_SSE, SAVE_UV_PLANAR)) \
+	RGB_YUV420_121_FUNCTION(static, rgb32_yuv420_121_##SUFFIX, rgb32_yuv420_121_std, 32, 4, CHROMA_121_INIT_SSE, \
+		RGBA2YUV_32_ORDER(RGBA_UNPACK_ORDER, CHROMA_121_SSE, SAVE_UV_PLANAR))
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+RGB_YUV420_121_FUNCTIONS_SSE(sse)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+RGB_YUV420_121_FUNCTIONS_SSE(sseu)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
 #endif
 
 #ifdef __SSE2__
 
-#define UV2RGB_16(U,V,R1,G1,B1,R2,G2,B2) \
+// compute the color offsets of 8 chroma values (in r_tmp, g_tmp and b_tmp)
+#define UV2RGB_OFFSETS_16(U,V) \
 	r_tmp = _mm_srai_epi16(_mm_mullo_epi16(V, _mm_set1_epi16(param->cr_factor)), 6); \
 	g_tmp = _mm_srai_epi16(_mm_add_epi16( \
 		_mm_mullo_epi16(U, _mm_set1_epi16(param->g_cb_factor)), \
 		_mm_mullo_epi16(V, _mm_set1_epi16(param->g_cr_factor))), 7); \
 	b_tmp = _mm_srai_epi16(_mm_mullo_epi16(U, _mm_set1_epi16(param->cb_factor)), 6); \
+
+// same, duplicated for the two pixels sharing each chroma value
+#define UV2RGB_16(U,V,R1,G1,B1,R2,G2,B2) \
+	UV2RGB_OFFSETS_16(U,V) \
 	R1 = _mm_unpacklo_epi16(r_tmp, r_tmp); \
 	G1 = _mm_unpacklo_epi16(g_tmp, g_tmp); \
 	B1 = _mm_unpacklo_epi16(b_tmp, b_tmp); \
@@ -930,9 +2812,12 @@ void rgb32_yuv420_sseu(uint32_t width, uint32_t height,
 	G2 = _mm_unpackhi_epi16(g_tmp, g_tmp); \
 	B2 = _mm_unpackhi_epi16(b_tmp, b_tmp); \
 
+// add the luma value of the pixels (Y1 and Y2, 16 bits values of the 8 bits luma) to the color offsets
+// (Y-y_offset)*y_factor>>7 does not fit 16 bits for luma values out of the nominal range, it is computed as 
+// ((Y-y_offset)<<7)*(y_factor<<2)>>16, which gives exactly the same result as the std implementation
 #define ADD_Y2RGB_16(Y1,Y2,R1,G1,B1,R2,G2,B2) \
-	Y1 = _mm_srai_epi16(_mm_mullo_epi16(Y1, _mm_set1_epi16(param->y_factor)), 7); \
-	Y2 = _mm_srai_epi16(_mm_mullo_epi16(Y2, _mm_set1_epi16(param->y_factor)), 7); \
+	Y1 = _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(Y1, _mm_set1_epi16(param->y_offset)), 7), _mm_set1_epi16(param->y_factor*4)); \
+	Y2 = _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(Y2, _mm_set1_epi16(param->y_offset)), 7), _mm_set1_epi16(param->y_factor*4)); \
 	\
 	R1 = _mm_add_epi16(Y1, R1); \
 	G1 = _mm_sub_epi16(Y1, G1); \
@@ -994,7 +2879,6 @@ PACK_RGB24_32_STEP(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
 	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
 	\
 	__m128i y = LOAD_SI128((const __m128i*)(y_ptr1)); \
-	y = _mm_sub_epi8(y, _mm_set1_epi8(param->y_offset)); \
 	y_16_1 = _mm_unpacklo_epi8(y, _mm_setzero_si128()); \
 	y_16_2 = _mm_unpackhi_epi8(y, _mm_setzero_si128()); \
 	\
@@ -1009,7 +2893,6 @@ PACK_RGB24_32_STEP(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
 	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
 	\
 	y = LOAD_SI128((const __m128i*)(y_ptr2)); \
-	y = _mm_sub_epi8(y, _mm_set1_epi8(param->y_offset)); \
 	y_16_1 = _mm_unpacklo_epi8(y, _mm_setzero_si128()); \
 	y_16_2 = _mm_unpackhi_epi8(y, _mm_setzero_si128()); \
 	\
@@ -1028,7 +2911,6 @@ PACK_RGB24_32_STEP(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
 	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
 	\
 	y = LOAD_SI128((const __m128i*)(y_ptr1+16)); \
-	y = _mm_sub_epi8(y, _mm_set1_epi8(param->y_offset)); \
 	y_16_1 = _mm_unpacklo_epi8(y, _mm_setzero_si128()); \
 	y_16_2 = _mm_unpackhi_epi8(y, _mm_setzero_si128()); \
 	\
@@ -1043,7 +2925,6 @@ PACK_RGB24_32_STEP(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
 	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
 	\
 	y = LOAD_SI128((const __m128i*)(y_ptr2+16)); \
-	y = _mm_sub_epi8(y, _mm_set1_epi8(param->y_offset)); \
 	y_16_1 = _mm_unpacklo_epi8(y, _mm_setzero_si128()); \
 	y_16_2 = _mm_unpackhi_epi8(y, _mm_setzero_si128()); \
 	\
@@ -1052,10 +2933,15 @@ PACK_RGB24_32_STEP(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
 	__m128i r_8_22 = _mm_packus_epi16(r_16_1, r_16_2); \
 	__m128i g_8_22 = _mm_packus_epi16(g_16_1, g_16_2); \
 	__m128i b_8_22 = _mm_packus_epi16(b_16_1, b_16_2); \
-	\
+
+// pack and save the 32 pixels of both lines computed by YUV2RGB_32 in rgb24 format, with PACK_RGB24_32 
+// or PACK_RGB24_32_SSSE3
+#define SAVE_RGB24_32 SAVE_RGB24_32_PACK(PACK_RGB24_32)
+
+#define SAVE_RGB24_32_PACK(PACK) \
 	__m128i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6; \
 	\
-	PACK_RGB24_32(r_8_11, r_8_12, g_8_11, g_8_12, b_8_11, b_8_12, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
+	PACK(r_8_11, r_8_12, g_8_11, g_8_12, b_8_11, b_8_12, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
 	SAVE_SI128((__m128i*)(rgb_ptr1), rgb_1); \
 	SAVE_SI128((__m128i*)(rgb_ptr1+16), rgb_2); \
 	SAVE_SI128((__m128i*)(rgb_ptr1+32), rgb_3); \
@@ -1063,7 +2949,7 @@ PACK_RGB24_32_STEP(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
 	SAVE_SI128((__m128i*)(rgb_ptr1+64), rgb_5); \
 	SAVE_SI128((__m128i*)(rgb_ptr1+80), rgb_6); \
 	\
-	PACK_RGB24_32(r_8_21, r_8_22, g_8_21, g_8_22, b_8_21, b_8_22, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
+	PACK(r_8_21, r_8_22, g_8_21, g_8_22, b_8_21, b_8_22, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
 	SAVE_SI128((__m128i*)(rgb_ptr2), rgb_1); \
 	SAVE_SI128((__m128i*)(rgb_ptr2+16), rgb_2); \
 	SAVE_SI128((__m128i*)(rgb_ptr2+32), rgb_3); \
@@ -1071,54 +2957,103 @@ PACK_RGB24_32_STEP(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
 	SAVE_SI128((__m128i*)(rgb_ptr2+64), rgb_5); \
 	SAVE_SI128((__m128i*)(rgb_ptr2+80), rgb_6); \
 
+// interleave 16 pixels of the four channels C0 to C3 (in memory order) and save them
+#define PACK_RGB32_16(C0, C1, C2, C3, RGB_PTR) \
+	{ \
+		__m128i c01_lo = _mm_unpacklo_epi8(C0, C1), c01_hi = _mm_unpackhi_epi8(C0, C1), \
+			c23_lo = _mm_unpacklo_epi8(C2, C3), c23_hi = _mm_unpackhi_epi8(C2, C3); \
+		SAVE_SI128((__m128i*)(RGB_PTR), _mm_unpacklo_epi16(c01_lo, c23_lo)); \
+		SAVE_SI128((__m128i*)(RGB_PTR+16), _mm_unpackhi_epi16(c01_lo, c23_lo)); \
+		SAVE_SI128((__m128i*)(RGB_PTR+32), _mm_unpacklo_epi16(c01_hi, c23_hi)); \
+		SAVE_SI128((__m128i*)(RGB_PTR+48), _mm_unpackhi_epi16(c01_hi, c23_hi)); \
+	} \
+
+// pack and save the 32 pixels of both lines computed by YUV2RGB_32 in a 32 bits format
+// C0 to C3 are the channels names (r, g, b or a) in memory order, a_8_xx must contain the alpha value
+#define SAVE_RGB32_32(C0, C1, C2, C3) \
+	PACK_RGB32_16(C0##_8_11, C1##_8_11, C2##_8_11, C3##_8_11, rgb_ptr1) \
+	PACK_RGB32_16(C0##_8_12, C1##_8_12, C2##_8_12, C3##_8_12, rgb_ptr1+64) \
+	PACK_RGB32_16(C0##_8_21, C1##_8_21, C2##_8_21, C3##_8_21, rgb_ptr2) \
+	PACK_RGB32_16(C0##_8_22, C1##_8_22, C2##_8_22, C3##_8_22, rgb_ptr2+64) \
+
+#define SAVE_RGBA_32 SAVE_RGB32_32(r, g, b, a)
+#define SAVE_BGRA_32 SAVE_RGB32_32(b, g, r, a)
+#define SAVE_ARGB_32 SAVE_RGB32_32(a, r, g, b)
+#define SAVE_ABGR_32 SAVE_RGB32_32(a, b, g, r)
+
 #define YUV2RGB_32_PLANAR \
 	LOAD_UV_PLANAR \
-	YUV2RGB_32
+	YUV2RGB_32 \
+	SAVE_RGB24_32
 
 #define YUV2RGB_32_NV12 \
 	LOAD_UV_NV12 \
-	YUV2RGB_32
+	YUV2RGB_32 \
+	SAVE_RGB24_32
 	
 #define YUV2RGB_32_NV21 \
 	LOAD_UV_NV21 \
-	YUV2RGB_32
+	YUV2RGB_32 \
+	SAVE_RGB24_32
 
 
+// see yuv420_rgb24_param_std for the parameters copy
+#define YUV420_RGB24_PARAM_FUNCTION_SSE(TARGET, NAME, CONVERT) \
+TARGET static void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGB, uint32_t RGB_stride, \
+	const YUV2RGBParam *yuv2rgb_param) \
+{ \
+	const YUV2RGBParam param_copy = *yuv2rgb_param, *const param = &param_copy; \
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height; y+=2) \
+	{ \
+		const uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+(y+1)*Y_stride, \
+			*u_ptr=U+(y/2)*UV_stride, \
+			*v_ptr=V+(y/2)*UV_stride; \
+		\
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride, \
+			*rgb_ptr2=RGB+(y+1)*RGB_stride; \
+		\
+		for(x=0; (x+31)<width; x+=32) \
+		{ \
+			CONVERT \
+			\
+			y_ptr1+=32; \
+			y_ptr2+=32; \
+			u_ptr+=16; \
+			v_ptr+=16; \
+			rgb_ptr1+=96; \
+			rgb_ptr2+=96; \
+		} \
+	} \
+	YUV420_RGB24_PARAM_TAIL(yuv420_rgb24_param_std, 32, yuv2rgb_param) \
+	STORE_POLICY_END \
+}
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+YUV420_RGB24_PARAM_FUNCTION_SSE(, yuv420_rgb24_param_sse, YUV2RGB_32_PLANAR)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+YUV420_RGB24_PARAM_FUNCTION_SSE(, yuv420_rgb24_param_sseu, YUV2RGB_32_PLANAR)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
 void yuv420_rgb24_sse(
 	uint32_t width, uint32_t height, 
 	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
 	uint8_t *RGB, uint32_t RGB_stride, 
 	YCbCrType yuv_type)
 {
-	#define LOAD_SI128 _mm_load_si128
-	#define SAVE_SI128 _mm_stream_si128
-	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
-	
-	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
-	{
-		const uint8_t *y_ptr1=Y+y*Y_stride,
-			*y_ptr2=Y+(y+1)*Y_stride,
-			*u_ptr=U+(y/2)*UV_stride,
-			*v_ptr=V+(y/2)*UV_stride;
-		
-		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
-			*rgb_ptr2=RGB+(y+1)*RGB_stride;
-		
-		for(x=0; x<(width-31); x+=32)
-		{
-			YUV2RGB_32_PLANAR
-			
-			y_ptr1+=32;
-			y_ptr2+=32;
-			u_ptr+=16; 
-			v_ptr+=16;
-			rgb_ptr1+=96;
-			rgb_ptr2+=96;
-		}
-	}
-	#undef LOAD_SI128
-	#undef SAVE_SI128
+	yuv420_rgb24_param_sse(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, &(YUV2RGB[yuv_type]));
 }
 
 void yuv420_rgb24_sseu(
@@ -1127,35 +3062,7 @@ void yuv420_rgb24_sseu(
 	uint8_t *RGB, uint32_t RGB_stride, 
 	YCbCrType yuv_type)
 {
-	#define LOAD_SI128 _mm_loadu_si128
-	#define SAVE_SI128 _mm_storeu_si128
-	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
-	
-	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
-	{
-		const uint8_t *y_ptr1=Y+y*Y_stride,
-			*y_ptr2=Y+(y+1)*Y_stride,
-			*u_ptr=U+(y/2)*UV_stride,
-			*v_ptr=V+(y/2)*UV_stride;
-		
-		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
-			*rgb_ptr2=RGB+(y+1)*RGB_stride;
-		
-		for(x=0; x<(width-31); x+=32)
-		{
-			YUV2RGB_32_PLANAR
-			
-			y_ptr1+=32;
-			y_ptr2+=32;
-			u_ptr+=16; 
-			v_ptr+=16;
-			rgb_ptr1+=96;
-			rgb_ptr2+=96;
-		}
-	}
-	#undef LOAD_SI128
-	#undef SAVE_SI128
+	yuv420_rgb24_param_sseu(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, &(YUV2RGB[yuv_type]));
 }
 
 void nv12_rgb24_sse(
@@ -1165,11 +3072,12 @@ void nv12_rgb24_sse(
 	YCbCrType yuv_type)
 {
 	#define LOAD_SI128 _mm_load_si128
-	#define SAVE_SI128 _mm_stream_si128
+	#define SAVE_SI128 STREAM_SI128
 	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride)
 	
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; (y+1)<height; y+=2)
 	{
 		const uint8_t *y_ptr1=Y+y*Y_stride,
 			*y_ptr2=Y+(y+1)*Y_stride,
@@ -1178,7 +3086,7 @@ void nv12_rgb24_sse(
 		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
 			*rgb_ptr2=RGB+(y+1)*RGB_stride;
 		
-		for(x=0; x<(width-31); x+=32)
+		for(x=0; (x+31)<width; x+=32)
 		{
 			YUV2RGB_32_NV12
 			
@@ -1189,6 +3097,8 @@ void nv12_rgb24_sse(
 			rgb_ptr2+=96;
 		}
 	}
+	NV_RGB24_TAIL(nv12_rgb24_lut, 32)
+	STORE_POLICY_END
 	#undef LOAD_SI128
 	#undef SAVE_SI128
 }
@@ -1204,7 +3114,7 @@ void nv12_rgb24_sseu(
 	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
 	
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; (y+1)<height; y+=2)
 	{
 		const uint8_t *y_ptr1=Y+y*Y_stride,
 			*y_ptr2=Y+(y+1)*Y_stride,
@@ -1213,7 +3123,7 @@ void nv12_rgb24_sseu(
 		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
 			*rgb_ptr2=RGB+(y+1)*RGB_stride;
 		
-		for(x=0; x<(width-31); x+=32)
+		for(x=0; (x+31)<width; x+=32)
 		{
 			YUV2RGB_32_NV12
 			
@@ -1224,6 +3134,7 @@ void nv12_rgb24_sseu(
 			rgb_ptr2+=96;
 		}
 	}
+	NV_RGB24_TAIL(nv12_rgb24_lut, 32)
 	#undef LOAD_SI128
 	#undef SAVE_SI128
 }
@@ -1235,11 +3146,12 @@ void nv21_rgb24_sse(
 	YCbCrType yuv_type)
 {
 	#define LOAD_SI128 _mm_load_si128
-	#define SAVE_SI128 _mm_stream_si128
+	#define SAVE_SI128 STREAM_SI128
 	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride)
 	
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; (y+1)<height; y+=2)
 	{
 		const uint8_t *y_ptr1=Y+y*Y_stride,
 			*y_ptr2=Y+(y+1)*Y_stride,
@@ -1248,7 +3160,7 @@ void nv21_rgb24_sse(
 		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
 			*rgb_ptr2=RGB+(y+1)*RGB_stride;
 		
-		for(x=0; x<(width-31); x+=32)
+		for(x=0; (x+31)<width; x+=32)
 		{
 			YUV2RGB_32_NV21
 			
@@ -1259,6 +3171,8 @@ void nv21_rgb24_sse(
 			rgb_ptr2+=96;
 		}
 	}
+	NV_RGB24_TAIL(nv21_rgb24_lut, 32)
+	STORE_POLICY_END
 	#undef LOAD_SI128
 	#undef SAVE_SI128
 }
@@ -1274,7 +3188,7 @@ void nv21_rgb24_sseu(
 	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
 	
 	uint32_t x, y;
-	for(y=0; y<(height-1); y+=2)
+	for(y=0; (y+1)<height; y+=2)
 	{
 		const uint8_t *y_ptr1=Y+y*Y_stride,
 			*y_ptr2=Y+(y+1)*Y_stride,
@@ -1283,7 +3197,7 @@ void nv21_rgb24_sseu(
 		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
 			*rgb_ptr2=RGB+(y+1)*RGB_stride;
 		
-		for(x=0; x<(width-31); x+=32)
+		for(x=0; (x+31)<width; x+=32)
 		{
 			YUV2RGB_32_NV21
 			
@@ -1294,10 +3208,3416 @@ void nv21_rgb24_sseu(
 			rgb_ptr2+=96;
 		}
 	}
+	NV_RGB24_TAIL(nv21_rgb24_lut, 32)
 	#undef LOAD_SI128
 	#undef SAVE_SI128
 }
 
+// 32 bits rgb outputs, the alpha vectors are the fourth channel of SAVE_RGB32_32
+#define ALPHA_SSE \
+	const __m128i a_8_11 = _mm_set1_epi8((char)alpha), a_8_12 = a_8_11, a_8_21 = a_8_11, a_8_22 = a_8_11;
 
+#define RGB32_FUNCTIONS_SSE(SUFFIX, FORMAT, format) \
+	YUV420_RGB32_FUNCTION(static, yuv420_##format##32_##SUFFIX, yuv420_##format##32_std, 32, ALPHA_SSE, \
+		LOAD_UV_PLANAR YUV2RGB_32 SAVE_##FORMAT##_32) \
+	NV_RGB32_FUNCTION(static, nv12_##format##32_##SUFFIX, nv12_##format##32_std, 32, ALPHA_SSE, \
+		LOAD_UV_NV12 YUV2RGB_32 SAVE_##FORMAT##_32) \
+	NV_RGB32_FUNCTION(static, nv21_##format##32_##SUFFIX, nv21_##format##32_std, 32, ALPHA_SSE, \
+		LOAD_UV_NV21 YUV2RGB_32 SAVE_##FORMAT##_32)
 
-#endif //__SSE2__
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+RGB32_FUNCTIONS_SSE(sse, RGBA, rgba)
+RGB32_FUNCTIONS_SSE(sse, BGRA, bgra)
+RGB32_FUNCTIONS_SSE(sse, ARGB, argb)
+RGB32_FUNCTIONS_SSE(sse, ABGR, abgr)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+RGB32_FUNCTIONS_SSE(sseu, RGBA, rgba)
+RGB32_FUNCTIONS_SSE(sseu, BGRA, bgra)
+RGB32_FUNCTIONS_SSE(sseu, ARGB, argb)
+RGB32_FUNCTIONS_SSE(sseu, ABGR, abgr)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+
+
+// yuv420p to rgb24 with chroma interpolation, see yuv420_rgb24_upsampling_std
+static void chroma_sum_vertical_sse(const uint8_t *near_ptr, const uint8_t *far_ptr, uint32_t count, int16_t *sum)
+{
+	uint32_t i;
+	for(i=0; (i+15)<count; i+=16)
+	{
+		const __m128i near_8 = _mm_loadu_si128((const __m128i*)(near_ptr+i)),
+			far_8 = _mm_loadu_si128((const __m128i*)(far_ptr+i));
+		
+		__m128i near_16 = _mm_unpacklo_epi8(near_8, _mm_setzero_si128()),
+			far_16 = _mm_unpacklo_epi8(far_8, _mm_setzero_si128());
+		_mm_storeu_si128((__m128i*)(sum+i), _mm_add_epi16(_mm_add_epi16(near_16, _mm_slli_epi16(near_16, 1)), far_16));
+		
+		near_16 = _mm_unpackhi_epi8(near_8, _mm_setzero_si128());
+		far_16 = _mm_unpackhi_epi8(far_8, _mm_setzero_si128());
+		_mm_storeu_si128((__m128i*)(sum+i+8), _mm_add_epi16(_mm_add_epi16(near_16, _mm_slli_epi16(near_16, 1)), far_16));
+	}
+	chroma_sum_vertical_std(near_ptr+i, far_ptr+i, count-i, sum+i);
+}
+
+static void chroma_upsample_horizontal_sse(const int16_t *sum, uint32_t count, uint8_t *out, ChromaUpsampling upsampling)
+{
+	uint32_t i;
+	if(upsampling==CHROMA_BILINEAR_COSITED)
+	{
+		for(i=0; (i+7)<count; i+=8)
+		{
+			const __m128i sum_16 = _mm_loadu_si128((const __m128i*)(sum+i)),
+				right_16 = _mm_loadu_si128((const __m128i*)(sum+i+1));
+			
+			const __m128i even_16 = _mm_srli_epi16(_mm_add_epi16(sum_16, _mm_set1_epi16(2)), 2),
+				odd_16 = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(sum_16, right_16), _mm_set1_epi16(4)), 3);
+			_mm_storeu_si128((__m128i*)(out+2*i), 
+				_mm_packus_epi16(_mm_unpacklo_epi16(even_16, odd_16), _mm_unpackhi_epi16(even_16, odd_16)));
+		}
+	}
+	else
+	{
+		for(i=0; (i+7)<count; i+=8)
+		{
+			const __m128i sum_16 = _mm_loadu_si128((const __m128i*)(sum+i)),
+				left_16 = _mm_loadu_si128((const __m128i*)(sum+i-1)),
+				right_16 = _mm_loadu_si128((const __m128i*)(sum+i+1));
+			
+			const __m128i sum3_16 = _mm_add_epi16(_mm_add_epi16(sum_16, _mm_slli_epi16(sum_16, 1)), _mm_set1_epi16(8));
+			const __m128i even_16 = _mm_srli_epi16(_mm_add_epi16(sum3_16, left_16), 4),
+				odd_16 = _mm_srli_epi16(_mm_add_epi16(sum3_16, right_16), 4);
+			_mm_storeu_si128((__m128i*)(out+2*i), 
+				_mm_packus_epi16(_mm_unpacklo_epi16(even_16, odd_16), _mm_unpackhi_epi16(even_16, odd_16)));
+		}
+	}
+	chroma_upsample_horizontal_std(sum+i, count-i, out+2*i, upsampling);
+}
+
+// convert 16 pixels of a row, from chroma rows with one value per pixel (unaligned line buffers)
+#define YUV444_RGB_16(Y_PTR, U_PTR, V_PTR, R_8, G_8, B_8) \
+	u = _mm_add_epi8(_mm_loadu_si128((const __m128i*)(U_PTR)), _mm_set1_epi8(-128)); \
+	v = _mm_add_epi8(_mm_loadu_si128((const __m128i*)(V_PTR)), _mm_set1_epi8(-128)); \
+	\
+	u_16 = _mm_srai_epi16(_mm_unpacklo_epi8(u, u), 8); \
+	v_16 = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8); \
+	UV2RGB_OFFSETS_16(u_16, v_16) \
+	r_16_1=r_tmp; g_16_1=g_tmp; b_16_1=b_tmp; \
+	\
+	u_16 = _mm_srai_epi16(_mm_unpackhi_epi8(u, u), 8); \
+	v_16 = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8); \
+	UV2RGB_OFFSETS_16(u_16, v_16) \
+	r_16_2=r_tmp; g_16_2=g_tmp; b_16_2=b_tmp; \
+	\
+	y = LOAD_SI128((const __m128i*)(Y_PTR)); \
+	y_16_1 = _mm_unpacklo_epi8(y, _mm_setzero_si128()); \
+	y_16_2 = _mm_unpackhi_epi8(y, _mm_setzero_si128()); \
+	\
+	ADD_Y2RGB_16(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	R_8 = _mm_packus_epi16(r_16_1, r_16_2); \
+	G_8 = _mm_packus_epi16(g_16_1, g_16_2); \
+	B_8 = _mm_packus_epi16(b_16_1, b_16_2); \
+
+#define YUV444_RGB24_ROW_SSE(NAME) \
+static void NAME(const YUV2RGBParam *param, \
+	const uint8_t *y_ptr, const uint8_t *u_ptr, const uint8_t *v_ptr, uint32_t count, uint8_t *rgb_ptr) \
+{ \
+	uint32_t x; \
+	for(x=0; (x+31)<count; x+=32) \
+	{ \
+		__m128i r_tmp, g_tmp, b_tmp; \
+		__m128i r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+		__m128i u, v, u_16, v_16, y, y_16_1, y_16_2; \
+		__m128i r_8_1, g_8_1, b_8_1, r_8_2, g_8_2, b_8_2; \
+		\
+		YUV444_RGB_16(y_ptr, u_ptr, v_ptr, r_8_1, g_8_1, b_8_1) \
+		YUV444_RGB_16(y_ptr+16, u_ptr+16, v_ptr+16, r_8_2, g_8_2, b_8_2) \
+		\
+		__m128i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6; \
+		PACK_RGB24_32(r_8_1, r_8_2, g_8_1, g_8_2, b_8_1, b_8_2, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
+		SAVE_SI128((__m128i*)(rgb_ptr), rgb_1); \
+		SAVE_SI128((__m128i*)(rgb_ptr+16), rgb_2); \
+		SAVE_SI128((__m128i*)(rgb_ptr+32), rgb_3); \
+		SAVE_SI128((__m128i*)(rgb_ptr+48), rgb_4); \
+		SAVE_SI128((__m128i*)(rgb_ptr+64), rgb_5); \
+		SAVE_SI128((__m128i*)(rgb_ptr+80), rgb_6); \
+		\
+		y_ptr+=32; \
+		u_ptr+=32; \
+		v_ptr+=32; \
+		rgb_ptr+=96; \
+	} \
+	yuv444_rgb24_row_std(param, y_ptr, u_ptr, v_ptr, count-x, rgb_ptr); \
+}
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 _mm_stream_si128
+YUV444_RGB24_ROW_SSE(yuv444_rgb24_row_sse)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+YUV444_RGB24_ROW_SSE(yuv444_rgb24_row_sseu)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+// the aligned row function always uses non temporal stores, the aligned functions converting by rows select 
+// it with the store policy
+#define YUV444_RGB24_ROW_POLICY_SSE (stream_stores ? yuv444_rgb24_row_sse : yuv444_rgb24_row_sseu)
+
+// the chunks start on multiples of UPSAMPLE_CHUNK_SIZE pixels, so they keep the alignment of the rows
+YUV420_RGB24_UPSAMPLING_FUNCTION(static, yuv420_rgb24_upsampling_sse, yuv420_rgb24, 
+	chroma_sum_vertical_sse, chroma_upsample_horizontal_sse, YUV444_RGB24_ROW_POLICY_SSE)
+YUV420_RGB24_UPSAMPLING_FUNCTION(static, yuv420_rgb24_upsampling_sseu, yuv420_rgb24, 
+	chroma_sum_vertical_sse, chroma_upsample_horizontal_sse, yuv444_rgb24_row_sseu)
+
+// 4:4:4, each row is converted as the interpolated rows above
+#define YUV444P_RGB24_FUNCTION_SSE(NAME, CONVERT_ROW) \
+static void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride) \
+	uint32_t y; \
+	for(y=0; y<height; ++y) \
+		CONVERT_ROW(param, Y+y*Y_stride, U+y*UV_stride, V+y*UV_stride, width, RGB+y*RGB_stride); \
+	STORE_POLICY_END \
+}
+
+YUV444P_RGB24_FUNCTION_SSE(yuv444p_rgb24_sse, YUV444_RGB24_ROW_POLICY_SSE)
+YUV444P_RGB24_FUNCTION_SSE(yuv444p_rgb24_sseu, yuv444_rgb24_row_sseu)
+
+// packed 4:2:2, the 64 bytes of 32 pixels are split in the 32 luma values (y_1 and y_2) and in the 16 cb (u) 
+// and cr (v) values, as they are loaded from planar yuv420p. LUMA_OP and CHROMA_OP extract the luma and 
+// chroma bytes of each 16 bits word.
+#define LOAD_YUV422_SPLIT(LUMA_OP, CHROMA_OP) \
+	__m128i pixels_1 = LOAD_SI128((const __m128i*)(yuv_ptr)), \
+		pixels_2 = LOAD_SI128((const __m128i*)(yuv_ptr+16)), \
+		pixels_3 = LOAD_SI128((const __m128i*)(yuv_ptr+32)), \
+		pixels_4 = LOAD_SI128((const __m128i*)(yuv_ptr+48)); \
+	__m128i y_1 = _mm_packus_epi16(LUMA_OP(pixels_1), LUMA_OP(pixels_2)), \
+		y_2 = _mm_packus_epi16(LUMA_OP(pixels_3), LUMA_OP(pixels_4)); \
+	__m128i uv_1 = _mm_packus_epi16(CHROMA_OP(pixels_1), CHROMA_OP(pixels_2)), \
+		uv_2 = _mm_packus_epi16(CHROMA_OP(pixels_3), CHROMA_OP(pixels_4)); \
+	__m128i u = _mm_packus_epi16(_mm_and_si128(uv_1, _mm_set1_epi16(255)), _mm_and_si128(uv_2, _mm_set1_epi16(255))), \
+		v = _mm_packus_epi16(_mm_srli_epi16(uv_1, 8), _mm_srli_epi16(uv_2, 8)); \
+
+#define LOW_BYTES_16(VALUE) _mm_and_si128(VALUE, _mm_set1_epi16(255))
+#define HIGH_BYTES_16(VALUE) _mm_srli_epi16(VALUE, 8)
+
+#define LOAD_YUYV LOAD_YUV422_SPLIT(LOW_BYTES_16, HIGH_BYTES_16)
+#define LOAD_UYVY LOAD_YUV422_SPLIT(HIGH_BYTES_16, LOW_BYTES_16)
+
+// convert and save 16 pixels of a single line, Y_8 being their luma values and U_16, V_16 their 8 chroma values
+#define YUV422_RGB_16(Y_8, U_16, V_16, R_8, G_8, B_8) \
+	UV2RGB_16(U_16, V_16, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	y_16_1 = _mm_unpacklo_epi8(Y_8, _mm_setzero_si128()); \
+	y_16_2 = _mm_unpackhi_epi8(Y_8, _mm_setzero_si128()); \
+	\
+	ADD_Y2RGB_16(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	R_8 = _mm_packus_epi16(r_16_1, r_16_2); \
+	G_8 = _mm_packus_epi16(g_16_1, g_16_2); \
+	B_8 = _mm_packus_epi16(b_16_1, b_16_2); \
+
+// convert and save the 32 pixels loaded by LOAD_YUYV or LOAD_UYVY
+#define YUV422_RGB24_32 \
+	__m128i r_tmp, g_tmp, b_tmp; \
+	__m128i r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+	__m128i y_16_1, y_16_2; \
+	__m128i r_8_1, g_8_1, b_8_1, r_8_2, g_8_2, b_8_2; \
+	\
+	u = _mm_add_epi8(u, _mm_set1_epi8(-128)); \
+	v = _mm_add_epi8(v, _mm_set1_epi8(-128)); \
+	\
+	YUV422_RGB_16(y_1, _mm_srai_epi16(_mm_unpacklo_epi8(u, u), 8), _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8), \
+		r_8_1, g_8_1, b_8_1) \
+	YUV422_RGB_16(y_2, _mm_srai_epi16(_mm_unpackhi_epi8(u, u), 8), _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8), \
+		r_8_2, g_8_2, b_8_2) \
+	\
+	__m128i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6; \
+	PACK_RGB24_32(r_8_1, r_8_2, g_8_1, g_8_2, b_8_1, b_8_2, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
+	SAVE_SI128((__m128i*)(rgb_ptr), rgb_1); \
+	SAVE_SI128((__m128i*)(rgb_ptr+16), rgb_2); \
+	SAVE_SI128((__m128i*)(rgb_ptr+32), rgb_3); \
+	SAVE_SI128((__m128i*)(rgb_ptr+48), rgb_4); \
+	SAVE_SI128((__m128i*)(rgb_ptr+64), rgb_5); \
+	SAVE_SI128((__m128i*)(rgb_ptr+80), rgb_6); \
+
+// the remaining columns are converted with STD_FUNCTION
+#define YUV422_RGB24_FUNCTION_SSE(NAME, STD_FUNCTION, LOAD_YUV422) \
+static void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *YUV, uint32_t YUV_stride, \
+	uint8_t *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride) \
+	uint32_t x, y; \
+	for(y=0; y<height; ++y) \
+	{ \
+		const uint8_t *yuv_ptr=YUV+y*YUV_stride; \
+		uint8_t *rgb_ptr=RGB+y*RGB_stride; \
+		\
+		for(x=0; (x+31)<width; x+=32) \
+		{ \
+			LOAD_YUV422 \
+			YUV422_RGB24_32 \
+			\
+			yuv_ptr+=64; \
+			rgb_ptr+=96; \
+		} \
+	} \
+	const uint32_t done = width-width%32; \
+	if(done<width) \
+		STD_FUNCTION(width-done, height, YUV+2*done, YUV_stride, RGB+3*done, RGB_stride, yuv_type); \
+	STORE_POLICY_END \
+}
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+YUV422_RGB24_FUNCTION_SSE(yuyv_rgb24_sse, yuyv_rgb24_std, LOAD_YUYV)
+YUV422_RGB24_FUNCTION_SSE(uyvy_rgb24_sse, uyvy_rgb24_std, LOAD_UYVY)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+YUV422_RGB24_FUNCTION_SSE(yuyv_rgb24_sseu, yuyv_rgb24_std, LOAD_YUYV)
+YUV422_RGB24_FUNCTION_SSE(uyvy_rgb24_sseu, uyvy_rgb24_std, LOAD_UYVY)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+// yuv420 to rgb with 2x and 4x reduction, see yuv420_rgb24_box_std
+// The luma values (and the chroma values for 4x) are averaged to line buffers, and converted as 4:4:4 rows. 
+// For 2x, the chroma samples are used directly.
+
+// average of the factor*factor blocks of count pixels, from the factor rows starting at ptr
+static void box_reduce_row_std(const uint8_t *ptr, uint32_t stride, uint32_t factor, uint32_t count, uint8_t *out)
+{
+	const uint32_t size = factor*factor;
+	uint32_t x, i, j;
+	for(x=0; x<count; ++x)
+	{
+		uint32_t sum = 0;
+		for(j=0; j<factor; ++j)
+			for(i=0; i<factor; ++i)
+				sum += ptr[j*stride+factor*x+i];
+		out[x] = (sum+size/2)/size;
+	}
+}
+
+static void box_reduce_row_sse(const uint8_t *ptr, uint32_t stride, uint32_t factor, uint32_t count, uint8_t *out)
+{
+	uint32_t x=0;
+	if(factor==2)
+	{
+		for(; (x+15)<count; x+=16)
+		{
+			const __m128i row1_1 = _mm_loadu_si128((const __m128i*)(ptr+2*x)),
+				row1_2 = _mm_loadu_si128((const __m128i*)(ptr+2*x+16)),
+				row2_1 = _mm_loadu_si128((const __m128i*)(ptr+stride+2*x)),
+				row2_2 = _mm_loadu_si128((const __m128i*)(ptr+stride+2*x+16));
+			
+			const __m128i sum_1 = _mm_add_epi16(_mm_add_epi16(LOW_BYTES_16(row1_1), HIGH_BYTES_16(row1_1)), 
+					_mm_add_epi16(LOW_BYTES_16(row2_1), HIGH_BYTES_16(row2_1))),
+				sum_2 = _mm_add_epi16(_mm_add_epi16(LOW_BYTES_16(row1_2), HIGH_BYTES_16(row1_2)), 
+					_mm_add_epi16(LOW_BYTES_16(row2_2), HIGH_BYTES_16(row2_2)));
+			_mm_storeu_si128((__m128i*)(out+x), _mm_packus_epi16(
+				_mm_srli_epi16(_mm_add_epi16(sum_1, _mm_set1_epi16(2)), 2), 
+				_mm_srli_epi16(_mm_add_epi16(sum_2, _mm_set1_epi16(2)), 2)));
+		}
+	}
+	else
+	{
+		for(; (x+15)<count; x+=16)
+		{
+			// sums of pairs of columns over the four rows, then of pairs of pairs (in 32 bits)
+			__m128i sum[4];
+			uint32_t i, j;
+			for(i=0; i<4; ++i)
+			{
+				__m128i pair_sum = _mm_setzero_si128();
+				for(j=0; j<4; ++j)
+				{
+					const __m128i row = _mm_loadu_si128((const __m128i*)(ptr+j*stride+4*x+16*i));
+					pair_sum = _mm_add_epi16(pair_sum, _mm_add_epi16(LOW_BYTES_16(row), HIGH_BYTES_16(row)));
+				}
+				sum[i] = _mm_madd_epi16(pair_sum, _mm_set1_epi16(1));
+			}
+			
+			const __m128i sum_1 = _mm_packs_epi32(sum[0], sum[1]),
+				sum_2 = _mm_packs_epi32(sum[2], sum[3]);
+			_mm_storeu_si128((__m128i*)(out+x), _mm_packus_epi16(
+				_mm_srli_epi16(_mm_add_epi16(sum_1, _mm_set1_epi16(8)), 4), 
+				_mm_srli_epi16(_mm_add_epi16(sum_2, _mm_set1_epi16(8)), 4)));
+		}
+	}
+	box_reduce_row_std(ptr+factor*x, stride, factor, count-x, out+x);
+}
+
+#define RESIZE_CHUNK_SIZE 256
+
+// the line buffers are aligned, the alignment of the rgb rows selects CONVERT_ROW
+#define YUV420_RGB24_BOX_FUNCTION_SSE(NAME, CONVERT_ROW) \
+static void NAME( \
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGB, uint32_t rgb_width, uint32_t rgb_height, uint32_t RGB_stride, \
+	YCbCrType yuv_type, uint32_t factor) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	STORE_POLICY_BEGIN((size_t)rgb_height*RGB_stride) \
+	__m128i y_buffer[RESIZE_CHUNK_SIZE/16], u_buffer[RESIZE_CHUNK_SIZE/16], v_buffer[RESIZE_CHUNK_SIZE/16]; \
+	uint8_t *const y_row = (uint8_t*)y_buffer, *const u_row = (uint8_t*)u_buffer, *const v_row = (uint8_t*)v_buffer; \
+	\
+	uint32_t x, y; \
+	for(y=0; y<rgb_height; ++y) \
+	{ \
+		uint8_t *rgb_ptr=RGB+y*RGB_stride; \
+		for(x=0; x<rgb_width; x+=RESIZE_CHUNK_SIZE) \
+		{ \
+			const uint32_t count = (rgb_width-x)<RESIZE_CHUNK_SIZE ? (rgb_width-x) : RESIZE_CHUNK_SIZE; \
+			box_reduce_row_sse(Y+factor*(y*Y_stride+x), Y_stride, factor, count, y_row); \
+			if(factor==2) \
+			{ \
+				CONVERT_ROW(param, y_row, U+y*UV_stride+x, V+y*UV_stride+x, count, rgb_ptr+3*x); \
+			} \
+			else \
+			{ \
+				box_reduce_row_sse(U+2*(y*UV_stride+x), UV_stride, 2, count, u_row); \
+				box_reduce_row_sse(V+2*(y*UV_stride+x), UV_stride, 2, count, v_row); \
+				CONVERT_ROW(param, y_row, u_row, v_row, count, rgb_ptr+3*x); \
+			} \
+		} \
+	} \
+	STORE_POLICY_END \
+}
+
+YUV420_RGB24_BOX_FUNCTION_SSE(yuv420_rgb24_box_sse, YUV444_RGB24_ROW_POLICY_SSE)
+YUV420_RGB24_BOX_FUNCTION_SSE(yuv420_rgb24_box_sseu, yuv444_rgb24_row_sseu)
+
+// High bit depth yuv to rgb
+// For 8 bits rgb, the terms are computed with _mm_mulhi_epi16, 8 values at a time, as the std version. 
+// For 16 bits rgb, the 32 bits sums are computed with _mm_madd_epi16, on pairs of interleaved (u,v) and (y,0) 
+// values, and saturated by _mm_packs_epi32: the rounding constant includes a -32768 bias, so that the 
+// saturation range is [0:65535] once the bias is reverted (by flipping the high bit).
+// TO_14 loads the 8 values at PTR, as 14 bits values (the 8 bits values of the high precision conversions 
+// are loaded with 64 bits loads, that have no alignment constraint)
+#define P10_TO_14_SSE(PTR) _mm_srli_epi16(_mm_slli_epi16(LOAD_SI128((const __m128i*)(PTR)), 6), 2)
+#define P016_TO_14_SSE(PTR) _mm_srli_epi16(LOAD_SI128((const __m128i*)(PTR)), 2)
+#define U8_TO_14_SSE(PTR) _mm_slli_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(PTR)), _mm_setzero_si128()), 6)
+
+#define SET_EPI16_PAIR(LOW, HIGH) _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)(HIGH)<<16) | (uint16_t)(LOW)))
+
+#define YUV2RGB24_14_INIT_SSE \
+	const YUV2RGB14Param *const param = &(YUV2RGB14_RGB24[yuv_type]); \
+	const __m128i y_factor = _mm_set1_epi16(param->y_factor), \
+		r_cr_factor = _mm_set1_epi16(param->r_cr_factor), \
+		g_cb_factor = _mm_set1_epi16(param->g_cb_factor), \
+		g_cr_factor = _mm_set1_epi16(param->g_cr_factor), \
+		b_cb_factor = _mm_set1_epi16(param->b_cb_factor), \
+		y_offset = _mm_set1_epi16(param->y_offset), \
+		round = _mm_set1_epi16(1<<(RGB24_14_SHIFT-1));
+
+#define YUV2RGB48_14_INIT_SSE \
+	const YUV2RGB14Param *const param = &(YUV2RGB14_RGB48[yuv_type]); \
+	const __m128i y_factor = SET_EPI16_PAIR(param->y_factor, 0), \
+		r_factors = SET_EPI16_PAIR(0, param->r_cr_factor), \
+		g_factors = SET_EPI16_PAIR(param->g_cb_factor, param->g_cr_factor), \
+		b_factors = SET_EPI16_PAIR(param->b_cb_factor, 0), \
+		y_offset = _mm_set1_epi16(param->y_offset), \
+		round = _mm_set1_epi32((1<<(RGB48_14_SHIFT-1)) - (32768<<RGB48_14_SHIFT));
+
+// load the 16 chroma samples of a block as 14 bits values, in u_1, u_2, v_1 and v_2
+#define LOAD_UV14_PLANAR(TO_14) \
+	const __m128i u_1 = TO_14(u_ptr), \
+		u_2 = TO_14(u_ptr+8), \
+		v_1 = TO_14(v_ptr), \
+		v_2 = TO_14(v_ptr+8); \
+
+// the 14 bits values fit in signed 16 bits integers, so that they can be deinterleaved by _mm_packs_epi32, 
+// the samples of even positions being the U_1 and U_2 values (v for nv21)
+#define LOAD_UV14_INTERLEAVED(TO_14, U_1, U_2, V_1, V_2) \
+	const __m128i uv_1 = TO_14(uv_ptr), \
+		uv_2 = TO_14(uv_ptr+8), \
+		uv_3 = TO_14(uv_ptr+16), \
+		uv_4 = TO_14(uv_ptr+24); \
+	const __m128i U_1 = _mm_packs_epi32(_mm_and_si128(uv_1, _mm_set1_epi32(0xFFFF)), _mm_and_si128(uv_2, _mm_set1_epi32(0xFFFF))), \
+		U_2 = _mm_packs_epi32(_mm_and_si128(uv_3, _mm_set1_epi32(0xFFFF)), _mm_and_si128(uv_4, _mm_set1_epi32(0xFFFF))), \
+		V_1 = _mm_packs_epi32(_mm_srli_epi32(uv_1, 16), _mm_srli_epi32(uv_2, 16)), \
+		V_2 = _mm_packs_epi32(_mm_srli_epi32(uv_3, 16), _mm_srli_epi32(uv_4, 16)); \
+
+#define LOAD_UV14_P016(TO_14) LOAD_UV14_INTERLEAVED(TO_14, u_1, u_2, v_1, v_2)
+#define LOAD_UV14_NV21(TO_14) LOAD_UV14_INTERLEAVED(TO_14, v_1, v_2, u_1, u_2)
+
+// same, as interleaved (u,v) pairs in uv_1 to uv_4, for the 16 bits rgb conversion
+#define LOAD_UV14_PAIRS_PLANAR(TO_14) \
+	LOAD_UV14_PLANAR(TO_14) \
+	const __m128i uv_1 = _mm_unpacklo_epi16(u_1, v_1), \
+		uv_2 = _mm_unpackhi_epi16(u_1, v_1), \
+		uv_3 = _mm_unpacklo_epi16(u_2, v_2), \
+		uv_4 = _mm_unpackhi_epi16(u_2, v_2); \
+
+#define LOAD_UV14_PAIRS_P016(TO_14) \
+	const __m128i uv_1 = TO_14(uv_ptr), \
+		uv_2 = TO_14(uv_ptr+8), \
+		uv_3 = TO_14(uv_ptr+16), \
+		uv_4 = TO_14(uv_ptr+24); \
+
+#define LOAD_Y14(TO_14, Y_PTR) TO_14(Y_PTR)
+
+// compute the chroma terms of 8 chroma samples, duplicated for the two pixels sharing each chroma value
+#define UV2RGB24_14_16(U, V, R1, G1, B1, R2, G2, B2) \
+	u_16 = _mm_slli_epi16(_mm_sub_epi16(U, _mm_set1_epi16(8192)), 2); \
+	v_16 = _mm_slli_epi16(_mm_sub_epi16(V, _mm_set1_epi16(8192)), 2); \
+	r_tmp = _mm_add_epi16(_mm_mulhi_epi16(v_16, r_cr_factor), round); \
+	g_tmp = _mm_add_epi16(_mm_add_epi16(_mm_mulhi_epi16(u_16, g_cb_factor), _mm_mulhi_epi16(v_16, g_cr_factor)), round); \
+	b_tmp = _mm_add_epi16(_mm_mulhi_epi16(u_16, b_cb_factor), round); \
+	R1 = _mm_unpacklo_epi16(r_tmp, r_tmp); \
+	G1 = _mm_unpacklo_epi16(g_tmp, g_tmp); \
+	B1 = _mm_unpacklo_epi16(b_tmp, b_tmp); \
+	R2 = _mm_unpackhi_epi16(r_tmp, r_tmp); \
+	G2 = _mm_unpackhi_epi16(g_tmp, g_tmp); \
+	B2 = _mm_unpackhi_epi16(b_tmp, b_tmp); \
+
+// add the Y' values of 16 pixels of a line to the chroma terms, and pack rgb to 8 bits
+#define ADD_Y2RGB24_14_16(Y1, Y2, R1, G1, B1, R2, G2, B2, R_8, G_8, B_8) \
+	y_16_1 = _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(Y1, y_offset), 1), y_factor); \
+	y_16_2 = _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(Y2, y_offset), 1), y_factor); \
+	R_8 = _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(y_16_1, R1), RGB24_14_SHIFT), \
+		_mm_srai_epi16(_mm_add_epi16(y_16_2, R2), RGB24_14_SHIFT)); \
+	G_8 = _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(y_16_1, G1), RGB24_14_SHIFT), \
+		_mm_srai_epi16(_mm_add_epi16(y_16_2, G2), RGB24_14_SHIFT)); \
+	B_8 = _mm_packus_epi16(_mm_srai_epi16(_mm_add_epi16(y_16_1, B1), RGB24_14_SHIFT), \
+		_mm_srai_epi16(_mm_add_epi16(y_16_2, B2), RGB24_14_SHIFT)); \
+
+#define SAVE_RGB24_32_LINE(R_8_1, R_8_2, G_8_1, G_8_2, B_8_1, B_8_2, RGB_PTR) \
+	PACK_RGB24_32(R_8_1, R_8_2, G_8_1, G_8_2, B_8_1, B_8_2, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
+	SAVE_SI128((__m128i*)(RGB_PTR), rgb_1); \
+	SAVE_SI128((__m128i*)(RGB_PTR+16), rgb_2); \
+	SAVE_SI128((__m128i*)(RGB_PTR+32), rgb_3); \
+	SAVE_SI128((__m128i*)(RGB_PTR+48), rgb_4); \
+	SAVE_SI128((__m128i*)(RGB_PTR+64), rgb_5); \
+	SAVE_SI128((__m128i*)(RGB_PTR+80), rgb_6); \
+
+// convert a block of 32 pixels of two lines to 8 bits rgb, LOAD_UV declares u_1, u_2, v_1 and v_2
+#define YUV16_RGB24_32(LOAD_UV, TO_14) \
+	LOAD_UV(TO_14) \
+	__m128i u_16, v_16, r_tmp, g_tmp, b_tmp, y_16_1, y_16_2; \
+	__m128i r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+	__m128i r_8_11, g_8_11, b_8_11, r_8_12, g_8_12, b_8_12, r_8_21, g_8_21, b_8_21, r_8_22, g_8_22, b_8_22; \
+	\
+	UV2RGB24_14_16(u_1, v_1, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	ADD_Y2RGB24_14_16(LOAD_Y14(TO_14, y_ptr1), LOAD_Y14(TO_14, y_ptr1+8), \
+		r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2, r_8_11, g_8_11, b_8_11) \
+	ADD_Y2RGB24_14_16(LOAD_Y14(TO_14, y_ptr2), LOAD_Y14(TO_14, y_ptr2+8), \
+		r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2, r_8_21, g_8_21, b_8_21) \
+	\
+	UV2RGB24_14_16(u_2, v_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	ADD_Y2RGB24_14_16(LOAD_Y14(TO_14, y_ptr1+16), LOAD_Y14(TO_14, y_ptr1+24), \
+		r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2, r_8_12, g_8_12, b_8_12) \
+	ADD_Y2RGB24_14_16(LOAD_Y14(TO_14, y_ptr2+16), LOAD_Y14(TO_14, y_ptr2+24), \
+		r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2, r_8_22, g_8_22, b_8_22) \
+	\
+	__m128i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6; \
+	SAVE_RGB24_32_LINE(r_8_11, r_8_12, g_8_11, g_8_12, b_8_11, b_8_12, rgb_ptr1) \
+	SAVE_RGB24_32_LINE(r_8_21, r_8_22, g_8_21, g_8_22, b_8_21, b_8_22, rgb_ptr2) \
+
+// add the Y' values of 8 pixels (in Y_LO and Y_HI) to the chroma terms of their 4 chroma samples, and pack
+#define ADD_Y2RGB48_14_8(Y_LO, Y_HI, UV) \
+	_mm_packs_epi32( \
+		_mm_srai_epi32(_mm_add_epi32(Y_LO, _mm_shuffle_epi32(UV, 0x50)), RGB48_14_SHIFT), \
+		_mm_srai_epi32(_mm_add_epi32(Y_HI, _mm_shuffle_epi32(UV, 0xFA)), RGB48_14_SHIFT))
+
+#define Y2RGB48_14_8(Y, R, G, B) \
+	y_16 = _mm_sub_epi16(Y, y_offset); \
+	y_lo = _mm_madd_epi16(_mm_unpacklo_epi16(y_16, _mm_setzero_si128()), y_factor); \
+	y_hi = _mm_madd_epi16(_mm_unpackhi_epi16(y_16, _mm_setzero_si128()), y_factor); \
+	R = ADD_Y2RGB48_14_8(y_lo, y_hi, r_uv); \
+	G = ADD_Y2RGB48_14_8(y_lo, y_hi, g_uv); \
+	B = ADD_Y2RGB48_14_8(y_lo, y_hi, b_uv); \
+
+// convert 8 pixels of both lines, from the 4 chroma samples in UV (interleaved u and v) and the y values 
+// Y1 and Y2, the results are biased by -32768
+#define YUV2RGB48_14_8(UV, Y1, Y2, R1, G1, B1, R2, G2, B2) \
+	uv_16 = _mm_sub_epi16(UV, _mm_set1_epi16(8192)); \
+	r_uv = _mm_add_epi32(_mm_madd_epi16(uv_16, r_factors), round); \
+	g_uv = _mm_add_epi32(_mm_madd_epi16(uv_16, g_factors), round); \
+	b_uv = _mm_add_epi32(_mm_madd_epi16(uv_16, b_factors), round); \
+	Y2RGB48_14_8(Y1, R1, G1, B1) \
+	Y2RGB48_14_8(Y2, R2, G2, B2) \
+
+// interleave 8 pixels of 16 bits r, g and b values: the pixels are first expanded to 64 bits (r, g, b, 0), 
+// then pixels 0 and 4, 1 and 5... are gathered in the same vector, so that 64 bits shifts move each of them 
+// to its position in the lanes of the output vectors (pixel 0 and 1 fill the first lane of RGB1, 4 and 5 the 
+// second lane of RGB2)
+#define PACK_RGB48_8(R, G, B, RGB1, RGB2, RGB3) \
+	{ \
+		const __m128i rg_1 = _mm_unpacklo_epi16(R, G), \
+			rg_2 = _mm_unpackhi_epi16(R, G), \
+			b0_1 = _mm_unpacklo_epi16(B, _mm_setzero_si128()), \
+			b0_2 = _mm_unpackhi_epi16(B, _mm_setzero_si128()); \
+		const __m128i p01 = _mm_unpacklo_epi32(rg_1, b0_1), \
+			p23 = _mm_unpackhi_epi32(rg_1, b0_1), \
+			p45 = _mm_unpacklo_epi32(rg_2, b0_2), \
+			p67 = _mm_unpackhi_epi32(rg_2, b0_2); \
+		const __m128i p04 = _mm_unpacklo_epi64(p01, p45), \
+			p15 = _mm_unpackhi_epi64(p01, p45), \
+			p26 = _mm_unpacklo_epi64(p23, p67), \
+			p37 = _mm_unpackhi_epi64(p23, p67); \
+		const __m128i rgb_a = _mm_or_si128(p04, _mm_slli_epi64(p15, 48)), \
+			rgb_b = _mm_or_si128(_mm_srli_epi64(p15, 16), _mm_slli_epi64(p26, 32)), \
+			rgb_c = _mm_or_si128(_mm_srli_epi64(p26, 32), _mm_slli_epi64(p37, 16)); \
+		RGB1 = _mm_unpacklo_epi64(rgb_a, rgb_b); \
+		RGB2 = _mm_unpacklo_epi64(rgb_c, _mm_unpackhi_epi64(rgb_a, rgb_a)); \
+		RGB3 = _mm_unpackhi_epi64(rgb_b, rgb_c); \
+	}
+
+// revert the bias and save 8 pixels
+#define SAVE_RGB48_8(R, G, B, RGB_PTR) \
+	PACK_RGB48_8(_mm_xor_si128(R, _mm_set1_epi16(-32768)), _mm_xor_si128(G, _mm_set1_epi16(-32768)), \
+		_mm_xor_si128(B, _mm_set1_epi16(-32768)), rgb_1, rgb_2, rgb_3) \
+	SAVE_SI128((__m128i*)(RGB_PTR), rgb_1); \
+	SAVE_SI128((__m128i*)(RGB_PTR+8), rgb_2); \
+	SAVE_SI128((__m128i*)(RGB_PTR+16), rgb_3); \
+
+// convert a block of 32 pixels of two lines to 16 bits rgb, LOAD_UV declares uv_1 to uv_4
+#define YUV16_RGB48_32(LOAD_UV, TO_14) \
+	LOAD_UV(TO_14) \
+	__m128i uv_16, r_uv, g_uv, b_uv, y_16, y_lo, y_hi; \
+	__m128i r_1, g_1, b_1, r_2, g_2, b_2, rgb_1, rgb_2, rgb_3; \
+	\
+	YUV2RGB48_14_8(uv_1, LOAD_Y14(TO_14, y_ptr1), LOAD_Y14(TO_14, y_ptr2), r_1, g_1, b_1, r_2, g_2, b_2) \
+	SAVE_RGB48_8(r_1, g_1, b_1, rgb_ptr1) \
+	SAVE_RGB48_8(r_2, g_2, b_2, rgb_ptr2) \
+	YUV2RGB48_14_8(uv_2, LOAD_Y14(TO_14, y_ptr1+8), LOAD_Y14(TO_14, y_ptr2+8), r_1, g_1, b_1, r_2, g_2, b_2) \
+	SAVE_RGB48_8(r_1, g_1, b_1, rgb_ptr1+24) \
+	SAVE_RGB48_8(r_2, g_2, b_2, rgb_ptr2+24) \
+	YUV2RGB48_14_8(uv_3, LOAD_Y14(TO_14, y_ptr1+16), LOAD_Y14(TO_14, y_ptr2+16), r_1, g_1, b_1, r_2, g_2, b_2) \
+	SAVE_RGB48_8(r_1, g_1, b_1, rgb_ptr1+48) \
+	SAVE_RGB48_8(r_2, g_2, b_2, rgb_ptr2+48) \
+	YUV2RGB48_14_8(uv_4, LOAD_Y14(TO_14, y_ptr1+24), LOAD_Y14(TO_14, y_ptr2+24), r_1, g_1, b_1, r_2, g_2, b_2) \
+	SAVE_RGB48_8(r_1, g_1, b_1, rgb_ptr1+72) \
+	SAVE_RGB48_8(r_2, g_2, b_2, rgb_ptr2+72) \
+
+#define YUV16_RGB_FUNCTIONS_SSE(SUFFIX) \
+YUV420P16_RGB_FUNCTION(static, yuv420p10_rgb24_##SUFFIX, yuv420p10_rgb24_std, 32, uint16_t, uint8_t, \
+	YUV2RGB24_14_INIT_SSE, YUV16_RGB24_32(LOAD_UV14_PLANAR, P10_TO_14_SSE)) \
+YUV420P16_RGB_FUNCTION(static, yuv420p10_rgb48_##SUFFIX, yuv420p10_rgb48_std, 32, uint16_t, uint16_t, \
+	YUV2RGB48_14_INIT_SSE, YUV16_RGB48_32(LOAD_UV14_PAIRS_PLANAR, P10_TO_14_SSE)) \
+P016_RGB_FUNCTION(static, p010_rgb24_##SUFFIX, p010_rgb24_std, 32, uint16_t, uint8_t, \
+	YUV2RGB24_14_INIT_SSE, YUV16_RGB24_32(LOAD_UV14_P016, P016_TO_14_SSE)) \
+P016_RGB_FUNCTION(static, p010_rgb48_##SUFFIX, p010_rgb48_std, 32, uint16_t, uint16_t, \
+	YUV2RGB48_14_INIT_SSE, YUV16_RGB48_32(LOAD_UV14_PAIRS_P016, P016_TO_14_SSE)) \
+YUV420P16_RGB_FUNCTION(static, yuv420_rgb24_precise_##SUFFIX, yuv420_rgb24_precise_std, 32, uint8_t, uint8_t, \
+	YUV2RGB24_14_INIT_SSE, YUV16_RGB24_32(LOAD_UV14_PLANAR, U8_TO_14_SSE)) \
+P016_RGB_FUNCTION(static, nv12_rgb24_precise_##SUFFIX, nv12_rgb24_precise_std, 32, uint8_t, uint8_t, \
+	YUV2RGB24_14_INIT_SSE, YUV16_RGB24_32(LOAD_UV14_P016, U8_TO_14_SSE)) \
+P016_RGB_FUNCTION(static, nv21_rgb24_precise_##SUFFIX, nv21_rgb24_precise_std, 32, uint8_t, uint8_t, \
+	YUV2RGB24_14_INIT_SSE, YUV16_RGB24_32(LOAD_UV14_NV21, U8_TO_14_SSE))
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+YUV16_RGB_FUNCTIONS_SSE(sse)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+YUV16_RGB_FUNCTIONS_SSE(sseu)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+// High precision rgb24 to yuv (see RGB2YUV15Param)
+// The sums of the products of the 16 bits (r, g) and (b, 0) pairs with the factors are computed in 32 bits 
+// with _mm_madd_epi16, the results being packed back to 16 bits after the shift.
+#define RGB2YUV15_INIT_SSE \
+	const RGB2YUV15Param *const param = &(RGB2YUV15[yuv_type]); \
+	const __m128i y_rg_factors = SET_EPI16_PAIR(param->y_r_factor, param->y_g_factor), \
+		y_b_factors = SET_EPI16_PAIR(param->y_b_factor, 0), \
+		cb_rg_factors = SET_EPI16_PAIR(param->cb_r_factor, param->cb_g_factor), \
+		cb_b_factors = SET_EPI16_PAIR(param->cb_b_factor, 0), \
+		cr_rg_factors = SET_EPI16_PAIR(param->cr_r_factor, param->cr_g_factor), \
+		cr_b_factors = SET_EPI16_PAIR(param->cr_b_factor, 0), \
+		y_round = _mm_set1_epi32((param->y_offset<<RGB2YUV15_PRECISION) + (1<<(RGB2YUV15_PRECISION-1))), \
+		uv_round = _mm_set1_epi32((128<<(RGB2YUV15_PRECISION+2)) + (1<<(RGB2YUV15_PRECISION+1)));
+
+// compute (FACTORS.(R, G, B) + ROUND)>>SHIFT for 8 values in each channel
+#define DOT15_HALF_SSE(UNPACK, R, G, B, PREFIX, ROUND, SHIFT) \
+	_mm_srai_epi32(_mm_add_epi32(_mm_add_epi32(_mm_madd_epi16(UNPACK(R, G), PREFIX##_rg_factors), \
+		_mm_madd_epi16(UNPACK(B, _mm_setzero_si128()), PREFIX##_b_factors)), ROUND), SHIFT)
+#define DOT15_8_SSE(R, G, B, PREFIX, ROUND, SHIFT) \
+	_mm_packs_epi32(DOT15_HALF_SSE(_mm_unpacklo_epi16, R, G, B, PREFIX, ROUND, SHIFT), \
+		DOT15_HALF_SSE(_mm_unpackhi_epi16, R, G, B, PREFIX, ROUND, SHIFT))
+
+// save the Y values of 16 pixels of a line, from the even and odd pixels values
+#define SAVE_Y15_16(Y_EVEN, Y_ODD, Y_PTR) \
+	Y = _mm_packus_epi16(Y_EVEN, Y_ODD); \
+	SAVE_SI128((__m128i*)(Y_PTR), _mm_unpackhi_epi8(_mm_slli_si128(Y, 8), Y));
+
+// convert 16 pixels of both lines, starting at pixel OFFSET, and compute the 8 cb and cr values in CB and CR
+// After the unpack steps (see RGB2YUV_32_ORDER), rgb1 has the r values of the even pixels of the first line 
+// in its low half and of the second line in its high half, rgb4 the same for the odd pixels.
+#define RGB2YUV15_16(OFFSET, CB, CR) \
+	rgb1 = LOAD_SI128((const __m128i*)(rgb_ptr1+3*(OFFSET))); \
+	rgb2 = LOAD_SI128((const __m128i*)(rgb_ptr1+3*(OFFSET)+16)); \
+	rgb3 = LOAD_SI128((const __m128i*)(rgb_ptr1+3*(OFFSET)+32)); \
+	rgb4 = LOAD_SI128((const __m128i*)(rgb_ptr2+3*(OFFSET))); \
+	rgb5 = LOAD_SI128((const __m128i*)(rgb_ptr2+3*(OFFSET)+16)); \
+	rgb6 = LOAD_SI128((const __m128i*)(rgb_ptr2+3*(OFFSET)+32)); \
+	UNPACK_RGB24_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6) \
+	UNPACK_RGB24_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6) \
+	UNPACK_RGB24_32_STEP(rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6) \
+	UNPACK_RGB24_32_STEP(tmp1, tmp2, tmp3, tmp4, tmp5, tmp6, rgb1, rgb2, rgb3, rgb4, rgb5, rgb6) \
+	r_1 = _mm_unpacklo_epi8(rgb1, _mm_setzero_si128()); \
+	g_1 = _mm_unpacklo_epi8(rgb2, _mm_setzero_si128()); \
+	b_1 = _mm_unpacklo_epi8(rgb3, _mm_setzero_si128()); \
+	r_2 = _mm_unpacklo_epi8(rgb4, _mm_setzero_si128()); \
+	g_2 = _mm_unpacklo_epi8(rgb5, _mm_setzero_si128()); \
+	b_2 = _mm_unpacklo_epi8(rgb6, _mm_setzero_si128()); \
+	SAVE_Y15_16(DOT15_8_SSE(r_1, g_1, b_1, y, y_round, RGB2YUV15_PRECISION), \
+		DOT15_8_SSE(r_2, g_2, b_2, y, y_round, RGB2YUV15_PRECISION), y_ptr1+(OFFSET)) \
+	r_sum = _mm_add_epi16(r_1, r_2); \
+	g_sum = _mm_add_epi16(g_1, g_2); \
+	b_sum = _mm_add_epi16(b_1, b_2); \
+	r_1 = _mm_unpackhi_epi8(rgb1, _mm_setzero_si128()); \
+	g_1 = _mm_unpackhi_epi8(rgb2, _mm_setzero_si128()); \
+	b_1 = _mm_unpackhi_epi8(rgb3, _mm_setzero_si128()); \
+	r_2 = _mm_unpackhi_epi8(rgb4, _mm_setzero_si128()); \
+	g_2 = _mm_unpackhi_epi8(rgb5, _mm_setzero_si128()); \
+	b_2 = _mm_unpackhi_epi8(rgb6, _mm_setzero_si128()); \
+	SAVE_Y15_16(DOT15_8_SSE(r_1, g_1, b_1, y, y_round, RGB2YUV15_PRECISION), \
+		DOT15_8_SSE(r_2, g_2, b_2, y, y_round, RGB2YUV15_PRECISION), y_ptr2+(OFFSET)) \
+	r_sum = _mm_add_epi16(r_sum, _mm_add_epi16(r_1, r_2)); \
+	g_sum = _mm_add_epi16(g_sum, _mm_add_epi16(g_1, g_2)); \
+	b_sum = _mm_add_epi16(b_sum, _mm_add_epi16(b_1, b_2)); \
+	CB = DOT15_8_SSE(r_sum, g_sum, b_sum, cb, uv_round, RGB2YUV15_PRECISION+2); \
+	CR = DOT15_8_SSE(r_sum, g_sum, b_sum, cr, uv_round, RGB2YUV15_PRECISION+2);
+
+// convert a block of 32 pixels of two lines, SAVE_UV being one of the SAVE_UV_PLANAR, SAVE_UV_NV12 and 
+// SAVE_UV_NV21 functions
+#define RGB2YUV15_32(SAVE_UV) \
+	__m128i rgb1, rgb2, rgb3, rgb4, rgb5, rgb6, tmp1, tmp2, tmp3, tmp4, tmp5, tmp6; \
+	__m128i r_1, g_1, b_1, r_2, g_2, b_2, r_sum, g_sum, b_sum, Y; \
+	__m128i cb_1, cr_1, cb_2, cr_2; \
+	RGB2YUV15_16(0, cb_1, cr_1) \
+	RGB2YUV15_16(16, cb_2, cr_2) \
+	SAVE_UV(_mm_packus_epi16(cb_1, cb_2), _mm_packus_epi16(cr_1, cr_2))
+
+#define RGB24_YUV15_FUNCTIONS_SSE(SUFFIX) \
+RGB_YUV420_FUNCTION(static, rgb24_yuv420_precise_##SUFFIX, rgb24_yuv420_precise_std, 32, 3, \
+	RGB2YUV15_INIT_SSE, RGB2YUV15_32(SAVE_UV_PLANAR)) \
+RGB_NV_FUNCTION(static, rgb24_nv12_precise_##SUFFIX, rgb24_nv12_precise_std, 32, 3, \
+	RGB2YUV15_INIT_SSE, RGB2YUV15_32(SAVE_UV_NV12)) \
+RGB_NV_FUNCTION(static, rgb24_nv21_precise_##SUFFIX, rgb24_nv21_precise_std, 32, 3, \
+	RGB2YUV15_INIT_SSE, RGB2YUV15_32(SAVE_UV_NV21))
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+RGB24_YUV15_FUNCTIONS_SSE(sse)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+RGB24_YUV15_FUNCTIONS_SSE(sseu)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+// Planar rgb outputs, the r_8_xx, g_8_xx and b_8_xx vectors of YUV2RGB_32 are saved without interleaving
+// float_to_half_sse is the same as float_to_half, on four values. The results are sign extended to 32 bits, 
+// so that they can be packed with _mm_packs_epi32.
+static __m128i float_to_half_sse(__m128 value)
+{
+	const __m128i bits = _mm_castps_si128(value);
+	const __m128i sign = _mm_and_si128(bits, _mm_set1_epi32((int32_t)0x80000000u));
+	const __m128i abs_bits = _mm_xor_si128(bits, sign);
+	
+	const __m128i is_nan = _mm_cmpgt_epi32(abs_bits, _mm_set1_epi32(255<<23)),
+		is_overflow = _mm_cmpgt_epi32(abs_bits, _mm_set1_epi32((143<<23)-1)),
+		is_subnormal = _mm_cmplt_epi32(abs_bits, _mm_set1_epi32(113<<23));
+	
+	const __m128i overflow = _mm_or_si128(_mm_set1_epi32(0x7c00), _mm_and_si128(is_nan, _mm_set1_epi32(0x0200)));
+	const __m128 magic = _mm_castsi128_ps(_mm_set1_epi32(126<<23));
+	const __m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(abs_bits), magic)), 
+		_mm_castps_si128(magic));
+	const __m128i normal = _mm_srli_epi32(_mm_add_epi32(_mm_sub_epi32(abs_bits, _mm_set1_epi32((112<<23)-0xfff)), 
+		_mm_and_si128(_mm_srli_epi32(abs_bits, 13), _mm_set1_epi32(1))), 13);
+	
+	__m128i half = _mm_or_si128(_mm_and_si128(is_subnormal, subnormal), _mm_andnot_si128(is_subnormal, normal));
+	half = _mm_or_si128(_mm_and_si128(is_overflow, overflow), _mm_andnot_si128(is_overflow, half));
+	return _mm_or_si128(half, _mm_srai_epi32(sign, 16));
+}
+
+#define NORMALIZE_INIT_SSE \
+	const __m128 scale_r = _mm_set1_ps(scale[0]), scale_g = _mm_set1_ps(scale[1]), scale_b = _mm_set1_ps(scale[2]), \
+		bias_r = _mm_set1_ps(bias[0]), bias_g = _mm_set1_ps(bias[1]), bias_b = _mm_set1_ps(bias[2]);
+
+// normalized float values of the 4 32 bits values of VALUE, for channel CHANNEL (r, g or b)
+#define NORMALIZE_SSE(VALUE, CHANNEL) _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(VALUE), scale_##CHANNEL), bias_##CHANNEL)
+
+// STORE saves the 16 values of VALUE_8, of channel CHANNEL, at PTR
+#define STORE_RGBP_SSE(VALUE_8, PTR, CHANNEL) \
+	SAVE_SI128((__m128i*)(PTR), VALUE_8);
+
+#define STORE_RGBP_FLOAT_SSE(VALUE_8, PTR, CHANNEL) \
+	{ \
+		const __m128i value_lo = _mm_unpacklo_epi8(VALUE_8, _mm_setzero_si128()), \
+			value_hi = _mm_unpackhi_epi8(VALUE_8, _mm_setzero_si128()); \
+		SAVE_SI128((__m128i*)(PTR), _mm_castps_si128(NORMALIZE_SSE(_mm_unpacklo_epi16(value_lo, _mm_setzero_si128()), CHANNEL))); \
+		SAVE_SI128((__m128i*)(PTR+4), _mm_castps_si128(NORMALIZE_SSE(_mm_unpackhi_epi16(value_lo, _mm_setzero_si128()), CHANNEL))); \
+		SAVE_SI128((__m128i*)(PTR+8), _mm_castps_si128(NORMALIZE_SSE(_mm_unpacklo_epi16(value_hi, _mm_setzero_si128()), CHANNEL))); \
+		SAVE_SI128((__m128i*)(PTR+12), _mm_castps_si128(NORMALIZE_SSE(_mm_unpackhi_epi16(value_hi, _mm_setzero_si128()), CHANNEL))); \
+	}
+
+#define STORE_RGBP_HALF_SSE(VALUE_8, PTR, CHANNEL) \
+	{ \
+		const __m128i value_lo = _mm_unpacklo_epi8(VALUE_8, _mm_setzero_si128()), \
+			value_hi = _mm_unpackhi_epi8(VALUE_8, _mm_setzero_si128()); \
+		SAVE_SI128((__m128i*)(PTR), _mm_packs_epi32( \
+			float_to_half_sse(NORMALIZE_SSE(_mm_unpacklo_epi16(value_lo, _mm_setzero_si128()), CHANNEL)), \
+			float_to_half_sse(NORMALIZE_SSE(_mm_unpackhi_epi16(value_lo, _mm_setzero_si128()), CHANNEL)))); \
+		SAVE_SI128((__m128i*)(PTR+8), _mm_packs_epi32( \
+			float_to_half_sse(NORMALIZE_SSE(_mm_unpacklo_epi16(value_hi, _mm_setzero_si128()), CHANNEL)), \
+			float_to_half_sse(NORMALIZE_SSE(_mm_unpackhi_epi16(value_hi, _mm_setzero_si128()), CHANNEL)))); \
+	}
+
+// save the 32 pixels of both lines computed by YUV2RGB_32
+#define SAVE_RGBP_32(STORE) \
+	STORE(r_8_11, r_ptr1, r) \
+	STORE(r_8_12, r_ptr1+16, r) \
+	STORE(g_8_11, g_ptr1, g) \
+	STORE(g_8_12, g_ptr1+16, g) \
+	STORE(b_8_11, b_ptr1, b) \
+	STORE(b_8_12, b_ptr1+16, b) \
+	STORE(r_8_21, r_ptr2, r) \
+	STORE(r_8_22, r_ptr2+16, r) \
+	STORE(g_8_21, g_ptr2, g) \
+	STORE(g_8_22, g_ptr2+16, g) \
+	STORE(b_8_21, b_ptr2, b) \
+	STORE(b_8_22, b_ptr2+16, b) \
+
+#define RGBP_FUNCTIONS_SSE(SUFFIX) \
+YUV420_RGBP_FUNCTION(static, yuv420_rgbp_##SUFFIX, yuv420_rgbp_std, 32, uint8_t, RGBP_PARAMS, RGBP_ARGS, , \
+	LOAD_UV_PLANAR YUV2RGB_32 SAVE_RGBP_32(STORE_RGBP_SSE)) \
+YUV420_RGBP_FUNCTION(static, yuv420_rgbp_float_##SUFFIX, yuv420_rgbp_float_std, 32, float, \
+	RGBP_FLOAT_PARAMS, RGBP_FLOAT_ARGS, NORMALIZE_INIT_SSE, \
+	LOAD_UV_PLANAR YUV2RGB_32 SAVE_RGBP_32(STORE_RGBP_FLOAT_SSE)) \
+YUV420_RGBP_FUNCTION(static, yuv420_rgbp_half_##SUFFIX, yuv420_rgbp_half_std, 32, uint16_t, \
+	RGBP_FLOAT_PARAMS, RGBP_FLOAT_ARGS, NORMALIZE_INIT_SSE, \
+	LOAD_UV_PLANAR YUV2RGB_32 SAVE_RGBP_32(STORE_RGBP_HALF_SSE))
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+RGBP_FUNCTIONS_SSE(sse)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+RGBP_FUNCTIONS_SSE(sseu)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+// SSSE3 implementations
+// They only differ from the sse ones by the interleaving of the rgb24 output, done with byte shuffles 
+// (3 shuffles and 2 ors for each 16 bytes) instead of the 5 rounds of packs of PACK_RGB24_32. They are 
+// compiled for the ssse3 target whatever the global compilation flags, so they must only be called when 
+// the cpu supports it, see yuv_rgb_cpu_simd.
+// The rgb24 input of the rgb to yuv functions is not changed: its deinterleaving to even and odd pixels 
+// of both lines (see RGB2YUV_32_ORDER) takes 4 rounds of 6 unpacks, which is fewer instructions than 
+// with byte shuffles, as each output vector gathers bytes from 6 input vectors.
+
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+
+// positions of the r, g and b values (in this order) in each of the three 16 bytes vectors of 16 rgb24 
+// pixels, 128 gives a zero byte
+static const uint8_t PACK_RGB24_SHUFFLE[9][16] __attribute__((aligned(16))) = {
+	{  0, 128, 128,   1, 128, 128,   2, 128, 128,   3, 128, 128,   4, 128, 128,   5},
+	{128,   0, 128, 128,   1, 128, 128,   2, 128, 128,   3, 128, 128,   4, 128, 128},
+	{128, 128,   0, 128, 128,   1, 128, 128,   2, 128, 128,   3, 128, 128,   4, 128},
+	{128, 128,   6, 128, 128,   7, 128, 128,   8, 128, 128,   9, 128, 128,  10, 128},
+	{  5, 128, 128,   6, 128, 128,   7, 128, 128,   8, 128, 128,   9, 128, 128,  10},
+	{128,   5, 128, 128,   6, 128, 128,   7, 128, 128,   8, 128, 128,   9, 128, 128},
+	{128,  11, 128, 128,  12, 128, 128,  13, 128, 128,  14, 128, 128,  15, 128, 128},
+	{128, 128,  11, 128, 128,  12, 128, 128,  13, 128, 128,  14, 128, 128,  15, 128},
+	{ 10, 128, 128,  11, 128, 128,  12, 128, 128,  13, 128, 128,  14, 128, 128,  15}
+};
+
+#define PACK_RGB24_16_STEP_SSSE3(R, G, B, N) \
+	_mm_or_si128(_mm_or_si128( \
+		_mm_shuffle_epi8(R, _mm_load_si128((const __m128i*)PACK_RGB24_SHUFFLE[3*(N)])), \
+		_mm_shuffle_epi8(G, _mm_load_si128((const __m128i*)PACK_RGB24_SHUFFLE[3*(N)+1]))), \
+		_mm_shuffle_epi8(B, _mm_load_si128((const __m128i*)PACK_RGB24_SHUFFLE[3*(N)+2])))
+
+// same as PACK_RGB24_32
+#define PACK_RGB24_32_SSSE3(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+RGB1 = PACK_RGB24_16_STEP_SSSE3(R1, G1, B1, 0); \
+RGB2 = PACK_RGB24_16_STEP_SSSE3(R1, G1, B1, 1); \
+RGB3 = PACK_RGB24_16_STEP_SSSE3(R1, G1, B1, 2); \
+RGB4 = PACK_RGB24_16_STEP_SSSE3(R2, G2, B2, 0); \
+RGB5 = PACK_RGB24_16_STEP_SSSE3(R2, G2, B2, 1); \
+RGB6 = PACK_RGB24_16_STEP_SSSE3(R2, G2, B2, 2); \
+
+#define YUV2RGB_32_PLANAR_SSSE3 \
+	LOAD_UV_PLANAR \
+	YUV2RGB_32 \
+	SAVE_RGB24_32_PACK(PACK_RGB24_32_SSSE3)
+
+#define YUV2RGB_32_NV12_SSSE3 \
+	LOAD_UV_NV12 \
+	YUV2RGB_32 \
+	SAVE_RGB24_32_PACK(PACK_RGB24_32_SSSE3)
+
+#define YUV2RGB_32_NV21_SSSE3 \
+	LOAD_UV_NV21 \
+	YUV2RGB_32 \
+	SAVE_RGB24_32_PACK(PACK_RGB24_32_SSSE3)
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+YUV420_RGB24_PARAM_FUNCTION_SSE(SSSE3_TARGET, yuv420_rgb24_param_ssse3, YUV2RGB_32_PLANAR_SSSE3)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+YUV420_RGB24_PARAM_FUNCTION_SSE(SSSE3_TARGET, yuv420_rgb24_param_ssse3u, YUV2RGB_32_PLANAR_SSSE3)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+SSSE3_TARGET void yuv420_rgb24_ssse3(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	yuv420_rgb24_param_ssse3(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, &(YUV2RGB[yuv_type]));
+}
+
+SSSE3_TARGET void yuv420_rgb24_ssse3u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	yuv420_rgb24_param_ssse3u(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, &(YUV2RGB[yuv_type]));
+}
+
+// nv12 and nv21 to rgb24, same as nv12_rgb24_sse
+#define NV_RGB24_FUNCTION_SSSE3(NAME, STD_FUNCTION, CONVERT) \
+SSSE3_TARGET void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]); \
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride) \
+	\
+	uint32_t x, y; \
+	for(y=0; (y+1)<height; y+=2) \
+	{ \
+		const uint8_t *y_ptr1=Y+y*Y_stride, \
+			*y_ptr2=Y+(y+1)*Y_stride, \
+			*uv_ptr=UV+(y/2)*UV_stride; \
+		\
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride, \
+			*rgb_ptr2=RGB+(y+1)*RGB_stride; \
+		\
+		for(x=0; (x+31)<width; x+=32) \
+		{ \
+			CONVERT \
+			\
+			y_ptr1+=32; \
+			y_ptr2+=32; \
+			uv_ptr+=32; \
+			rgb_ptr1+=96; \
+			rgb_ptr2+=96; \
+		} \
+	} \
+	NV_RGB24_TAIL(STD_FUNCTION, 32) \
+	STORE_POLICY_END \
+}
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+NV_RGB24_FUNCTION_SSSE3(nv12_rgb24_ssse3, nv12_rgb24_lut, YUV2RGB_32_NV12_SSSE3)
+NV_RGB24_FUNCTION_SSSE3(nv21_rgb24_ssse3, nv21_rgb24_lut, YUV2RGB_32_NV21_SSSE3)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+NV_RGB24_FUNCTION_SSSE3(nv12_rgb24_ssse3u, nv12_rgb24_lut, YUV2RGB_32_NV12_SSSE3)
+NV_RGB24_FUNCTION_SSSE3(nv21_rgb24_ssse3u, nv21_rgb24_lut, YUV2RGB_32_NV21_SSSE3)
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+// AVX2 implementations
+// They are compiled for the avx2 target whatever the global compilation flags, so they must only
+// be called when the cpu supports it, see yuv_rgb_cpu_simd
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+#define UV2RGB_32_AVX2(U,V,R1,G1,B1,R2,G2,B2) \
+	r_tmp = _mm256_srai_epi16(_mm256_mullo_epi16(V, _mm256_set1_epi16(param->cr_factor)), 6); \
+	g_tmp = _mm256_srai_epi16(_mm256_add_epi16( \
+		_mm256_mullo_epi16(U, _mm256_set1_epi16(param->g_cb_factor)), \
+		_mm256_mullo_epi16(V, _mm256_set1_epi16(param->g_cr_factor))), 7); \
+	b_tmp = _mm256_srai_epi16(_mm256_mullo_epi16(U, _mm256_set1_epi16(param->cb_factor)), 6); \
+	R1 = _mm256_unpacklo_epi16(r_tmp, r_tmp); \
+	G1 = _mm256_unpacklo_epi16(g_tmp, g_tmp); \
+	B1 = _mm256_unpacklo_epi16(b_tmp, b_tmp); \
+	R2 = _mm256_unpackhi_epi16(r_tmp, r_tmp); \
+	G2 = _mm256_unpackhi_epi16(g_tmp, g_tmp); \
+	B2 = _mm256_unpackhi_epi16(b_tmp, b_tmp); \
+
+// same as ADD_Y2RGB_16
+#define ADD_Y2RGB_32_AVX2(Y1,Y2,R1,G1,B1,R2,G2,B2) \
+	Y1 = _mm256_mulhi_epi16(_mm256_slli_epi16(_mm256_sub_epi16(Y1, _mm256_set1_epi16(param->y_offset)), 7), _mm256_set1_epi16(param->y_factor*4)); \
+	Y2 = _mm256_mulhi_epi16(_mm256_slli_epi16(_mm256_sub_epi16(Y2, _mm256_set1_epi16(param->y_offset)), 7), _mm256_set1_epi16(param->y_factor*4)); \
+	\
+	R1 = _mm256_add_epi16(Y1, R1); \
+	G1 = _mm256_sub_epi16(Y1, G1); \
+	B1 = _mm256_add_epi16(Y1, B1); \
+	R2 = _mm256_add_epi16(Y2, R2); \
+	G2 = _mm256_sub_epi16(Y2, G2); \
+	B2 = _mm256_add_epi16(Y2, B2); \
+
+// pshufb masks used to interleave 16 r, g and b values into 48 bytes of rgb24 data
+// RGB24_SHUFFLE_<channel><output vector>, see rgb.txt for the resulting layout
+#define RGB24_SHUFFLE_R0 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5
+#define RGB24_SHUFFLE_G0 -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1
+#define RGB24_SHUFFLE_B0 -1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1
+#define RGB24_SHUFFLE_R1 -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1
+#define RGB24_SHUFFLE_G1 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10
+#define RGB24_SHUFFLE_B1 -1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1
+#define RGB24_SHUFFLE_R2 -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1
+#define RGB24_SHUFFLE_G2 -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1
+#define RGB24_SHUFFLE_B2 10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15
+
+#define SHUFFLE_RGB24_AVX2(R, G, B, N) \
+	_mm256_or_si256(_mm256_or_si256( \
+		_mm256_shuffle_epi8(R, _mm256_setr_epi8(RGB24_SHUFFLE_R##N, RGB24_SHUFFLE_R##N)), \
+		_mm256_shuffle_epi8(G, _mm256_setr_epi8(RGB24_SHUFFLE_G##N, RGB24_SHUFFLE_G##N))), \
+		_mm256_shuffle_epi8(B, _mm256_setr_epi8(RGB24_SHUFFLE_B##N, RGB24_SHUFFLE_B##N)))
+
+// interleave 32 r, g and b values (each in pixel order) to 96 bytes of rgb24 data
+// shuffles work inside each 128 bits lane, so the lanes are reordered afterward
+#define PACK_RGB24_32_AVX2(R, G, B, RGB1, RGB2, RGB3) \
+	rgb_tmp1 = SHUFFLE_RGB24_AVX2(R, G, B, 0); \
+	rgb_tmp2 = SHUFFLE_RGB24_AVX2(R, G, B, 1); \
+	rgb_tmp3 = SHUFFLE_RGB24_AVX2(R, G, B, 2); \
+	RGB1 = _mm256_permute2x128_si256(rgb_tmp1, rgb_tmp2, 0x20); \
+	RGB2 = _mm256_permute2x128_si256(rgb_tmp3, rgb_tmp1, 0x30); \
+	RGB3 = _mm256_permute2x128_si256(rgb_tmp2, rgb_tmp3, 0x31); \
+
+#define LOAD_UV_PLANAR_AVX2 \
+	__m256i u = LOAD_SI256((const __m256i*)(u_ptr)); \
+	__m256i v = LOAD_SI256((const __m256i*)(v_ptr)); \
+
+// packus works inside each 128 bits lane, the permute restores u and v order
+#define LOAD_UV_NV12_AVX2 \
+	__m256i uv1 = LOAD_SI256((const __m256i*)(uv_ptr)); \
+	__m256i uv2 = LOAD_SI256((const __m256i*)(uv_ptr+32)); \
+	__m256i u = _mm256_packus_epi16(_mm256_and_si256(uv1, _mm256_set1_epi16(255)), _mm256_and_si256(uv2, _mm256_set1_epi16(255))); \
+	__m256i v = _mm256_packus_epi16(_mm256_srli_epi16(uv1, 8), _mm256_srli_epi16(uv2, 8)); \
+	u = _mm256_permute4x64_epi64(u, 0xD8); \
+	v = _mm256_permute4x64_epi64(v, 0xD8); \
+
+#define LOAD_UV_NV21_AVX2 \
+	__m256i uv1 = LOAD_SI256((const __m256i*)(uv_ptr)); \
+	__m256i uv2 = LOAD_SI256((const __m256i*)(uv_ptr+32)); \
+	__m256i v = _mm256_packus_epi16(_mm256_and_si256(uv1, _mm256_set1_epi16(255)), _mm256_and_si256(uv2, _mm256_set1_epi16(255))); \
+	__m256i u = _mm256_packus_epi16(_mm256_srli_epi16(uv1, 8), _mm256_srli_epi16(uv2, 8)); \
+	u = _mm256_permute4x64_epi64(u, 0xD8); \
+	v = _mm256_permute4x64_epi64(v, 0xD8); \
+
+// convert 32 pixels of one line, using the rgb offsets computed by UV2RGB_32_AVX2, and save them with SAVE
+#define YUV2RGB_LINE_32_AVX2(Y_PTR, RGB_PTR, SAVE) \
+	r_16_1=r_uv_16_1; g_16_1=g_uv_16_1; b_16_1=b_uv_16_1; \
+	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
+	\
+	y = LOAD_SI256((const __m256i*)(Y_PTR)); \
+	y_16_1 = _mm256_unpacklo_epi8(y, _mm256_setzero_si256()); \
+	y_16_2 = _mm256_unpackhi_epi8(y, _mm256_setzero_si256()); \
+	\
+	ADD_Y2RGB_32_AVX2(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	r_8 = _mm256_packus_epi16(r_16_1, r_16_2); \
+	g_8 = _mm256_packus_epi16(g_16_1, g_16_2); \
+	b_8 = _mm256_packus_epi16(b_16_1, b_16_2); \
+	\
+	SAVE(RGB_PTR) \
+
+// save 32 pixels of one line in rgb24 format
+#define SAVE_RGB24_32_AVX2(RGB_PTR) \
+	{ \
+		__m256i rgb_tmp1, rgb_tmp2, rgb_tmp3, rgb_1, rgb_2, rgb_3; \
+		PACK_RGB24_32_AVX2(r_8, g_8, b_8, rgb_1, rgb_2, rgb_3) \
+		SAVE_SI256((__m256i*)(RGB_PTR), rgb_1); \
+		SAVE_SI256((__m256i*)(RGB_PTR+32), rgb_2); \
+		SAVE_SI256((__m256i*)(RGB_PTR+64), rgb_3); \
+	} \
+
+// interleave 32 pixels of the four channels C0 to C3 (in memory order, each in pixel order) and save them
+// unpacks work inside each 128 bits lane, so the lanes are reordered before saving
+#define PACK_RGB32_32_AVX2(C0, C1, C2, C3, RGB_PTR) \
+	{ \
+		__m256i c01_lo = _mm256_unpacklo_epi8(C0, C1), c01_hi = _mm256_unpackhi_epi8(C0, C1), \
+			c23_lo = _mm256_unpacklo_epi8(C2, C3), c23_hi = _mm256_unpackhi_epi8(C2, C3); \
+		__m256i rgb_1 = _mm256_unpacklo_epi16(c01_lo, c23_lo), rgb_2 = _mm256_unpackhi_epi16(c01_lo, c23_lo), \
+			rgb_3 = _mm256_unpacklo_epi16(c01_hi, c23_hi), rgb_4 = _mm256_unpackhi_epi16(c01_hi, c23_hi); \
+		SAVE_SI256((__m256i*)(RGB_PTR), _mm256_permute2x128_si256(rgb_1, rgb_2, 0x20)); \
+		SAVE_SI256((__m256i*)(RGB_PTR+32), _mm256_permute2x128_si256(rgb_3, rgb_4, 0x20)); \
+		SAVE_SI256((__m256i*)(RGB_PTR+64), _mm256_permute2x128_si256(rgb_1, rgb_2, 0x31)); \
+		SAVE_SI256((__m256i*)(RGB_PTR+96), _mm256_permute2x128_si256(rgb_3, rgb_4, 0x31)); \
+	} \
+
+// save 32 pixels of one line in a 32 bits format, a_8 must contain the alpha value
+#define SAVE_RGBA_32_AVX2(RGB_PTR) PACK_RGB32_32_AVX2(r_8, g_8, b_8, a_8, RGB_PTR)
+#define SAVE_BGRA_32_AVX2(RGB_PTR) PACK_RGB32_32_AVX2(b_8, g_8, r_8, a_8, RGB_PTR)
+#define SAVE_ARGB_32_AVX2(RGB_PTR) PACK_RGB32_32_AVX2(a_8, r_8, g_8, b_8, RGB_PTR)
+#define SAVE_ABGR_32_AVX2(RGB_PTR) PACK_RGB32_32_AVX2(a_8, b_8, g_8, r_8, RGB_PTR)
+
+// u and v values are sign extended to 16 bits in pixel order, so that the result of 
+// UV2RGB_32_AVX2 matches the per lane unpacking of the y values
+// SAVE saves the pixels of one line, in a format of RGB_SIZE bytes per pixel
+#define YUV2RGB_64_AVX2(SAVE, RGB_SIZE) \
+	__m256i r_tmp, g_tmp, b_tmp; \
+	__m256i r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+	__m256i r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2; \
+	__m256i y, y_16_1, y_16_2; \
+	__m256i r_8, g_8, b_8; \
+	\
+	u = _mm256_add_epi8(u, _mm256_set1_epi8(-128)); \
+	v = _mm256_add_epi8(v, _mm256_set1_epi8(-128)); \
+	\
+	/* process first 32 pixels of both lines */\
+	__m256i u_16 = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(u)); \
+	__m256i v_16 = _mm256_cvtepi8_epi16(_mm256_castsi256_si128(v)); \
+	\
+	UV2RGB_32_AVX2(u_16, v_16, r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2) \
+	YUV2RGB_LINE_32_AVX2(y_ptr1, rgb_ptr1, SAVE) \
+	YUV2RGB_LINE_32_AVX2(y_ptr2, rgb_ptr2, SAVE) \
+	\
+	/* process last 32 pixels of both lines */\
+	u_16 = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(u, 1)); \
+	v_16 = _mm256_cvtepi8_epi16(_mm256_extracti128_si256(v, 1)); \
+	\
+	UV2RGB_32_AVX2(u_16, v_16, r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2) \
+	YUV2RGB_LINE_32_AVX2(y_ptr1+32, rgb_ptr1+32*(RGB_SIZE), SAVE) \
+	YUV2RGB_LINE_32_AVX2(y_ptr2+32, rgb_ptr2+32*(RGB_SIZE), SAVE) \
+
+#define YUV2RGB_64_PLANAR_AVX2 \
+	LOAD_UV_PLANAR_AVX2 \
+	YUV2RGB_64_AVX2(SAVE_RGB24_32_AVX2, 3)
+
+#define YUV2RGB_64_NV12_AVX2 \
+	LOAD_UV_NV12_AVX2 \
+	YUV2RGB_64_AVX2(SAVE_RGB24_32_AVX2, 3)
+
+#define YUV2RGB_64_NV21_AVX2 \
+	LOAD_UV_NV21_AVX2 \
+	YUV2RGB_64_AVX2(SAVE_RGB24_32_AVX2, 3)
+
+AVX2_TARGET void yuv420_rgb24_avx2(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI256 _mm256_load_si256
+	#define SAVE_SI256 STREAM_SI256
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride)
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*u_ptr=U+(y/2)*UV_stride,
+			*v_ptr=V+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_PLANAR_AVX2
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			u_ptr+=32; 
+			v_ptr+=32;
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	YUV420_RGB24_TAIL(yuv420_rgb24_lut, 64)
+	STORE_POLICY_END
+	#undef LOAD_SI256
+	#undef SAVE_SI256
+}
+
+AVX2_TARGET void yuv420_rgb24_avx2u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI256 _mm256_loadu_si256
+	#define SAVE_SI256 _mm256_storeu_si256
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*u_ptr=U+(y/2)*UV_stride,
+			*v_ptr=V+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_PLANAR_AVX2
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			u_ptr+=32; 
+			v_ptr+=32;
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	YUV420_RGB24_TAIL(yuv420_rgb24_lut, 64)
+	#undef LOAD_SI256
+	#undef SAVE_SI256
+}
+
+AVX2_TARGET void nv12_rgb24_avx2(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI256 _mm256_load_si256
+	#define SAVE_SI256 STREAM_SI256
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride)
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*uv_ptr=UV+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_NV12_AVX2
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			uv_ptr+=64; 
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	NV_RGB24_TAIL(nv12_rgb24_lut, 64)
+	STORE_POLICY_END
+	#undef LOAD_SI256
+	#undef SAVE_SI256
+}
+
+AVX2_TARGET void nv12_rgb24_avx2u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI256 _mm256_loadu_si256
+	#define SAVE_SI256 _mm256_storeu_si256
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*uv_ptr=UV+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_NV12_AVX2
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			uv_ptr+=64; 
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	NV_RGB24_TAIL(nv12_rgb24_lut, 64)
+	#undef LOAD_SI256
+	#undef SAVE_SI256
+}
+
+AVX2_TARGET void nv21_rgb24_avx2(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI256 _mm256_load_si256
+	#define SAVE_SI256 STREAM_SI256
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride)
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*uv_ptr=UV+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_NV21_AVX2
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			uv_ptr+=64; 
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	NV_RGB24_TAIL(nv21_rgb24_lut, 64)
+	STORE_POLICY_END
+	#undef LOAD_SI256
+	#undef SAVE_SI256
+}
+
+AVX2_TARGET void nv21_rgb24_avx2u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI256 _mm256_loadu_si256
+	#define SAVE_SI256 _mm256_storeu_si256
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*uv_ptr=UV+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_NV21_AVX2
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			uv_ptr+=64; 
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	NV_RGB24_TAIL(nv21_rgb24_lut, 64)
+	#undef LOAD_SI256
+	#undef SAVE_SI256
+}
+
+// 32 bits rgb outputs
+#define ALPHA_AVX2 \
+	const __m256i a_8 = _mm256_set1_epi8((char)alpha);
+
+#define RGB32_FUNCTIONS_AVX2(SUFFIX, FORMAT, format) \
+	YUV420_RGB32_FUNCTION(AVX2_TARGET static, yuv420_##format##32_##SUFFIX, yuv420_##format##32_std, 64, ALPHA_AVX2, \
+		LOAD_UV_PLANAR_AVX2 YUV2RGB_64_AVX2(SAVE_##FORMAT##_32_AVX2, 4)) \
+	NV_RGB32_FUNCTION(AVX2_TARGET static, nv12_##format##32_##SUFFIX, nv12_##format##32_std, 64, ALPHA_AVX2, \
+		LOAD_UV_NV12_AVX2 YUV2RGB_64_AVX2(SAVE_##FORMAT##_32_AVX2, 4)) \
+	NV_RGB32_FUNCTION(AVX2_TARGET static, nv21_##format##32_##SUFFIX, nv21_##format##32_std, 64, ALPHA_AVX2, \
+		LOAD_UV_NV21_AVX2 YUV2RGB_64_AVX2(SAVE_##FORMAT##_32_AVX2, 4))
+
+#define LOAD_SI256 _mm256_load_si256
+#define SAVE_SI256 STREAM_SI256
+RGB32_FUNCTIONS_AVX2(avx2, RGBA, rgba)
+RGB32_FUNCTIONS_AVX2(avx2, BGRA, bgra)
+RGB32_FUNCTIONS_AVX2(avx2, ARGB, argb)
+RGB32_FUNCTIONS_AVX2(avx2, ABGR, abgr)
+#undef LOAD_SI256
+#undef SAVE_SI256
+
+#define LOAD_SI256 _mm256_loadu_si256
+#define SAVE_SI256 _mm256_storeu_si256
+RGB32_FUNCTIONS_AVX2(avx2u, RGBA, rgba)
+RGB32_FUNCTIONS_AVX2(avx2u, BGRA, bgra)
+RGB32_FUNCTIONS_AVX2(avx2u, ARGB, argb)
+RGB32_FUNCTIONS_AVX2(avx2u, ABGR, abgr)
+#undef LOAD_SI256
+#undef SAVE_SI256
+
+// Planar half float output, the sse kernel is compiled with the f16c conversion instructions (available on 
+// all avx2 cpus), which are much faster than float_to_half_sse. NaN values may keep their payload.
+#define F16C_TARGET __attribute__((target("avx2,f16c")))
+
+#define STORE_RGBP_HALF_F16C(VALUE_8, PTR, CHANNEL) \
+	{ \
+		const __m128i value_lo = _mm_unpacklo_epi8(VALUE_8, _mm_setzero_si128()), \
+			value_hi = _mm_unpackhi_epi8(VALUE_8, _mm_setzero_si128()); \
+		SAVE_SI128((__m128i*)(PTR), _mm_unpacklo_epi64( \
+			_mm_cvtps_ph(NORMALIZE_SSE(_mm_unpacklo_epi16(value_lo, _mm_setzero_si128()), CHANNEL), _MM_FROUND_TO_NEAREST_INT), \
+			_mm_cvtps_ph(NORMALIZE_SSE(_mm_unpackhi_epi16(value_lo, _mm_setzero_si128()), CHANNEL), _MM_FROUND_TO_NEAREST_INT))); \
+		SAVE_SI128((__m128i*)(PTR+8), _mm_unpacklo_epi64( \
+			_mm_cvtps_ph(NORMALIZE_SSE(_mm_unpacklo_epi16(value_hi, _mm_setzero_si128()), CHANNEL), _MM_FROUND_TO_NEAREST_INT), \
+			_mm_cvtps_ph(NORMALIZE_SSE(_mm_unpackhi_epi16(value_hi, _mm_setzero_si128()), CHANNEL), _MM_FROUND_TO_NEAREST_INT))); \
+	}
+
+#define LOAD_SI128 _mm_load_si128
+#define SAVE_SI128 STREAM_SI128
+YUV420_RGBP_FUNCTION(F16C_TARGET static, yuv420_rgbp_half_avx2, yuv420_rgbp_half_std, 32, uint16_t, \
+	RGBP_FLOAT_PARAMS, RGBP_FLOAT_ARGS, NORMALIZE_INIT_SSE, \
+	LOAD_UV_PLANAR YUV2RGB_32 SAVE_RGBP_32(STORE_RGBP_HALF_F16C))
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+YUV420_RGBP_FUNCTION(F16C_TARGET static, yuv420_rgbp_half_avx2u, yuv420_rgbp_half_std, 32, uint16_t, \
+	RGBP_FLOAT_PARAMS, RGBP_FLOAT_ARGS, NORMALIZE_INIT_SSE, \
+	LOAD_UV_PLANAR YUV2RGB_32 SAVE_RGBP_32(STORE_RGBP_HALF_F16C))
+#undef LOAD_SI128
+#undef SAVE_SI128
+
+
+// AVX-512 implementations
+// They require the AVX512F, AVX512BW and AVX512VBMI extensions (Ice Lake and later), and are compiled
+// for that target whatever the global compilation flags, see yuv_rgb_cpu_simd
+// The rgb24 (de)interleave uses vpermb/vpermt2b with the index tables below, instead of the unpack 
+// ladder described in rgb.txt: two permutes per 64 bytes vector in both directions
+
+#define AVX512_TARGET __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+
+// r and g bytes of rgb24 output vector N, picked from the concatenation of r and g vectors
+// PACK_RGB24_BN then insert the b bytes, at the positions given by PACK_RGB24_MASKN
+static const uint8_t PACK_RGB24_RG0[64] __attribute__((aligned(64))) = {
+	  0,  64,   0,   1,  65,   0,   2,  66,   0,   3,  67,   0,   4,  68,   0,   5,
+	 69,   0,   6,  70,   0,   7,  71,   0,   8,  72,   0,   9,  73,   0,  10,  74,
+	  0,  11,  75,   0,  12,  76,   0,  13,  77,   0,  14,  78,   0,  15,  79,   0,
+	 16,  80,   0,  17,  81,   0,  18,  82,   0,  19,  83,   0,  20,  84,   0,  21
+};
+static const uint8_t PACK_RGB24_B0[64] __attribute__((aligned(64))) = {
+	  0,   0,   0,   0,   0,   1,   0,   0,   2,   0,   0,   3,   0,   0,   4,   0,
+	  0,   5,   0,   0,   6,   0,   0,   7,   0,   0,   8,   0,   0,   9,   0,   0,
+	 10,   0,   0,  11,   0,   0,  12,   0,   0,  13,   0,   0,  14,   0,   0,  15,
+	  0,   0,  16,   0,   0,  17,   0,   0,  18,   0,   0,  19,   0,   0,  20,   0
+};
+static const uint8_t PACK_RGB24_RG1[64] __attribute__((aligned(64))) = {
+	 85,   0,  22,  86,   0,  23,  87,   0,  24,  88,   0,  25,  89,   0,  26,  90,
+	  0,  27,  91,   0,  28,  92,   0,  29,  93,   0,  30,  94,   0,  31,  95,   0,
+	 32,  96,   0,  33,  97,   0,  34,  98,   0,  35,  99,   0,  36, 100,   0,  37,
+	101,   0,  38, 102,   0,  39, 103,   0,  40, 104,   0,  41, 105,   0,  42, 106
+};
+static const uint8_t PACK_RGB24_B1[64] __attribute__((aligned(64))) = {
+	  0,  21,   0,   0,  22,   0,   0,  23,   0,   0,  24,   0,   0,  25,   0,   0,
+	 26,   0,   0,  27,   0,   0,  28,   0,   0,  29,   0,   0,  30,   0,   0,  31,
+	  0,   0,  32,   0,   0,  33,   0,   0,  34,   0,   0,  35,   0,   0,  36,   0,
+	  0,  37,   0,   0,  38,   0,   0,  39,   0,   0,  40,   0,   0,  41,   0,   0
+};
+static const uint8_t PACK_RGB24_RG2[64] __attribute__((aligned(64))) = {
+	  0,  43, 107,   0,  44, 108,   0,  45, 109,   0,  46, 110,   0,  47, 111,   0,
+	 48, 112,   0,  49, 113,   0,  50, 114,   0,  51, 115,   0,  52, 116,   0,  53,
+	117,   0,  54, 118,   0,  55, 119,   0,  56, 120,   0,  57, 121,   0,  58, 122,
+	  0,  59, 123,   0,  60, 124,   0,  61, 125,   0,  62, 126,   0,  63, 127,   0
+};
+static const uint8_t PACK_RGB24_B2[64] __attribute__((aligned(64))) = {
+	 42,   0,   0,  43,   0,   0,  44,   0,   0,  45,   0,   0,  46,   0,   0,  47,
+	  0,   0,  48,   0,   0,  49,   0,   0,  50,   0,   0,  51,   0,   0,  52,   0,
+	  0,  53,   0,   0,  54,   0,   0,  55,   0,   0,  56,   0,   0,  57,   0,   0,
+	 58,   0,   0,  59,   0,   0,  60,   0,   0,  61,   0,   0,  62,   0,   0,  63
+};
+#define PACK_RGB24_MASK0 0x4924924924924924ULL
+#define PACK_RGB24_MASK1 0x2492492492492492ULL
+#define PACK_RGB24_MASK2 0x9249249249249249ULL
+
+// channel values of 64 rgb24 pixels, even pixels in the first 32 bytes and odd pixels in the last 32 bytes
+// UNPACK_RGB24_X01 picks from the first two input vectors, UNPACK_RGB24_X2 from the third one, at the
+// positions given by UNPACK_RGB24_MASKX
+static const uint8_t UNPACK_RGB24_R01[64] __attribute__((aligned(64))) = {
+	  0,   6,  12,  18,  24,  30,  36,  42,  48,  54,  60,  66,  72,  78,  84,  90,
+	 96, 102, 108, 114, 120, 126,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  3,   9,  15,  21,  27,  33,  39,  45,  51,  57,  63,  69,  75,  81,  87,  93,
+	 99, 105, 111, 117, 123,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0
+};
+static const uint8_t UNPACK_RGB24_R2[64] __attribute__((aligned(64))) = {
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   4,  10,  16,  22,  28,  34,  40,  46,  52,  58,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   1,   7,  13,  19,  25,  31,  37,  43,  49,  55,  61
+};
+static const uint8_t UNPACK_RGB24_G01[64] __attribute__((aligned(64))) = {
+	  1,   7,  13,  19,  25,  31,  37,  43,  49,  55,  61,  67,  73,  79,  85,  91,
+	 97, 103, 109, 115, 121, 127,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  4,  10,  16,  22,  28,  34,  40,  46,  52,  58,  64,  70,  76,  82,  88,  94,
+	100, 106, 112, 118, 124,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0
+};
+static const uint8_t UNPACK_RGB24_G2[64] __attribute__((aligned(64))) = {
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   5,  11,  17,  23,  29,  35,  41,  47,  53,  59,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   2,   8,  14,  20,  26,  32,  38,  44,  50,  56,  62
+};
+static const uint8_t UNPACK_RGB24_B01[64] __attribute__((aligned(64))) = {
+	  2,   8,  14,  20,  26,  32,  38,  44,  50,  56,  62,  68,  74,  80,  86,  92,
+	 98, 104, 110, 116, 122,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  5,  11,  17,  23,  29,  35,  41,  47,  53,  59,  65,  71,  77,  83,  89,  95,
+	101, 107, 113, 119, 125,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0
+};
+static const uint8_t UNPACK_RGB24_B2[64] __attribute__((aligned(64))) = {
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   0,   6,  12,  18,  24,  30,  36,  42,  48,  54,  60,
+	  0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+	  0,   0,   0,   0,   0,   3,   9,  15,  21,  27,  33,  39,  45,  51,  57,  63
+};
+#define UNPACK_RGB24_MASKR 0xffe00000ffc00000ULL
+#define UNPACK_RGB24_MASKG 0xffe00000ffc00000ULL
+#define UNPACK_RGB24_MASKB 0xffe00000ffe00000ULL
+
+// interleave the low bytes of two 16 bits vectors (even and odd pixels)
+static const uint8_t INTERLEAVE_Y[64] __attribute__((aligned(64))) = {
+	  0,  64,   2,  66,   4,  68,   6,  70,   8,  72,  10,  74,  12,  76,  14,  78,
+	 16,  80,  18,  82,  20,  84,  22,  86,  24,  88,  26,  90,  28,  92,  30,  94,
+	 32,  96,  34,  98,  36, 100,  38, 102,  40, 104,  42, 106,  44, 108,  46, 110,
+	 48, 112,  50, 114,  52, 116,  54, 118,  56, 120,  58, 122,  60, 124,  62, 126
+};
+
+#define UV2RGB_32_AVX512(U,V,R1,G1,B1,R2,G2,B2) \
+	r_tmp = _mm512_srai_epi16(_mm512_mullo_epi16(V, _mm512_set1_epi16(param->cr_factor)), 6); \
+	g_tmp = _mm512_srai_epi16(_mm512_add_epi16( \
+		_mm512_mullo_epi16(U, _mm512_set1_epi16(param->g_cb_factor)), \
+		_mm512_mullo_epi16(V, _mm512_set1_epi16(param->g_cr_factor))), 7); \
+	b_tmp = _mm512_srai_epi16(_mm512_mullo_epi16(U, _mm512_set1_epi16(param->cb_factor)), 6); \
+	R1 = _mm512_unpacklo_epi16(r_tmp, r_tmp); \
+	G1 = _mm512_unpacklo_epi16(g_tmp, g_tmp); \
+	B1 = _mm512_unpacklo_epi16(b_tmp, b_tmp); \
+	R2 = _mm512_unpackhi_epi16(r_tmp, r_tmp); \
+	G2 = _mm512_unpackhi_epi16(g_tmp, g_tmp); \
+	B2 = _mm512_unpackhi_epi16(b_tmp, b_tmp); \
+
+// same as ADD_Y2RGB_16
+#define ADD_Y2RGB_32_AVX512(Y1,Y2,R1,G1,B1,R2,G2,B2) \
+	Y1 = _mm512_mulhi_epi16(_mm512_slli_epi16(_mm512_sub_epi16(Y1, _mm512_set1_epi16(param->y_offset)), 7), _mm512_set1_epi16(param->y_factor*4)); \
+	Y2 = _mm512_mulhi_epi16(_mm512_slli_epi16(_mm512_sub_epi16(Y2, _mm512_set1_epi16(param->y_offset)), 7), _mm512_set1_epi16(param->y_factor*4)); \
+	\
+	R1 = _mm512_add_epi16(Y1, R1); \
+	G1 = _mm512_sub_epi16(Y1, G1); \
+	B1 = _mm512_add_epi16(Y1, B1); \
+	R2 = _mm512_add_epi16(Y2, R2); \
+	G2 = _mm512_sub_epi16(Y2, G2); \
+	B2 = _mm512_add_epi16(Y2, B2); \
+
+#define PACK_RGB24_64_STEP_AVX512(R, G, B, N) \
+	_mm512_mask_permutexvar_epi8( \
+		_mm512_permutex2var_epi8(R, _mm512_load_si512((const __m512i*)PACK_RGB24_RG##N), G), \
+		PACK_RGB24_MASK##N, _mm512_load_si512((const __m512i*)PACK_RGB24_B##N), B)
+
+// interleave 64 r, g and b values (each in pixel order) to 192 bytes of rgb24 data
+#define PACK_RGB24_64_AVX512(R, G, B, RGB1, RGB2, RGB3) \
+	RGB1 = PACK_RGB24_64_STEP_AVX512(R, G, B, 0); \
+	RGB2 = PACK_RGB24_64_STEP_AVX512(R, G, B, 1); \
+	RGB3 = PACK_RGB24_64_STEP_AVX512(R, G, B, 2); \
+
+#define UNPACK_RGB24_64_STEP_AVX512(RGB1, RGB2, RGB3, C) \
+	_mm512_mask_permutexvar_epi8( \
+		_mm512_permutex2var_epi8(RGB1, _mm512_load_si512((const __m512i*)UNPACK_RGB24_##C##01), RGB2), \
+		UNPACK_RGB24_MASK##C, _mm512_load_si512((const __m512i*)UNPACK_RGB24_##C##2), RGB3)
+
+// deinterleave 192 bytes of rgb24 data to r, g and b vectors (even pixels first, then odd pixels)
+#define UNPACK_RGB24_64_AVX512(RGB1, RGB2, RGB3, RD, GD, BD) \
+	RD = UNPACK_RGB24_64_STEP_AVX512(RGB1, RGB2, RGB3, R); \
+	GD = UNPACK_RGB24_64_STEP_AVX512(RGB1, RGB2, RGB3, G); \
+	BD = UNPACK_RGB24_64_STEP_AVX512(RGB1, RGB2, RGB3, B); \
+
+#define LOAD_UV_PLANAR_AVX512 \
+	__m256i u = LOAD_SI256((const __m256i*)(u_ptr)); \
+	__m256i v = LOAD_SI256((const __m256i*)(v_ptr)); \
+
+#define LOAD_UV_NV12_AVX512 \
+	__m512i uv = LOAD_SI512((const __m512i*)(uv_ptr)); \
+	__m256i u = _mm512_cvtepi16_epi8(uv); \
+	__m256i v = _mm512_cvtepi16_epi8(_mm512_srli_epi16(uv, 8)); \
+
+#define LOAD_UV_NV21_AVX512 \
+	__m512i uv = LOAD_SI512((const __m512i*)(uv_ptr)); \
+	__m256i v = _mm512_cvtepi16_epi8(uv); \
+	__m256i u = _mm512_cvtepi16_epi8(_mm512_srli_epi16(uv, 8)); \
+
+// convert 64 pixels of one line, and save them with SAVE
+#define YUV2RGB_LINE_64_AVX512(Y_PTR, RGB_PTR, SAVE) \
+	r_16_1=r_uv_16_1; g_16_1=g_uv_16_1; b_16_1=b_uv_16_1; \
+	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
+	\
+	y = LOAD_SI512((const __m512i*)(Y_PTR)); \
+	y_16_1 = _mm512_unpacklo_epi8(y, _mm512_setzero_si512()); \
+	y_16_2 = _mm512_unpackhi_epi8(y, _mm512_setzero_si512()); \
+	\
+	ADD_Y2RGB_32_AVX512(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	r_8 = _mm512_packus_epi16(r_16_1, r_16_2); \
+	g_8 = _mm512_packus_epi16(g_16_1, g_16_2); \
+	b_8 = _mm512_packus_epi16(b_16_1, b_16_2); \
+	\
+	SAVE(RGB_PTR) \
+
+// save 64 pixels of one line in rgb24 format
+#define SAVE_RGB24_64_AVX512(RGB_PTR) \
+	{ \
+		__m512i rgb_1, rgb_2, rgb_3; \
+		PACK_RGB24_64_AVX512(r_8, g_8, b_8, rgb_1, rgb_2, rgb_3) \
+		SAVE_SI512((__m512i*)(RGB_PTR), rgb_1); \
+		SAVE_SI512((__m512i*)(RGB_PTR+64), rgb_2); \
+		SAVE_SI512((__m512i*)(RGB_PTR+128), rgb_3); \
+	} \
+
+// interleave 64 pixels of the four channels C0 to C3 (in memory order, each in pixel order) and save them
+// after the per lane unpacks, rgb_N holds pixels 4N to 4N+3 of each 16 pixels lane, the 128 bits shuffles
+// gather the four lanes of each output vector
+#define PACK_RGB32_64_AVX512(C0, C1, C2, C3, RGB_PTR) \
+	{ \
+		__m512i c01_lo = _mm512_unpacklo_epi8(C0, C1), c01_hi = _mm512_unpackhi_epi8(C0, C1), \
+			c23_lo = _mm512_unpacklo_epi8(C2, C3), c23_hi = _mm512_unpackhi_epi8(C2, C3); \
+		__m512i rgb_0 = _mm512_unpacklo_epi16(c01_lo, c23_lo), rgb_1 = _mm512_unpackhi_epi16(c01_lo, c23_lo), \
+			rgb_2 = _mm512_unpacklo_epi16(c01_hi, c23_hi), rgb_3 = _mm512_unpackhi_epi16(c01_hi, c23_hi); \
+		__m512i rgb_01_lo = _mm512_shuffle_i64x2(rgb_0, rgb_1, 0x44), rgb_23_lo = _mm512_shuffle_i64x2(rgb_2, rgb_3, 0x44), \
+			rgb_01_hi = _mm512_shuffle_i64x2(rgb_0, rgb_1, 0xEE), rgb_23_hi = _mm512_shuffle_i64x2(rgb_2, rgb_3, 0xEE); \
+		SAVE_SI512((__m512i*)(RGB_PTR), _mm512_shuffle_i64x2(rgb_01_lo, rgb_23_lo, 0x88)); \
+		SAVE_SI512((__m512i*)(RGB_PTR+64), _mm512_shuffle_i64x2(rgb_01_lo, rgb_23_lo, 0xDD)); \
+		SAVE_SI512((__m512i*)(RGB_PTR+128), _mm512_shuffle_i64x2(rgb_01_hi, rgb_23_hi, 0x88)); \
+		SAVE_SI512((__m512i*)(RGB_PTR+192), _mm512_shuffle_i64x2(rgb_01_hi, rgb_23_hi, 0xDD)); \
+	} \
+
+// save 64 pixels of one line in a 32 bits format, a_8 must contain the alpha value
+#define SAVE_RGBA_64_AVX512(RGB_PTR) PACK_RGB32_64_AVX512(r_8, g_8, b_8, a_8, RGB_PTR)
+#define SAVE_BGRA_64_AVX512(RGB_PTR) PACK_RGB32_64_AVX512(b_8, g_8, r_8, a_8, RGB_PTR)
+#define SAVE_ARGB_64_AVX512(RGB_PTR) PACK_RGB32_64_AVX512(a_8, r_8, g_8, b_8, RGB_PTR)
+#define SAVE_ABGR_64_AVX512(RGB_PTR) PACK_RGB32_64_AVX512(a_8, b_8, g_8, r_8, RGB_PTR)
+
+// same organisation as YUV2RGB_64_AVX2, but all 64 pixels of a line are processed at once
+#define YUV2RGB_64_AVX512(SAVE) \
+	__m512i r_tmp, g_tmp, b_tmp; \
+	__m512i r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+	__m512i r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2; \
+	__m512i y, y_16_1, y_16_2; \
+	__m512i r_8, g_8, b_8; \
+	\
+	__m512i u_16 = _mm512_cvtepi8_epi16(_mm256_add_epi8(u, _mm256_set1_epi8(-128))); \
+	__m512i v_16 = _mm512_cvtepi8_epi16(_mm256_add_epi8(v, _mm256_set1_epi8(-128))); \
+	\
+	UV2RGB_32_AVX512(u_16, v_16, r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2) \
+	YUV2RGB_LINE_64_AVX512(y_ptr1, rgb_ptr1, SAVE) \
+	YUV2RGB_LINE_64_AVX512(y_ptr2, rgb_ptr2, SAVE) \
+
+#define YUV2RGB_64_PLANAR_AVX512 \
+	LOAD_UV_PLANAR_AVX512 \
+	YUV2RGB_64_AVX512(SAVE_RGB24_64_AVX512)
+
+#define YUV2RGB_64_NV12_AVX512 \
+	LOAD_UV_NV12_AVX512 \
+	YUV2RGB_64_AVX512(SAVE_RGB24_64_AVX512)
+
+#define YUV2RGB_64_NV21_AVX512 \
+	LOAD_UV_NV21_AVX512 \
+	YUV2RGB_64_AVX512(SAVE_RGB24_64_AVX512)
+
+// compute Y' of 32 pixels, from 16 bits r, g and b values
+#define RGB2Y_32_AVX512(R, G, B, Y) \
+	Y = _mm512_add_epi16(_mm512_mullo_epi16(R, _mm512_set1_epi16(param->r_factor)), \
+		_mm512_mullo_epi16(G, _mm512_set1_epi16(param->g_factor))); \
+	Y = _mm512_add_epi16(Y, _mm512_mullo_epi16(B, _mm512_set1_epi16(param->b_factor))); \
+	Y = _mm512_srli_epi16(Y, 8); \
+
+// process one line of 64 pixels: save Y values and add (B-Y') and (R-Y') of pairs of pixels to CB and CR
+// C0, C1 and C2 are the channel vectors in memory order (r_8, g_8, b_8 for rgb24)
+#define RGB2YUV_LINE_64_AVX512(RGB_PTR, Y_PTR, CB, CR, C0, C1, C2) \
+	rgb1 = LOAD_SI512((const __m512i*)(RGB_PTR)); \
+	rgb2 = LOAD_SI512((const __m512i*)(RGB_PTR+64)); \
+	rgb3 = LOAD_SI512((const __m512i*)(RGB_PTR+128)); \
+	UNPACK_RGB24_64_AVX512(rgb1, rgb2, rgb3, C0, C1, C2) \
+	/* even pixels */ \
+	r_16 = _mm512_cvtepu8_epi16(_mm512_castsi512_si256(r_8)); \
+	g_16 = _mm512_cvtepu8_epi16(_mm512_castsi512_si256(g_8)); \
+	b_16 = _mm512_cvtepu8_epi16(_mm512_castsi512_si256(b_8)); \
+	RGB2Y_32_AVX512(r_16, g_16, b_16, y1_16) \
+	CB = _mm512_add_epi16(CB, _mm512_sub_epi16(b_16, y1_16)); \
+	CR = _mm512_add_epi16(CR, _mm512_sub_epi16(r_16, y1_16)); \
+	/* odd pixels */ \
+	r_16 = _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(r_8, 1)); \
+	g_16 = _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(g_8, 1)); \
+	b_16 = _mm512_cvtepu8_epi16(_mm512_extracti64x4_epi64(b_8, 1)); \
+	RGB2Y_32_AVX512(r_16, g_16, b_16, y2_16) \
+	CB = _mm512_add_epi16(CB, _mm512_sub_epi16(b_16, y2_16)); \
+	CR = _mm512_add_epi16(CR, _mm512_sub_epi16(r_16, y2_16)); \
+	/* Rescale Y' to Y, interleave even and odd pixels and save it */ \
+	y1_16 = _mm512_add_epi16(_mm512_srli_epi16(_mm512_mullo_epi16(y1_16, _mm512_set1_epi16(param->y_factor)), 7), _mm512_set1_epi16(param->y_offset)); \
+	y2_16 = _mm512_add_epi16(_mm512_srli_epi16(_mm512_mullo_epi16(y2_16, _mm512_set1_epi16(param->y_factor)), 7), _mm512_set1_epi16(param->y_offset)); \
+	SAVE_SI512((__m512i*)(Y_PTR), _mm512_permutex2var_epi8(y1_16, _mm512_load_si512((const __m512i*)INTERLEAVE_Y), y2_16)); \
+
+// save the 32 cb and cr values of CB and CR (16 bits, not saturated yet)
+#define SAVE_UV_PLANAR_AVX512(CB, CR) \
+	SAVE_SI256((__m256i*)(u_ptr), _mm512_cvtusepi16_epi8(_mm512_max_epi16(CB, _mm512_setzero_si512()))); \
+	SAVE_SI256((__m256i*)(v_ptr), _mm512_cvtusepi16_epi8(_mm512_max_epi16(CR, _mm512_setzero_si512()))); \
+
+// once saturated to [0:255], the interleaved values are (cr<<8)|cb
+#define SAVE_UV_NV12_AVX512(CB, CR) \
+	SAVE_SI512((__m512i*)(uv_ptr), _mm512_or_si512( \
+		_mm512_min_epi16(_mm512_max_epi16(CB, _mm512_setzero_si512()), _mm512_set1_epi16(255)), \
+		_mm512_slli_epi16(_mm512_min_epi16(_mm512_max_epi16(CR, _mm512_setzero_si512()), _mm512_set1_epi16(255)), 8))); \
+
+#define SAVE_UV_NV21_AVX512(CB, CR) SAVE_UV_NV12_AVX512(CR, CB)
+
+#define RGB2YUV_64_AVX512 RGB2YUV_64_ORDER_AVX512(r_8, g_8, b_8, SAVE_UV_PLANAR_AVX512)
+
+#define RGB2YUV_64_ORDER_AVX512(C0, C1, C2, SAVE_UV) \
+	__m512i rgb1, rgb2, rgb3, r_8, g_8, b_8; \
+	__m512i r_16, g_16, b_16, y1_16, y2_16; \
+	__m512i cb_16 = _mm512_setzero_si512(), cr_16 = _mm512_setzero_si512(); \
+	RGB2YUV_LINE_64_AVX512(rgb_ptr1, y_ptr1, cb_16, cr_16, C0, C1, C2) \
+	RGB2YUV_LINE_64_AVX512(rgb_ptr2, y_ptr2, cb_16, cr_16, C0, C1, C2) \
+	/* Rescale Cb and Cr to their final range, pack and save them */ \
+	cb_16 = _mm512_add_epi16(_mm512_srai_epi16(_mm512_mullo_epi16(_mm512_srai_epi16(_mm512_add_epi16(cb_16, _mm512_set1_epi16(2)), 2), _mm512_set1_epi16(param->cb_factor)), 8), _mm512_set1_epi16(128)); \
+	cr_16 = _mm512_add_epi16(_mm512_srai_epi16(_mm512_mullo_epi16(_mm512_srai_epi16(_mm512_add_epi16(cr_16, _mm512_set1_epi16(2)), 2), _mm512_set1_epi16(param->cr_factor)), 8), _mm512_set1_epi16(128)); \
+	SAVE_UV(cb_16, cr_16) \
+
+AVX512_TARGET void yuv420_rgb24_avx512(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI512 _mm512_load_si512
+	#define LOAD_SI256 _mm256_load_si256
+	#define SAVE_SI512 STREAM_SI512
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride)
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*u_ptr=U+(y/2)*UV_stride,
+			*v_ptr=V+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_PLANAR_AVX512
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			u_ptr+=32; 
+			v_ptr+=32;
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	YUV420_RGB24_TAIL(yuv420_rgb24_lut, 64)
+	STORE_POLICY_END
+	#undef LOAD_SI512
+	#undef LOAD_SI256
+	#undef SAVE_SI512
+}
+
+AVX512_TARGET void yuv420_rgb24_avx512u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI512 _mm512_loadu_si512
+	#define LOAD_SI256 _mm256_loadu_si256
+	#define SAVE_SI512 _mm512_storeu_si512
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*u_ptr=U+(y/2)*UV_stride,
+			*v_ptr=V+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_PLANAR_AVX512
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			u_ptr+=32; 
+			v_ptr+=32;
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	YUV420_RGB24_TAIL(yuv420_rgb24_lut, 64)
+	#undef LOAD_SI512
+	#undef LOAD_SI256
+	#undef SAVE_SI512
+}
+
+AVX512_TARGET void nv12_rgb24_avx512(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI512 _mm512_load_si512
+	#define SAVE_SI512 STREAM_SI512
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride)
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*uv_ptr=UV+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_NV12_AVX512
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			uv_ptr+=64; 
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	NV_RGB24_TAIL(nv12_rgb24_lut, 64)
+	STORE_POLICY_END
+	#undef LOAD_SI512
+	#undef SAVE_SI512
+}
+
+AVX512_TARGET void nv12_rgb24_avx512u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI512 _mm512_loadu_si512
+	#define SAVE_SI512 _mm512_storeu_si512
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*uv_ptr=UV+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_NV12_AVX512
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			uv_ptr+=64; 
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	NV_RGB24_TAIL(nv12_rgb24_lut, 64)
+	#undef LOAD_SI512
+	#undef SAVE_SI512
+}
+
+AVX512_TARGET void nv21_rgb24_avx512(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI512 _mm512_load_si512
+	#define SAVE_SI512 STREAM_SI512
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	STORE_POLICY_BEGIN((size_t)height*RGB_stride)
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*uv_ptr=UV+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_NV21_AVX512
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			uv_ptr+=64; 
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	NV_RGB24_TAIL(nv21_rgb24_lut, 64)
+	STORE_POLICY_END
+	#undef LOAD_SI512
+	#undef SAVE_SI512
+}
+
+AVX512_TARGET void nv21_rgb24_avx512u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI512 _mm512_loadu_si512
+	#define SAVE_SI512 _mm512_storeu_si512
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*uv_ptr=UV+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			YUV2RGB_64_NV21_AVX512
+			
+			y_ptr1+=64;
+			y_ptr2+=64;
+			uv_ptr+=64; 
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+		}
+	}
+	NV_RGB24_TAIL(nv21_rgb24_lut, 64)
+	#undef LOAD_SI512
+	#undef SAVE_SI512
+}
+
+// 32 bits rgb outputs
+#define ALPHA_AVX512 \
+	const __m512i a_8 = _mm512_set1_epi8((char)alpha);
+
+#define RGB32_FUNCTIONS_AVX512(SUFFIX, FORMAT, format) \
+	YUV420_RGB32_FUNCTION(AVX512_TARGET static, yuv420_##format##32_##SUFFIX, yuv420_##format##32_std, 64, ALPHA_AVX512, \
+		LOAD_UV_PLANAR_AVX512 YUV2RGB_64_AVX512(SAVE_##FORMAT##_64_AVX512)) \
+	NV_RGB32_FUNCTION(AVX512_TARGET static, nv12_##format##32_##SUFFIX, nv12_##format##32_std, 64, ALPHA_AVX512, \
+		LOAD_UV_NV12_AVX512 YUV2RGB_64_AVX512(SAVE_##FORMAT##_64_AVX512)) \
+	NV_RGB32_FUNCTION(AVX512_TARGET static, nv21_##format##32_##SUFFIX, nv21_##format##32_std, 64, ALPHA_AVX512, \
+		LOAD_UV_NV21_AVX512 YUV2RGB_64_AVX512(SAVE_##FORMAT##_64_AVX512))
+
+#define LOAD_SI512 _mm512_load_si512
+#define LOAD_SI256 _mm256_load_si256
+#define SAVE_SI512 STREAM_SI512
+RGB32_FUNCTIONS_AVX512(avx512, RGBA, rgba)
+RGB32_FUNCTIONS_AVX512(avx512, BGRA, bgra)
+RGB32_FUNCTIONS_AVX512(avx512, ARGB, argb)
+RGB32_FUNCTIONS_AVX512(avx512, ABGR, abgr)
+#undef LOAD_SI512
+#undef LOAD_SI256
+#undef SAVE_SI512
+
+#define LOAD_SI512 _mm512_loadu_si512
+#define LOAD_SI256 _mm256_loadu_si256
+#define SAVE_SI512 _mm512_storeu_si512
+RGB32_FUNCTIONS_AVX512(avx512u, RGBA, rgba)
+RGB32_FUNCTIONS_AVX512(avx512u, BGRA, bgra)
+RGB32_FUNCTIONS_AVX512(avx512u, ARGB, argb)
+RGB32_FUNCTIONS_AVX512(avx512u, ABGR, abgr)
+#undef LOAD_SI512
+#undef LOAD_SI256
+#undef SAVE_SI512
+
+AVX512_TARGET void rgb24_yuv420_avx512(uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI512 _mm512_load_si512
+	#define SAVE_SI512 STREAM_SI512
+	#define SAVE_SI256 STREAM_SI256
+	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
+	STORE_POLICY_BEGIN((size_t)height*Y_stride*3/2)
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*u_ptr=U+(y/2)*UV_stride,
+			*v_ptr=V+(y/2)*UV_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			RGB2YUV_64_AVX512
+			
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+			y_ptr1+=64;
+			y_ptr2+=64;
+			u_ptr+=32; 
+			v_ptr+=32;
+		}
+	}
+	RGB_YUV420_TAIL(rgb24_yuv420_std, 64, RGB, RGB_stride, 3)
+	STORE_POLICY_END
+	#undef LOAD_SI512
+	#undef SAVE_SI512
+	#undef SAVE_SI256
+}
+
+AVX512_TARGET void rgb24_yuv420_avx512u(uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	#define LOAD_SI512 _mm512_loadu_si512
+	#define SAVE_SI512 _mm512_storeu_si512
+	#define SAVE_SI256 _mm256_storeu_si256
+	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*u_ptr=U+(y/2)*UV_stride,
+			*v_ptr=V+(y/2)*UV_stride;
+		
+		for(x=0; (x+63)<width; x+=64)
+		{
+			RGB2YUV_64_AVX512
+			
+			rgb_ptr1+=192;
+			rgb_ptr2+=192;
+			y_ptr1+=64;
+			y_ptr2+=64;
+			u_ptr+=32; 
+			v_ptr+=32;
+		}
+	}
+	RGB_YUV420_TAIL(rgb24_yuv420_std, 64, RGB, RGB_stride, 3)
+	#undef LOAD_SI512
+	#undef SAVE_SI512
+	#undef SAVE_SI256
+}
+
+// bgr24, the r and b vectors are swapped in the deinterleave
+#define LOAD_SI512 _mm512_load_si512
+#define SAVE_SI512 STREAM_SI512
+#define SAVE_SI256 STREAM_SI256
+RGB_YUV420_FUNCTION(AVX512_TARGET static, bgr24_yuv420_avx512, bgr24_yuv420_std, 64, 3, RGB2YUV_INIT, RGB2YUV_64_ORDER_AVX512(b_8, g_8, r_8, SAVE_UV_PLANAR_AVX512))
+#undef LOAD_SI512
+#undef SAVE_SI512
+#undef SAVE_SI256
+
+#define LOAD_SI512 _mm512_loadu_si512
+#define SAVE_SI512 _mm512_storeu_si512
+#define SAVE_SI256 _mm256_storeu_si256
+RGB_YUV420_FUNCTION(AVX512_TARGET static, bgr24_yuv420_avx512u, bgr24_yuv420_std, 64, 3, RGB2YUV_INIT, RGB2YUV_64_ORDER_AVX512(b_8, g_8, r_8, SAVE_UV_PLANAR_AVX512))
+#undef LOAD_SI512
+#undef SAVE_SI512
+#undef SAVE_SI256
+
+// rgb24 to nv12 and nv21
+#define LOAD_SI512 _mm512_load_si512
+#define SAVE_SI512 STREAM_SI512
+RGB_NV_FUNCTION(AVX512_TARGET, rgb24_nv12_avx512, rgb24_nv12_std, 64, 3, RGB2YUV_INIT, RGB2YUV_64_ORDER_AVX512(r_8, g_8, b_8, SAVE_UV_NV12_AVX512))
+RGB_NV_FUNCTION(AVX512_TARGET, rgb24_nv21_avx512, rgb24_nv21_std, 64, 3, RGB2YUV_INIT, RGB2YUV_64_ORDER_AVX512(r_8, g_8, b_8, SAVE_UV_NV21_AVX512))
+#undef LOAD_SI512
+#undef SAVE_SI512
+
+#define LOAD_SI512 _mm512_loadu_si512
+#define SAVE_SI512 _mm512_storeu_si512
+RGB_NV_FUNCTION(AVX512_TARGET, rgb24_nv12_avx512u, rgb24_nv12_std, 64, 3, RGB2YUV_INIT, RGB2YUV_64_ORDER_AVX512(r_8, g_8, b_8, SAVE_UV_NV12_AVX512))
+RGB_NV_FUNCTION(AVX512_TARGET, rgb24_nv21_avx512u, rgb24_nv21_std, 64, 3, RGB2YUV_INIT, RGB2YUV_64_ORDER_AVX512(r_8, g_8, b_8, SAVE_UV_NV21_AVX512))
+#undef LOAD_SI512
+#undef SAVE_SI512
+
+#endif //__SSE2__
+
+#ifdef __ARM_NEON
+
+// NEON implementations
+// vld3q_u8/vst3q_u8 (vld4q_u8 for rgba) do the rgb (de)interleave, so there is no equivalent of the
+// unpack/pack steps of the sse version, and 16 pixels of each line are processed per iteration.
+// The arithmetic is the same as the sse version, so that both give the same result.
+// NEON loads and stores have no alignment requirement, so there is a single version of each function.
+
+#define UV2RGB_16_NEON(U,V,R1,G1,B1,R2,G2,B2) \
+	r_tmp = vshrq_n_s16(vmulq_s16(V, vdupq_n_s16(param->cr_factor)), 6); \
+	g_tmp = vshrq_n_s16(vmlaq_s16( \
+		vmulq_s16(U, vdupq_n_s16(param->g_cb_factor)), \
+		V, vdupq_n_s16(param->g_cr_factor)), 7); \
+	b_tmp = vshrq_n_s16(vmulq_s16(U, vdupq_n_s16(param->cb_factor)), 6); \
+	tmp = vzipq_s16(r_tmp, r_tmp); R1 = tmp.val[0]; R2 = tmp.val[1]; \
+	tmp = vzipq_s16(g_tmp, g_tmp); G1 = tmp.val[0]; G2 = tmp.val[1]; \
+	tmp = vzipq_s16(b_tmp, b_tmp); B1 = tmp.val[0]; B2 = tmp.val[1]; \
+
+// same as ADD_Y2RGB_16, vqdmulhq_s16 computing (2*a*b)>>16
+#define ADD_Y2RGB_16_NEON(Y1,Y2,R1,G1,B1,R2,G2,B2) \
+	Y1 = vqdmulhq_s16(vshlq_n_s16(vsubq_s16(Y1, vdupq_n_s16(param->y_offset)), 7), vdupq_n_s16(param->y_factor*2)); \
+	Y2 = vqdmulhq_s16(vshlq_n_s16(vsubq_s16(Y2, vdupq_n_s16(param->y_offset)), 7), vdupq_n_s16(param->y_factor*2)); \
+	\
+	R1 = vaddq_s16(Y1, R1); \
+	G1 = vsubq_s16(Y1, G1); \
+	B1 = vaddq_s16(Y1, B1); \
+	R2 = vaddq_s16(Y2, R2); \
+	G2 = vsubq_s16(Y2, G2); \
+	B2 = vaddq_s16(Y2, B2); \
+
+#define LOAD_UV_PLANAR_NEON \
+	uint8x8_t u = vld1_u8(u_ptr); \
+	uint8x8_t v = vld1_u8(v_ptr); \
+
+#define LOAD_UV_NV12_NEON \
+	uint8x8x2_t uv = vld2_u8(uv_ptr); \
+	uint8x8_t u = uv.val[0]; \
+	uint8x8_t v = uv.val[1]; \
+
+#define LOAD_UV_NV21_NEON \
+	uint8x8x2_t uv = vld2_u8(uv_ptr); \
+	uint8x8_t u = uv.val[1]; \
+	uint8x8_t v = uv.val[0]; \
+
+// convert 16 pixels of one line, using the rgb offsets computed by UV2RGB_16_NEON, and save them with SAVE
+#define YUV2RGB_LINE_16_NEON(Y_PTR, RGB_PTR, SAVE) \
+	r_16_1=r_uv_16_1; g_16_1=g_uv_16_1; b_16_1=b_uv_16_1; \
+	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
+	\
+	y = vld1q_u8(Y_PTR); \
+	y_16_1 = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y))); \
+	y_16_2 = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y))); \
+	\
+	ADD_Y2RGB_16_NEON(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	r_8 = vcombine_u8(vqmovun_s16(r_16_1), vqmovun_s16(r_16_2)); \
+	g_8 = vcombine_u8(vqmovun_s16(g_16_1), vqmovun_s16(g_16_2)); \
+	b_8 = vcombine_u8(vqmovun_s16(b_16_1), vqmovun_s16(b_16_2)); \
+	SAVE(RGB_PTR) \
+
+#define SAVE_RGB24_16_NEON(RGB_PTR) \
+	{ \
+		uint8x16x3_t rgb; \
+		rgb.val[0] = r_8; \
+		rgb.val[1] = g_8; \
+		rgb.val[2] = b_8; \
+		vst3q_u8(RGB_PTR, rgb); \
+	} \
+
+// vst4q_u8 interleaves the four channels, C0 to C3 are in memory order
+#define PACK_RGB32_16_NEON(C0, C1, C2, C3, RGB_PTR) \
+	{ \
+		uint8x16x4_t rgb; \
+		rgb.val[0] = C0; \
+		rgb.val[1] = C1; \
+		rgb.val[2] = C2; \
+		rgb.val[3] = C3; \
+		vst4q_u8(RGB_PTR, rgb); \
+	} \
+
+// save 16 pixels of one line in a 32 bits format, a_8 must contain the alpha value
+#define SAVE_RGBA_16_NEON(RGB_PTR) PACK_RGB32_16_NEON(r_8, g_8, b_8, a_8, RGB_PTR)
+#define SAVE_BGRA_16_NEON(RGB_PTR) PACK_RGB32_16_NEON(b_8, g_8, r_8, a_8, RGB_PTR)
+#define SAVE_ARGB_16_NEON(RGB_PTR) PACK_RGB32_16_NEON(a_8, r_8, g_8, b_8, RGB_PTR)
+#define SAVE_ABGR_16_NEON(RGB_PTR) PACK_RGB32_16_NEON(a_8, b_8, g_8, r_8, RGB_PTR)
+
+#define YUV2RGB_16_NEON(SAVE) \
+	int16x8_t r_tmp, g_tmp, b_tmp; \
+	int16x8x2_t tmp; \
+	int16x8_t r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+	int16x8_t r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2; \
+	int16x8_t y_16_1, y_16_2; \
+	uint8x16_t y, r_8, g_8, b_8; \
+	\
+	/* u-128 and v-128, sign extended to 16 bits */ \
+	int16x8_t u_16 = vmovl_s8(vreinterpret_s8_u8(veor_u8(u, vdup_n_u8(128)))); \
+	int16x8_t v_16 = vmovl_s8(vreinterpret_s8_u8(veor_u8(v, vdup_n_u8(128)))); \
+	\
+	UV2RGB_16_NEON(u_16, v_16, r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2) \
+	YUV2RGB_LINE_16_NEON(y_ptr1, rgb_ptr1, SAVE) \
+	YUV2RGB_LINE_16_NEON(y_ptr2, rgb_ptr2, SAVE) \
+
+#define YUV2RGB_16_PLANAR_NEON \
+	LOAD_UV_PLANAR_NEON \
+	YUV2RGB_16_NEON(SAVE_RGB24_16_NEON)
+
+#define YUV2RGB_16_NV12_NEON \
+	LOAD_UV_NV12_NEON \
+	YUV2RGB_16_NEON(SAVE_RGB24_16_NEON)
+
+#define YUV2RGB_16_NV21_NEON \
+	LOAD_UV_NV21_NEON \
+	YUV2RGB_16_NEON(SAVE_RGB24_16_NEON)
+
+void yuv420_rgb24_neon(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*u_ptr=U+(y/2)*UV_stride,
+			*v_ptr=V+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+15)<width; x+=16)
+		{
+			YUV2RGB_16_PLANAR_NEON
+			
+			y_ptr1+=16;
+			y_ptr2+=16;
+			u_ptr+=8; 
+			v_ptr+=8;
+			rgb_ptr1+=48;
+			rgb_ptr2+=48;
+		}
+	}
+	YUV420_RGB24_TAIL(yuv420_rgb24_lut, 16)
+}
+
+void nv12_rgb24_neon(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*uv_ptr=UV+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+15)<width; x+=16)
+		{
+			YUV2RGB_16_NV12_NEON
+			
+			y_ptr1+=16;
+			y_ptr2+=16;
+			uv_ptr+=16; 
+			rgb_ptr1+=48;
+			rgb_ptr2+=48;
+		}
+	}
+	NV_RGB24_TAIL(nv12_rgb24_lut, 16)
+}
+
+void nv21_rgb24_neon(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*uv_ptr=UV+(y/2)*UV_stride;
+		
+		uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		for(x=0; (x+15)<width; x+=16)
+		{
+			YUV2RGB_16_NV21_NEON
+			
+			y_ptr1+=16;
+			y_ptr2+=16;
+			uv_ptr+=16; 
+			rgb_ptr1+=48;
+			rgb_ptr2+=48;
+		}
+	}
+	NV_RGB24_TAIL(nv21_rgb24_lut, 16)
+}
+
+// 32 bits rgb outputs
+#define ALPHA_NEON \
+	const uint8x16_t a_8 = vdupq_n_u8(alpha);
+
+#define RGB32_FUNCTIONS_NEON(FORMAT, format) \
+	YUV420_RGB32_FUNCTION(static, yuv420_##format##32_neon, yuv420_##format##32_std, 16, ALPHA_NEON, \
+		LOAD_UV_PLANAR_NEON YUV2RGB_16_NEON(SAVE_##FORMAT##_16_NEON)) \
+	NV_RGB32_FUNCTION(static, nv12_##format##32_neon, nv12_##format##32_std, 16, ALPHA_NEON, \
+		LOAD_UV_NV12_NEON YUV2RGB_16_NEON(SAVE_##FORMAT##_16_NEON)) \
+	NV_RGB32_FUNCTION(static, nv21_##format##32_neon, nv21_##format##32_std, 16, ALPHA_NEON, \
+		LOAD_UV_NV21_NEON YUV2RGB_16_NEON(SAVE_##FORMAT##_16_NEON))
+
+RGB32_FUNCTIONS_NEON(RGBA, rgba)
+RGB32_FUNCTIONS_NEON(BGRA, bgra)
+RGB32_FUNCTIONS_NEON(ARGB, argb)
+RGB32_FUNCTIONS_NEON(ABGR, abgr)
+
+// compute Y' of 8 pixels, from 16 bits r, g and b values
+#define RGB2Y_8_NEON(R, G, B, Y) \
+	Y = vmlaq_u16(vmulq_u16(R, vdupq_n_u16(param->r_factor)), G, vdupq_n_u16(param->g_factor)); \
+	Y = vmlaq_u16(Y, B, vdupq_n_u16(param->b_factor)); \
+	Y = vshrq_n_u16(Y, 8); \
+
+// Rescale Y' to Y
+#define Y2Y_8_NEON(Y) \
+	vqmovn_u16(vaddq_u16(vshrq_n_u16(vmulq_u16(Y, vdupq_n_u16(param->y_factor)), 7), vdupq_n_u16(param->y_offset)))
+
+// process one line of 16 pixels: save Y values, and add (B-Y') and (R-Y') of pairs of pixels to CB and CR
+// vuzpq separates even and odd pixels, so that the horizontal sum can be done with a simple add
+#define RGB2YUV_LINE_16_NEON(R, G, B, Y_PTR, CB, CR) \
+	r_16 = vmovl_u8(vget_low_u8(R)); \
+	g_16 = vmovl_u8(vget_low_u8(G)); \
+	b_16 = vmovl_u8(vget_low_u8(B)); \
+	RGB2Y_8_NEON(r_16, g_16, b_16, y1_16) \
+	cb1_16 = vreinterpretq_s16_u16(vsubq_u16(b_16, y1_16)); \
+	cr1_16 = vreinterpretq_s16_u16(vsubq_u16(r_16, y1_16)); \
+	r_16 = vmovl_u8(vget_high_u8(R)); \
+	g_16 = vmovl_u8(vget_high_u8(G)); \
+	b_16 = vmovl_u8(vget_high_u8(B)); \
+	RGB2Y_8_NEON(r_16, g_16, b_16, y2_16) \
+	cb2_16 = vreinterpretq_s16_u16(vsubq_u16(b_16, y2_16)); \
+	cr2_16 = vreinterpretq_s16_u16(vsubq_u16(r_16, y2_16)); \
+	vst1q_u8(Y_PTR, vcombine_u8(Y2Y_8_NEON(y1_16), Y2Y_8_NEON(y2_16))); \
+	tmp = vuzpq_s16(cb1_16, cb2_16); \
+	CB = vaddq_s16(CB, vaddq_s16(tmp.val[0], tmp.val[1])); \
+	tmp = vuzpq_s16(cr1_16, cr2_16); \
+	CR = vaddq_s16(CR, vaddq_s16(tmp.val[0], tmp.val[1])); \
+
+// save the 8 cb and cr values of CB and CR
+#define SAVE_UV_PLANAR_NEON(CB, CR) \
+	vst1_u8(u_ptr, vqmovun_s16(CB)); \
+	vst1_u8(v_ptr, vqmovun_s16(CR)); \
+
+#define SAVE_UV_NV12_NEON(CB, CR) \
+	{ \
+		uint8x8x2_t uv; \
+		uv.val[0] = vqmovun_s16(CB); \
+		uv.val[1] = vqmovun_s16(CR); \
+		vst2_u8(uv_ptr, uv); \
+	} \
+
+#define SAVE_UV_NV21_NEON(CB, CR) SAVE_UV_NV12_NEON(CR, CB)
+
+#define RGB2YUV_16_NEON RGB2YUV_16_ORDER_NEON(0, 1, 2, SAVE_UV_PLANAR_NEON)
+
+// R, G and B are the indices of the channels in the deinterleaved rgb1 and rgb2 vectors
+#define RGB2YUV_16_ORDER_NEON(R, G, B, SAVE_UV) \
+	uint16x8_t r_16, g_16, b_16, y1_16, y2_16; \
+	int16x8_t cb1_16, cb2_16, cr1_16, cr2_16; \
+	int16x8x2_t tmp; \
+	int16x8_t cb = vdupq_n_s16(0), cr = vdupq_n_s16(0); \
+	RGB2YUV_LINE_16_NEON(rgb1.val[R], rgb1.val[G], rgb1.val[B], y_ptr1, cb, cr) \
+	RGB2YUV_LINE_16_NEON(rgb2.val[R], rgb2.val[G], rgb2.val[B], y_ptr2, cb, cr) \
+	/* Rescale Cb and Cr to their final range, pack and save them */ \
+	cb = vaddq_s16(vshrq_n_s16(vmulq_s16(vrshrq_n_s16(cb, 2), vdupq_n_s16(param->cb_factor)), 8), vdupq_n_s16(128)); \
+	cr = vaddq_s16(vshrq_n_s16(vmulq_s16(vrshrq_n_s16(cr, 2), vdupq_n_s16(param->cr_factor)), 8), vdupq_n_s16(128)); \
+	SAVE_UV(cb, cr) \
+
+void rgb24_yuv420_neon(uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+			*rgb_ptr2=RGB+(y+1)*RGB_stride;
+		
+		uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*u_ptr=U+(y/2)*UV_stride,
+			*v_ptr=V+(y/2)*UV_stride;
+		
+		for(x=0; (x+15)<width; x+=16)
+		{
+			uint8x16x3_t rgb1 = vld3q_u8(rgb_ptr1), rgb2 = vld3q_u8(rgb_ptr2);
+			RGB2YUV_16_NEON
+			
+			rgb_ptr1+=48;
+			rgb_ptr2+=48;
+			y_ptr1+=16;
+			y_ptr2+=16;
+			u_ptr+=8; 
+			v_ptr+=8;
+		}
+	}
+	RGB_YUV420_TAIL(rgb24_yuv420_std, 16, RGB, RGB_stride, 3)
+}
+
+void rgb32_yuv420_neon(uint32_t width, uint32_t height, 
+	const uint8_t *RGBA, uint32_t RGBA_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	const RGB2YUVParam *const param = &(RGB2YUV[yuv_type]);
+	
+	uint32_t x, y;
+	for(y=0; (y+1)<height; y+=2)
+	{
+		const uint8_t *rgb_ptr1=RGBA+y*RGBA_stride,
+			*rgb_ptr2=RGBA+(y+1)*RGBA_stride;
+		
+		uint8_t *y_ptr1=Y+y*Y_stride,
+			*y_ptr2=Y+(y+1)*Y_stride,
+			*u_ptr=U+(y/2)*UV_stride,
+			*v_ptr=V+(y/2)*UV_stride;
+		
+		for(x=0; (x+15)<width; x+=16)
+		{
+			uint8x16x4_t rgb1 = vld4q_u8(rgb_ptr1), rgb2 = vld4q_u8(rgb_ptr2);
+			RGB2YUV_16_NEON
+			
+			rgb_ptr1+=64;
+			rgb_ptr2+=64;
+			y_ptr1+=16;
+			y_ptr2+=16;
+			u_ptr+=8; 
+			v_ptr+=8;
+		}
+	}
+	RGB_YUV420_TAIL(rgb32_yuv420_std, 16, RGBA, RGBA_stride, 4)
+}
+
+// other channel orders
+#define LOAD_RGB24_NEON \
+	uint8x16x3_t rgb1 = vld3q_u8(rgb_ptr1), rgb2 = vld3q_u8(rgb_ptr2);
+
+#define LOAD_RGB32_NEON \
+	uint8x16x4_t rgb1 = vld4q_u8(rgb_ptr1), rgb2 = vld4q_u8(rgb_ptr2);
+
+RGB_YUV420_FUNCTION(static, bgr24_yuv420_neon, bgr24_yuv420_std, 16, 3, RGB2YUV_INIT, LOAD_RGB24_NEON RGB2YUV_16_ORDER_NEON(2, 1, 0, SAVE_UV_PLANAR_NEON))
+RGB_YUV420_FUNCTION(static, bgra32_yuv420_neon, bgra32_yuv420_std, 16, 4, RGB2YUV_INIT, LOAD_RGB32_NEON RGB2YUV_16_ORDER_NEON(2, 1, 0, SAVE_UV_PLANAR_NEON))
+RGB_YUV420_FUNCTION(static, argb32_yuv420_neon, argb32_yuv420_std, 16, 4, RGB2YUV_INIT, LOAD_RGB32_NEON RGB2YUV_16_ORDER_NEON(1, 2, 3, SAVE_UV_PLANAR_NEON))
+RGB_YUV420_FUNCTION(static, abgr32_yuv420_neon, abgr32_yuv420_std, 16, 4, RGB2YUV_INIT, LOAD_RGB32_NEON RGB2YUV_16_ORDER_NEON(3, 2, 1, SAVE_UV_PLANAR_NEON))
+
+// rgb to nv12 and nv21
+RGB_NV_FUNCTION(, rgb24_nv12_neon, rgb24_nv12_std, 16, 3, RGB2YUV_INIT, LOAD_RGB24_NEON RGB2YUV_16_ORDER_NEON(0, 1, 2, SAVE_UV_NV12_NEON))
+RGB_NV_FUNCTION(, rgb24_nv21_neon, rgb24_nv21_std, 16, 3, RGB2YUV_INIT, LOAD_RGB24_NEON RGB2YUV_16_ORDER_NEON(0, 1, 2, SAVE_UV_NV21_NEON))
+RGB_NV_FUNCTION(, rgb32_nv12_neon, rgb32_nv12_std, 16, 4, RGB2YUV_INIT, LOAD_RGB32_NEON RGB2YUV_16_ORDER_NEON(0, 1, 2, SAVE_UV_NV12_NEON))
+RGB_NV_FUNCTION(, rgb32_nv21_neon, rgb32_nv21_std, 16, 4, RGB2YUV_INIT, LOAD_RGB32_NEON RGB2YUV_16_ORDER_NEON(0, 1, 2, SAVE_UV_NV21_NEON))
+
+// On arm, the sse functions are provided with the neon implementation, so that code 
+// written for x86 builds and runs unchanged
+void yuv420_rgb24_sse(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	yuv420_rgb24_neon(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type);
+}
+
+void yuv420_rgb24_sseu(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	yuv420_rgb24_neon(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type);
+}
+
+void nv12_rgb24_sse(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	nv12_rgb24_neon(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type);
+}
+
+void nv12_rgb24_sseu(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	nv12_rgb24_neon(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type);
+}
+
+void nv21_rgb24_sse(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	nv21_rgb24_neon(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type);
+}
+
+void nv21_rgb24_sseu(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	nv21_rgb24_neon(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type);
+}
+
+void rgb24_yuv420_sse(uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	rgb24_yuv420_neon(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type);
+}
+
+void rgb24_yuv420_sseu(uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	rgb24_yuv420_neon(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type);
+}
+
+void rgb32_yuv420_sse(uint32_t width, uint32_t height, 
+	const uint8_t *RGBA, uint32_t RGBA_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	rgb32_yuv420_neon(width, height, RGBA, RGBA_stride, Y, U, V, Y_stride, UV_stride, yuv_type);
+}
+
+void rgb32_yuv420_sseu(uint32_t width, uint32_t height, 
+	const uint8_t *RGBA, uint32_t RGBA_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	rgb32_yuv420_neon(width, height, RGBA, RGBA_stride, Y, U, V, Y_stride, UV_stride, yuv_type);
+}
+
+#define RGB_NV_SSE_FORWARD(NAME) \
+void NAME##_sse(uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type) \
+{ \
+	NAME##_neon(width, height, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type); \
+} \
+\
+void NAME##_sseu(uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type) \
+{ \
+	NAME##_neon(width, height, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type); \
+}
+
+RGB_NV_SSE_FORWARD(rgb24_nv12)
+RGB_NV_SSE_FORWARD(rgb24_nv21)
+RGB_NV_SSE_FORWARD(rgb32_nv12)
+RGB_NV_SSE_FORWARD(rgb32_nv21)
+
+#endif //__ARM_NEON
+
+// Runtime dispatching
+
+SIMDType yuv_rgb_cpu_simd(void)
+{
+#ifdef __SSE2__
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vbmi"))
+		return SIMD_AVX512;
+	if(__builtin_cpu_supports("avx2"))
+		return SIMD_AVX2;
+	if(__builtin_cpu_supports("ssse3"))
+		return SIMD_SSSE3;
+	return SIMD_SSE2;
+#elif defined(__ARM_NEON)
+	return SIMD_NEON;
+#else
+	return SIMD_NONE;
+#endif
+}
+
+void yuv_rgb_set_store_policy(StorePolicy policy)
+{
+	store_policy = policy;
+}
+
+StorePolicy yuv_rgb_store_policy(void)
+{
+	return store_policy;
+}
+
+static PrecisionMode precision = PRECISION_FAST;
+
+void yuv_rgb_set_precision(PrecisionMode mode)
+{
+	precision = mode;
+}
+
+PrecisionMode yuv_rgb_precision(void)
+{
+	return precision;
+}
+
+// Statistics and tracing
+// Each call of an implementation by a dispatching function is a site, with its own counters, that is added 
+// to the list of sites at its first call. STATS_CALL(SIMD, IMPLEMENTATION, ALIGNED, CALL) measures CALL and 
+// updates the counters of its site, it is only CALL without YUV_RGB_STATS.
+#ifdef YUV_RGB_STATS
+
+typedef struct StatsSite
+{
+	YUVRGBStats stats;
+	struct StatsSite *next;
+	int registered;
+} StatsSite;
+
+static StatsSite *stats_sites = NULL;
+
+// The callback and its user data are published together, so that a conversion running during 
+// yuv_rgb_set_trace_callback uses either the previous pair or the new one. The replaced pairs are never 
+// freed, since a conversion may still be using them, they stay in the retired list.
+typedef struct TraceHook
+{
+	YUVRGBTraceCallback callback;
+	void *user_data;
+	struct TraceHook *next;
+} TraceHook;
+
+static TraceHook *trace_hook = NULL;
+static TraceHook *trace_retired_hooks = NULL;
+
+static uint64_t stats_time_ns(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (uint64_t)t.tv_sec*1000000000u + (uint64_t)t.tv_nsec;
+}
+
+static void stats_record(StatsSite *site, uint32_t width, uint32_t height, uint64_t start_ns, uint64_t end_ns)
+{
+	int registered = __atomic_load_n(&(site->registered), __ATOMIC_ACQUIRE);
+	if(!registered && __atomic_compare_exchange_n(&(site->registered), &registered, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+	{
+		StatsSite *head = __atomic_load_n(&stats_sites, __ATOMIC_ACQUIRE);
+		do
+			site->next = head;
+		while(!__atomic_compare_exchange_n(&stats_sites, &head, site, 1, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+	}
+	
+	const int stream_stores = site->stats.unaligned ? 0 : stats_stream_stores;
+	__atomic_fetch_add(&(site->stats.calls), 1, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&(site->stats.pixels), (uint64_t)width*height, __ATOMIC_RELAXED);
+	__atomic_fetch_add(&(site->stats.nanoseconds), end_ns-start_ns, __ATOMIC_RELAXED);
+	if(stream_stores)
+		__atomic_fetch_add(&(site->stats.stream_calls), 1, __ATOMIC_RELAXED);
+	
+	const TraceHook *hook = __atomic_load_n(&trace_hook, __ATOMIC_ACQUIRE);
+	if(hook)
+	{
+		const YUVRGBSpan span = {site->stats.function, site->stats.implementation, site->stats.simd, 
+			site->stats.unaligned, stream_stores, width, height, start_ns, end_ns};
+		hook->callback(&span, hook->user_data);
+	}
+}
+
+#define STATS_CALL(SIMD, IMPLEMENTATION, ALIGNED, CALL) \
+	{ \
+		static StatsSite stats_site = {{__func__, IMPLEMENTATION, SIMD, !(ALIGNED), 0, 0, 0, 0}, NULL, 0}; \
+		stats_stream_stores = 0; \
+		const uint64_t stats_start_ns = stats_time_ns(); \
+		CALL; \
+		stats_record(&stats_site, width, height, stats_start_ns, stats_time_ns()); \
+	}
+
+int yuv_rgb_stats_enabled(void)
+{
+	return 1;
+}
+
+uint32_t yuv_rgb_stats(YUVRGBStats *stats, uint32_t max_count)
+{
+	uint32_t count = 0;
+	const StatsSite *site;
+	for(site=__atomic_load_n(&stats_sites, __ATOMIC_ACQUIRE); site; site=site->next, ++count)
+		if(count<max_count)
+		{
+			YUVRGBStats *s = stats+count;
+			*s = site->stats;
+			s->calls = __atomic_load_n(&(site->stats.calls), __ATOMIC_RELAXED);
+			s->pixels = __atomic_load_n(&(site->stats.pixels), __ATOMIC_RELAXED);
+			s->nanoseconds = __atomic_load_n(&(site->stats.nanoseconds), __ATOMIC_RELAXED);
+			s->stream_calls = __atomic_load_n(&(site->stats.stream_calls), __ATOMIC_RELAXED);
+		}
+	return count;
+}
+
+// the sites stay in the list, with zero counters
+void yuv_rgb_stats_reset(void)
+{
+	StatsSite *site;
+	for(site=__atomic_load_n(&stats_sites, __ATOMIC_ACQUIRE); site; site=site->next)
+	{
+		__atomic_store_n(&(site->stats.calls), 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&(site->stats.pixels), 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&(site->stats.nanoseconds), 0, __ATOMIC_RELAXED);
+		__atomic_store_n(&(site->stats.stream_calls), 0, __ATOMIC_RELAXED);
+	}
+}
+
+// if the allocation of the new pair fails, the callback is removed
+void yuv_rgb_set_trace_callback(YUVRGBTraceCallback callback, void *user_data)
+{
+	TraceHook *hook = NULL;
+	if(callback)
+	{
+		hook = malloc(sizeof(TraceHook));
+		if(hook)
+		{
+			hook->callback = callback;
+			hook->user_data = user_data;
+			hook->next = NULL;
+		}
+	}
+	
+	TraceHook *previous = __atomic_exchange_n(&trace_hook, hook, __ATOMIC_ACQ_REL);
+	if(previous)
+	{
+		TraceHook *head = __atomic_load_n(&trace_retired_hooks, __ATOMIC_ACQUIRE);
+		do
+			previous->next = head;
+		while(!__atomic_compare_exchange_n(&trace_retired_hooks, &head, previous, 1, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+	}
+}
+
+#else
+
+#define STATS_CALL(SIMD, IMPLEMENTATION, ALIGNED, CALL) CALL;
+
+int yuv_rgb_stats_enabled(void)
+{
+	return 0;
+}
+
+uint32_t yuv_rgb_stats(YUVRGBStats *stats, uint32_t max_count)
+{
+	(void)stats;
+	(void)max_count;
+	return 0;
+}
+
+void yuv_rgb_stats_reset(void)
+{
+}
+
+void yuv_rgb_set_trace_callback(YUVRGBTraceCallback callback, void *user_data)
+{
+	(void)callback;
+	(void)user_data;
+}
+
+#endif
+
+// alignment is checked on the bitwise or of all pointers and strides
+#define IS_ALIGNED(value, alignment) ((((uintptr_t)(value)) & ((alignment)-1)) == 0)
+
+// With PRECISION_HIGH, the 8 bits rgb24 conversions use the high precision implementation, that only has a 
+// sse version
+#ifdef __SSE2__
+#define PRECISE_DISPATCH(NAME, ALIGN, ARGS) \
+	if(precision==PRECISION_HIGH) \
+	{ \
+		if(IS_ALIGNED(ALIGN, 16)) \
+			STATS_CALL(SIMD_SSE2, "precise_sse", 1, NAME##_precise_sse ARGS) \
+		else \
+			STATS_CALL(SIMD_SSE2, "precise_sseu", 0, NAME##_precise_sseu ARGS) \
+		return; \
+	}
+#else
+#define PRECISE_DISPATCH(NAME, ALIGN, ARGS) \
+	if(precision==PRECISION_HIGH) \
+	{ \
+		STATS_CALL(SIMD_NONE, "precise_std", 1, NAME##_precise_std ARGS) \
+		return; \
+	}
+#endif
+
+void yuv420_rgb24(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	PRECISE_DISPATCH(yuv420_rgb24, (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride, 
+		(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#ifdef __SSE2__
+	const SIMDType simd = yuv_rgb_cpu_simd();
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride;
+	if(simd>=SIMD_AVX512 && width>=64)
+	{
+		if(IS_ALIGNED(align, 64))
+			STATS_CALL(SIMD_AVX512, "avx512", 1, yuv420_rgb24_avx512(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_AVX512, "avx512u", 0, yuv420_rgb24_avx512u(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+	else if(simd>=SIMD_AVX2 && width>=64)
+	{
+		if(IS_ALIGNED(align, 32))
+			STATS_CALL(SIMD_AVX2, "avx2", 1, yuv420_rgb24_avx2(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_AVX2, "avx2u", 0, yuv420_rgb24_avx2u(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+	else if(simd>=SIMD_SSSE3)
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSSE3, "ssse3", 1, yuv420_rgb24_ssse3(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_SSSE3, "ssse3u", 0, yuv420_rgb24_ssse3u(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+	else
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSE2, "sse", 1, yuv420_rgb24_sse(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_SSE2, "sseu", 0, yuv420_rgb24_sseu(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+#elif defined(__ARM_NEON)
+	STATS_CALL(SIMD_NEON, "neon", 1, yuv420_rgb24_neon(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#else
+	STATS_CALL(SIMD_NONE, "lut", 1, yuv420_rgb24_lut(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#endif
+}
+
+void nv12_rgb24(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	PRECISE_DISPATCH(nv12_rgb24, (uintptr_t)Y | (uintptr_t)UV | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride, 
+		(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#ifdef __SSE2__
+	const SIMDType simd = yuv_rgb_cpu_simd();
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)UV | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride;
+	if(simd>=SIMD_AVX512 && width>=64)
+	{
+		if(IS_ALIGNED(align, 64))
+			STATS_CALL(SIMD_AVX512, "avx512", 1, nv12_rgb24_avx512(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_AVX512, "avx512u", 0, nv12_rgb24_avx512u(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+	else if(simd>=SIMD_AVX2 && width>=64)
+	{
+		if(IS_ALIGNED(align, 32))
+			STATS_CALL(SIMD_AVX2, "avx2", 1, nv12_rgb24_avx2(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_AVX2, "avx2u", 0, nv12_rgb24_avx2u(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+	else if(simd>=SIMD_SSSE3)
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSSE3, "ssse3", 1, nv12_rgb24_ssse3(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_SSSE3, "ssse3u", 0, nv12_rgb24_ssse3u(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+	else
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSE2, "sse", 1, nv12_rgb24_sse(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_SSE2, "sseu", 0, nv12_rgb24_sseu(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+#elif defined(__ARM_NEON)
+	STATS_CALL(SIMD_NEON, "neon", 1, nv12_rgb24_neon(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#else
+	STATS_CALL(SIMD_NONE, "lut", 1, nv12_rgb24_lut(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#endif
+}
+
+void nv21_rgb24(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	PRECISE_DISPATCH(nv21_rgb24, (uintptr_t)Y | (uintptr_t)UV | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride, 
+		(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#ifdef __SSE2__
+	const SIMDType simd = yuv_rgb_cpu_simd();
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)UV | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride;
+	if(simd>=SIMD_AVX512 && width>=64)
+	{
+		if(IS_ALIGNED(align, 64))
+			STATS_CALL(SIMD_AVX512, "avx512", 1, nv21_rgb24_avx512(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_AVX512, "avx512u", 0, nv21_rgb24_avx512u(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+	else if(simd>=SIMD_AVX2 && width>=64)
+	{
+		if(IS_ALIGNED(align, 32))
+			STATS_CALL(SIMD_AVX2, "avx2", 1, nv21_rgb24_avx2(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_AVX2, "avx2u", 0, nv21_rgb24_avx2u(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+	else if(simd>=SIMD_SSSE3)
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSSE3, "ssse3", 1, nv21_rgb24_ssse3(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_SSSE3, "ssse3u", 0, nv21_rgb24_ssse3u(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+	else
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSE2, "sse", 1, nv21_rgb24_sse(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_SSE2, "sseu", 0, nv21_rgb24_sseu(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	}
+#elif defined(__ARM_NEON)
+	STATS_CALL(SIMD_NEON, "neon", 1, nv21_rgb24_neon(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#else
+	STATS_CALL(SIMD_NONE, "lut", 1, nv21_rgb24_lut(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#endif
+}
+
+void rgb24_yuv420(
+	uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+	PRECISE_DISPATCH(rgb24_yuv420, (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride, 
+		(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#ifdef __SSE2__
+	const SIMDType simd = yuv_rgb_cpu_simd();
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride;
+	if(simd>=SIMD_AVX512 && width>=64)
+	{
+		if(IS_ALIGNED(align, 64))
+			STATS_CALL(SIMD_AVX512, "avx512", 1, rgb24_yuv420_avx512(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_AVX512, "avx512u", 0, rgb24_yuv420_avx512u(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+	}
+	else
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSE2, "sse", 1, rgb24_yuv420_sse(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_SSE2, "sseu", 0, rgb24_yuv420_sseu(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+	}
+#elif defined(__ARM_NEON)
+	STATS_CALL(SIMD_NEON, "neon", 1, rgb24_yuv420_neon(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#else
+	STATS_CALL(SIMD_NONE, "std", 1, rgb24_yuv420_std(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#endif
+}
+
+void rgb32_yuv420(
+	uint32_t width, uint32_t height, 
+	const uint8_t *RGBA, uint32_t RGBA_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+#ifdef __SSE2__
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGBA | Y_stride | UV_stride | RGBA_stride;
+	if(IS_ALIGNED(align, 16))
+		STATS_CALL(SIMD_SSE2, "sse", 1, rgb32_yuv420_sse(width, height, RGBA, RGBA_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+	else
+		STATS_CALL(SIMD_SSE2, "sseu", 0, rgb32_yuv420_sseu(width, height, RGBA, RGBA_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#elif defined(__ARM_NEON)
+	STATS_CALL(SIMD_NEON, "neon", 1, rgb32_yuv420_neon(width, height, RGBA, RGBA_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#else
+	STATS_CALL(SIMD_NONE, "std", 1, rgb32_yuv420_std(width, height, RGBA, RGBA_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#endif
+}
+
+void bgr24_yuv420(
+	uint32_t width, uint32_t height, 
+	const uint8_t *BGR, uint32_t BGR_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	YCbCrType yuv_type)
+{
+#ifdef __SSE2__
+	const SIMDType simd = yuv_rgb_cpu_simd();
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)BGR | Y_stride | UV_stride | BGR_stride;
+	if(simd>=SIMD_AVX512 && width>=64)
+	{
+		if(IS_ALIGNED(align, 64))
+			STATS_CALL(SIMD_AVX512, "avx512", 1, bgr24_yuv420_avx512(width, height, BGR, BGR_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_AVX512, "avx512u", 0, bgr24_yuv420_avx512u(width, height, BGR, BGR_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+	}
+	else
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSE2, "sse", 1, bgr24_yuv420_sse(width, height, BGR, BGR_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+		else
+			STATS_CALL(SIMD_SSE2, "sseu", 0, bgr24_yuv420_sseu(width, height, BGR, BGR_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+	}
+#elif defined(__ARM_NEON)
+	STATS_CALL(SIMD_NEON, "neon", 1, bgr24_yuv420_neon(width, height, BGR, BGR_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#else
+	STATS_CALL(SIMD_NONE, "std", 1, bgr24_yuv420_std(width, height, BGR, BGR_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#endif
+}
+
+// same selection as rgb32_yuv420
+#ifdef __SSE2__
+#define RGB32_YUV420_DISPATCH(NAME) \
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGBA | Y_stride | UV_stride | RGBA_stride; \
+	if(IS_ALIGNED(align, 16)) \
+		STATS_CALL(SIMD_SSE2, "sse", 1, NAME##_sse(width, height, RGBA, RGBA_stride, Y, U, V, Y_stride, UV_stride, yuv_type)) \
+	else \
+		STATS_CALL(SIMD_SSE2, "sseu", 0, NAME##_sseu(width, height, RGBA, RGBA_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#elif defined(__ARM_NEON)
+#define RGB32_YUV420_DISPATCH(NAME) \
+	STATS_CALL(SIMD_NEON, "neon", 1, NAME##_neon(width, height, RGBA, RGBA_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#else
+#define RGB32_YUV420_DISPATCH(NAME) \
+	STATS_CALL(SIMD_NONE, "std", 1, NAME##_std(width, height, RGBA, RGBA_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#endif
+
+#define RGB32_YUV420_DISPATCH_FUNCTION(NAME) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *RGBA, uint32_t RGBA_stride, \
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type) \
+{ \
+	RGB32_YUV420_DISPATCH(NAME) \
+}
+
+RGB32_YUV420_DISPATCH_FUNCTION(bgra32_yuv420)
+RGB32_YUV420_DISPATCH_FUNCTION(argb32_yuv420)
+RGB32_YUV420_DISPATCH_FUNCTION(abgr32_yuv420)
+
+// rgb to nv12 and nv21, same selection as rgb24_yuv420 and rgb32_yuv420
+#ifdef __SSE2__
+#define RGB_NV_DISPATCH_SSE(NAME) \
+	if(IS_ALIGNED(align, 16)) \
+		STATS_CALL(SIMD_SSE2, "sse", 1, NAME##_sse(width, height, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type)) \
+	else \
+		STATS_CALL(SIMD_SSE2, "sseu", 0, NAME##_sseu(width, height, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type))
+#define RGB24_NV_DISPATCH(NAME) \
+	const SIMDType simd = yuv_rgb_cpu_simd(); \
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)UV | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride; \
+	if(simd>=SIMD_AVX512 && width>=64) \
+	{ \
+		if(IS_ALIGNED(align, 64)) \
+			STATS_CALL(SIMD_AVX512, "avx512", 1, NAME##_avx512(width, height, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type)) \
+		else \
+			STATS_CALL(SIMD_AVX512, "avx512u", 0, NAME##_avx512u(width, height, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type)) \
+	} \
+	else \
+	{ \
+		RGB_NV_DISPATCH_SSE(NAME) \
+	}
+#define RGB32_NV_DISPATCH(NAME) \
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)UV | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride; \
+	RGB_NV_DISPATCH_SSE(NAME)
+#elif defined(__ARM_NEON)
+#define RGB24_NV_DISPATCH(NAME) \
+	STATS_CALL(SIMD_NEON, "neon", 1, NAME##_neon(width, height, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type))
+#define RGB32_NV_DISPATCH RGB24_NV_DISPATCH
+#else
+#define RGB24_NV_DISPATCH(NAME) \
+	STATS_CALL(SIMD_NONE, "std", 1, NAME##_std(width, height, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type))
+#define RGB32_NV_DISPATCH RGB24_NV_DISPATCH
+#endif
+
+#define RGB_NV_DISPATCH_FUNCTION(NAME, DISPATCH) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type) \
+{ \
+	DISPATCH(NAME) \
+}
+
+#define RGB24_NV_PRECISE_DISPATCH(NAME) \
+	PRECISE_DISPATCH(NAME, (uintptr_t)Y | (uintptr_t)UV | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride, \
+		(width, height, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type)) \
+	RGB24_NV_DISPATCH(NAME)
+
+RGB_NV_DISPATCH_FUNCTION(rgb24_nv12, RGB24_NV_PRECISE_DISPATCH)
+RGB_NV_DISPATCH_FUNCTION(rgb24_nv21, RGB24_NV_PRECISE_DISPATCH)
+RGB_NV_DISPATCH_FUNCTION(rgb32_nv12, RGB32_NV_DISPATCH)
+RGB_NV_DISPATCH_FUNCTION(rgb32_nv21, RGB32_NV_DISPATCH)
+
+// rgb to yuv420p with a chroma filter, the box filter uses the same selection as rgb24_yuv420 and rgb32_yuv420, 
+// and the [1 2 1] filter only has a sse implementation
+#ifdef __SSE2__
+#define RGB_YUV420_121_DISPATCH(NAME) \
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride; \
+	if(IS_ALIGNED(align, 16)) \
+		STATS_CALL(SIMD_SSE2, "sse", 1, NAME##_sse(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type)) \
+	else \
+		STATS_CALL(SIMD_SSE2, "sseu", 0, NAME##_sseu(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#else
+#define RGB_YUV420_121_DISPATCH(NAME) \
+	STATS_CALL(SIMD_NONE, "std", 1, NAME##_std(0, width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type))
+#endif
+
+#define RGB_YUV420_DOWNSAMPLING_DISPATCH_FUNCTION(NAME, BOX_FUNCTION, FILTER_121_NAME) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *RGB, uint32_t RGB_stride, \
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	YCbCrType yuv_type, ChromaDownsampling downsampling) \
+{ \
+	if(downsampling==CHROMA_121_COSITED) \
+	{ \
+		RGB_YUV420_121_DISPATCH(FILTER_121_NAME) \
+	} \
+	else \
+		BOX_FUNCTION(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type); \
+}
+
+RGB_YUV420_DOWNSAMPLING_DISPATCH_FUNCTION(rgb24_yuv420_downsampling, rgb24_yuv420, rgb24_yuv420_121)
+RGB_YUV420_DOWNSAMPLING_DISPATCH_FUNCTION(rgb32_yuv420_downsampling, rgb32_yuv420, rgb32_yuv420_121)
+
+// The 32 bits rgb dispatchers select the implementation in the same way as yuv420_rgb24
+// ALIGN is the bitwise or of all pointers and strides, and ARGS the parenthesized arguments
+#ifdef __SSE2__
+#define RGB32_DISPATCH(NAME, ALIGN, ARGS) \
+	const SIMDType simd = yuv_rgb_cpu_simd(); \
+	const uintptr_t align = ALIGN; \
+	if(simd>=SIMD_AVX512 && width>=64) \
+	{ \
+		if(IS_ALIGNED(align, 64)) \
+			STATS_CALL(SIMD_AVX512, "avx512", 1, NAME##_avx512 ARGS) \
+		else \
+			STATS_CALL(SIMD_AVX512, "avx512u", 0, NAME##_avx512u ARGS) \
+	} \
+	else if(simd>=SIMD_AVX2 && width>=64) \
+	{ \
+		if(IS_ALIGNED(align, 32)) \
+			STATS_CALL(SIMD_AVX2, "avx2", 1, NAME##_avx2 ARGS) \
+		else \
+			STATS_CALL(SIMD_AVX2, "avx2u", 0, NAME##_avx2u ARGS) \
+	} \
+	else \
+	{ \
+		if(IS_ALIGNED(align, 16)) \
+			STATS_CALL(SIMD_SSE2, "sse", 1, NAME##_sse ARGS) \
+		else \
+			STATS_CALL(SIMD_SSE2, "sseu", 0, NAME##_sseu ARGS) \
+	}
+#elif defined(__ARM_NEON)
+#define RGB32_DISPATCH(NAME, ALIGN, ARGS) \
+	STATS_CALL(SIMD_NEON, "neon", 1, NAME##_neon ARGS)
+#else
+#define RGB32_DISPATCH(NAME, ALIGN, ARGS) \
+	STATS_CALL(SIMD_NONE, "std", 1, NAME##_std ARGS)
+#endif
+
+#define YUV420_RGB32_DISPATCH_FUNCTION(NAME) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGBA, uint32_t RGBA_stride, \
+	YCbCrType yuv_type, uint8_t alpha) \
+{ \
+	RGB32_DISPATCH(NAME, (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGBA | Y_stride | UV_stride | RGBA_stride, \
+		(width, height, Y, U, V, Y_stride, UV_stride, RGBA, RGBA_stride, yuv_type, alpha)) \
+}
+
+#define NV_RGB32_DISPATCH_FUNCTION(NAME) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	uint8_t *RGBA, uint32_t RGBA_stride, \
+	YCbCrType yuv_type, uint8_t alpha) \
+{ \
+	RGB32_DISPATCH(NAME, (uintptr_t)Y | (uintptr_t)UV | (uintptr_t)RGBA | Y_stride | UV_stride | RGBA_stride, \
+		(width, height, Y, UV, Y_stride, UV_stride, RGBA, RGBA_stride, yuv_type, alpha)) \
+}
+
+YUV420_RGB32_DISPATCH_FUNCTION(yuv420_rgba32)
+YUV420_RGB32_DISPATCH_FUNCTION(yuv420_bgra32)
+YUV420_RGB32_DISPATCH_FUNCTION(yuv420_argb32)
+YUV420_RGB32_DISPATCH_FUNCTION(yuv420_abgr32)
+NV_RGB32_DISPATCH_FUNCTION(nv12_rgba32)
+NV_RGB32_DISPATCH_FUNCTION(nv12_bgra32)
+NV_RGB32_DISPATCH_FUNCTION(nv12_argb32)
+NV_RGB32_DISPATCH_FUNCTION(nv12_abgr32)
+NV_RGB32_DISPATCH_FUNCTION(nv21_rgba32)
+NV_RGB32_DISPATCH_FUNCTION(nv21_bgra32)
+NV_RGB32_DISPATCH_FUNCTION(nv21_argb32)
+NV_RGB32_DISPATCH_FUNCTION(nv21_abgr32)
+
+// The interpolating conversion only has a sse implementation, the alignment of the chroma planes does not matter
+void yuv420_rgb24_upsampling(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type, ChromaUpsampling upsampling)
+{
+#ifdef __SSE2__
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)RGB | Y_stride | RGB_stride;
+	if(IS_ALIGNED(align, 16))
+		STATS_CALL(SIMD_SSE2, "sse", 1, yuv420_rgb24_upsampling_sse(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type, upsampling))
+	else
+		STATS_CALL(SIMD_SSE2, "sseu", 0, yuv420_rgb24_upsampling_sseu(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type, upsampling))
+#else
+	STATS_CALL(SIMD_NONE, "std", 1, yuv420_rgb24_upsampling_std(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type, upsampling))
+#endif
+}
+
+// The high bit depth and packed 4:2:2 conversions only have a sse implementation, used for any alignment
+#ifdef __SSE2__
+#define SSE_ONLY_DISPATCH(NAME, ALIGN, ARGS) \
+	if(IS_ALIGNED(ALIGN, 16)) \
+		STATS_CALL(SIMD_SSE2, "sse", 1, NAME##_sse ARGS) \
+	else \
+		STATS_CALL(SIMD_SSE2, "sseu", 0, NAME##_sseu ARGS)
+#else
+#define SSE_ONLY_DISPATCH(NAME, ALIGN, ARGS) \
+	STATS_CALL(SIMD_NONE, "std", 1, NAME##_std ARGS)
+#endif
+
+#define YUV420P16_RGB_DISPATCH_FUNCTION(NAME, RGB_TYPE) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint16_t *Y, const uint16_t *U, const uint16_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	RGB_TYPE *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	SSE_ONLY_DISPATCH(NAME, (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride, \
+		(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type)) \
+}
+
+#define P016_RGB_DISPATCH_FUNCTION(NAME, RGB_TYPE) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint16_t *Y, const uint16_t *UV, uint32_t Y_stride, uint32_t UV_stride, \
+	RGB_TYPE *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	SSE_ONLY_DISPATCH(NAME, (uintptr_t)Y | (uintptr_t)UV | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride, \
+		(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type)) \
+}
+
+YUV420P16_RGB_DISPATCH_FUNCTION(yuv420p10_rgb24, uint8_t)
+YUV420P16_RGB_DISPATCH_FUNCTION(yuv420p10_rgb48, uint16_t)
+P016_RGB_DISPATCH_FUNCTION(p010_rgb24, uint8_t)
+P016_RGB_DISPATCH_FUNCTION(p010_rgb48, uint16_t)
+
+// The context conversions use the sse (or ssse3) implementation when available (neon builds use the std one)
+void yuv420_rgb24_ctx(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	const YCbCrContext *context)
+{
+#ifdef __SSE2__
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride;
+	if(yuv_rgb_cpu_simd()>=SIMD_SSSE3)
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSSE3, "ssse3", 1, yuv420_rgb24_param_ssse3(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, &(context->yuv2rgb)))
+		else
+			STATS_CALL(SIMD_SSSE3, "ssse3u", 0, yuv420_rgb24_param_ssse3u(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, &(context->yuv2rgb)))
+	}
+	else if(IS_ALIGNED(align, 16))
+		STATS_CALL(SIMD_SSE2, "sse", 1, yuv420_rgb24_param_sse(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, &(context->yuv2rgb)))
+	else
+		STATS_CALL(SIMD_SSE2, "sseu", 0, yuv420_rgb24_param_sseu(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, &(context->yuv2rgb)))
+#else
+	STATS_CALL(SIMD_NONE, "std", 1, yuv420_rgb24_ctx_std(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, context))
+#endif
+}
+
+void rgb24_yuv420_ctx(
+	uint32_t width, uint32_t height, 
+	const uint8_t *RGB, uint32_t RGB_stride, 
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	const YCbCrContext *context)
+{
+#ifdef __SSE2__
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)RGB | Y_stride | UV_stride | RGB_stride;
+	if(IS_ALIGNED(align, 16))
+		STATS_CALL(SIMD_SSE2, "sse", 1, rgb24_yuv420_param_sse(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, &(context->rgb2yuv)))
+	else
+		STATS_CALL(SIMD_SSE2, "sseu", 0, rgb24_yuv420_param_sseu(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, &(context->rgb2yuv)))
+#else
+	STATS_CALL(SIMD_NONE, "std", 1, rgb24_yuv420_ctx_std(width, height, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, context))
+#endif
+}
+
+// The 4:4:4 and packed 4:2:2 conversions only have a sse implementation (the yuv444p alignment only depends 
+// on y and rgb, as for the interpolating conversion)
+void yuv444p_rgb24(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+#ifdef __SSE2__
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)RGB | Y_stride | RGB_stride;
+	if(IS_ALIGNED(align, 16))
+		STATS_CALL(SIMD_SSE2, "sse", 1, yuv444p_rgb24_sse(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+	else
+		STATS_CALL(SIMD_SSE2, "sseu", 0, yuv444p_rgb24_sseu(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#else
+	STATS_CALL(SIMD_NONE, "std", 1, yuv444p_rgb24_std(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type))
+#endif
+}
+
+#define YUV422_RGB24_DISPATCH_FUNCTION(NAME) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *YUV, uint32_t YUV_stride, \
+	uint8_t *RGB, uint32_t RGB_stride, \
+	YCbCrType yuv_type) \
+{ \
+	SSE_ONLY_DISPATCH(NAME, (uintptr_t)YUV | (uintptr_t)RGB | YUV_stride | RGB_stride, \
+		(width, height, YUV, YUV_stride, RGB, RGB_stride, yuv_type)) \
+}
+
+YUV422_RGB24_DISPATCH_FUNCTION(yuyv_rgb24)
+YUV422_RGB24_DISPATCH_FUNCTION(uyvy_rgb24)
+
+// The scaling conversion uses the sse implementation for the 2x and 4x reductions (the alignment only depends 
+// on rgb), and the std one for the other factors
+void yuv420_rgb24_resize(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint8_t *RGB, uint32_t rgb_width, uint32_t rgb_height, uint32_t RGB_stride, 
+	YCbCrType yuv_type)
+{
+	if(width==rgb_width && height==rgb_height)
+	{
+		yuv420_rgb24(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type);
+		return;
+	}
+#ifdef __SSE2__
+	const uint32_t factor = rgb_width>0 ? width/rgb_width : 0;
+	if((factor==2 || factor==4) && width==factor*rgb_width && height==factor*rgb_height)
+	{
+		const uintptr_t align = (uintptr_t)RGB | RGB_stride;
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSE2, "sse", 1, yuv420_rgb24_box_sse(Y, U, V, Y_stride, UV_stride, RGB, rgb_width, rgb_height, RGB_stride, yuv_type, factor))
+		else
+			STATS_CALL(SIMD_SSE2, "sseu", 0, yuv420_rgb24_box_sseu(Y, U, V, Y_stride, UV_stride, RGB, rgb_width, rgb_height, RGB_stride, yuv_type, factor))
+		return;
+	}
+#endif
+	STATS_CALL(SIMD_NONE, "std", 1, yuv420_rgb24_resize_std(width, height, Y, U, V, Y_stride, UV_stride, RGB, rgb_width, rgb_height, RGB_stride, yuv_type))
+}
+
+// The 8 bits and float planar rgb conversions only have a sse implementation
+#define YUV420_RGBP_DISPATCH_FUNCTION(NAME, RGB_TYPE, EXTRA_PARAMS, EXTRA_ARGS) \
+void NAME( \
+	uint32_t width, uint32_t height, \
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, \
+	RGB_TYPE *R, RGB_TYPE *G, RGB_TYPE *B, uint32_t RGB_stride, \
+	YCbCrType yuv_type EXTRA_PARAMS) \
+{ \
+	SSE_ONLY_DISPATCH(NAME, (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)R | (uintptr_t)G | (uintptr_t)B | \
+		Y_stride | UV_stride | RGB_stride, \
+		(width, height, Y, U, V, Y_stride, UV_stride, R, G, B, RGB_stride, yuv_type EXTRA_ARGS)) \
+}
+
+YUV420_RGBP_DISPATCH_FUNCTION(yuv420_rgbp, uint8_t, RGBP_PARAMS, RGBP_ARGS)
+YUV420_RGBP_DISPATCH_FUNCTION(yuv420_rgbp_float, float, RGBP_FLOAT_PARAMS, RGBP_FLOAT_ARGS)
+
+// the half float conversion uses the f16c instructions when available, see yuv420_rgbp_half_avx2
+void yuv420_rgbp_half(
+	uint32_t width, uint32_t height, 
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride, 
+	uint16_t *R, uint16_t *G, uint16_t *B, uint32_t RGB_stride, 
+	YCbCrType yuv_type, const float scale[3], const float bias[3])
+{
+#ifdef __SSE2__
+	const uintptr_t align = (uintptr_t)Y | (uintptr_t)U | (uintptr_t)V | (uintptr_t)R | (uintptr_t)G | (uintptr_t)B | 
+		Y_stride | UV_stride | RGB_stride;
+	if(yuv_rgb_cpu_simd()>=SIMD_AVX2)
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_AVX2, "avx2", 1, yuv420_rgbp_half_avx2(width, height, Y, U, V, Y_stride, UV_stride, R, G, B, RGB_stride, yuv_type, scale, bias))
+		else
+			STATS_CALL(SIMD_AVX2, "avx2u", 0, yuv420_rgbp_half_avx2u(width, height, Y, U, V, Y_stride, UV_stride, R, G, B, RGB_stride, yuv_type, scale, bias))
+	}
+	else
+	{
+		if(IS_ALIGNED(align, 16))
+			STATS_CALL(SIMD_SSE2, "sse", 1, yuv420_rgbp_half_sse(width, height, Y, U, V, Y_stride, UV_stride, R, G, B, RGB_stride, yuv_type, scale, bias))
+		else
+			STATS_CALL(SIMD_SSE2, "sseu", 0, yuv420_rgbp_half_sseu(width, height, Y, U, V, Y_stride, UV_stride, R, G, B, RGB_stride, yuv_type, scale, bias))
+	}
+#else
+	STATS_CALL(SIMD_NONE, "std", 1, yuv420_rgbp_half_std(width, height, Y, U, V, Y_stride, UV_stride, R, G, B, RGB_stride, yuv_type, scale, bias))
+#endif
+}
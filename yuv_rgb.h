@@ -1,7 +1,7 @@
 // Copyright 2016 Adrien Descamps
 // Distributed under BSD 3-Clause License
 
-// Provide optimized functions to convert images from 8bits yuv420 to rgb24 format
+// Provide optimized functions to convert images from 8bits yuv420 to rgb24 (or 32 bits rgb) format
 
 // There are a few slightly different variations of the YCbCr color space with different parameters that 
 // change the conversion matrix.
@@ -11,24 +11,184 @@
 
 // YUV420 is stored as three separate channels, with U and V (Cb and Cr) subsampled by a 2 factor
 // For conversion from yuv to rgb, no interpolation is done, and the same UV value are used for 4 rgb pixels. This 
-// is suboptimal for image quality, but by far the fastest method.
+// is suboptimal for image quality, but by far the fastest method. yuv420_rgb24_upsampling can interpolate the 
+// chroma values instead, see below.
 
-// For all methods, width and height should be even, if not, the last row/column of the result image won't be affected.
-// For sse methods, if the width if not divisable by 32, the last (width%32) pixels of each line won't be affected.
+// All methods convert the whole image, for any width and height. If width (or height) is odd, the chroma 
+// samples of the last column (or row) are only shared by two pixels instead of four.
+// The simd methods convert blocks of 32 (sse and ssse3), 64 (avx2 and avx512) or 16 (neon) pixels of each line, 
+// the remaining (width%block_size) pixels of each line, and the last row if height is odd, are converted 
+// with the std implementation.
+
+// The functions without implementation suffix (yuv420_rgb24, nv12_rgb24, ...) select at runtime the fastest
+// implementation supported by the cpu and by the memory alignment of their parameters.
+// ssse3, avx2 and avx512 implementations are only available on x86 with gcc compatible compilers, and must only 
+// be called directly if yuv_rgb_cpu_simd() returns SIMD_SSSE3 (respectively SIMD_AVX2, SIMD_AVX512) or higher.
+// neon implementations are only available on arm builds with neon enabled (armv7 with -mfpu=neon, or aarch64).
+// On these builds, the sse functions are also provided, and forward to the neon implementation.
 
 #include <stdint.h>
 
+// yuv color spaces: YCBCR_JPEG is full range BT.601, the others are limited range ([16:235] for luma, 
+// [16:240] for chroma) unless specified otherwise. YCBCR_2020 is the non constant luminance BT.2020 matrix.
+// Other matrices can be used with a conversion context, see ycbcr_context_create.
 typedef enum
 {
 	YCBCR_JPEG,
 	YCBCR_601,
-	YCBCR_709
+	YCBCR_709,
+	YCBCR_709_FULL,
+	YCBCR_2020
 } YCbCrType;
 
+// chroma upsampling method for yuv to rgb conversion
+// In yuv420, chroma samples are vertically located between the two rows of luma samples they cover, and 
+// horizontally either between the two columns (centered, as in JPEG and MPEG-1) or at the position of the 
+// left one (co-sited, as in MPEG-2 and H.264).
+typedef enum
+{
+	CHROMA_NEAREST,          // use the same chroma values for the 4 pixels, as the other conversion functions
+	CHROMA_BILINEAR_CENTER,  // bilinear interpolation of centered chroma samples
+	CHROMA_BILINEAR_COSITED  // bilinear interpolation of horizontally co-sited chroma samples
+} ChromaUpsampling;
+
+// chroma downsampling filter for rgb to yuv conversion
+typedef enum
+{
+	CHROMA_BOX,          // average of the 2x2 pixels of each chroma sample (centered chroma), as the other conversion functions
+	CHROMA_121_COSITED   // [1 2 1] horizontal filter centered on the even columns, and average of the two rows (co-sited chroma)
+} ChromaDownsampling;
+
+// simd instruction sets, in increasing order of preference (the order is only meaningful 
+// between instruction sets of the same architecture)
+typedef enum
+{
+	SIMD_NONE,
+	SIMD_NEON,
+	SIMD_SSE2,
+	SIMD_SSSE3,
+	SIMD_AVX2,
+	SIMD_AVX512  // AVX512F + AVX512BW + AVX512VBMI (Ice Lake and later)
+} SIMDType;
+
+// store policy of the aligned simd functions (sse, ssse3, avx2 and avx512 suffixes, and the dispatching functions with 
+// aligned parameters). Non temporal stores bypass the cache, which is faster for large images that would not 
+// fit in it anyway, while regular stores keep the output in cache for the next processing step.
+typedef enum
+{
+	STORE_AUTO,     // non temporal stores if the output is larger than half of the last level cache (default)
+	STORE_STREAM,   // always non temporal stores
+	STORE_TEMPORAL  // always regular stores
+} StorePolicy;
+
+// precision of the rgb24 conversions of the dispatching functions (see yuv_rgb_set_precision)
+typedef enum
+{
+	PRECISION_FAST, // 6 to 8 bits fixed point factors, maximum error of a few units (default)
+	PRECISION_HIGH  // 14 to 20 bits fixed point factors, maximum error of 1
+} PrecisionMode;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// the library is built with hidden visibility, only these functions are exported
+#if defined(__GNUC__) && !defined(_WIN32)
+#pragma GCC visibility push(default)
+#endif
+
+// return the best simd instruction set supported by both the library build and the running cpu
+SIMDType yuv_rgb_cpu_simd(void);
+
+// set the store policy of the following conversions, it should not be changed while conversions are running.
+// After non temporal stores, the simd functions end with a store fence, so that the output can be used by 
+// another thread as soon as they return.
+// With STORE_AUTO, the output size is the one of each call (each band of the multithreaded conversion).
+void yuv_rgb_set_store_policy(StorePolicy policy);
+StorePolicy yuv_rgb_store_policy(void);
+
+// set the precision of the following yuv420_rgb24, nv12_rgb24, nv21_rgb24, rgb24_yuv420, rgb24_nv12 and rgb24_nv21 
+// conversions (and of the multithreaded, strips and batch conversions using them), with the same constraints 
+// as yuv_rgb_set_store_policy. With PRECISION_HIGH they use the _precise implementations (sse when available), 
+// whose results are within 1 of the exact (floating point) values, up to 1.4 times slower than the default ones.
+void yuv_rgb_set_precision(PrecisionMode mode);
+PrecisionMode yuv_rgb_precision(void);
+
+// Statistics and tracing
+// When the library is built with -DUSE_STATS=ON (YUV_RGB_STATS defined), the dispatching functions record, for 
+// each implementation they select, the number of calls, of pixels and the time spent, and call the trace 
+// callback after each conversion. Otherwise this is compiled out, yuv_rgb_stats returning no entry.
+// The counters are updated atomically, the multithreaded conversions counting one call per band.
+typedef struct
+{
+	const char *function;       // dispatching function, for example "nv21_rgb24"
+	const char *implementation; // implementation selected by it, for example "avx2", "sseu" or "precise_sse"
+	SIMDType simd;              // instruction set of the implementation
+	int unaligned;              // unaligned implementation, selected because of the pointers or strides alignment
+	uint64_t calls, pixels, nanoseconds;
+	uint64_t stream_calls;      // calls with non temporal stores (see yuv_rgb_set_store_policy)
+} YUVRGBStats;
+
+// return 1 if the library is built with statistics
+int yuv_rgb_stats_enabled(void);
+
+// copy up to max_count entries (one per function and implementation used since the start or the last reset) 
+// into stats, and return the total number of entries
+uint32_t yuv_rgb_stats(YUVRGBStats *stats, uint32_t max_count);
+void yuv_rgb_stats_reset(void);
+
+// a conversion, given to the trace callback, with its start and end times (CLOCK_MONOTONIC, in ns)
+typedef struct
+{
+	const char *function, *implementation;
+	SIMDType simd;
+	int unaligned, stream_stores;
+	uint32_t width, height;
+	uint64_t start_ns, end_ns;
+} YUVRGBSpan;
+
+typedef void (*YUVRGBTraceCallback)(const YUVRGBSpan *span, void *user_data);
+
+// set the callback called after each conversion (in the converting thread), NULL to remove it. It can be 
+// changed while conversions are running, each of them calling either the previous or the new callback, with 
+// its own user_data.
+void yuv_rgb_set_trace_callback(YUVRGBTraceCallback callback, void *user_data);
+
+// yuv to rgb, runtime selection of the best implementation
+void yuv420_rgb24(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv12 to rgb, runtime selection of the best implementation
+void nv12_rgb24(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride,
+	YCbCrType yuv_type);
+
+// yuv nv21 to rgb, runtime selection of the best implementation
+void nv21_rgb24(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride,
+	YCbCrType yuv_type);
+
+// rgb to yuv, runtime selection of the best implementation
+void rgb24_yuv420(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+// rgba to yuv, runtime selection of the best implementation
+void rgb32_yuv420(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
 // yuv to rgb, standard c implementation
 void yuv420_rgb24_std(
 	uint32_t width, uint32_t height, 
@@ -50,6 +210,27 @@ void nv21_rgb24_std(
 	uint8_t *rgb, uint32_t rgb_stride,
 	YCbCrType yuv_type);
 
+// yuv to rgb, lookup table implementation, with the same output as the std functions but without 
+// multiplications, for the targets without simd (used by the dispatching functions on them)
+// The tables (2.5KB per yuv_type, and a 2KB clamping table) are built at the first call with each yuv_type.
+void yuv420_rgb24_lut(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void nv12_rgb24_lut(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride,
+	YCbCrType yuv_type);
+
+void nv21_rgb24_lut(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride,
+	YCbCrType yuv_type);
+
 // yuv to rgb, sse implementation
 // pointers must be 16 byte aligned, and strides must be divisable by 16
 void yuv420_rgb24_sse(
@@ -98,6 +279,150 @@ void nv21_rgb24_sseu(
 	uint8_t *rgb, uint32_t rgb_stride, 
 	YCbCrType yuv_type);
 
+// yuv to rgb, ssse3 implementation (faster rgb24 interleaving than sse)
+// pointers must be 16 byte aligned, and strides must be divisable by 16
+void yuv420_rgb24_ssse3(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv to rgb, ssse3 implementation
+// pointers do not need to be 16 byte aligned
+void yuv420_rgb24_ssse3u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv12 to rgb, ssse3 implementation
+// pointers must be 16 byte aligned, and strides must be divisable by 16
+void nv12_rgb24_ssse3(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv12 to rgb, ssse3 implementation
+// pointers do not need to be 16 byte aligned
+void nv12_rgb24_ssse3u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv21 to rgb, ssse3 implementation
+// pointers must be 16 byte aligned, and strides must be divisable by 16
+void nv21_rgb24_ssse3(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv21 to rgb, ssse3 implementation
+// pointers do not need to be 16 byte aligned
+void nv21_rgb24_ssse3u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+
+// yuv to rgb, avx2 implementation
+// pointers must be 32 byte aligned, and strides must be divisable by 32
+void yuv420_rgb24_avx2(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv to rgb, avx2 implementation
+// pointers do not need to be 32 byte aligned
+void yuv420_rgb24_avx2u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv12 to rgb, avx2 implementation
+// pointers must be 32 byte aligned, and strides must be divisable by 32
+void nv12_rgb24_avx2(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv12 to rgb, avx2 implementation
+// pointers do not need to be 32 byte aligned
+void nv12_rgb24_avx2u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv21 to rgb, avx2 implementation
+// pointers must be 32 byte aligned, and strides must be divisable by 32
+void nv21_rgb24_avx2(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv21 to rgb, avx2 implementation
+// pointers do not need to be 32 byte aligned
+void nv21_rgb24_avx2u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv to rgb, avx512 implementation
+// pointers must be 64 byte aligned, and strides must be divisable by 64
+void yuv420_rgb24_avx512(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv to rgb, avx512 implementation
+// pointers do not need to be 64 byte aligned
+void yuv420_rgb24_avx512u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv12 to rgb, avx512 implementation
+// pointers must be 64 byte aligned, and strides must be divisable by 64
+void nv12_rgb24_avx512(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv12 to rgb, avx512 implementation
+// pointers do not need to be 64 byte aligned
+void nv12_rgb24_avx512u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv21 to rgb, avx512 implementation
+// pointers must be 64 byte aligned, and strides must be divisable by 64
+void nv21_rgb24_avx512(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv21 to rgb, avx512 implementation
+// pointers do not need to be 64 byte aligned
+void nv21_rgb24_avx512u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
 
 
 
@@ -124,6 +449,22 @@ void rgb24_yuv420_sseu(
 	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
 	YCbCrType yuv_type);
 
+// rgb to yuv, avx512 implementation
+// pointers must be 64 byte aligned, and strides must be divisible by 64
+void rgb24_yuv420_avx512(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+// rgb to yuv, avx512 implementation
+// pointers do not need to be 64 byte aligned
+void rgb24_yuv420_avx512u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
 // rgba to yuv, standard c implementation
 // alpha channel is ignored
 void rgb32_yuv420_std(
@@ -150,6 +491,1056 @@ void rgb32_yuv420_sseu(
 	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
 	YCbCrType yuv_type);
 
+// yuv to rgb, neon implementation
+// pointers and strides do not need any alignment
+void yuv420_rgb24_neon(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv nv12 to rgb, neon implementation
+void nv12_rgb24_neon(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride,
+	YCbCrType yuv_type);
+
+// yuv nv21 to rgb, neon implementation
+void nv21_rgb24_neon(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgb, uint32_t rgb_stride,
+	YCbCrType yuv_type);
+
+// rgb to yuv, neon implementation
+void rgb24_yuv420_neon(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+// rgba to yuv, neon implementation
+void rgb32_yuv420_neon(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+// rgb to yuv, other channel orders
+// bgr24 (b, g, r bytes), and 32 bits formats named by their byte order in memory (rgb32_yuv420 is rgba), the 
+// alpha channel is ignored.
+// The functions without suffix select the best implementation at runtime, as rgb24_yuv420 and rgb32_yuv420.
+void bgr24_yuv420(
+	uint32_t width, uint32_t height, 
+	const uint8_t *bgr, uint32_t bgr_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void bgr24_yuv420_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *bgr, uint32_t bgr_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void bgra32_yuv420(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void bgra32_yuv420_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void argb32_yuv420(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void argb32_yuv420_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void abgr32_yuv420(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void abgr32_yuv420_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+// rgb to yuv nv12 and nv21 (semi planar, interleaved u and v in a single plane, v first for nv21)
+// The simd implementations save the interleaved chroma directly, and have the same alignment requirements 
+// as the yuv420p ones. rgb32 inputs are rgba, the alpha channel is ignored.
+// The functions without suffix select the best implementation at runtime, as rgb24_yuv420 and rgb32_yuv420.
+void rgb24_nv12(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv12_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv12_sse(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv12_sseu(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv12_avx512(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv12_avx512u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv12_neon(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv21(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv21_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv21_sse(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv21_sseu(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv21_avx512(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv21_avx512u(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv21_neon(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb32_nv12(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb32_nv12_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb32_nv12_sse(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb32_nv12_sseu(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb32_nv12_neon(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb32_nv21(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb32_nv21_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb32_nv21_sse(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb32_nv21_sseu(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb32_nv21_neon(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+// yuv to 32 bits rgb
+// The four channel orders are supported, named by the order of the bytes in memory (rgba32 stores r, g, b 
+// then a), and the alpha channel is set to the constant alpha value.
+// The functions without suffix select the best implementation at runtime, as yuv420_rgb24. The simd 
+// implementations have the same alignment requirements as the rgb24 ones, and only the std implementation 
+// is exported.
+void yuv420_rgba32(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+void yuv420_rgba32_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+void yuv420_bgra32(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+void yuv420_bgra32_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+void yuv420_argb32(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+void yuv420_argb32_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+void yuv420_abgr32(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+void yuv420_abgr32_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv12_rgba32(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv12_rgba32_std(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv12_bgra32(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv12_bgra32_std(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv12_argb32(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv12_argb32_std(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv12_abgr32(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv12_abgr32_std(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv21_rgba32(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv21_rgba32_std(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv21_bgra32(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv21_bgra32_std(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv21_argb32(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv21_argb32_std(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv21_abgr32(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+void nv21_abgr32_std(
+	uint32_t width, uint32_t height,
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride,
+	uint8_t *rgba, uint32_t rgba_stride,
+	YCbCrType yuv_type, uint8_t alpha);
+
+// yuv to rgb, with chroma interpolation
+// Same as yuv420_rgb24 when upsampling is CHROMA_NEAREST. Otherwise, each pixel gets its own chroma values, 
+// interpolated from the four nearest chroma samples (with weights 9/16, 3/16, 3/16 and 1/16 for centered 
+// samples), the samples on the image borders being repeated.
+// The rows are converted with sse when available, y and rgb only need a 16 bytes alignment to use aligned 
+// accesses. Since each row uses the neighbouring chroma rows, the image must not be split in bands with 
+// yuv2rgb_mt.
+void yuv420_rgb24_upsampling(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type, ChromaUpsampling upsampling);
+
+void yuv420_rgb24_upsampling_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type, ChromaUpsampling upsampling);
+
+// rgb to yuv, with a selectable chroma filter
+// Same as rgb24_yuv420 (and rgb32_yuv420) with CHROMA_BOX. CHROMA_121_COSITED gives less aliasing, and the 
+// chroma samples are at the position expected by MPEG-2 and H.264 decoders. The pixels of the image borders 
+// are repeated.
+// It is converted with sse when available, with the same alignment requirements as rgb24_yuv420_sse to use 
+// aligned accesses.
+void rgb24_yuv420_downsampling(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type, ChromaDownsampling downsampling);
+
+void rgb24_yuv420_downsampling_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type, ChromaDownsampling downsampling);
+
+// alpha channel is ignored
+void rgb32_yuv420_downsampling(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type, ChromaDownsampling downsampling);
+
+void rgb32_yuv420_downsampling_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgba, uint32_t rgba_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type, ChromaDownsampling downsampling);
+
+// yuv to rgb, with scaling to a rgb image of rgb_width*rgb_height pixels
+// When width and height are multiples of rgb_width and rgb_height, each rgb pixel is computed from the 
+// average of the yuv values of the pixels it covers (box filter). Otherwise, the yuv values are interpolated 
+// at the center of each rgb pixel (bilinear), which is only suited to factors below 2.
+// The 2x and 4x reductions are converted with sse when available, reading the yuv image only once (for 2x, 
+// the chroma samples are used directly). rgb only needs a 16 bytes alignment to use aligned accesses.
+void yuv420_rgb24_resize(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_width, uint32_t rgb_height, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void yuv420_rgb24_resize_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_width, uint32_t rgb_height, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// 4:4:4 and packed 4:2:2 yuv to rgb
+// yuv444p is planar, with one chroma sample per pixel (u and v share the same stride). yuyv (also called 
+// yuy2) and uyvy are packed 4:2:2 formats, each 4 bytes macropixel (y0 u y1 v, respectively u y0 v y1) holding 
+// two horizontal pixels sharing the same chroma values. If width is odd, the rows must still contain 
+// (width+1)/2 complete macropixels.
+// The functions without suffix use sse when available, to use aligned accesses y and rgb (yuv444p), or yuv 
+// and rgb (yuyv and uyvy), pointers and strides must be multiples of 16.
+void yuv444p_rgb24(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void yuv444p_rgb24_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void yuyv_rgb24(
+	uint32_t width, uint32_t height, 
+	const uint8_t *yuv, uint32_t yuv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void yuyv_rgb24_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *yuv, uint32_t yuv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void uyvy_rgb24(
+	uint32_t width, uint32_t height, 
+	const uint8_t *yuv, uint32_t yuv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void uyvy_rgb24_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *yuv, uint32_t yuv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// yuv to planar rgb
+// The r, g and b values are saved in three separate planes (the gbrp format of ffmpeg, with the planes given 
+// separately), sharing the same stride, in bytes. yuv420_rgbp has 8 bits values, yuv420_rgbp_float float 
+// values, and yuv420_rgbp_half IEEE half float values (binary16, rounded to nearest even), both computed 
+// as value*scale[c]+bias[c] from the 8 bits value of channel c (0 for r, 1 for g and 2 for b). 
+// For example, scale[c] = 1/(255*std[c]) and bias[c] = -mean[c]/std[c] give the usual normalized tensors.
+// The functions without suffix use sse when available, all pointers and strides must be multiples of 16 to 
+// use aligned accesses.
+void yuv420_rgbp(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *r, uint8_t *g, uint8_t *b, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void yuv420_rgbp_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *r, uint8_t *g, uint8_t *b, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void yuv420_rgbp_float(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	float *r, float *g, float *b, uint32_t rgb_stride, 
+	YCbCrType yuv_type, const float scale[3], const float bias[3]);
+
+void yuv420_rgbp_float_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	float *r, float *g, float *b, uint32_t rgb_stride, 
+	YCbCrType yuv_type, const float scale[3], const float bias[3]);
+
+void yuv420_rgbp_half(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint16_t *r, uint16_t *g, uint16_t *b, uint32_t rgb_stride, 
+	YCbCrType yuv_type, const float scale[3], const float bias[3]);
+
+void yuv420_rgbp_half_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint16_t *r, uint16_t *g, uint16_t *b, uint32_t rgb_stride, 
+	YCbCrType yuv_type, const float scale[3], const float bias[3]);
+
+// high bit depth yuv to rgb
+// yuv420p10 is planar, with 10 bits values stored in the low bits of 16 bits words (yuv420p10le on little 
+// endian hosts), and p010 semi planar (interleaved u and v, as nv12), with the values stored in the high bits 
+// of 16 bits words, so that the p010 functions also convert p016 (and p012) without loss. Samples are in 
+// native byte order, and all strides are in bytes.
+// rgb24 output has 8 bits channels, and rgb48 output 16 bits channels in [0:65535] (in native byte order).
+// The conversion is computed directly from the high bit depth values (with 14 bits of precision), there is 
+// no intermediate 8 bits image.
+// The functions without suffix use sse when available, whatever the alignment (all pointers and strides 
+// must be multiples of 16 to use aligned accesses).
+void yuv420p10_rgb24(
+	uint32_t width, uint32_t height, 
+	const uint16_t *y, const uint16_t *u, const uint16_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void yuv420p10_rgb24_std(
+	uint32_t width, uint32_t height, 
+	const uint16_t *y, const uint16_t *u, const uint16_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void yuv420p10_rgb48(
+	uint32_t width, uint32_t height, 
+	const uint16_t *y, const uint16_t *u, const uint16_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint16_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void yuv420p10_rgb48_std(
+	uint32_t width, uint32_t height, 
+	const uint16_t *y, const uint16_t *u, const uint16_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint16_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void p010_rgb24(
+	uint32_t width, uint32_t height, 
+	const uint16_t *y, const uint16_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void p010_rgb24_std(
+	uint32_t width, uint32_t height, 
+	const uint16_t *y, const uint16_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void p010_rgb48(
+	uint32_t width, uint32_t height, 
+	const uint16_t *y, const uint16_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint16_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void p010_rgb48_std(
+	uint32_t width, uint32_t height, 
+	const uint16_t *y, const uint16_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint16_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// high precision 8 bits conversions, used by the dispatching functions with PRECISION_HIGH
+// yuv to rgb24 uses the high bit depth code (14 bits values), and rgb24 to yuv 15 bits factors.
+void yuv420_rgb24_precise_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void nv12_rgb24_precise_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void nv21_rgb24_precise_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_yuv420_precise_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv12_precise_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+void rgb24_nv21_precise_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+// conversion context, for the color spaces not in YCbCrType
+// ycbcr_context_create computes the conversion parameters from the luma factors of red and blue (Rf and Bf, 
+// the green factor being 1-Rf-Bf), the luma range [y_min:y_max] and the chroma range (224 for the usual limited 
+// range, 255 for full range, chroma being centered on 128). For example, BT.601 is (0.299, 0.114, 16, 235, 224).
+// It returns NULL if the parameters are invalid or do not fit the fixed point format, or on allocation failure.
+// A context is only read by the conversion functions, so that it can be shared by several threads.
+typedef struct YCbCrContext YCbCrContext;
+
+YCbCrContext *ycbcr_context_create(double r_factor, double b_factor, uint8_t y_min, uint8_t y_max, uint8_t cbcr_range);
+
+void ycbcr_context_destroy(YCbCrContext *context);
+
+// same as yuv420_rgb24 and rgb24_yuv420, with the color space of the context
+// The functions without suffix use sse when available, with the same alignment requirements as 
+// yuv420_rgb24_sse and rgb24_yuv420_sse to use aligned accesses.
+void yuv420_rgb24_ctx(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	const YCbCrContext *context);
+
+void yuv420_rgb24_ctx_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	const YCbCrContext *context);
+
+void rgb24_yuv420_ctx(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	const YCbCrContext *context);
+
+void rgb24_yuv420_ctx_std(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	const YCbCrContext *context);
+
+// Frame buffers
+// A frame pool hands out buffers of a given format and size, that are recycled when released instead of 
+// being freed, so that no memory is allocated (or mapped by the os) per frame once the pool has enough 
+// buffers. The planes and strides are aligned on 64 bytes, so that the aligned simd functions (and their 
+// fastest versions in the dispatching functions) can always be used. The pool is thread safe, and is 
+// implemented in yuv_rgb_frame_pool.c (which requires pthreads).
+
+typedef struct YUVRGBFramePool YUVRGBFramePool;
+
+typedef enum
+{
+	FRAME_YUV420P,    // y, u and v planes
+	FRAME_NV12,       // y and interleaved chroma planes, also used for nv21
+	FRAME_YUV420P16,  // y, u and v planes of 16 bits values (yuv420p10), use FRAME_NV12 with twice the width for p010
+	FRAME_RGB24,
+	FRAME_RGB32,
+	FRAME_RGB48
+} FrameFormat;
+
+// flags of yuv_rgb_frame_pool_create
+// back the buffers with (transparent) huge pages, where supported, to avoid tlb misses on large frames
+#define FRAME_POOL_HUGE_PAGES 1
+
+typedef struct
+{
+	uint8_t *data[3];      // planes in the order of FrameFormat, unused ones are NULL
+	uint32_t stride[3];    // in bytes
+	uint32_t width, height;
+} YUVRGBFrameBuffer;
+
+// create a pool of buffers of width x height pixels, with buffer_count buffers allocated immediately
+// return NULL on failure
+YUVRGBFramePool *yuv_rgb_frame_pool_create(FrameFormat format, uint32_t width, uint32_t height, 
+	uint32_t buffer_count, uint32_t flags);
+
+// free the pool and all its buffers (that must not be used anymore)
+void yuv_rgb_frame_pool_destroy(YUVRGBFramePool *pool);
+
+// get a buffer, a new one is allocated if they are all in use
+// return NULL on allocation failure
+YUVRGBFrameBuffer *yuv_rgb_frame_acquire(YUVRGBFramePool *pool);
+
+// give back a buffer to the pool, for the next yuv_rgb_frame_acquire
+void yuv_rgb_frame_release(YUVRGBFramePool *pool, YUVRGBFrameBuffer *buffer);
+
+// Multithreaded conversion
+// The image is split in horizontal bands of an even number of rows (so that each chroma row belongs to a 
+// single band), which are converted in parallel by the threads of a pool. A pool is created once and reused 
+// for every frame, so that threads are not created for each conversion.
+// Any of the conversion functions above (dispatching, std or simd ones) can be used, with the same 
+// alignment requirements as when calling it directly, since the bands start on a row boundary.
+// A pool must not be used by several threads at the same time.
+
+typedef struct YUVRGBThreadPool YUVRGBThreadPool;
+
+// signatures of the conversion functions
+typedef void (*YUV2RGBFunction)(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+typedef void (*YUVSP2RGBFunction)(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+typedef void (*YUV2RGB32Function)(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+typedef void (*YUVSP2RGB32Function)(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+typedef void (*RGB2YUVFunction)(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+typedef void (*RGB2YUVSPFunction)(
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+// create a pool of thread_count threads (including the calling thread, that also converts bands)
+// if thread_count is 0, one thread per online cpu is used
+// return NULL on failure
+YUVRGBThreadPool *yuv_rgb_pool_create(uint32_t thread_count);
+
+// stop the threads and free the pool
+void yuv_rgb_pool_destroy(YUVRGBThreadPool *pool);
+
+// number of threads of the pool, including the calling thread
+uint32_t yuv_rgb_pool_thread_count(const YUVRGBThreadPool *pool);
+
+// convert with yuv420p input (yuv420_rgb24 and variants), return once the whole image is converted
+void yuv2rgb_mt(YUVRGBThreadPool *pool, YUV2RGBFunction fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// convert with semi planar input (nv12_rgb24, nv21_rgb24 and variants)
+void yuvsp2rgb_mt(YUVRGBThreadPool *pool, YUVSP2RGBFunction fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
+
+// convert with yuv420p input to 32 bits rgb (yuv420_rgba32 and variants)
+void yuv2rgb32_mt(YUVRGBThreadPool *pool, YUV2RGB32Function fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+// convert with semi planar input to 32 bits rgb (nv12_rgba32, nv21_rgba32 and variants)
+void yuvsp2rgb32_mt(YUVRGBThreadPool *pool, YUVSP2RGB32Function fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha);
+
+// convert with rgb input (rgb24_yuv420, rgb32_yuv420 and variants)
+void rgb2yuv_mt(YUVRGBThreadPool *pool, RGB2YUVFunction fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+// convert with rgb input to semi planar output (rgb24_nv12, rgb32_nv21 and variants)
+void rgb2yuvsp_mt(YUVRGBThreadPool *pool, RGB2YUVSPFunction fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type);
+
+// Batch conversion
+// The frames of a batch (with the same size and color space) are converted in parallel by the threads of 
+// the pool. When there are enough frames, each thread converts whole frames, otherwise the frames are also 
+// split in bands, and idle threads take the next frame or band as soon as they are done, so that the 
+// throughput is the one of all cores whatever the batch length.
+
+// a yuv420p frame and its rgb output
+typedef struct
+{
+	const uint8_t *y, *u, *v;
+	uint32_t y_stride, uv_stride;
+	uint8_t *rgb;
+	uint32_t rgb_stride;
+} YUV2RGBFrame;
+
+// a nv12 or nv21 frame and its rgb output
+typedef struct
+{
+	const uint8_t *y, *uv;
+	uint32_t y_stride, uv_stride;
+	uint8_t *rgb;
+	uint32_t rgb_stride;
+} YUVSP2RGBFrame;
+
+// return once all frames are converted
+void yuv2rgb_batch(YUVRGBThreadPool *pool, YUV2RGBFunction fun, 
+	uint32_t width, uint32_t height, 
+	const YUV2RGBFrame *frames, uint32_t frame_count, 
+	YCbCrType yuv_type);
+
+void yuvsp2rgb_batch(YUVRGBThreadPool *pool, YUVSP2RGBFunction fun, 
+	uint32_t width, uint32_t height, 
+	const YUVSP2RGBFrame *frames, uint32_t frame_count, 
+	YCbCrType yuv_type);
+
+// Strip conversion
+// The image is converted by strips of strip_rows rows (rounded down to an even number), one after the other 
+// in the calling thread, and callback is called after each strip, with its first row and row count, so that 
+// the next processing step (overlay, encoding...) can use the strip while it is still in cache.
+// If strip_rows is 0, the strips are about 256KB (all planes included), half of a typical L2 cache.
+// The conversion function should use regular stores, which is the case of all functions with the default 
+// store policy (see yuv_rgb_set_store_policy), the strips being smaller than the cache.
+// callback may be NULL.
+typedef void (*YUVRGBStripCallback)(uint32_t first_row, uint32_t row_count, void *user_data);
+
+void yuv2rgb_strips(YUV2RGBFunction fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type, 
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data);
+
+void yuvsp2rgb_strips(YUVSP2RGBFunction fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type, 
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data);
+
+void yuv2rgb32_strips(YUV2RGB32Function fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha, 
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data);
+
+void yuvsp2rgb32_strips(YUVSP2RGB32Function fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgba, uint32_t rgba_stride, 
+	YCbCrType yuv_type, uint8_t alpha, 
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data);
+
+void rgb2yuv_strips(RGB2YUVFunction fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *u, uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type, 
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data);
+
+void rgb2yuvsp_strips(RGB2YUVSPFunction fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *rgb, uint32_t rgb_stride, 
+	uint8_t *y, uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	YCbCrType yuv_type, 
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data);
+
+// Region of interest conversion
+// Only the given rectangles of the source image are converted, each one to its own rgb output, directly from 
+// the source planes (y, u and v or uv being the planes of the whole image), without copy. The rectangles can 
+// start at any column and row: those starting on an odd column or row are split so that each pixel uses the 
+// same chroma sample as with a full image conversion, and the output is the same as the corresponding part 
+// of the full image output. The pointers given to the conversion function are usually not aligned, it should 
+// be a dispatching function (as yuv420_rgb24) or an unaligned implementation.
+typedef struct
+{
+	uint32_t x, y, width, height;
+	uint8_t *rgb;
+	uint32_t rgb_stride;
+} YUVRGBRegion;
+
+// convert region_count regions, in the calling thread, with a 24 bits rgb conversion function
+void yuv2rgb_roi(YUV2RGBFunction fun, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	const YUVRGBRegion *regions, uint32_t region_count, 
+	YCbCrType yuv_type);
+
+void yuvsp2rgb_roi(YUVSP2RGBFunction fun, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	const YUVRGBRegion *regions, uint32_t region_count, 
+	YCbCrType yuv_type);
+
+// Rotated conversion
+// The image is rotated or flipped during the conversion: the y and chroma values are rotated by small tiles, 
+// in the yuv domain (1 byte per value, and a quarter of the chroma values), and each tile of the output is 
+// converted with the conversion function, so that the rgb values are written once, in their final orientation.
+// With ORIENTATION_ROTATE_90 and ORIENTATION_ROTATE_270, the output is height pixels wide and width pixels 
+// high. The output is the same as a conversion followed by a rotation of the rgb image, also for odd sizes.
+// As for the region of interest conversion, fun should be a dispatching function or an unaligned implementation.
+typedef enum
+{
+	ORIENTATION_NONE,
+	ORIENTATION_ROTATE_90,  // clockwise
+	ORIENTATION_ROTATE_180,
+	ORIENTATION_ROTATE_270, // clockwise, that is 90 degrees counterclockwise
+	ORIENTATION_MIRROR,     // horizontal flip, the first column of the input is the last one of the output
+	ORIENTATION_FLIP        // vertical flip
+} Orientation;
+
+void yuv2rgb_rotate(YUV2RGBFunction fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type, Orientation orientation);
+
+void yuvsp2rgb_rotate(YUVSP2RGBFunction fun, 
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *uv, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type, Orientation orientation);
+
+// Asynchronous conversion
+// A job queue converts jobs in the background, with its own thread pool, so that an event loop can submit 
+// a conversion and be notified of its completion without blocking on it. The jobs are converted one after 
+// the other, in submission order, each one split in bands on all the threads of the queue (as with the _mt 
+// functions). The queue is bounded: a job takes a slot of the queue from its submission until its 
+// completion is reported, yuv_rgb_queue_submit waits for a free slot and yuv_rgb_queue_try_submit fails 
+// instead, so that a slow consumer throttles the producer.
+// The completion is reported either by calling the callback of the job, in a thread of the queue, or, if 
+// the callback is NULL, by adding the user_data of the job to the completed list of the queue, that is 
+// read with yuv_rgb_queue_completed. The file descriptor returned by yuv_rgb_queue_fd (an eventfd on linux, 
+// a pipe elsewhere) is readable while this list is not empty, it can be given to poll, select or epoll.
+// The slot of a job is freed before its callback is called, so a callback can submit the next job (even to 
+// a full queue), but it must not call yuv_rgb_queue_wait or yuv_rgb_queue_destroy, that would wait for it.
+// The queue is thread safe, and is implemented in yuv_rgb_queue.c (which requires pthreads).
+
+typedef struct YUVRGBJobQueue YUVRGBJobQueue;
+
+typedef enum
+{
+	JOB_YUV2RGB,      // yuv420p input, fun.yuv2rgb
+	JOB_YUVSP2RGB,    // semi planar input, fun.yuvsp2rgb
+	JOB_YUV2RGB32,    // yuv420p input and 32 bits rgb output, fun.yuv2rgb32
+	JOB_YUVSP2RGB32,  // semi planar input and 32 bits rgb output, fun.yuvsp2rgb32
+	JOB_RGB2YUV,      // yuv420p output, fun.rgb2yuv
+	JOB_RGB2YUVSP     // semi planar output, fun.rgb2yuvsp
+} JobType;
+
+typedef void (*YUVRGBJobCallback)(void *user_data);
+
+// description of a job, copied by the submission, the planes must stay valid until the job is completed
+typedef struct
+{
+	JobType type;
+	union
+	{
+		YUV2RGBFunction yuv2rgb;
+		YUVSP2RGBFunction yuvsp2rgb;
+		YUV2RGB32Function yuv2rgb32;
+		YUVSP2RGB32Function yuvsp2rgb32;
+		RGB2YUVFunction rgb2yuv;
+		RGB2YUVSPFunction rgb2yuvsp;
+	} fun;
+	uint32_t width, height;
+	// input planes and strides: y, u and v (or uv, and no third plane for semi planar input) with 
+	// y and uv strides, or rgb with its stride
+	const uint8_t *src[3];
+	uint32_t src_stride[2];
+	// output planes and strides, in the same order
+	uint8_t *dst[3];
+	uint32_t dst_stride[2];
+	YCbCrType yuv_type;
+	uint8_t alpha;    // of the 32 bits rgb output
+	YUVRGBJobCallback callback;
+	void *user_data;
+} YUVRGBJob;
+
+// create a queue of at most capacity jobs (submitted and not completed yet), converted by thread_count 
+// threads (one per online cpu if 0)
+// return NULL on failure
+YUVRGBJobQueue *yuv_rgb_queue_create(uint32_t thread_count, uint32_t capacity);
+
+// wait for the completion of all jobs, and free the queue (completed jobs not read are discarded)
+void yuv_rgb_queue_destroy(YUVRGBJobQueue *queue);
+
+// add a job to the queue, waiting for a free slot if it is full
+void yuv_rgb_queue_submit(YUVRGBJobQueue *queue, const YUVRGBJob *job);
+
+// add a job to the queue if it is not full
+// return 0 on success, -1 if the queue is full
+int yuv_rgb_queue_try_submit(YUVRGBJobQueue *queue, const YUVRGBJob *job);
+
+// file descriptor that is readable while there are completed jobs to read with yuv_rgb_queue_completed, 
+// it must not be read or closed by the caller
+// return -1 if it could not be created
+int yuv_rgb_queue_fd(const YUVRGBJobQueue *queue);
+
+// get the user_data of at most max_count completed jobs (without callback), in completion order, and free 
+// their slots
+// return the number of jobs
+uint32_t yuv_rgb_queue_completed(YUVRGBJobQueue *queue, void **user_data, uint32_t max_count);
+
+// wait until all submitted jobs are converted, and their callbacks returned
+void yuv_rgb_queue_wait(YUVRGBJobQueue *queue);
+
+#if defined(__GNUC__) && !defined(_WIN32)
+#pragma GCC visibility pop
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,9 @@
+# Package configuration of the installed library, provides the yuv_rgb::yuv_rgb (shared) and
+# yuv_rgb::yuv_rgb_static targets, for example:
+#   find_package(yuv_rgb REQUIRED)
+#   target_link_libraries(program yuv_rgb::yuv_rgb_static)
+
+include(CMakeFindDependencyMacro)
+find_dependency(Threads)
+
+include("${CMAKE_CURRENT_LIST_DIR}/yuv_rgbTargets.cmake")
@@ -0,0 +1,203 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+// posix_memalign, and madvise on linux
+#define _DEFAULT_SOURCE
+#define _POSIX_C_SOURCE 200112L
+
+#include "yuv_rgb.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+// alignment of the planes and strides, as required by the avx512 aligned functions
+#define FRAME_ALIGNMENT 64
+// alignment of the buffers backed by huge pages
+#define HUGE_PAGE_SIZE (2*1024*1024)
+
+// the public buffer is the first member, so that released buffers can be converted back
+typedef struct FrameEntry
+{
+	YUVRGBFrameBuffer buffer;
+	void *memory;
+	struct FrameEntry *next_free;   // next released buffer
+	struct FrameEntry *next;        // next allocated buffer
+} FrameEntry;
+
+struct YUVRGBFramePool
+{
+	pthread_mutex_t mutex;
+	uint32_t width, height, flags;
+	uint32_t plane_count;
+	uint32_t stride[3];
+	size_t offset[3];
+	size_t size;
+
+	// protected by mutex
+	FrameEntry *free_list;
+	FrameEntry *buffers;
+};
+
+static uint32_t align_stride(uint32_t size)
+{
+	return (size+FRAME_ALIGNMENT-1)/FRAME_ALIGNMENT*FRAME_ALIGNMENT;
+}
+
+// allocate a buffer, the memory is written once so that it is mapped before the first conversion
+static FrameEntry *frame_entry_create(const YUVRGBFramePool *pool)
+{
+	FrameEntry *entry = calloc(1, sizeof(FrameEntry));
+	if(!entry)
+		return NULL;
+
+	const size_t alignment = (pool->flags & FRAME_POOL_HUGE_PAGES) ? HUGE_PAGE_SIZE : FRAME_ALIGNMENT;
+	if(posix_memalign(&entry->memory, alignment, (pool->size+alignment-1)/alignment*alignment)!=0)
+	{
+		free(entry);
+		return NULL;
+	}
+#ifdef MADV_HUGEPAGE
+	if(pool->flags & FRAME_POOL_HUGE_PAGES)
+		madvise(entry->memory, (pool->size+alignment-1)/alignment*alignment, MADV_HUGEPAGE);
+#endif
+	memset(entry->memory, 0, pool->size);
+
+	uint32_t i;
+	for(i=0; i<pool->plane_count; ++i)
+	{
+		entry->buffer.data[i] = (uint8_t*)entry->memory + pool->offset[i];
+		entry->buffer.stride[i] = pool->stride[i];
+	}
+	entry->buffer.width = pool->width;
+	entry->buffer.height = pool->height;
+	return entry;
+}
+
+YUVRGBFramePool *yuv_rgb_frame_pool_create(FrameFormat format, uint32_t width, uint32_t height,
+	uint32_t buffer_count, uint32_t flags)
+{
+	YUVRGBFramePool *pool = calloc(1, sizeof(YUVRGBFramePool));
+	if(!pool)
+		return NULL;
+
+	pool->width = width;
+	pool->height = height;
+	pool->flags = flags;
+
+	const uint32_t uv_width = (width+1)/2, uv_height = (height+1)/2;
+	const uint32_t plane_height[3] = {height, uv_height, uv_height};
+	switch(format)
+	{
+		case FRAME_YUV420P:
+			pool->plane_count = 3;
+			pool->stride[0] = align_stride(width);
+			pool->stride[1] = pool->stride[2] = align_stride(uv_width);
+			break;
+		case FRAME_NV12:
+			pool->plane_count = 2;
+			pool->stride[0] = align_stride(width);
+			pool->stride[1] = align_stride(2*uv_width);
+			break;
+		case FRAME_YUV420P16:
+			pool->plane_count = 3;
+			pool->stride[0] = align_stride(2*width);
+			pool->stride[1] = pool->stride[2] = align_stride(2*uv_width);
+			break;
+		case FRAME_RGB24:
+			pool->plane_count = 1;
+			pool->stride[0] = align_stride(3*width);
+			break;
+		case FRAME_RGB32:
+			pool->plane_count = 1;
+			pool->stride[0] = align_stride(4*width);
+			break;
+		case FRAME_RGB48:
+			pool->plane_count = 1;
+			pool->stride[0] = align_stride(6*width);
+			break;
+		default:
+			free(pool);
+			return NULL;
+	}
+
+	uint32_t i;
+	for(i=0; i<pool->plane_count; ++i)
+	{
+		pool->offset[i] = pool->size;
+		pool->size += (size_t)pool->stride[i]*plane_height[i];
+	}
+
+	pthread_mutex_init(&pool->mutex, NULL);
+
+	for(i=0; i<buffer_count; ++i)
+	{
+		FrameEntry *entry = frame_entry_create(pool);
+		if(!entry)
+		{
+			yuv_rgb_frame_pool_destroy(pool);
+			return NULL;
+		}
+		entry->next = pool->buffers;
+		pool->buffers = entry;
+		entry->next_free = pool->free_list;
+		pool->free_list = entry;
+	}
+
+	return pool;
+}
+
+void yuv_rgb_frame_pool_destroy(YUVRGBFramePool *pool)
+{
+	if(!pool)
+		return;
+
+	FrameEntry *entry = pool->buffers;
+	while(entry)
+	{
+		FrameEntry *next = entry->next;
+		free(entry->memory);
+		free(entry);
+		entry = next;
+	}
+
+	pthread_mutex_destroy(&pool->mutex);
+	free(pool);
+}
+
+YUVRGBFrameBuffer *yuv_rgb_frame_acquire(YUVRGBFramePool *pool)
+{
+	pthread_mutex_lock(&pool->mutex);
+	FrameEntry *entry = pool->free_list;
+	if(entry)
+		pool->free_list = entry->next_free;
+	pthread_mutex_unlock(&pool->mutex);
+
+	if(!entry)
+	{
+		// the pool grows when all buffers are in use, the allocation is done without the lock
+		entry = frame_entry_create(pool);
+		if(!entry)
+			return NULL;
+
+		pthread_mutex_lock(&pool->mutex);
+		entry->next = pool->buffers;
+		pool->buffers = entry;
+		pthread_mutex_unlock(&pool->mutex);
+	}
+
+	return &entry->buffer;
+}
+
+void yuv_rgb_frame_release(YUVRGBFramePool *pool, YUVRGBFrameBuffer *buffer)
+{
+	if(!buffer)
+		return;
+
+	FrameEntry *entry = (FrameEntry*)buffer;
+	pthread_mutex_lock(&pool->mutex);
+	entry->next_free = pool->free_list;
+	pool->free_list = entry;
+	pthread_mutex_unlock(&pool->mutex);
+}
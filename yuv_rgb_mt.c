@@ -0,0 +1,795 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+// sysconf
+#define _POSIX_C_SOURCE 200112L
+
+#include "yuv_rgb.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// Each thread gets several bands, so that a thread delayed by the os does not delay the whole conversion
+#define BANDS_PER_THREAD 4
+// minimum number of rows of a band, smaller images are converted by less threads
+#define MIN_BAND_ROWS 16
+// default size of the strips of the strip conversion (input and output), half of a typical L2 cache
+#define STRIP_SIZE (256*1024)
+
+// convert rows [first_row, first_row+row_count) of the current job
+typedef void (*BandFunction)(const void *job, uint32_t first_row, uint32_t row_count);
+
+// convert rows [first_row, first_row+row_count) of frame frame of the current batch
+typedef void (*FrameBandFunction)(const void *batch, uint32_t frame, uint32_t first_row, uint32_t row_count);
+
+// convert unit unit of the current job (a band of an image, or of a frame of a batch)
+typedef void (*UnitFunction)(const void *job, uint32_t unit);
+
+struct YUVRGBThreadPool
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t start_cond;   // signaled when a new job is available, or when the pool is stopped
+	pthread_cond_t done_cond;    // signaled when the last band of the job is converted
+	pthread_t *threads;
+	uint32_t worker_count;       // the calling thread is not included
+
+	// current job, protected by mutex
+	UnitFunction unit_fun;
+	const void *job;
+	uint32_t unit_count;
+	uint32_t next_unit;          // next unit to be converted
+	uint32_t remaining_units;    // units not converted yet, including the ones in progress
+	uint32_t generation;         // incremented for each job
+	int stop;
+};
+
+// rows of a band, bands always start on an even row, and the last one also gets the last row if height is odd
+static void band_rows(uint32_t height, uint32_t band_count, uint32_t band, uint32_t *first_row, uint32_t *row_count)
+{
+	const uint32_t pairs = height/2;
+	const uint32_t first = (uint32_t)(((uint64_t)pairs*band)/band_count),
+		last = (uint32_t)(((uint64_t)pairs*(band+1))/band_count);
+
+	*first_row = 2*first;
+	*row_count = 2*(last-first);
+	if(band==(band_count-1))
+		*row_count += height%2;
+}
+
+// convert units of the current job until there is none left, mutex must be locked
+// Each thread takes the next unit when it is done with the previous one, so that the load is balanced 
+// whatever the speed of each thread.
+static void process_units(YUVRGBThreadPool *pool)
+{
+	while(pool->next_unit < pool->unit_count)
+	{
+		const uint32_t unit = pool->next_unit++;
+
+		pthread_mutex_unlock(&pool->mutex);
+		pool->unit_fun(pool->job, unit);
+		pthread_mutex_lock(&pool->mutex);
+
+		if(--pool->remaining_units == 0)
+			pthread_cond_signal(&pool->done_cond);
+	}
+}
+
+static void *worker(void *arg)
+{
+	YUVRGBThreadPool *pool = arg;
+	uint32_t generation = 0;
+
+	pthread_mutex_lock(&pool->mutex);
+	for(;;)
+	{
+		while(!pool->stop && pool->generation==generation)
+			pthread_cond_wait(&pool->start_cond, &pool->mutex);
+		if(pool->stop)
+			break;
+		generation = pool->generation;
+		process_units(pool);
+	}
+	pthread_mutex_unlock(&pool->mutex);
+	return NULL;
+}
+
+YUVRGBThreadPool *yuv_rgb_pool_create(uint32_t thread_count)
+{
+	if(thread_count==0)
+	{
+		const long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+		thread_count = cpu_count>0 ? (uint32_t)cpu_count : 1;
+	}
+
+	YUVRGBThreadPool *pool = calloc(1, sizeof(YUVRGBThreadPool));
+	if(!pool)
+		return NULL;
+
+	pool->threads = calloc(thread_count, sizeof(pthread_t));
+	if(!pool->threads)
+	{
+		free(pool);
+		return NULL;
+	}
+
+	pthread_mutex_init(&pool->mutex, NULL);
+	pthread_cond_init(&pool->start_cond, NULL);
+	pthread_cond_init(&pool->done_cond, NULL);
+
+	for(uint32_t i=0; i<(thread_count-1); ++i)
+	{
+		if(pthread_create(&pool->threads[i], NULL, worker, pool)!=0)
+		{
+			yuv_rgb_pool_destroy(pool);
+			return NULL;
+		}
+		pool->worker_count++;
+	}
+
+	return pool;
+}
+
+void yuv_rgb_pool_destroy(YUVRGBThreadPool *pool)
+{
+	if(!pool)
+		return;
+
+	pthread_mutex_lock(&pool->mutex);
+	pool->stop = 1;
+	pthread_cond_broadcast(&pool->start_cond);
+	pthread_mutex_unlock(&pool->mutex);
+
+	for(uint32_t i=0; i<pool->worker_count; ++i)
+		pthread_join(pool->threads[i], NULL);
+
+	pthread_cond_destroy(&pool->done_cond);
+	pthread_cond_destroy(&pool->start_cond);
+	pthread_mutex_destroy(&pool->mutex);
+	free(pool->threads);
+	free(pool);
+}
+
+uint32_t yuv_rgb_pool_thread_count(const YUVRGBThreadPool *pool)
+{
+	return pool->worker_count+1;
+}
+
+// run the unit_count units of a job on all threads of the pool, and wait for their completion
+static void pool_run_units(YUVRGBThreadPool *pool, UnitFunction unit_fun, const void *job, uint32_t unit_count)
+{
+	pthread_mutex_lock(&pool->mutex);
+	pool->unit_fun = unit_fun;
+	pool->job = job;
+	pool->unit_count = unit_count;
+	pool->next_unit = 0;
+	pool->remaining_units = unit_count;
+	pool->generation++;
+	pthread_cond_broadcast(&pool->start_cond);
+
+	process_units(pool);
+	while(pool->remaining_units>0)
+		pthread_cond_wait(&pool->done_cond, &pool->mutex);
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+// number of bands of an image, at most limit, and with at least MIN_BAND_ROWS rows
+static uint32_t band_count(uint32_t height, uint32_t limit)
+{
+	const uint32_t max_band_count = height/MIN_BAND_ROWS;
+	return limit<max_band_count ? limit : (max_band_count>0 ? max_band_count : 1);
+}
+
+typedef struct
+{
+	BandFunction band_fun;
+	const void *job;
+	uint32_t height;
+	uint32_t band_count;
+} BandJob;
+
+static void band_unit(const void *data, uint32_t unit)
+{
+	const BandJob *job = data;
+	uint32_t first_row, row_count;
+	band_rows(job->height, job->band_count, unit, &first_row, &row_count);
+	job->band_fun(job->job, first_row, row_count);
+}
+
+// run a job on all threads of the pool, and wait for its completion
+static void pool_run(YUVRGBThreadPool *pool, BandFunction band_fun, const void *job, uint32_t height)
+{
+	const BandJob band_job = {band_fun, job, height, band_count(height, (pool->worker_count+1)*BANDS_PER_THREAD)};
+
+	// not worth waking up the workers
+	if(pool->worker_count==0 || band_job.band_count<=1)
+	{
+		band_fun(job, 0, height);
+		return;
+	}
+
+	pool_run_units(pool, band_unit, &band_job, band_job.band_count);
+}
+
+typedef struct
+{
+	FrameBandFunction band_fun;
+	const void *batch;
+	uint32_t height;
+	uint32_t band_count;         // bands of each frame
+} BatchJob;
+
+// units are numbered frame by frame, so that the threads work on the same frames at the same time
+static void batch_unit(const void *data, uint32_t unit)
+{
+	const BatchJob *job = data;
+	uint32_t first_row, row_count;
+	band_rows(job->height, job->band_count, unit%job->band_count, &first_row, &row_count);
+	job->band_fun(job->batch, unit/job->band_count, first_row, row_count);
+}
+
+// run a batch of frame_count frames on all threads of the pool, and wait for its completion
+// Long batches are converted frame by frame by each thread, shorter ones are split in bands so that each 
+// thread still gets BANDS_PER_THREAD units.
+static void pool_run_batch(YUVRGBThreadPool *pool, FrameBandFunction band_fun, const void *batch, 
+	uint32_t height, uint32_t frame_count)
+{
+	if(frame_count==0)
+		return;
+	
+	const uint32_t unit_target = (pool->worker_count+1)*BANDS_PER_THREAD;
+	const BatchJob batch_job = {band_fun, batch, height, 
+		band_count(height, frame_count>=unit_target ? 1 : (unit_target+frame_count-1)/frame_count)};
+	const uint32_t unit_count = frame_count*batch_job.band_count;
+
+	if(pool->worker_count==0 || unit_count<=1)
+	{
+		uint32_t frame;
+		for(frame=0; frame<frame_count; ++frame)
+			band_fun(batch, frame, 0, height);
+		return;
+	}
+
+	pool_run_units(pool, batch_unit, &batch_job, unit_count);
+}
+
+// convert the bands of strip_rows rows (an even number) one after the other in the calling thread, and call 
+// callback after each of them, row_size being the number of bytes of all planes used by a row
+static void strip_run(BandFunction band_fun, const void *job, uint32_t height, uint32_t row_size, 
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data)
+{
+	if(strip_rows==0)
+		strip_rows = row_size>0 ? STRIP_SIZE/row_size : height;
+	strip_rows -= strip_rows%2;
+	if(strip_rows<2)
+		strip_rows = 2;
+	
+	uint32_t first_row;
+	for(first_row=0; first_row<height; first_row+=strip_rows)
+	{
+		const uint32_t row_count = (height-first_row)<strip_rows ? (height-first_row) : strip_rows;
+		band_fun(job, first_row, row_count);
+		if(callback)
+			callback(first_row, row_count, user_data);
+	}
+}
+
+typedef struct
+{
+	YUV2RGBFunction fun;
+	uint32_t width;
+	const uint8_t *y, *u, *v;
+	uint32_t y_stride, uv_stride;
+	uint8_t *rgb;
+	uint32_t rgb_stride;
+	YCbCrType yuv_type;
+} YUV2RGBJob;
+
+static void yuv2rgb_band(const void *data, uint32_t first_row, uint32_t row_count)
+{
+	const YUV2RGBJob *job = data;
+	job->fun(job->width, row_count,
+		job->y+first_row*job->y_stride, job->u+(first_row/2)*job->uv_stride, job->v+(first_row/2)*job->uv_stride,
+		job->y_stride, job->uv_stride,
+		job->rgb+first_row*job->rgb_stride, job->rgb_stride,
+		job->yuv_type);
+}
+
+void yuv2rgb_mt(YUVRGBThreadPool *pool, YUV2RGBFunction fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	const YUV2RGBJob job = {fun, width, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type};
+	pool_run(pool, yuv2rgb_band, &job, height);
+}
+
+typedef struct
+{
+	YUV2RGBFunction fun;
+	uint32_t width;
+	const YUV2RGBFrame *frames;
+	YCbCrType yuv_type;
+} YUV2RGBBatch;
+
+static void yuv2rgb_frame_band(const void *data, uint32_t frame, uint32_t first_row, uint32_t row_count)
+{
+	const YUV2RGBBatch *batch = data;
+	const YUV2RGBFrame *f = batch->frames+frame;
+	const YUV2RGBJob job = {batch->fun, batch->width, f->y, f->u, f->v, f->y_stride, f->uv_stride, 
+		f->rgb, f->rgb_stride, batch->yuv_type};
+	yuv2rgb_band(&job, first_row, row_count);
+}
+
+void yuv2rgb_batch(YUVRGBThreadPool *pool, YUV2RGBFunction fun,
+	uint32_t width, uint32_t height,
+	const YUV2RGBFrame *frames, uint32_t frame_count,
+	YCbCrType yuv_type)
+{
+	const YUV2RGBBatch batch = {fun, width, frames, yuv_type};
+	pool_run_batch(pool, yuv2rgb_frame_band, &batch, height, frame_count);
+}
+
+void yuv2rgb_strips(YUV2RGBFunction fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type,
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data)
+{
+	const YUV2RGBJob job = {fun, width, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type};
+	strip_run(yuv2rgb_band, &job, height, Y_stride+UV_stride+RGB_stride, strip_rows, callback, user_data);
+}
+
+typedef struct
+{
+	YUVSP2RGBFunction fun;
+	uint32_t width;
+	const uint8_t *y, *uv;
+	uint32_t y_stride, uv_stride;
+	uint8_t *rgb;
+	uint32_t rgb_stride;
+	YCbCrType yuv_type;
+} YUVSP2RGBJob;
+
+static void yuvsp2rgb_band(const void *data, uint32_t first_row, uint32_t row_count)
+{
+	const YUVSP2RGBJob *job = data;
+	job->fun(job->width, row_count,
+		job->y+first_row*job->y_stride, job->uv+(first_row/2)*job->uv_stride,
+		job->y_stride, job->uv_stride,
+		job->rgb+first_row*job->rgb_stride, job->rgb_stride,
+		job->yuv_type);
+}
+
+void yuvsp2rgb_mt(YUVRGBThreadPool *pool, YUVSP2RGBFunction fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	const YUVSP2RGBJob job = {fun, width, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type};
+	pool_run(pool, yuvsp2rgb_band, &job, height);
+}
+
+typedef struct
+{
+	YUVSP2RGBFunction fun;
+	uint32_t width;
+	const YUVSP2RGBFrame *frames;
+	YCbCrType yuv_type;
+} YUVSP2RGBBatch;
+
+static void yuvsp2rgb_frame_band(const void *data, uint32_t frame, uint32_t first_row, uint32_t row_count)
+{
+	const YUVSP2RGBBatch *batch = data;
+	const YUVSP2RGBFrame *f = batch->frames+frame;
+	const YUVSP2RGBJob job = {batch->fun, batch->width, f->y, f->uv, f->y_stride, f->uv_stride, 
+		f->rgb, f->rgb_stride, batch->yuv_type};
+	yuvsp2rgb_band(&job, first_row, row_count);
+}
+
+void yuvsp2rgb_batch(YUVRGBThreadPool *pool, YUVSP2RGBFunction fun,
+	uint32_t width, uint32_t height,
+	const YUVSP2RGBFrame *frames, uint32_t frame_count,
+	YCbCrType yuv_type)
+{
+	const YUVSP2RGBBatch batch = {fun, width, frames, yuv_type};
+	pool_run_batch(pool, yuvsp2rgb_frame_band, &batch, height, frame_count);
+}
+
+void yuvsp2rgb_strips(YUVSP2RGBFunction fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type,
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data)
+{
+	const YUVSP2RGBJob job = {fun, width, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type};
+	strip_run(yuvsp2rgb_band, &job, height, Y_stride+UV_stride/2+RGB_stride, strip_rows, callback, user_data);
+}
+
+typedef struct
+{
+	YUV2RGB32Function fun;
+	uint32_t width;
+	const uint8_t *y, *u, *v;
+	uint32_t y_stride, uv_stride;
+	uint8_t *rgba;
+	uint32_t rgba_stride;
+	YCbCrType yuv_type;
+	uint8_t alpha;
+} YUV2RGB32Job;
+
+static void yuv2rgb32_band(const void *data, uint32_t first_row, uint32_t row_count)
+{
+	const YUV2RGB32Job *job = data;
+	job->fun(job->width, row_count,
+		job->y+first_row*job->y_stride, job->u+(first_row/2)*job->uv_stride, job->v+(first_row/2)*job->uv_stride,
+		job->y_stride, job->uv_stride,
+		job->rgba+first_row*job->rgba_stride, job->rgba_stride,
+		job->yuv_type, job->alpha);
+}
+
+void yuv2rgb32_mt(YUVRGBThreadPool *pool, YUV2RGB32Function fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGBA, uint32_t RGBA_stride,
+	YCbCrType yuv_type, uint8_t alpha)
+{
+	const YUV2RGB32Job job = {fun, width, Y, U, V, Y_stride, UV_stride, RGBA, RGBA_stride, yuv_type, alpha};
+	pool_run(pool, yuv2rgb32_band, &job, height);
+}
+
+void yuv2rgb32_strips(YUV2RGB32Function fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGBA, uint32_t RGBA_stride,
+	YCbCrType yuv_type, uint8_t alpha,
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data)
+{
+	const YUV2RGB32Job job = {fun, width, Y, U, V, Y_stride, UV_stride, RGBA, RGBA_stride, yuv_type, alpha};
+	strip_run(yuv2rgb32_band, &job, height, Y_stride+UV_stride+RGBA_stride, strip_rows, callback, user_data);
+}
+
+typedef struct
+{
+	YUVSP2RGB32Function fun;
+	uint32_t width;
+	const uint8_t *y, *uv;
+	uint32_t y_stride, uv_stride;
+	uint8_t *rgba;
+	uint32_t rgba_stride;
+	YCbCrType yuv_type;
+	uint8_t alpha;
+} YUVSP2RGB32Job;
+
+static void yuvsp2rgb32_band(const void *data, uint32_t first_row, uint32_t row_count)
+{
+	const YUVSP2RGB32Job *job = data;
+	job->fun(job->width, row_count,
+		job->y+first_row*job->y_stride, job->uv+(first_row/2)*job->uv_stride,
+		job->y_stride, job->uv_stride,
+		job->rgba+first_row*job->rgba_stride, job->rgba_stride,
+		job->yuv_type, job->alpha);
+}
+
+void yuvsp2rgb32_mt(YUVRGBThreadPool *pool, YUVSP2RGB32Function fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGBA, uint32_t RGBA_stride,
+	YCbCrType yuv_type, uint8_t alpha)
+{
+	const YUVSP2RGB32Job job = {fun, width, Y, UV, Y_stride, UV_stride, RGBA, RGBA_stride, yuv_type, alpha};
+	pool_run(pool, yuvsp2rgb32_band, &job, height);
+}
+
+void yuvsp2rgb32_strips(YUVSP2RGB32Function fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGBA, uint32_t RGBA_stride,
+	YCbCrType yuv_type, uint8_t alpha,
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data)
+{
+	const YUVSP2RGB32Job job = {fun, width, Y, UV, Y_stride, UV_stride, RGBA, RGBA_stride, yuv_type, alpha};
+	strip_run(yuvsp2rgb32_band, &job, height, Y_stride+UV_stride/2+RGBA_stride, strip_rows, callback, user_data);
+}
+
+typedef struct
+{
+	RGB2YUVFunction fun;
+	uint32_t width;
+	const uint8_t *rgb;
+	uint32_t rgb_stride;
+	uint8_t *y, *u, *v;
+	uint32_t y_stride, uv_stride;
+	YCbCrType yuv_type;
+} RGB2YUVJob;
+
+static void rgb2yuv_band(const void *data, uint32_t first_row, uint32_t row_count)
+{
+	const RGB2YUVJob *job = data;
+	job->fun(job->width, row_count,
+		job->rgb+first_row*job->rgb_stride, job->rgb_stride,
+		job->y+first_row*job->y_stride, job->u+(first_row/2)*job->uv_stride, job->v+(first_row/2)*job->uv_stride,
+		job->y_stride, job->uv_stride,
+		job->yuv_type);
+}
+
+void rgb2yuv_mt(YUVRGBThreadPool *pool, RGB2YUVFunction fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *RGB, uint32_t RGB_stride,
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	YCbCrType yuv_type)
+{
+	const RGB2YUVJob job = {fun, width, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type};
+	pool_run(pool, rgb2yuv_band, &job, height);
+}
+
+void rgb2yuv_strips(RGB2YUVFunction fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *RGB, uint32_t RGB_stride,
+	uint8_t *Y, uint8_t *U, uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	YCbCrType yuv_type,
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data)
+{
+	const RGB2YUVJob job = {fun, width, RGB, RGB_stride, Y, U, V, Y_stride, UV_stride, yuv_type};
+	strip_run(rgb2yuv_band, &job, height, RGB_stride+Y_stride+UV_stride, strip_rows, callback, user_data);
+}
+
+typedef struct
+{
+	RGB2YUVSPFunction fun;
+	uint32_t width;
+	const uint8_t *rgb;
+	uint32_t rgb_stride;
+	uint8_t *y, *uv;
+	uint32_t y_stride, uv_stride;
+	YCbCrType yuv_type;
+} RGB2YUVSPJob;
+
+static void rgb2yuvsp_band(const void *data, uint32_t first_row, uint32_t row_count)
+{
+	const RGB2YUVSPJob *job = data;
+	job->fun(job->width, row_count,
+		job->rgb+first_row*job->rgb_stride, job->rgb_stride,
+		job->y+first_row*job->y_stride, job->uv+(first_row/2)*job->uv_stride,
+		job->y_stride, job->uv_stride,
+		job->yuv_type);
+}
+
+void rgb2yuvsp_mt(YUVRGBThreadPool *pool, RGB2YUVSPFunction fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *RGB, uint32_t RGB_stride,
+	uint8_t *Y, uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride,
+	YCbCrType yuv_type)
+{
+	const RGB2YUVSPJob job = {fun, width, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type};
+	pool_run(pool, rgb2yuvsp_band, &job, height);
+}
+
+void rgb2yuvsp_strips(RGB2YUVSPFunction fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *RGB, uint32_t RGB_stride,
+	uint8_t *Y, uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride,
+	YCbCrType yuv_type,
+	uint32_t strip_rows, YUVRGBStripCallback callback, void *user_data)
+{
+	const RGB2YUVSPJob job = {fun, width, RGB, RGB_stride, Y, UV, Y_stride, UV_stride, yuv_type};
+	strip_run(rgb2yuvsp_band, &job, height, RGB_stride+Y_stride+UV_stride/2, strip_rows, callback, user_data);
+}
+
+// Region of interest conversion
+// A region is converted in up to four parts: its first column if it starts on an odd column, and its first row 
+// if it starts on an odd row, that do not share their chroma samples with the next column or row, and the rest, 
+// that starts on an even column and row, as the conversion functions expect.
+
+// split [start, start+size) in its first element if start is odd, and the rest
+static void region_split(uint32_t start, uint32_t size, uint32_t first[2], uint32_t count[2])
+{
+	count[0] = (start%2) && size>0 ? 1 : 0;
+	count[1] = size-count[0];
+	first[0] = start;
+	first[1] = start+count[0];
+}
+
+void yuv2rgb_roi(YUV2RGBFunction fun,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	const YUVRGBRegion *regions, uint32_t region_count,
+	YCbCrType yuv_type)
+{
+	uint32_t i, j, k;
+	for(i=0; i<region_count; ++i)
+	{
+		const YUVRGBRegion *r = regions+i;
+		uint32_t x[2], width[2], y[2], height[2];
+		region_split(r->x, r->width, x, width);
+		region_split(r->y, r->height, y, height);
+		for(j=0; j<2; ++j)
+			for(k=0; k<2; ++k)
+				if(width[k]>0 && height[j]>0)
+					fun(width[k], height[j],
+						Y+y[j]*Y_stride+x[k], U+(y[j]/2)*UV_stride+x[k]/2, V+(y[j]/2)*UV_stride+x[k]/2,
+						Y_stride, UV_stride,
+						r->rgb+(y[j]-r->y)*r->rgb_stride+3*(x[k]-r->x), r->rgb_stride,
+						yuv_type);
+	}
+}
+
+void yuvsp2rgb_roi(YUVSP2RGBFunction fun,
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride,
+	const YUVRGBRegion *regions, uint32_t region_count,
+	YCbCrType yuv_type)
+{
+	uint32_t i, j, k;
+	for(i=0; i<region_count; ++i)
+	{
+		const YUVRGBRegion *r = regions+i;
+		uint32_t x[2], width[2], y[2], height[2];
+		region_split(r->x, r->width, x, width);
+		region_split(r->y, r->height, y, height);
+		for(j=0; j<2; ++j)
+			for(k=0; k<2; ++k)
+				if(width[k]>0 && height[j]>0)
+					fun(width[k], height[j],
+						Y+y[j]*Y_stride+x[k], UV+(y[j]/2)*UV_stride+2*(x[k]/2),
+						Y_stride, UV_stride,
+						r->rgb+(y[j]-r->y)*r->rgb_stride+3*(x[k]-r->x), r->rgb_stride,
+						yuv_type);
+	}
+}
+
+// Rotated conversion
+// The output is converted by tiles of ROTATE_TILE_WIDTH x ROTATE_TILE_HEIGHT pixels: the y and chroma values of 
+// a tile are first copied in the output orientation into small buffers, that stay in the L1 cache, and then 
+// converted with the conversion function, that writes the rgb values directly at their final position.
+// The tiles are wide enough for the 64 pixels blocks of the avx2 and avx512 implementations.
+#define ROTATE_TILE_WIDTH 128
+#define ROTATE_TILE_HEIGHT 32
+
+// move of the input pixel (in columns and rows) for the next output column, and for the next output row
+typedef struct
+{
+	int column_dx, column_dy;
+	int row_dx, row_dy;
+} OrientationSteps;
+
+static const OrientationSteps ORIENTATION_STEPS[6] = {
+	{1, 0, 0, 1},   // ORIENTATION_NONE
+	{0, -1, 1, 0},  // ORIENTATION_ROTATE_90, output (x, y) is input (y, height-1-x)
+	{-1, 0, 0, -1}, // ORIENTATION_ROTATE_180
+	{0, 1, -1, 0},  // ORIENTATION_ROTATE_270, output (x, y) is input (width-1-y, x)
+	{-1, 0, 0, 1},  // ORIENTATION_MIRROR
+	{1, 0, 0, -1}   // ORIENTATION_FLIP
+};
+
+// Mapping of the output pixels to the input ones
+// When an input dimension is odd and reversed, the first output column (or row) is the last input one, that has 
+// its own chroma sample, and the next 2x2 blocks of the output start on its second column (or row): the tiles 
+// then start on phase+n*ROTATE_TILE_WIDTH (phase+n*ROTATE_TILE_HEIGHT), the first one having a size of 1.
+typedef struct
+{
+	const OrientationSteps *steps;
+	uint32_t width, height;                // of the output
+	uint32_t x0, y0;                       // input pixel of the first output pixel
+	ptrdiff_t column_step, row_step;       // in the y plane
+	ptrdiff_t uv_column_step, uv_row_step; // in the chroma plane(s), for two output columns or rows
+	uint32_t phase_x, phase_y;
+} OrientationMapping;
+
+// uv_size is the size of a chroma sample, 1 for planar chroma and 2 for interleaved chroma
+static void orientation_mapping(Orientation orientation, uint32_t width, uint32_t height, 
+	uint32_t Y_stride, uint32_t UV_stride, int uv_size, OrientationMapping *m)
+{
+	const OrientationSteps *s = ORIENTATION_STEPS+orientation;
+	m->steps = s;
+	m->width = s->column_dx!=0 ? width : height;
+	m->height = s->column_dx!=0 ? height : width;
+	m->x0 = (s->column_dx<0 || s->row_dx<0) ? width-1 : 0;
+	m->y0 = (s->column_dy<0 || s->row_dy<0) ? height-1 : 0;
+	m->column_step = s->column_dx + (ptrdiff_t)s->column_dy*Y_stride;
+	m->row_step = s->row_dx + (ptrdiff_t)s->row_dy*Y_stride;
+	m->uv_column_step = uv_size*s->column_dx + (ptrdiff_t)s->column_dy*UV_stride;
+	m->uv_row_step = uv_size*s->row_dx + (ptrdiff_t)s->row_dy*UV_stride;
+	m->phase_x = (s->column_dx<0 && width%2) || (s->column_dy<0 && height%2) ? 1 : 0;
+	m->phase_y = (s->row_dx<0 && width%2) || (s->row_dy<0 && height%2) ? 1 : 0;
+}
+
+// size of the tile starting at output position start, of a dimension of the given size and phase
+static uint32_t tile_size(uint32_t start, uint32_t size, uint32_t phase, uint32_t tile_max)
+{
+	if(start<phase)
+		return 1;
+	return size-start<tile_max ? size-start : tile_max;
+}
+
+// copy a width x height tile of values of SIZE bytes, reading them from src with the given steps
+#define TILE_GATHER_FUNCTION(NAME, SIZE) \
+static void NAME(uint8_t *tile, uint32_t tile_stride, const uint8_t *src, ptrdiff_t column_step, ptrdiff_t row_step, \
+	uint32_t width, uint32_t height) \
+{ \
+	uint32_t x, y, i; \
+	for(y=0; y<height; ++y) \
+	{ \
+		const uint8_t *s = src+(ptrdiff_t)y*row_step; \
+		uint8_t *t = tile+y*tile_stride; \
+		for(x=0; x<width; ++x, s+=column_step, t+=SIZE) \
+			for(i=0; i<SIZE; ++i) \
+				t[i] = s[i]; \
+	} \
+}
+
+TILE_GATHER_FUNCTION(tile_gather, 1)
+TILE_GATHER_FUNCTION(tile_gather2, 2)
+
+// iterate on the tiles of the output, x and y being the input pixel of the first pixel of the tile
+#define FOR_EACH_TILE(M) \
+	uint32_t tile_x, tile_y, tile_width, tile_height; \
+	for(tile_y=0; tile_y<(M).height; tile_y+=tile_height) \
+	{ \
+		tile_height = tile_size(tile_y, (M).height, (M).phase_y, ROTATE_TILE_HEIGHT); \
+		for(tile_x=0; tile_x<(M).width; tile_x+=tile_width) \
+		{ \
+			tile_width = tile_size(tile_x, (M).width, (M).phase_x, ROTATE_TILE_WIDTH); \
+			const uint32_t x = (M).x0 + (M).steps->column_dx*(int32_t)tile_x + (M).steps->row_dx*(int32_t)tile_y, \
+				y = (M).y0 + (M).steps->column_dy*(int32_t)tile_x + (M).steps->row_dy*(int32_t)tile_y;
+
+#define END_FOR_EACH_TILE \
+		} \
+	}
+
+void yuv2rgb_rotate(YUV2RGBFunction fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type, Orientation orientation)
+{
+	if(orientation==ORIENTATION_NONE)
+	{
+		fun(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type);
+		return;
+	}
+	
+	uint8_t y_tile[ROTATE_TILE_WIDTH*ROTATE_TILE_HEIGHT], 
+		u_tile[(ROTATE_TILE_WIDTH/2)*(ROTATE_TILE_HEIGHT/2)], v_tile[(ROTATE_TILE_WIDTH/2)*(ROTATE_TILE_HEIGHT/2)];
+	OrientationMapping m;
+	orientation_mapping(orientation, width, height, Y_stride, UV_stride, 1, &m);
+	
+	FOR_EACH_TILE(m)
+		const uint32_t uv_offset = (y/2)*UV_stride+x/2;
+		tile_gather(y_tile, ROTATE_TILE_WIDTH, Y+y*Y_stride+x, m.column_step, m.row_step, tile_width, tile_height);
+		tile_gather(u_tile, ROTATE_TILE_WIDTH/2, U+uv_offset, m.uv_column_step, m.uv_row_step, 
+			(tile_width+1)/2, (tile_height+1)/2);
+		tile_gather(v_tile, ROTATE_TILE_WIDTH/2, V+uv_offset, m.uv_column_step, m.uv_row_step, 
+			(tile_width+1)/2, (tile_height+1)/2);
+		fun(tile_width, tile_height, y_tile, u_tile, v_tile, ROTATE_TILE_WIDTH, ROTATE_TILE_WIDTH/2,
+			RGB+tile_y*RGB_stride+3*tile_x, RGB_stride, yuv_type);
+	END_FOR_EACH_TILE
+}
+
+void yuvsp2rgb_rotate(YUVSP2RGBFunction fun,
+	uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *UV, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type, Orientation orientation)
+{
+	if(orientation==ORIENTATION_NONE)
+	{
+		fun(width, height, Y, UV, Y_stride, UV_stride, RGB, RGB_stride, yuv_type);
+		return;
+	}
+	
+	uint8_t y_tile[ROTATE_TILE_WIDTH*ROTATE_TILE_HEIGHT], uv_tile[ROTATE_TILE_WIDTH*(ROTATE_TILE_HEIGHT/2)];
+	OrientationMapping m;
+	orientation_mapping(orientation, width, height, Y_stride, UV_stride, 2, &m);
+	
+	FOR_EACH_TILE(m)
+		tile_gather(y_tile, ROTATE_TILE_WIDTH, Y+y*Y_stride+x, m.column_step, m.row_step, tile_width, tile_height);
+		tile_gather2(uv_tile, ROTATE_TILE_WIDTH, UV+(y/2)*UV_stride+2*(x/2), m.uv_column_step, m.uv_row_step, 
+			(tile_width+1)/2, (tile_height+1)/2);
+		fun(tile_width, tile_height, y_tile, uv_tile, ROTATE_TILE_WIDTH, ROTATE_TILE_WIDTH,
+			RGB+tile_y*RGB_stride+3*tile_x, RGB_stride, yuv_type);
+	END_FOR_EACH_TILE
+}
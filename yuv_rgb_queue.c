@@ -0,0 +1,294 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+// pipe and fcntl
+#define _POSIX_C_SOURCE 200112L
+
+#include "yuv_rgb.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#else
+#include <fcntl.h>
+#endif
+
+struct YUVRGBJobQueue
+{
+	pthread_mutex_t mutex;
+	pthread_cond_t job_cond;     // signaled when a job is submitted, or when the queue is stopped
+	pthread_cond_t slot_cond;    // signaled when a slot is freed
+	pthread_cond_t idle_cond;    // signaled when the last submitted job is converted and its callback returned
+	pthread_t thread;            // takes the jobs one after the other, and converts them with pool
+	int thread_started;
+	YUVRGBThreadPool *pool;
+	int fd[2];                   // read and write ends of the pipe, or the same eventfd
+	uint32_t capacity;
+
+	// protected by mutex
+	YUVRGBJob *jobs;             // submitted jobs, circular buffer of capacity jobs
+	uint32_t first_job, job_count;
+	int converting;              // a job has been taken by the thread and is not converted yet
+	int calling_back;            // the callback of the last converted job has not returned yet
+	void **completed;            // user_data of the completed jobs, circular buffer of capacity entries
+	uint32_t first_completed, completed_count;
+	uint32_t used_slots;         // submitted, converting and completed jobs
+	int stop;
+};
+
+// make the fd readable, mutex must be locked
+static void notify_fd(YUVRGBJobQueue *queue)
+{
+	if(queue->fd[1]<0)
+		return;
+#ifdef __linux__
+	const uint64_t one = 1;
+	const ssize_t result = write(queue->fd[1], &one, sizeof(one));
+#else
+	const uint8_t one = 1;
+	const ssize_t result = write(queue->fd[1], &one, sizeof(one));
+#endif
+	(void)result;
+}
+
+// make the fd not readable anymore, mutex must be locked
+static void clear_fd(YUVRGBJobQueue *queue)
+{
+	if(queue->fd[0]<0)
+		return;
+#ifdef __linux__
+	uint64_t count;
+	const ssize_t result = read(queue->fd[0], &count, sizeof(count));
+	(void)result;
+#else
+	uint8_t buffer[16];
+	while(read(queue->fd[0], buffer, sizeof(buffer))>0) {}
+#endif
+}
+
+static void run_job(YUVRGBThreadPool *pool, const YUVRGBJob *job)
+{
+	switch(job->type)
+	{
+		case JOB_YUV2RGB:
+			yuv2rgb_mt(pool, job->fun.yuv2rgb, job->width, job->height,
+				job->src[0], job->src[1], job->src[2], job->src_stride[0], job->src_stride[1],
+				job->dst[0], job->dst_stride[0], job->yuv_type);
+			break;
+		case JOB_YUVSP2RGB:
+			yuvsp2rgb_mt(pool, job->fun.yuvsp2rgb, job->width, job->height,
+				job->src[0], job->src[1], job->src_stride[0], job->src_stride[1],
+				job->dst[0], job->dst_stride[0], job->yuv_type);
+			break;
+		case JOB_YUV2RGB32:
+			yuv2rgb32_mt(pool, job->fun.yuv2rgb32, job->width, job->height,
+				job->src[0], job->src[1], job->src[2], job->src_stride[0], job->src_stride[1],
+				job->dst[0], job->dst_stride[0], job->yuv_type, job->alpha);
+			break;
+		case JOB_YUVSP2RGB32:
+			yuvsp2rgb32_mt(pool, job->fun.yuvsp2rgb32, job->width, job->height,
+				job->src[0], job->src[1], job->src_stride[0], job->src_stride[1],
+				job->dst[0], job->dst_stride[0], job->yuv_type, job->alpha);
+			break;
+		case JOB_RGB2YUV:
+			rgb2yuv_mt(pool, job->fun.rgb2yuv, job->width, job->height,
+				job->src[0], job->src_stride[0],
+				job->dst[0], job->dst[1], job->dst[2], job->dst_stride[0], job->dst_stride[1], job->yuv_type);
+			break;
+		case JOB_RGB2YUVSP:
+			rgb2yuvsp_mt(pool, job->fun.rgb2yuvsp, job->width, job->height,
+				job->src[0], job->src_stride[0],
+				job->dst[0], job->dst[1], job->dst_stride[0], job->dst_stride[1], job->yuv_type);
+			break;
+	}
+}
+
+// convert the jobs in submission order, until the queue is stopped and all jobs are converted
+// The slot of a job with a callback is freed before the callback is called, so that the callback can submit 
+// a new job to a full queue.
+static void *queue_thread(void *arg)
+{
+	YUVRGBJobQueue *queue = arg;
+
+	pthread_mutex_lock(&queue->mutex);
+	for(;;)
+	{
+		while(!queue->stop && queue->job_count==0)
+			pthread_cond_wait(&queue->job_cond, &queue->mutex);
+		if(queue->job_count==0)
+			break;
+
+		const YUVRGBJob job = queue->jobs[queue->first_job];
+		queue->first_job = (queue->first_job+1)%queue->capacity;
+		queue->job_count--;
+		queue->converting = 1;
+		pthread_mutex_unlock(&queue->mutex);
+
+		run_job(queue->pool, &job);
+
+		pthread_mutex_lock(&queue->mutex);
+		queue->converting = 0;
+		if(job.callback)
+		{
+			queue->used_slots--;
+			pthread_cond_signal(&queue->slot_cond);
+			queue->calling_back = 1;
+			pthread_mutex_unlock(&queue->mutex);
+			
+			job.callback(job.user_data);
+			
+			pthread_mutex_lock(&queue->mutex);
+			queue->calling_back = 0;
+		}
+		else
+		{
+			// the slot is freed when the completion is read
+			queue->completed[(queue->first_completed+queue->completed_count)%queue->capacity] = job.user_data;
+			if(queue->completed_count++ == 0)
+				notify_fd(queue);
+		}
+		if(queue->job_count==0)
+			pthread_cond_broadcast(&queue->idle_cond);
+	}
+	pthread_mutex_unlock(&queue->mutex);
+	return NULL;
+}
+
+YUVRGBJobQueue *yuv_rgb_queue_create(uint32_t thread_count, uint32_t capacity)
+{
+	if(capacity==0)
+		return NULL;
+
+	YUVRGBJobQueue *queue = calloc(1, sizeof(YUVRGBJobQueue));
+	if(!queue)
+		return NULL;
+
+	queue->fd[0] = queue->fd[1] = -1;
+	queue->capacity = capacity;
+	pthread_mutex_init(&queue->mutex, NULL);
+	pthread_cond_init(&queue->job_cond, NULL);
+	pthread_cond_init(&queue->slot_cond, NULL);
+	pthread_cond_init(&queue->idle_cond, NULL);
+
+	queue->jobs = calloc(capacity, sizeof(YUVRGBJob));
+	queue->completed = calloc(capacity, sizeof(void*));
+	queue->pool = yuv_rgb_pool_create(thread_count);
+	if(!queue->jobs || !queue->completed || !queue->pool)
+	{
+		yuv_rgb_queue_destroy(queue);
+		return NULL;
+	}
+
+#ifdef __linux__
+	queue->fd[0] = queue->fd[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#else
+	if(pipe(queue->fd)==0)
+	{
+		fcntl(queue->fd[0], F_SETFL, O_NONBLOCK);
+		fcntl(queue->fd[1], F_SETFL, O_NONBLOCK);
+	}
+	else
+		queue->fd[0] = queue->fd[1] = -1;
+#endif
+
+	if(pthread_create(&queue->thread, NULL, queue_thread, queue)!=0)
+	{
+		yuv_rgb_queue_destroy(queue);
+		return NULL;
+	}
+	queue->thread_started = 1;
+
+	return queue;
+}
+
+void yuv_rgb_queue_destroy(YUVRGBJobQueue *queue)
+{
+	if(!queue)
+		return;
+
+	if(queue->thread_started)
+	{
+		pthread_mutex_lock(&queue->mutex);
+		queue->stop = 1;
+		pthread_cond_signal(&queue->job_cond);
+		pthread_mutex_unlock(&queue->mutex);
+		pthread_join(queue->thread, NULL);
+	}
+
+	if(queue->fd[0]>=0)
+		close(queue->fd[0]);
+	if(queue->fd[1]>=0 && queue->fd[1]!=queue->fd[0])
+		close(queue->fd[1]);
+	yuv_rgb_pool_destroy(queue->pool);
+	pthread_cond_destroy(&queue->idle_cond);
+	pthread_cond_destroy(&queue->slot_cond);
+	pthread_cond_destroy(&queue->job_cond);
+	pthread_mutex_destroy(&queue->mutex);
+	free(queue->completed);
+	free(queue->jobs);
+	free(queue);
+}
+
+// add a job, mutex must be locked and a slot must be free
+static void push_job(YUVRGBJobQueue *queue, const YUVRGBJob *job)
+{
+	queue->jobs[(queue->first_job+queue->job_count)%queue->capacity] = *job;
+	queue->job_count++;
+	queue->used_slots++;
+	pthread_cond_signal(&queue->job_cond);
+}
+
+void yuv_rgb_queue_submit(YUVRGBJobQueue *queue, const YUVRGBJob *job)
+{
+	pthread_mutex_lock(&queue->mutex);
+	while(queue->used_slots==queue->capacity)
+		pthread_cond_wait(&queue->slot_cond, &queue->mutex);
+	push_job(queue, job);
+	pthread_mutex_unlock(&queue->mutex);
+}
+
+int yuv_rgb_queue_try_submit(YUVRGBJobQueue *queue, const YUVRGBJob *job)
+{
+	int result = -1;
+	pthread_mutex_lock(&queue->mutex);
+	if(queue->used_slots<queue->capacity)
+	{
+		push_job(queue, job);
+		result = 0;
+	}
+	pthread_mutex_unlock(&queue->mutex);
+	return result;
+}
+
+int yuv_rgb_queue_fd(const YUVRGBJobQueue *queue)
+{
+	return queue->fd[0];
+}
+
+uint32_t yuv_rgb_queue_completed(YUVRGBJobQueue *queue, void **user_data, uint32_t max_count)
+{
+	pthread_mutex_lock(&queue->mutex);
+	const uint32_t count = queue->completed_count<max_count ? queue->completed_count : max_count;
+	uint32_t i;
+	for(i=0; i<count; ++i)
+		user_data[i] = queue->completed[(queue->first_completed+i)%queue->capacity];
+	queue->first_completed = (queue->first_completed+count)%queue->capacity;
+	queue->completed_count -= count;
+	queue->used_slots -= count;
+	if(count>0 && queue->completed_count==0)
+		clear_fd(queue);
+	if(count>0)
+		pthread_cond_broadcast(&queue->slot_cond);
+	pthread_mutex_unlock(&queue->mutex);
+	return count;
+}
+
+void yuv_rgb_queue_wait(YUVRGBJobQueue *queue)
+{
+	pthread_mutex_lock(&queue->mutex);
+	while(queue->job_count>0 || queue->converting || queue->calling_back)
+		pthread_cond_wait(&queue->idle_cond, &queue->mutex);
+	pthread_mutex_unlock(&queue->mutex);
+}